@@ -216,6 +216,16 @@ namespace dxvk {
     };
     using RemixIboMemoizer = MemoryRegionMemoizer<RemixIndexBufferMemoizationData>;
     RemixIboMemoizer remixMemoization;
+
+    /**
+     * \brief Process-wide unique value identifying the current buffer contents
+     *
+     * Assigned on creation and replaced whenever the buffer is locked for writing,
+     * so data derived from the contents can be cached across draws.
+     */
+    inline uint64_t GetWriteGeneration() const { return m_writeGeneration; }
+
+    inline void BumpWriteGeneration() { m_writeGeneration = s_nextWriteGeneration++; }
     // NV-DXVK end
 
   private:
@@ -253,6 +263,12 @@ namespace dxvk {
 
     uint64_t                    m_seq = 0ull;
 
+    // NV-DXVK start: Implement memoization for some expensive CPU operations
+    uint64_t                    m_writeGeneration = s_nextWriteGeneration++;
+
+    static inline std::atomic<uint64_t> s_nextWriteGeneration = 1;
+    // NV-DXVK end
+
   };
 
 }
\ No newline at end of file
@@ -45,6 +45,7 @@
 #include "../dxvk/rtx_render/rtx_context.h"
 #include "../dxvk/rtx_render/rtx_options.h"
 #include "../dxvk/rtx_render/rtx_terrain_baker.h"
+#include "../dxvk/rtx_render/rtx_texture_category_cache.h"
 
 #include "d3d9_initializer.h"
 
@@ -4514,6 +4515,7 @@ namespace dxvk {
         Flush();
         SynchronizeCsThread();
 
+        DxvkCsStallScope stall(m_dxvkDevice->csStats(), DxvkCsStallReason::ResourceWait);
         m_dxvkDevice->waitForResource(Resource, access);
       }
     }
@@ -5049,6 +5051,11 @@ namespace dxvk {
     if ((desc.Pool == D3DPOOL_DEFAULT || !(Flags & D3DLOCK_NO_DIRTY_UPDATE)) && !(Flags & D3DLOCK_READONLY))
       pResource->DirtyRange().Conjoin(lockRange);
 
+    // NV-DXVK start: Implement memoization for some expensive CPU operations
+    if (!(Flags & D3DLOCK_READONLY))
+      pResource->BumpWriteGeneration();
+    // NV-DXVK end
+
     Rc<DxvkBuffer> mappingBuffer = pResource->GetBuffer<D3D9_COMMON_BUFFER_TYPE_MAPPING>();
 
     DxvkBufferSliceHandle physSlice;
@@ -7274,7 +7281,8 @@ namespace dxvk {
               if (isLastStage && numActiveStages > 1 && RtxOptions::ignoreLastTextureStage()) {
                 return true;
               }
-              if (lookupHash(RtxOptions::ignoreTextures(), texHash) || lookupHash(RtxOptions::lightmapTextures(), texHash)) {
+              const TextureCategoryFlags texCategories = TextureCategoryCache::get().lookup(texHash);
+              if (texCategories.instanceCategories.test(InstanceCategories::Ignore) || texCategories.textureCategories.test(TextureCategories::Lightmap)) {
                 return true;
               }
             }
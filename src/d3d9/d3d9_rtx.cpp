@@ -14,6 +14,7 @@
 #include "d3d9_rtx_utils.h"
 #include "d3d9_texture.h"
 #include "../dxvk/rtx_render/rtx_terrain_baker.h"
+#include "../dxvk/rtx_render/rtx_texture_category_cache.h"
 
 namespace dxvk {
   static const bool s_isDxvkResolutionEnvVarSet = (env::getEnvVar("DXVK_RESOLUTION_WIDTH") != "") || (env::getEnvVar("DXVK_RESOLUTION_HEIGHT") != "");
@@ -26,6 +27,7 @@ namespace dxvk {
 
   D3D9Rtx::D3D9Rtx(D3D9DeviceEx* d3d9Device, bool enableDrawCallConversion)
     : m_rtStagingData(d3d9Device->GetDXVKDevice(), "RtxStagingDataAlloc: D3D9", (VkMemoryPropertyFlagBits) (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    , m_rtStreamArena(d3d9Device->GetDXVKDevice(), "RtxFrameStagingArena: D3D9", kMaxFramesInFlight, (VkMemoryPropertyFlagBits) (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
     , m_parent(d3d9Device)
     , m_enableDrawCallConversion(enableDrawCallConversion)
     , m_pGeometryWorkers(enableDrawCallConversion ? std::make_unique<GeometryProcessor>(numGeometryProcessingThreads(), "geometry-processing") : nullptr) {
@@ -208,6 +210,10 @@ namespace dxvk {
 
   void D3D9Rtx::processVertices(const VertexContext vertexContext[caps::MaxStreams], int vertexIndexOffset, RasterGeometry& geoData) {
     DxvkBufferSlice streamCopies[caps::MaxStreams] {};
+    // Write generation of streams used directly from a D3D9 buffer, 0 if the stream data was copied
+    uint64_t streamWriteGenerations[caps::MaxStreams] {};
+
+    m_blendIndicesSourceHash = kEmptyHash;
 
     // Process vertex buffers from CPU
     for (const auto& element : d3d9State().vertexDecl->GetElements()) {
@@ -255,7 +261,7 @@ namespace dxvk {
       case D3DDECLUSAGE_COLOR:
         if (element.UsageIndex == 0 &&
             !RtxOptions::ignoreAllVertexColorBakedLighting() &&
-            !lookupHash(RtxOptions::ignoreBakedLightingTextures(), m_activeDrawCallState.materialData.colorTextures[0].getImageHash())) {
+            !TextureCategoryCache::get().lookup(m_activeDrawCallState.materialData.colorTextures[0].getImageHash()).instanceCategories.test(InstanceCategories::IgnoreBakedLighting)) {
           targetBuffer = &geoData.color0Buffer;
         }
         break;
@@ -268,6 +274,9 @@ namespace dxvk {
         if (!streamCopies[element.Stream].defined()) {
           // Deep clonning a buffer object is not cheap (320 bytes to copy and other work). Set a min-size threshold.
           const uint32_t kMinSizeToClone = 512;
+          // Copies up to this size go to the per-frame stream arena rather than the staging allocator
+          const uint32_t kMaxSizeToCoalesce = 64 * 1024;
+          const uint32_t kCoalescedStreamAlignment = 16;
 
           // Check if buffer is actualy a d3d9 orphan
           const bool isOrphan = !(ctx.buffer.getSliceHandle() == ctx.mappedSlice);
@@ -279,11 +288,17 @@ namespace dxvk {
               m_parent->FlushBuffer(ctx.pVBO);
 
             streamCopies[element.Stream] = ctx.buffer.subSlice(vertexOffset, numVertexBytes);
+
+            if (ctx.pVBO != nullptr && !ctx.pVBO->WasWrittenByGPU())
+              streamWriteGenerations[element.Stream] = ctx.pVBO->GetWriteGeneration();
           } else if (canUseBuffer && numVertexBytes > kMinSizeToClone) {
             // Create a clone for the orphaned physical slice
             auto clone = ctx.buffer.buffer()->clone();
             clone->rename(ctx.mappedSlice);
             streamCopies[element.Stream] = DxvkBufferSlice(clone, ctx.buffer.offset() + vertexOffset, numVertexBytes);
+          } else if (numVertexBytes <= kMaxSizeToCoalesce) {
+            // Small streams are packed together, and identical ones shared, for the whole frame
+            streamCopies[element.Stream] = m_rtStreamArena.upload((uint8_t*) ctx.mappedSlice.mapPtr + vertexOffset, numVertexBytes, kCoalescedStreamAlignment);
           } else {
             streamCopies[element.Stream] = m_rtStagingData.alloc(CACHE_LINE_SIZE, numVertexBytes);
 
@@ -296,6 +311,11 @@ namespace dxvk {
 
         *targetBuffer = RasterBuffer(streamCopies[element.Stream], element.Offset, ctx.stride, DecodeDecltype(D3DDECLTYPE(element.Type)));
         assert(targetBuffer->offset() % 4 == 0);
+
+        if (targetBuffer == &geoData.blendIndicesBuffer && streamWriteGenerations[element.Stream] != 0) {
+          const uint64_t source[] = { streamWriteGenerations[element.Stream], (uint64_t) vertexOffset + element.Offset, ctx.stride };
+          m_blendIndicesSourceHash = XXH3_64bits(source, sizeof(source));
+        }
       }
     }
   }
@@ -385,7 +405,7 @@ namespace dxvk {
     if (RtxOptions::RaytracedRenderTarget::enable()) {
       for (uint32_t i : bit::BitMask(m_parent->GetActiveRTTextures())) {
         D3D9CommonTexture* texture = GetCommonTexture(d3d9State().textures[i]);
-        if (lookupHash(RtxOptions::raytracedRenderTargetTextures(), texture->GetImage()->getDescriptorHash())) {
+        if (TextureCategoryCache::get().lookup(texture->GetImage()->getDescriptorHash()).textureCategories.test(TextureCategories::RaytracedRenderTarget)) {
           m_activeDrawCallState.isUsingRaytracedRenderTarget = true;
         }
       }
@@ -456,7 +476,7 @@ namespace dxvk {
     // a texture for some geometry later
     if (RtxOptions::RaytracedRenderTarget::enable()) {
       D3D9CommonTexture* texture = GetCommonTexture(d3d9State().renderTargets[kRenderTargetIndex]->GetBaseTexture());
-      if (texture && lookupHash(RtxOptions::raytracedRenderTargetTextures(), texture->GetImage()->getDescriptorHash())) {
+      if (texture && TextureCategoryCache::get().lookup(texture->GetImage()->getDescriptorHash()).textureCategories.test(TextureCategories::RaytracedRenderTarget)) {
         m_activeDrawCallState.isDrawingToRaytracedRenderTarget = true;
         return { RtxGeometryStatus::RayTraced, false };
       }
@@ -618,7 +638,7 @@ namespace dxvk {
         for (uint32_t i : bit::BitMask(m_parent->GetActiveRTTextures())) {
           D3D9CommonTexture* texture = GetCommonTexture(d3d9State().textures[i]);
           auto hash = texture->GetImage()->getDescriptorHash();
-          if (lookupHash(RtxOptions::raytracedRenderTargetTextures(), hash)) {
+          if (TextureCategoryCache::get().lookup(hash).textureCategories.test(TextureCategories::RaytracedRenderTarget)) {
             // Mark this as a valid Raytraced Render Target draw call
             m_activeDrawCallState.isUsingRaytracedRenderTarget = true;
           }
@@ -788,10 +808,27 @@ namespace dxvk {
     const uint32_t vertexCount = geoData.vertexCount;
 
     HashQuery blendIndices;
+    BoneIndexRange cachedBoneIndexRange;
+    bool hasCachedBoneIndexRange = false;
+    XXH64_hash_t boneIndexRangeHash = kEmptyHash;
+
     // Analyze the vertex data and find the min and max bone indices used in this mesh.
     // The min index is used to detect a case when vertex blend is enabled but there is just one bone used in the mesh,
     // so we can drop the skinning pass. That is processed in RtxContext::commitGeometryToRT(...)
-    if (indexedVertexBlend && geoData.blendIndicesBuffer.defined()) {
+    // The result only depends on the buffer contents, so it is reused while the source buffer is not written to.
+    if (indexedVertexBlend && geoData.blendIndicesBuffer.defined() && m_blendIndicesSourceHash != kEmptyHash) {
+      const uint64_t range[] = { vertexCount, numBonesPerVertex };
+      boneIndexRangeHash = XXH3_64bits_withSeed(range, sizeof(range), m_blendIndicesSourceHash);
+
+      std::lock_guard<dxvk::mutex> lock(m_boneIndexRangeMutex);
+      if (BoneIndexRange* cached = m_boneIndexRanges.find(boneIndexRangeHash)) {
+        cached->lastUsedFrame = m_frameArena.getFrameId();
+        cachedBoneIndexRange = *cached;
+        hasCachedBoneIndexRange = true;
+      }
+    }
+
+    if (indexedVertexBlend && geoData.blendIndicesBuffer.defined() && !hasCachedBoneIndexRange) {
       auto& buffer = geoData.blendIndicesBuffer;
 
       blendIndices.pBase = (uint8_t*) buffer.mapPtr(buffer.offsetFromSlice());
@@ -820,17 +857,21 @@ namespace dxvk {
     memcpy(boneMatrices, d3d9State().transforms.data() + startBoneTransform, sizeof(Matrix4)*(maxBone + 1));
     m_stagedBonesCount += maxBone + 1;
 
-    return m_pGeometryWorkers->Schedule([boneMatrices, blendIndices, numBonesPerVertex, vertexCount]()->SkinningData {
+    return m_pGeometryWorkers->Schedule([this, boneMatrices, blendIndices, numBonesPerVertex, vertexCount, cachedBoneIndexRange, hasCachedBoneIndexRange, boneIndexRangeHash,
+                                         frameId = m_frameArena.getFrameId()]()->SkinningData {
       ScopedCpuProfileZone();
       uint32_t numBones = numBonesPerVertex;
 
       int minBoneIndex = 0;
-      if (blendIndices.ref) {
+      if (hasCachedBoneIndexRange) {
+        minBoneIndex = cachedBoneIndexRange.minBoneIndex;
+        numBones = cachedBoneIndexRange.maxBoneIndex + 1;
+      } else if (blendIndices.ref) {
         const uint8_t* pBlendIndices = blendIndices.pBase;
         // Find out how many bone indices are specified for each vertex.
         // This is needed to find out the min bone index and ignore the padding zeroes.
         int maxBoneIndex = -1;
-        if (!getMinMaxBoneIndices(pBlendIndices, blendIndices.stride, vertexCount, numBonesPerVertex, minBoneIndex, maxBoneIndex)) {
+        if (!getMinMaxBoneIndices(pBlendIndices, blendIndices.stride, blendIndices.elementSize, vertexCount, numBonesPerVertex, minBoneIndex, maxBoneIndex)) {
           minBoneIndex = 0;
           maxBoneIndex = 0;
         }
@@ -839,16 +880,20 @@ namespace dxvk {
         // Release this memory back to the staging allocator
         blendIndices.ref->release(DxvkAccess::Read);
         blendIndices.ref->decRef();
+
+        if (boneIndexRangeHash != kEmptyHash) {
+          std::lock_guard<dxvk::mutex> lock(m_boneIndexRangeMutex);
+          BoneIndexRange& range = m_boneIndexRanges[boneIndexRangeHash];
+          range.minBoneIndex = minBoneIndex;
+          range.maxBoneIndex = maxBoneIndex;
+          range.lastUsedFrame = frameId;
+        }
       }
 
       // Pass bone data to RT back-end
 
       SkinningData skinningData;
-      skinningData.pBoneMatrices.reserve(numBones);
-
-      for (uint32_t n = 0; n < numBones; n++) {
-        skinningData.pBoneMatrices.push_back(boneMatrices[n]);
-      }
+      skinningData.pBoneMatrices = SkinningData::BoneMatrices(boneMatrices, boneMatrices + numBones, FrameArenaAllocator<Matrix4>(&m_frameArena));
 
       skinningData.minBoneIndex = minBoneIndex;
       skinningData.numBones = numBones;
@@ -978,9 +1023,10 @@ namespace dxvk {
         }
 
         const XXH64_hash_t texHash = texture->GetSampleView(true)->image()->getHash();
+        const TextureCategoryFlags texCategories = TextureCategoryCache::get().lookup(texHash);
 
         // Currently we only support regular textures, skip lightmaps.
-        if (lookupHash(RtxOptions::lightmapTextures(), texHash)) {
+        if (texCategories.textureCategories.test(TextureCategories::Lightmap)) {
           continue;
         }
 
@@ -1000,7 +1046,7 @@ namespace dxvk {
 
         // Check if texture factor blending is enabled
         if (isCurrentStageTextureFactorBlendingEnabled &&
-            lookupHash(RtxOptions::ignoreBakedLightingTextures(), texHash)) {
+            texCategories.instanceCategories.test(InstanceCategories::IgnoreBakedLighting)) {
           useStageTextureFactorBlending = false;
           useMultipleStageTextureFactorBlending = false;
         }
@@ -1222,12 +1268,38 @@ namespace dxvk {
       static_cast<RtxContext*>(ctx)->endFrame(currentReflexFrameId, targetImage, callInjectRtx); 
     });
 
+    // Draws of this frame, including their bone matrices, are consumed by the CS thread before this runs
+    m_parent->EmitCs([this, cFrameId = m_frameArena.getFrameId()](DxvkContext* ctx) {
+      m_frameArena.completeFrame(cFrameId);
+    });
+
     // Reset for the next frame
     m_rtxInjectTriggered = false;
     m_drawCallID = 0;
     m_seenCameraPositionsPrev = std::move(m_seenCameraPositions);
 
     m_stagedBonesCount = 0;
+
+    const FrameArena::Stats frameArenaStats = m_frameArena.advanceFrame();
+    ProfilerPlotValueI64("Frame Arena Allocations", frameArenaStats.allocationCount);
+    ProfilerPlotValueI64("Frame Arena Bytes", frameArenaStats.allocatedBytes);
+    ProfilerPlotValueI64("Frame Arena Blocks", frameArenaStats.blockCount);
+
+    const RtxFrameStagingArena::Stats streamArenaStats = m_rtStreamArena.endFrame();
+    ProfilerPlotValueI64("Stream Arena Uploads", streamArenaStats.uploadCount);
+    ProfilerPlotValueI64("Stream Arena Deduplicated", streamArenaStats.dedupedCount);
+    ProfilerPlotValueI64("Stream Arena Bytes", (int64_t) streamArenaStats.uploadedBytes);
+    ProfilerPlotValueI64("Stream Arena Chunks", streamArenaStats.chunkCount);
+
+    {
+      // Evict bone index ranges of buffers that were rewritten or are no longer drawn
+      std::lock_guard<dxvk::mutex> lock(m_boneIndexRangeMutex);
+      const uint64_t frameId = m_frameArena.getFrameId();
+      m_boneIndexRanges.erase_if([frameId](XXH64_hash_t, const BoneIndexRange& range) {
+        return range.lastUsedFrame + kBoneIndexRangeLifetime < frameId;
+      });
+      ProfilerPlotValueI64("Bone Index Range Cache Size", (int64_t) m_boneIndexRanges.size());
+    }
   }
 
   void D3D9Rtx::OnPresent(const Rc<DxvkImage>& targetImage) {
@@ -3,6 +3,7 @@
 #include "d3d9_state.h"
 #include "../dxvk/dxvk_buffer.h"
 #include "../util/util_threadpool.h"
+#include "../util/util_flat_hash_map.h"
 
 #include <vector>
 #include <optional>
@@ -174,12 +175,31 @@ namespace dxvk {
   private: 
     inline static const uint32_t kMaxConcurrentDraws = 6 * 1024; // some games issuing >3000 draw calls per frame...  account for some consumer thread lag with x2
     using GeometryProcessor = WorkerThreadPool<kMaxConcurrentDraws>;
+    // Transient per draw allocations, must outlive the geometry workers allocating from it.
+    // A frame's memory is only recycled once the CS thread has completed that frame, see EndFrame.
+    FrameArena m_frameArena;
+
+    // Min/max bone indices found in blend index data that has not been written since, see processSkinning.
+    // Filled in by the geometry workers, so it must also outlive them.
+    struct BoneIndexRange {
+      int minBoneIndex = 0;
+      int maxBoneIndex = 0;
+      uint64_t lastUsedFrame = 0;
+    };
+    static constexpr uint64_t kBoneIndexRangeLifetime = 16;
+    dxvk::mutex m_boneIndexRangeMutex;
+    fast_flat_map<BoneIndexRange> m_boneIndexRanges;
+    // Identifies the blend indices source of the current draw, kEmptyHash if it can't be cached
+    XXH64_hash_t m_blendIndicesSourceHash = kEmptyHash;
+
     const std::unique_ptr<GeometryProcessor> m_pGeometryWorkers;
     AtomicQueue<DrawCallState, kMaxConcurrentDraws> m_drawCallStateQueue;
 
     DrawCallState m_activeDrawCallState;
 
     RtxStagingDataAlloc m_rtStagingData;
+    // Small vertex stream copies, packed and deduplicated per frame
+    RtxFrameStagingArena m_rtStreamArena;
     D3D9DeviceEx* m_parent;
 
     std::optional<D3DPRESENT_PARAMETERS> m_activePresentParams;
@@ -13,11 +13,20 @@
 #include "../util/util_math.h"
 
 namespace dxvk {
-  bool getMinMaxBoneIndices(const uint8_t* pBoneIndices, uint32_t stride, uint32_t vertexCount, uint32_t numBonesPerVertex, int& minBoneIndex, int& maxBoneIndex) {
+  bool getMinMaxBoneIndices(const uint8_t* pBoneIndices, uint32_t stride, uint32_t elementSize, uint32_t vertexCount, uint32_t numBonesPerVertex, int& minBoneIndex, int& maxBoneIndex) {
     ScopedCpuProfileZone();
     if (vertexCount == 0)
       return false;
 
+    // Packed 4 byte elements (UBYTE4, D3DCOLOR) can be scanned 4 vertices at a time
+    if (elementSize >= 4 && numBonesPerVertex >= 1 && numBonesPerVertex <= 4) {
+      uint32_t minIndex, maxIndex;
+      fast::findMinMaxStrided8x4(vertexCount, pBoneIndices, stride, numBonesPerVertex, minIndex, maxIndex);
+      minBoneIndex = (int) minIndex;
+      maxBoneIndex = (int) maxIndex;
+      return true;
+    }
+
     minBoneIndex = 256;
     maxBoneIndex = -1;
 
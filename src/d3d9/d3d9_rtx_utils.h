@@ -13,6 +13,7 @@ namespace dxvk {
     *
     * \param [in] indexPtr: Base pointer for the bone indices vertex region
     * \param [in] stride: Stride of the vertex buffer
+    * \param [in] elementSize: Size of the blend indices vertex element in bytes
     * \param [in] vertexCount: Number of vertices
     * \param [in] numBonesPerVertex: Number of bones per vertex
     * \param [out] minBoneIndex: Minimum referenced bone index
@@ -20,7 +21,7 @@ namespace dxvk {
     *
     * \returns: False if unable to determine the min/max
     */
-  bool getMinMaxBoneIndices(const uint8_t* indexPtr, uint32_t stride, uint32_t vertexCount, uint32_t numBonesPerVertex, int& minBoneIndex, int& maxBoneIndex);
+  bool getMinMaxBoneIndices(const uint8_t* indexPtr, uint32_t stride, uint32_t elementSize, uint32_t vertexCount, uint32_t numBonesPerVertex, int& minBoneIndex, int& maxBoneIndex);
 
   /**
     * \brief: Determines of a render target can be considered primary.
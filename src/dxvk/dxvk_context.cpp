@@ -6017,8 +6017,10 @@ namespace dxvk {
     ScopedCpuProfileZone();
     auto idx = shaders.hash() % m_gpLookupCache.size();
 
-    if (unlikely(!m_gpLookupCache[idx] || !shaders.eq(m_gpLookupCache[idx]->shaders())))
+    if (unlikely(!m_gpLookupCache[idx] || !shaders.eq(m_gpLookupCache[idx]->shaders()))) {
       m_gpLookupCache[idx] = m_common->pipelineManager().createGraphicsPipeline(shaders);
+      m_common->pipelineManager().notifyGraphicsShadersBound(shaders);
+    }
 
     return m_gpLookupCache[idx];
   }
@@ -6029,8 +6031,10 @@ namespace dxvk {
     ScopedCpuProfileZone();
     auto idx = shaders.hash() % m_cpLookupCache.size();
 
-    if (unlikely(!m_cpLookupCache[idx] || !shaders.eq(m_cpLookupCache[idx]->shaders())))
+    if (unlikely(!m_cpLookupCache[idx] || !shaders.eq(m_cpLookupCache[idx]->shaders()))) {
       m_cpLookupCache[idx] = m_common->pipelineManager().createComputePipeline(shaders);
+      m_common->pipelineManager().notifyComputeShadersBound(shaders);
+    }
 
     return m_cpLookupCache[idx];
   }
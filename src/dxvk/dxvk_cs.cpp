@@ -1,5 +1,6 @@
 #include "dxvk_cs.h"
 #include "dxvk_scoped_annotation.h"
+#include "../util/sync/sync_spinlock.h"
 
 // NV-DXVK start: notify user and kill process on exception in CS thread to avoid silent hangs
 #include "rtx_render/rtx_env.h"
@@ -30,6 +31,8 @@ namespace dxvk {
     
     if (m_flags.test(DxvkCsChunkFlag::SingleUse)) {
       m_commandOffset = 0;
+      m_commandCount = 0;
+      m_dataCommandCount = 0;
       
       while (cmd != nullptr) {
         auto next = cmd->next();
@@ -62,6 +65,8 @@ namespace dxvk {
     m_tail = nullptr;
 
     m_commandOffset = 0;
+    m_commandCount = 0;
+    m_dataCommandCount = 0;
   }
   
   
@@ -127,14 +132,46 @@ namespace dxvk {
   uint64_t DxvkCsThread::dispatchChunk(DxvkCsChunkRef&& chunk) {
     ScopedCpuProfileZone();
 
-    uint64_t seq;
+    // Uncontended in the common case of a single producer thread
+    std::unique_lock<dxvk::mutex> dispatchLock(m_dispatchMutex);
 
-    { std::unique_lock<dxvk::mutex> lock(m_mutex);
-      seq = ++m_chunksDispatched;
-      m_chunksQueued.push(std::move(chunk));
+    // Only incremented under the dispatch lock
+    const uint64_t seq = m_chunksDispatched.load(std::memory_order_relaxed) + 1;
+
+    DxvkCsStats& stats = m_device->csStats();
+    stats.recordChunk(chunk->commandCount(), chunk->dataCommandCount(),
+      chunk->usedBytes(), DxvkCsChunk::capacity());
+
+    if (unlikely(!m_chunksQueued.tryPush(std::move(chunk)))) {
+      // The ring is full, wait for the thread to retire enough
+      // chunks that the one before the oldest queued one is done
+      auto t0 = dxvk::high_resolution_clock::now();
+      waitForExecuted(seq - MaxChunksQueued);
+      auto t1 = dxvk::high_resolution_clock::now();
+      auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+
+      m_device->addStatCtr(DxvkStatCounter::CsStallCount, 1);
+      m_device->addStatCtr(DxvkStatCounter::CsStallTicks, ticks.count());
+      stats.recordStall(DxvkCsStallReason::QueueFull,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+      // Cannot fail, at most MaxChunksQueued - 1 chunks are left
+      m_chunksQueued.tryPush(std::move(chunk));
     }
-    
-    m_condOnAdd.notify_one();
+
+    m_chunksDispatched.store(seq, std::memory_order_release);
+    stats.recordQueueDepth(m_chunksQueued.size());
+    dispatchLock.unlock();
+
+    // Pairs with the fence in threadFunc, either the thread sees
+    // the new chunk before parking or we see that it is parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_consumerParked.load(std::memory_order_relaxed)) {
+      std::lock_guard<dxvk::mutex> lock(m_mutex);
+      m_condOnAdd.notify_one();
+    }
+
     return seq;
   }
   
@@ -142,25 +179,40 @@ namespace dxvk {
   void DxvkCsThread::synchronize(uint64_t seq) {
     ScopedCpuProfileZone();
 
+    if (seq == SynchronizeAll)
+      seq = m_chunksDispatched.load(std::memory_order_acquire);
+
     // Avoid locking if we know the sync is a no-op, may
     // reduce overhead if this is being called frequently
     if (seq > m_chunksExecuted.load(std::memory_order_acquire)) {
-      std::unique_lock<dxvk::mutex> lock(m_mutex);
-
-      if (seq == SynchronizeAll)
-        seq = m_chunksDispatched.load();
-
       auto t0 = dxvk::high_resolution_clock::now();
-      m_condOnSync.wait(lock, [this, seq] {
-        return m_chunksExecuted.load() >= seq;
-      });
+      waitForExecuted(seq);
       auto t1 = dxvk::high_resolution_clock::now();
       auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
 
       m_device->addStatCtr(DxvkStatCounter::CsSyncCount, 1);
       m_device->addStatCtr(DxvkStatCounter::CsSyncTicks, ticks.count());
+      m_device->csStats().recordStall(DxvkCsStallReason::Synchronize,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
     }
   }
+
+
+  void DxvkCsThread::waitForExecuted(uint64_t seq) {
+    // Short syncs are common, e.g. for resource readbacks
+    // right after the chunk writing them, so spin first
+    if (sync::spinFor(SpinCount, [this, seq] { return m_chunksExecuted.load(std::memory_order_acquire) >= seq; }))
+      return;
+
+    std::unique_lock<dxvk::mutex> lock(m_mutex);
+    m_syncWaiters.fetch_add(1);
+
+    m_condOnSync.wait(lock, [this, seq] {
+      return m_chunksExecuted.load() >= seq;
+    });
+
+    m_syncWaiters.fetch_sub(1);
+  }
   
   
   void DxvkCsThread::threadFunc() {
@@ -172,32 +224,41 @@ namespace dxvk {
 
     try {
       while (!m_stopped.load()) {
-        { 
+        if (!m_chunksQueued.tryPop(chunk)) {
           ScopedCpuProfileZoneN("waiting for work");
-          std::unique_lock<dxvk::mutex> lock(m_mutex);
-          if (chunk) {
-            m_chunksExecuted++;
-            m_condOnSync.notify_one();
-            
-            chunk = DxvkCsChunkRef();
-          }
-          
-          if (m_chunksQueued.size() == 0) {
-            m_condOnAdd.wait(lock, [this] {
-              return (m_chunksQueued.size() != 0)
-                  || (m_stopped.load());
+
+          // Chunks tend to arrive in bursts, so spin briefly before parking
+          const bool ready = sync::spinFor(SpinCount, [this, &chunk] {
+            return m_chunksQueued.tryPop(chunk) || m_stopped.load(std::memory_order_relaxed);
+          });
+
+          if (!ready) {
+            std::unique_lock<dxvk::mutex> lock(m_mutex);
+            m_consumerParked.store(true, std::memory_order_relaxed);
+
+            // Pairs with the fence in dispatchChunk
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            m_condOnAdd.wait(lock, [this, &chunk] {
+              return m_chunksQueued.tryPop(chunk) || m_stopped.load();
             });
-          }
-          
-          if (m_chunksQueued.size() != 0) {
-            chunk = std::move(m_chunksQueued.front());
-            m_chunksQueued.pop();
+
+            m_consumerParked.store(false, std::memory_order_relaxed);
           }
         }
-        
+
         if (chunk) {
           m_context->addStatCtr(DxvkStatCounter::CsChunkCount, 1);
           chunk->executeAll(m_context.ptr());
+
+          // Release the chunk before anyone waiting on it resumes
+          chunk = DxvkCsChunkRef();
+          m_chunksExecuted.fetch_add(1);
+
+          if (m_syncWaiters.load() != 0) {
+            std::lock_guard<dxvk::mutex> lock(m_mutex);
+            m_condOnSync.notify_all();
+          }
         }
       }
     } catch (const DxvkError& e) {
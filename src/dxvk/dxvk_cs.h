@@ -3,9 +3,9 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 
 #include "../util/thread.h"
+#include "../util/util_spsc_ring.h"
 
 #include "dxvk_device.h"
 #include "dxvk_context.h"
@@ -154,6 +154,38 @@ namespace dxvk {
       return m_commandOffset == 0;
     }
 
+    /**
+     * \brief Number of recorded commands
+     * \returns Command count, including data commands
+     */
+    size_t commandCount() const {
+      return m_commandCount;
+    }
+
+    /**
+     * \brief Number of recorded data commands
+     * \returns Commands added through \ref pushCmd
+     */
+    size_t dataCommandCount() const {
+      return m_dataCommandCount;
+    }
+
+    /**
+     * \brief Number of bytes used by commands
+     * \returns Used size, at most \ref capacity
+     */
+    size_t usedBytes() const {
+      return m_commandOffset;
+    }
+
+    /**
+     * \brief Command storage size
+     * \returns Chunk capacity in bytes
+     */
+    static constexpr size_t capacity() {
+      return MaxBlockSize;
+    }
+
     /**
      * \brief Tries to add a command to the chunk
      * 
@@ -182,6 +214,7 @@ namespace dxvk {
         m_head = m_tail;
       
       m_commandOffset += sizeof(FuncType);
+      m_commandCount += 1;
       return true;
     }
 
@@ -209,6 +242,8 @@ namespace dxvk {
       m_tail = func;
 
       m_commandOffset += sizeof(FuncType);
+      m_commandCount += 1;
+      m_dataCommandCount += 1;
       return func->data();
     }
     
@@ -239,6 +274,8 @@ namespace dxvk {
   private:
     
     size_t m_commandOffset = 0;
+    size_t m_commandCount = 0;
+    size_t m_dataCommandCount = 0;
     
     DxvkCsCmd* m_head = nullptr;
     DxvkCsCmd* m_tail = nullptr;
@@ -386,6 +423,10 @@ namespace dxvk {
 
     constexpr static uint64_t SynchronizeAll = ~0ull;
 
+    /// Maximum number of chunks waiting for the thread. Dispatching
+    /// blocks once this many chunks are queued.
+    constexpr static uint32_t MaxChunksQueued = 4096;
+
     DxvkCsThread(
       const Rc<DxvkDevice>&   device,
       const Rc<DxvkContext>&  context);
@@ -396,6 +437,11 @@ namespace dxvk {
      * 
      * Can be used to efficiently play back large
      * command lists recorded on another thread.
+     * Chunks are handed over through a lock-free
+     * ring. The device lock does not serialize all
+     * producers (e.g. D3D9 without multithreading,
+     * window message handlers or the Remix API), so
+     * concurrent calls are serialized internally.
      * \param [in] chunk The chunk to dispatch
      * \returns Sequence number of the submission
      */
@@ -430,14 +476,28 @@ namespace dxvk {
     std::atomic<uint64_t>       m_chunksDispatched = { 0ull };
     std::atomic<uint64_t>       m_chunksExecuted   = { 0ull };
     
+    // Number of probes before a waiting thread parks
+    constexpr static uint32_t SpinCount = 200;
+
     std::atomic<bool>           m_stopped = { false };
+
+    // Only used to park and wake the threads, the
+    // chunks themselves are passed through the ring
     dxvk::mutex                 m_mutex;
     dxvk::condition_variable    m_condOnAdd;
     dxvk::condition_variable    m_condOnSync;
-    std::queue<DxvkCsChunkRef>  m_chunksQueued;
+    std::atomic<bool>           m_consumerParked = { false };
+    std::atomic<uint32_t>       m_syncWaiters    = { 0u };
+
+    // Serializes producers, the ring only supports one
+    dxvk::mutex                 m_dispatchMutex;
+
+    SpscRing<DxvkCsChunkRef, MaxChunksQueued> m_chunksQueued;
     dxvk::thread                m_thread;
     
     void threadFunc();
+
+    void waitForExecuted(uint64_t seq);
     
   };
   
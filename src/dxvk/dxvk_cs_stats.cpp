@@ -0,0 +1,241 @@
+#include "dxvk_cs_stats.h"
+
+#include "../util/log/log.h"
+#include "../util/util_env.h"
+#include "../util/util_string.h"
+
+namespace dxvk {
+
+  DxvkCsStats::DxvkCsStats() {
+    std::string path = env::getEnvVar("DXVK_CS_STATS_LOG");
+
+    if (!path.empty()) {
+      m_log = std::ofstream(str::tows(path.c_str()).c_str());
+      m_logJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+      if (m_log) {
+        Logger::info(str::format("CS stats: Writing frame log to ", path));
+        writeLogHeader();
+      } else {
+        Logger::warn(str::format("CS stats: Failed to open ", path));
+      }
+    }
+  }
+
+
+  DxvkCsStats::~DxvkCsStats() {
+
+  }
+
+
+  void DxvkCsStats::recordChunk(
+          size_t              commandCount,
+          size_t              dataCommandCount,
+          size_t              usedBytes,
+          size_t              capacity) {
+    m_chunkCount.fetch_add(1, std::memory_order_relaxed);
+    m_commandCount.fetch_add(commandCount, std::memory_order_relaxed);
+    m_dataCommandCount.fetch_add(dataCommandCount, std::memory_order_relaxed);
+    m_chunkBytes.fetch_add(usedBytes, std::memory_order_relaxed);
+
+    m_chunkFill[fillBucket(usedBytes, capacity)].fetch_add(1, std::memory_order_relaxed);
+    m_commandsPerChunk[countBucket(commandCount)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  void DxvkCsStats::recordQueueDepth(
+          size_t              depth) {
+    m_queueDepth[countBucket(depth)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t maxDepth = m_maxQueueDepth.load(std::memory_order_relaxed);
+
+    while (depth > maxDepth && !m_maxQueueDepth.compare_exchange_weak(
+        maxDepth, depth, std::memory_order_relaxed))
+      continue;
+  }
+
+
+  void DxvkCsStats::recordStall(
+          DxvkCsStallReason   reason,
+          uint64_t            ns) {
+    m_stallCount[uint32_t(reason)].fetch_add(1, std::memory_order_relaxed);
+    m_stallNs[uint32_t(reason)].fetch_add(ns, std::memory_order_relaxed);
+  }
+
+
+  void DxvkCsStats::endFrame(
+          uint64_t            frameId) {
+    // Recording threads may race with this, which can
+    // move a sample into the next frame but never lose it
+    DxvkCsFrameStats frame;
+    frame.frameId           = frameId;
+    frame.chunkCount        = m_chunkCount.exchange(0, std::memory_order_relaxed);
+    frame.commandCount      = m_commandCount.exchange(0, std::memory_order_relaxed);
+    frame.dataCommandCount  = m_dataCommandCount.exchange(0, std::memory_order_relaxed);
+    frame.chunkBytes        = m_chunkBytes.exchange(0, std::memory_order_relaxed);
+    frame.maxQueueDepth     = m_maxQueueDepth.exchange(0, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::FillBuckets; i++)
+      frame.chunkFill[i] = m_chunkFill[i].exchange(0, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::CountBuckets; i++) {
+      frame.queueDepth[i]       = m_queueDepth[i].exchange(0, std::memory_order_relaxed);
+      frame.commandsPerChunk[i] = m_commandsPerChunk[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::StallReasons; i++) {
+      frame.stallCount[i] = m_stallCount[i].exchange(0, std::memory_order_relaxed);
+      frame.stallNs[i]    = m_stallNs[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    { std::lock_guard<sync::Spinlock> lock(m_lock);
+      m_lastFrame = frame;
+
+      m_totals.frameId           = frameId;
+      m_totals.chunkCount       += frame.chunkCount;
+      m_totals.commandCount     += frame.commandCount;
+      m_totals.dataCommandCount += frame.dataCommandCount;
+      m_totals.chunkBytes       += frame.chunkBytes;
+      m_totals.maxQueueDepth     = std::max(m_totals.maxQueueDepth, frame.maxQueueDepth);
+
+      for (uint32_t i = 0; i < DxvkCsFrameStats::StallReasons; i++) {
+        m_totals.stallCount[i] += frame.stallCount[i];
+        m_totals.stallNs[i]    += frame.stallNs[i];
+      }
+    }
+
+    // The frame is a local snapshot, so readers of the
+    // last frame never wait for the file to be written
+    if (m_log) {
+      std::lock_guard<dxvk::mutex> lock(m_logMutex);
+      writeLogFrame(frame);
+    }
+  }
+
+
+  DxvkCsFrameStats DxvkCsStats::lastFrame() const {
+    std::lock_guard<sync::Spinlock> lock(m_lock);
+    return m_lastFrame;
+  }
+
+
+  void DxvkCsStats::exportCounters(
+          DxvkStatCounters&   counters) const {
+    std::lock_guard<sync::Spinlock> lock(m_lock);
+
+    const uint32_t resourceWait = uint32_t(DxvkCsStallReason::ResourceWait);
+    const uint32_t futureWait   = uint32_t(DxvkCsStallReason::GeometryFuture);
+
+    counters.setCtr(DxvkStatCounter::CsQueueDepth,         m_lastFrame.maxQueueDepth);
+    counters.setCtr(DxvkStatCounter::CsCommandCount,       m_totals.commandCount);
+    counters.setCtr(DxvkStatCounter::CsChunkBytes,         m_totals.chunkBytes);
+    counters.setCtr(DxvkStatCounter::CsResourceWaitCount,  m_totals.stallCount[resourceWait]);
+    counters.setCtr(DxvkStatCounter::CsResourceWaitTicks,  m_totals.stallNs[resourceWait] / 1000);
+    counters.setCtr(DxvkStatCounter::CsFutureWaitCount,    m_totals.stallCount[futureWait]);
+    counters.setCtr(DxvkStatCounter::CsFutureWaitTicks,    m_totals.stallNs[futureWait] / 1000);
+  }
+
+
+  const char* DxvkCsStats::stallReasonName(
+          DxvkCsStallReason   reason) {
+    switch (reason) {
+      case DxvkCsStallReason::QueueFull:      return "queue_full";
+      case DxvkCsStallReason::Synchronize:    return "synchronize";
+      case DxvkCsStallReason::ResourceWait:   return "resource_wait";
+      case DxvkCsStallReason::GeometryFuture: return "geometry_future";
+      default:                                return "unknown";
+    }
+  }
+
+
+  uint32_t DxvkCsStats::fillBucket(size_t usedBytes, size_t capacity) {
+    return uint32_t(std::min<size_t>(
+      usedBytes * DxvkCsFrameStats::FillBuckets / capacity,
+      DxvkCsFrameStats::FillBuckets - 1));
+  }
+
+
+  uint32_t DxvkCsStats::countBucket(size_t value) {
+    uint32_t bucket = 0;
+
+    while (value != 0 && bucket < DxvkCsFrameStats::CountBuckets - 1) {
+      value >>= 1;
+      bucket += 1;
+    }
+
+    return bucket;
+  }
+
+
+  void DxvkCsStats::writeLogHeader() {
+    // JSON lines are self-describing
+    if (m_logJson)
+      return;
+
+    m_log << "frame,chunks,commands,data_commands,chunk_bytes,max_queue_depth";
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::StallReasons; i++) {
+      const char* name = stallReasonName(DxvkCsStallReason(i));
+      m_log << "," << name << "_count," << name << "_us";
+    }
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::FillBuckets; i++)
+      m_log << ",fill_" << i;
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::CountBuckets; i++)
+      m_log << ",depth_" << i;
+
+    for (uint32_t i = 0; i < DxvkCsFrameStats::CountBuckets; i++)
+      m_log << ",cmds_" << i;
+
+    m_log << "\n";
+  }
+
+
+  void DxvkCsStats::writeLogFrame(const DxvkCsFrameStats& frame) {
+    auto writeArray = [this] (const char* separator, const auto& values) {
+      for (size_t i = 0; i < values.size(); i++)
+        m_log << (i ? "," : separator) << values[i];
+    };
+
+    if (m_logJson) {
+      m_log << "{\"frame\":" << frame.frameId
+            << ",\"chunks\":" << frame.chunkCount
+            << ",\"commands\":" << frame.commandCount
+            << ",\"data_commands\":" << frame.dataCommandCount
+            << ",\"chunk_bytes\":" << frame.chunkBytes
+            << ",\"max_queue_depth\":" << frame.maxQueueDepth
+            << ",\"stalls\":{";
+
+      for (uint32_t i = 0; i < DxvkCsFrameStats::StallReasons; i++) {
+        m_log << (i ? "," : "") << "\"" << stallReasonName(DxvkCsStallReason(i)) << "\":"
+              << "{\"count\":" << frame.stallCount[i]
+              << ",\"us\":" << frame.stallNs[i] / 1000 << "}";
+      }
+
+      m_log << "},\"fill\":";
+      writeArray("[", frame.chunkFill);
+      m_log << "],\"queue_depth\":";
+      writeArray("[", frame.queueDepth);
+      m_log << "],\"commands_per_chunk\":";
+      writeArray("[", frame.commandsPerChunk);
+      m_log << "]}\n";
+    } else {
+      m_log << frame.frameId
+            << "," << frame.chunkCount
+            << "," << frame.commandCount
+            << "," << frame.dataCommandCount
+            << "," << frame.chunkBytes
+            << "," << frame.maxQueueDepth;
+
+      for (uint32_t i = 0; i < DxvkCsFrameStats::StallReasons; i++)
+        m_log << "," << frame.stallCount[i] << "," << frame.stallNs[i] / 1000;
+
+      writeArray(",", frame.chunkFill);
+      writeArray(",", frame.queueDepth);
+      writeArray(",", frame.commandsPerChunk);
+      m_log << "\n";
+    }
+  }
+
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <fstream>
+
+#include "../util/sync/sync_spinlock.h"
+#include "../util/thread.h"
+#include "../util/util_time.h"
+
+#include "dxvk_stats.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Reasons for waiting on the CS pipeline
+   */
+  enum class DxvkCsStallReason : uint32_t {
+    QueueFull,        ///< Dispatch waited for a free CS queue slot
+    Synchronize,      ///< Explicit synchronization with the CS thread
+    ResourceWait,     ///< Map or Lock waited for a resource to become idle
+    GeometryFuture,   ///< CS thread waited for geometry hashing or skinning workers
+
+    Count
+  };
+
+
+  /**
+   * \brief CS statistics for a single frame
+   *
+   * Count histograms use power of two buckets, bucket 0
+   * holds zero and bucket n holds values in [2^(n-1), 2^n),
+   * the last bucket also holds everything larger. Fill
+   * buckets are an eighth of the chunk size each.
+   */
+  struct DxvkCsFrameStats {
+    constexpr static uint32_t FillBuckets  = 8;
+    constexpr static uint32_t CountBuckets = 14;
+    constexpr static uint32_t StallReasons = uint32_t(DxvkCsStallReason::Count);
+
+    uint64_t frameId          = 0;
+    uint64_t chunkCount       = 0;
+    uint64_t commandCount     = 0;
+    uint64_t dataCommandCount = 0;
+    uint64_t chunkBytes       = 0;
+    uint64_t maxQueueDepth    = 0;
+
+    std::array<uint32_t, FillBuckets>  chunkFill        = { };
+    std::array<uint32_t, CountBuckets> queueDepth       = { };
+    std::array<uint32_t, CountBuckets> commandsPerChunk = { };
+
+    std::array<uint64_t, StallReasons> stallCount = { };
+    std::array<uint64_t, StallReasons> stallNs    = { };
+  };
+
+
+  /**
+   * \brief CS instrumentation
+   *
+   * Collects per-frame histograms of chunk fill, queue depth
+   * and commands per chunk, as well as the time spent blocked
+   * per \ref DxvkCsStallReason. Recording is lock-free and may
+   * happen on any thread. Completed frames are exported through
+   * \ref DxvkStatCounters and, if \c DXVK_CS_STATS_LOG is set,
+   * appended to a CSV file, or a JSON lines file if the path
+   * ends in \c .json.
+   */
+  class DxvkCsStats {
+
+  public:
+
+    DxvkCsStats();
+    ~DxvkCsStats();
+
+    DxvkCsStats             (const DxvkCsStats&) = delete;
+    DxvkCsStats& operator = (const DxvkCsStats&) = delete;
+
+    /**
+     * \brief Records a dispatched chunk
+     *
+     * \param [in] commandCount Total number of commands
+     * \param [in] dataCommandCount Commands carrying a data payload
+     * \param [in] usedBytes Bytes used in the chunk
+     * \param [in] capacity Chunk capacity in bytes
+     */
+    void recordChunk(
+            size_t              commandCount,
+            size_t              dataCommandCount,
+            size_t              usedBytes,
+            size_t              capacity);
+
+    /**
+     * \brief Records the CS queue depth after a dispatch
+     * \param [in] depth Number of queued chunks
+     */
+    void recordQueueDepth(
+            size_t              depth);
+
+    /**
+     * \brief Records time spent blocked
+     *
+     * \param [in] reason Why the caller was blocked
+     * \param [in] ns Time spent blocked, in nanoseconds
+     */
+    void recordStall(
+            DxvkCsStallReason   reason,
+            uint64_t            ns);
+
+    /**
+     * \brief Completes the current frame
+     *
+     * Moves all statistics recorded since the last call
+     * into the last frame slot and the running totals,
+     * and writes them to the frame log if enabled.
+     * \param [in] frameId ID of the completed frame
+     */
+    void endFrame(
+            uint64_t            frameId);
+
+    /**
+     * \brief Retrieves the last completed frame
+     * \returns Statistics for the last frame
+     */
+    DxvkCsFrameStats lastFrame() const;
+
+    /**
+     * \brief Writes totals into stat counters
+     * \param [out] counters Counters to update
+     */
+    void exportCounters(
+            DxvkStatCounters&   counters) const;
+
+    /**
+     * \brief Name of a stall reason
+     *
+     * \param [in] reason Stall reason
+     * \returns Short name, as used in the frame log
+     */
+    static const char* stallReasonName(
+            DxvkCsStallReason   reason);
+
+    /**
+     * \brief Count histogram bucket of a value
+     *
+     * \param [in] value Value to classify
+     * \returns Bucket index, see \ref DxvkCsFrameStats
+     */
+    static uint32_t countBucket(
+            size_t              value);
+
+    /**
+     * \brief Fill histogram bucket of a chunk
+     *
+     * \param [in] usedBytes Bytes used in the chunk
+     * \param [in] capacity Chunk capacity in bytes
+     * \returns Bucket index, see \ref DxvkCsFrameStats
+     */
+    static uint32_t fillBucket(
+            size_t              usedBytes,
+            size_t              capacity);
+
+  private:
+
+    using Counter = std::atomic<uint64_t>;
+    using Bucket  = std::atomic<uint32_t>;
+
+    Counter m_chunkCount        = { 0ull };
+    Counter m_commandCount      = { 0ull };
+    Counter m_dataCommandCount  = { 0ull };
+    Counter m_chunkBytes        = { 0ull };
+    Counter m_maxQueueDepth     = { 0ull };
+
+    std::array<Bucket, DxvkCsFrameStats::FillBuckets>  m_chunkFill        = { };
+    std::array<Bucket, DxvkCsFrameStats::CountBuckets> m_queueDepth       = { };
+    std::array<Bucket, DxvkCsFrameStats::CountBuckets> m_commandsPerChunk = { };
+
+    std::array<Counter, DxvkCsFrameStats::StallReasons> m_stallCount = { };
+    std::array<Counter, DxvkCsFrameStats::StallReasons> m_stallNs    = { };
+
+    mutable sync::Spinlock  m_lock;
+    DxvkCsFrameStats        m_lastFrame;
+    DxvkCsFrameStats        m_totals;
+
+    dxvk::mutex             m_logMutex;
+    std::ofstream           m_log;
+    bool                    m_logJson = false;
+
+    void writeLogHeader();
+
+    void writeLogFrame(const DxvkCsFrameStats& frame);
+
+  };
+
+
+  /**
+   * \brief Scoped stall timer
+   *
+   * Records the lifetime of the object as
+   * a stall with the given reason.
+   */
+  class DxvkCsStallScope {
+
+  public:
+
+    DxvkCsStallScope(
+            DxvkCsStats&        stats,
+            DxvkCsStallReason   reason)
+    : m_stats (stats),
+      m_reason(reason),
+      m_start (dxvk::high_resolution_clock::now()) { }
+
+    ~DxvkCsStallScope() {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        dxvk::high_resolution_clock::now() - m_start);
+      m_stats.recordStall(m_reason, ns.count());
+    }
+
+    DxvkCsStallScope             (const DxvkCsStallScope&) = delete;
+    DxvkCsStallScope& operator = (const DxvkCsStallScope&) = delete;
+
+  private:
+
+    DxvkCsStats&                            m_stats;
+    DxvkCsStallReason                       m_reason;
+    dxvk::high_resolution_clock::time_point m_start;
+
+  };
+
+}
@@ -335,6 +335,8 @@ namespace dxvk {
     result.setCtr(DxvkStatCounter::PipeCompilerBusy,  m_objects.pipelineManager().isCompilingShaders());
     result.setCtr(DxvkStatCounter::GpuIdleTicks,      m_submissionQueue.gpuIdleTicks());
 
+    m_csStats.exportCounters(result);
+
     std::lock_guard<sync::Spinlock> lock(m_statLock);
     result.merge(m_statCounters);
     return result;
@@ -412,8 +414,14 @@ namespace dxvk {
   }
 
   void DxvkDevice::incrementPresentCount() {
-    std::lock_guard<sync::Spinlock> statLock(m_statLock);
-    m_statCounters.addCtr(DxvkStatCounter::QueuePresentCount, 1); // Increase getCurrentFrameId()
+    uint64_t frameId;
+
+    { std::lock_guard<sync::Spinlock> statLock(m_statLock);
+      m_statCounters.addCtr(DxvkStatCounter::QueuePresentCount, 1); // Increase getCurrentFrameId()
+      frameId = m_statCounters.getCtr(DxvkStatCounter::QueuePresentCount);
+    }
+
+    m_csStats.endFrame(frameId);
   }
 
   // NV-DXVK start: DLFG integration
@@ -26,6 +26,7 @@
 #include "dxvk_compute.h"
 #include "dxvk_constant_state.h"
 #include "dxvk_context.h"
+#include "dxvk_cs_stats.h"
 #include "dxvk_extensions.h"
 #include "dxvk_framebuffer.h"
 #include "dxvk_image.h"
@@ -448,6 +449,17 @@ namespace dxvk {
       return m_statCounters;
     }
 
+    /**
+     * \brief CS instrumentation
+     *
+     * Per-frame statistics of the CS chunk
+     * pipeline and the reasons it stalled.
+     * \returns Reference to CS stats
+     */
+    DxvkCsStats& csStats() {
+      return m_csStats;
+    }
+
     /**
      * \brief Retrieves memors statistics
      *
@@ -665,6 +677,7 @@ namespace dxvk {
 
     sync::Spinlock              m_statLock;
     DxvkStatCounters            m_statCounters;
+    DxvkCsStats                 m_csStats;
     
     DxvkDeviceQueueSet          m_queues;
     
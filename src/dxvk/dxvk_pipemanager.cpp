@@ -110,6 +110,20 @@ namespace dxvk {
 // NV-DXVK end
   }
 
+
+  void DxvkPipelineManager::notifyGraphicsShadersBound(
+    const DxvkGraphicsPipelineShaders& shaders) {
+    if (m_stateCache != nullptr)
+      m_stateCache->notifyGraphicsShadersBound(shaders);
+  }
+
+
+  void DxvkPipelineManager::notifyComputeShadersBound(
+    const DxvkComputePipelineShaders& shaders) {
+    if (m_stateCache != nullptr)
+      m_stateCache->notifyComputeShadersBound(shaders);
+  }
+
   // NV-DXVK start: compile raytracing shaders on shader compilation threads
   namespace WAR4000939 {
     extern bool shouldApply(const Rc<DxvkDevice>& device);
@@ -114,6 +114,23 @@ namespace dxvk {
       bool                          isRemixShader = false);
 // NV-DXVK end
 
+    /**
+     * \brief Notifies the state cache of bound graphics shaders
+     *
+     * Lets the state cache prioritize compiling pipelines
+     * for shaders that the application is actually using.
+     * \param [in] shaders Shaders bound by a context
+     */
+    void notifyGraphicsShadersBound(
+      const DxvkGraphicsPipelineShaders& shaders);
+
+    /**
+     * \brief Notifies the state cache of a bound compute shader
+     * \param [in] shaders Shaders bound by a context
+     */
+    void notifyComputeShadersBound(
+      const DxvkComputePipelineShaders& shaders);
+
     // NV-DXVK start: compile raytracing shaders on shader compilation threads
     /**
      * \brief Registers a set of raytracing shaders
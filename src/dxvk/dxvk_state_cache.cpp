@@ -23,21 +23,14 @@
 #include "dxvk_pipemanager.h"
 #include "dxvk_state_cache.h"
 
+#include "../util/util_mapped_file.h"
+
 namespace dxvk {
 
   static const Sha1Hash       g_nullHash      = Sha1Hash::compute(nullptr, 0);
   static const DxvkShaderKey  g_nullShaderKey = DxvkShaderKey();
 
 
-  /**
-   * \brief Packed entry header
-   */
-  struct DxvkStateCacheEntryHeader {
-    uint32_t stageMask : 8;
-    uint32_t entrySize : 24;
-  };
-
-  
   /**
    * \brief State cache entry data
    *
@@ -56,8 +49,8 @@ namespace dxvk {
       return m_data;
     }
 
-    Sha1Hash computeHash() const {
-      return Sha1Hash::compute(m_data, m_size);
+    DxvkStateCacheChecksum computeChecksum() const {
+      return XXH3_128bits(m_data, m_size);
     }
 
     template<typename T>
@@ -103,12 +96,11 @@ namespace dxvk {
       return true;
     }
 
-    bool readFromStream(std::istream& stream, size_t size) {
+    bool readFromMemory(const char* data, size_t size) {
       if (size > MaxSize)
         return false;
 
-      if (!stream.read(m_data, size))
-        return false;
+      std::memcpy(m_data, data, size);
 
       m_size = size;
       m_read = 0;
@@ -135,13 +127,9 @@ namespace dxvk {
 
 
   template<typename T>
-  bool readCacheEntryTyped(std::istream& stream, T& entry) {
-    auto data = reinterpret_cast<char*>(&entry);
-    auto size = sizeof(entry);
+  bool readCacheEntryTyped(const char* data, T& entry) {
+    std::memcpy(&entry, data, sizeof(entry));
 
-    if (!stream.read(data, size))
-      return false;
-    
     Sha1Hash expectedHash = std::exchange(entry.hash, g_nullHash);
     Sha1Hash computedHash = Sha1Hash::compute(entry);
     return expectedHash == computedHash;
@@ -202,10 +190,17 @@ namespace dxvk {
 
       // Write all valid entries to the cache file in
       // case we're recovering a corrupted cache file
-      for (auto& e : m_entries)
-        writeCacheEntry(file, e);
+      for (size_t i = 0; i < m_entries.size(); i++)
+        writeCacheEntry(file, m_entries[i], m_entryUsage[i]);
     }
 
+    // Anything past this offset gets appended in this session
+    std::error_code ec;
+    m_entriesFileSize = size_t(std::filesystem::file_size(getCacheFileName(), ec));
+
+    if (ec)
+      m_entriesFileSize = 0;
+
     // Use half the available CPU cores for pipeline compilation
     uint32_t numCpuCores = dxvk::thread::hardware_concurrency();
     uint32_t numWorkers  = ((std::max(1u, numCpuCores) - 1) * 5) / 7;
@@ -320,20 +315,11 @@ namespace dxvk {
     // Deferred lock, don't stall workers unless we have to
     std::unique_lock<dxvk::mutex> workerLock;
 
-    const auto addWorkerItem = [&, this](const WorkerItem& item) {
+    const auto addWorkerItem = [&, this](const WorkerItem& item, const DxvkStateCacheKey* key) {
       if (!workerLock)
         workerLock = std::unique_lock<dxvk::mutex>(m_workerLock);
 
-      // NV-DXVK start: do not compile same shader multiple times
-      if (m_workerItemsInFlight.count(item.hash()) == 0) {
-        if (item.isRemixShader) {
-          ++m_workerCompilingRemixShaders;
-        }
-
-        m_workerQueue.push(item);
-        m_workerItemsInFlight.insert(item.hash());
-      }
-      // NV-DXVK end
+      enqueueWorkerItem(item, key);
     };
 
     // Add a worker item for either the shader or entire set of shaders in a pipeline associated with the shader
@@ -347,7 +333,7 @@ namespace dxvk {
         item.cp.forceNoSpecConstants = true;
         item.isRemixShader = true;
 
-        addWorkerItem(item);
+        addWorkerItem(item, nullptr);
     } else {
       auto pipelines = m_pipelineMap.equal_range(key);
 
@@ -364,7 +350,7 @@ namespace dxvk {
 
         item.isRemixShader = isRemixShader;
 
-        addWorkerItem(item);
+        addWorkerItem(item, &p->second);
       }
     }
 
@@ -384,18 +370,170 @@ namespace dxvk {
 
     std::unique_lock<dxvk::mutex> workerLock(m_workerLock);
 
-    // Do not compile same shader multiple times
-    if (m_workerItemsInFlight.count(item.hash()) == 0) {
-      assert(item.isRemixShader);
+    assert(item.isRemixShader);
+    enqueueWorkerItem(item, nullptr);
+    m_workerCond.notify_all();
+  }
+  // NV-DXVK end
+
+
+  void DxvkStateCache::notifyGraphicsShadersBound(
+    const DxvkGraphicsPipelineShaders&    shaders) {
+    if (shaders.vs == nullptr)
+      return;
+
+    DxvkStateCacheKey key;
+    key.vs  = getShaderKey(shaders.vs);
+    key.tcs = getShaderKey(shaders.tcs);
+    key.tes = getShaderKey(shaders.tes);
+    key.gs  = getShaderKey(shaders.gs);
+    key.fs  = getShaderKey(shaders.fs);
+
+    // Matches the hash of the corresponding worker item
+    notifyShadersBound(key, shaders.hash());
+  }
+
+
+  void DxvkStateCache::notifyComputeShadersBound(
+    const DxvkComputePipelineShaders&     shaders) {
+    if (shaders.cs == nullptr)
+      return;
+
+    DxvkStateCacheKey key;
+    key.cs = getShaderKey(shaders.cs);
+
+    notifyShadersBound(key, shaders.hash());
+  }
+
+
+  void DxvkStateCache::notifyShadersBound(
+    const DxvkStateCacheKey&              key,
+          size_t                          itemHash) {
+    std::lock_guard<dxvk::mutex> lock(m_workerLock);
+
+    if (!m_workerBoundItems.insert(itemHash).second)
+      return;
+
+    // Update usage data of all known pipelines for these
+    // shaders, it gets written back when the cache is closed
+    auto entries = m_entryMap.equal_range(key);
+
+    for (auto e = entries.first; e != entries.second; e++) {
+      DxvkStateCacheUsage& usage = m_entryUsage[e->second];
+
+      if (usage.lastSession != m_session) {
+        usage.lastSession   = m_session;
+        usage.sessionCount += 1;
+
+        m_usageChanged = true;
+      }
+    }
+
+    // If the pipelines are still waiting to be compiled, move them
+    // up. Raising the priority of a heap element only requires
+    // sifting it up, which push_heap does on the prefix ending
+    // with that element.
+    if (!m_workerItemsInFlight.count(itemHash))
+      return;
+
+    for (size_t i = 0; i < m_workerQueue.size(); i++) {
+      if (m_workerQueue[i].hash == itemHash) {
+        m_workerQueue[i].order.priority |= DxvkStateCacheQueueOrder::PriorityBound;
+        std::push_heap(m_workerQueue.begin(), m_workerQueue.begin() + i + 1);
+        break;
+      }
+    }
+  }
+
+
+  void DxvkStateCache::enqueueWorkerItem(
+    const WorkerItem&                     item,
+    const DxvkStateCacheKey*              key) {
+    size_t hash = item.hash();
+
+    // NV-DXVK start: do not compile same shader multiple times
+    if (!m_workerItemsInFlight.insert(hash).second)
+      return;
+    // NV-DXVK end
+
+    // NV-DXVK start
+    if (item.isRemixShader)
       ++m_workerCompilingRemixShaders;
+    // NV-DXVK end
 
-      m_workerQueue.push(item);
-      m_workerItemsInFlight.insert(item.hash());
+    WorkerQueueEntry entry;
+    entry.order.priority = key ? getUsagePriority(*key) : 0;
+    entry.order.sequence = m_workerSequence++;
+    entry.hash = hash;
+    entry.item = item;
 
-      m_workerCond.notify_all();
+    if (item.isRemixShader)
+      entry.order.priority |= DxvkStateCacheQueueOrder::PriorityRemix;
+
+    if (m_workerBoundItems.count(hash))
+      entry.order.priority |= DxvkStateCacheQueueOrder::PriorityBound;
+
+    m_workerQueue.push_back(std::move(entry));
+    std::push_heap(m_workerQueue.begin(), m_workerQueue.end());
+  }
+
+
+  uint64_t DxvkStateCache::getUsagePriority(
+    const DxvkStateCacheKey&              key) const {
+    uint64_t priority = 0;
+
+    auto entries = m_entryMap.equal_range(key);
+
+    for (auto e = entries.first; e != entries.second; e++)
+      priority = std::max(priority, getUsageWeight(m_entryUsage[e->second], m_session));
+
+    return priority;
+  }
+
+
+  uint64_t DxvkStateCache::getUsageWeight(
+    const DxvkStateCacheUsage&            usage,
+          uint32_t                        session) {
+    // Weigh pipelines by the number of sessions they were used in,
+    // and halve that for every session since they were last used.
+    if (!usage.sessionCount)
+      return 0;
+
+    uint32_t age = std::min(session - std::min(usage.lastSession, session), 31u);
+    return (uint64_t(std::min(usage.sessionCount, 0xffffu)) << 16) >> age;
+  }
+
+
+  bool DxvkStateCache::isUsageOrderChanged(
+    const std::vector<DxvkStateCacheUsage>& oldUsage,
+    const std::vector<DxvkStateCacheUsage>& newUsage,
+          uint32_t                        session) {
+    if (oldUsage.size() != newUsage.size())
+      return true;
+
+    std::vector<std::pair<uint64_t, uint64_t>> weights(oldUsage.size());
+
+    for (size_t i = 0; i < weights.size(); i++) {
+      weights[i] = std::make_pair(
+        getUsageWeight(oldUsage[i], session),
+        getUsageWeight(newUsage[i], session));
+    }
+
+    // Sorted by old weight, the new weights must be strictly increasing
+    // between distinct old weights and equal among equal old weights
+    std::sort(weights.begin(), weights.end());
+
+    for (size_t i = 1; i < weights.size(); i++) {
+      bool orderChanged = weights[i - 1].first == weights[i].first
+        ? weights[i - 1].second != weights[i].second
+        : weights[i - 1].second >= weights[i].second;
+
+      if (orderChanged)
+        return true;
     }
+
+    return false;
   }
-  // NV-DXVK end
 
   void DxvkStateCache::stopWorkerThreads() {
     { std::lock_guard<dxvk::mutex> workerLock(m_workerLock);
@@ -412,6 +550,14 @@ namespace dxvk {
       worker.join();
     
     m_writerThread.join();
+
+    // Bound shaders may still be reported after this point
+    std::lock_guard<dxvk::mutex> workerLock(m_workerLock);
+
+    // Weights are compared for the next session, which is
+    // the first one to compile pipelines based on them
+    if (m_usageChanged && isUsageOrderChanged(m_fileUsage, m_entryUsage, m_session + 1))
+      rewriteCacheFile();
   }
 
 
@@ -506,20 +652,83 @@ namespace dxvk {
 
 
   bool DxvkStateCache::readCacheFile() {
-    // Open state file and just fail if it doesn't exist
-    std::ifstream ifile(getCacheFileName().c_str(), std::ios_base::binary);
+    // Map state file and just fail if it doesn't exist
+    MappedFile file;
 
-    if (!ifile) {
+    if (!file.open(getCacheFileName())) {
       Logger::warn("DXVK: No state cache file found");
       return false;
     }
 
+    auto t0 = dxvk::high_resolution_clock::now();
+
+    DxvkStateCacheFileData fileData;
+
+    if (!parseCacheData(file.data(), file.size(), 0, fileData))
+      return false;
+
+    // The file may get rewritten below, don't keep it mapped
+    file.close();
+
+    // Notify user about format conversion
+    DxvkStateCacheHeader newHeader;
+
+    if (fileData.version != newHeader.version)
+      Logger::warn(str::format("DXVK: Updating state cache version to v", newHeader.version));
+
+    // Register all entries at once so that the
+    // lookup tables only need to grow one time
+    m_entries = std::move(fileData.entries);
+    m_entryUsage = std::move(fileData.usage);
+    m_fileUsage = m_entryUsage;
+    m_entryMap.reserve(m_entries.size());
+    m_pipelineMap.reserve(m_entries.size());
+
+    for (size_t i = 0; i < m_entries.size(); i++) {
+      const DxvkStateCacheKey& shaders = m_entries[i].shaders;
+
+      mapPipelineToEntry(shaders, i);
+
+      mapShaderToPipeline(shaders.vs,  shaders);
+      mapShaderToPipeline(shaders.tcs, shaders);
+      mapShaderToPipeline(shaders.tes, shaders);
+      mapShaderToPipeline(shaders.gs,  shaders);
+      mapShaderToPipeline(shaders.fs,  shaders);
+      mapShaderToPipeline(shaders.cs,  shaders);
+
+      m_session = std::max(m_session, m_entryUsage[i].lastSession + 1);
+    }
+
+    auto t1 = dxvk::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
+
+    Logger::info(str::format(
+      "DXVK: Read ", m_entries.size(),
+      " valid state cache entries in ", ms.count(), " ms"));
+
+    if (fileData.numInvalidEntries) {
+      Logger::warn(str::format(
+        "DXVK: Skipped ", fileData.numInvalidEntries,
+        " invalid state cache entries"));
+      return false;
+    }
+    
+    // Rewrite entire state cache if it is outdated
+    return fileData.version == newHeader.version;
+  }
+
+
+  bool DxvkStateCache::parseCacheData(
+    const char*                     data,
+          size_t                    size,
+          uint32_t                  numThreads,
+          DxvkStateCacheFileData&   file) {
     // The header stores the state cache version,
     // we need to regenerate it if it's outdated
     DxvkStateCacheHeader newHeader;
     DxvkStateCacheHeader curHeader;
 
-    if (!readCacheHeader(ifile, curHeader)) {
+    if (!readCacheHeader(data, size, curHeader)) {
       Logger::warn("DXVK: Failed to read state cache header");
       return false;
     }
@@ -547,61 +756,110 @@ namespace dxvk {
       return false;
     }
 
-    // Notify user about format conversion
-    if (curHeader.version != newHeader.version)
-      Logger::warn(str::format("DXVK: Updating state cache version to v", newHeader.version));
+    // Find the entry boundaries first. This only needs to look at
+    // the entry headers, so it is cheap compared to validating the
+    // checksums, which can then happen in parallel. A truncated
+    // entry at the end of the file is ignored.
+    struct EntryRange {
+      size_t offset;
+      size_t size;
+    };
 
-    // Read actual cache entries from the file.
-    // If we encounter invalid entries, we should
-    // regenerate the entire state cache file.
-    uint32_t numInvalidEntries = 0;
+    std::vector<EntryRange> ranges;
+    size_t offset = sizeof(curHeader);
 
-    while (ifile) {
-      DxvkStateCacheEntry entry;
+    if (curHeader.version < 8) {
+      ranges.reserve((size - offset) / expectedSize);
+
+      for ( ; offset + expectedSize <= size; offset += expectedSize)
+        ranges.push_back({ offset, expectedSize });
+    } else {
+      size_t checksumSize = curHeader.version < 13
+        ? sizeof(Sha1Hash)
+        : sizeof(DxvkStateCacheChecksum);
+
+      while (offset + sizeof(DxvkStateCacheEntryHeader) + checksumSize <= size) {
+        DxvkStateCacheEntryHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
 
-      if (readCacheEntry(curHeader.version, ifile, entry)) {
-        size_t entryId = m_entries.size();
-        m_entries.push_back(entry);
+        size_t entrySize = sizeof(header) + checksumSize + header.entrySize;
 
-        mapPipelineToEntry(entry.shaders, entryId);
+        if (offset + entrySize > size)
+          break;
 
-        mapShaderToPipeline(entry.shaders.vs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.tcs, entry.shaders);
-        mapShaderToPipeline(entry.shaders.tes, entry.shaders);
-        mapShaderToPipeline(entry.shaders.gs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.fs,  entry.shaders);
-        mapShaderToPipeline(entry.shaders.cs,  entry.shaders);
-      } else if (ifile) {
-        numInvalidEntries += 1;
+        ranges.push_back({ offset, entrySize });
+        offset += entrySize;
       }
     }
 
-    Logger::info(str::format(
-      "DXVK: Read ", m_entries.size(),
-      " valid state cache entries"));
+    // Read entries in contiguous batches, one per thread
+    constexpr size_t MinEntriesPerThread = 256;
 
-    if (numInvalidEntries) {
-      Logger::warn(str::format(
-        "DXVK: Skipped ", numInvalidEntries,
-        " invalid state cache entries"));
-      return false;
+    if (!numThreads)
+      numThreads = dxvk::thread::hardware_concurrency();
+
+    numThreads = uint32_t(std::clamp<size_t>(ranges.size() / MinEntriesPerThread, 1, std::max(numThreads, 1u)));
+
+    std::vector<DxvkStateCacheEntry> entries(ranges.size());
+    std::vector<DxvkStateCacheUsage> usage(ranges.size());
+    std::vector<uint8_t> valid(ranges.size());
+
+    auto readBatch = [&] (size_t batch) {
+      size_t begin = ranges.size() * batch / numThreads;
+      size_t end   = ranges.size() * (batch + 1) / numThreads;
+
+      for (size_t i = begin; i < end; i++) {
+        valid[i] = readCacheEntry(curHeader.version,
+          data + ranges[i].offset, ranges[i].size, entries[i], usage[i]);
+      }
+    };
+
+    std::vector<dxvk::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    for (uint32_t i = 1; i < numThreads; i++)
+      threads.emplace_back([&readBatch, i] { readBatch(i); });
+
+    readBatch(0);
+
+    for (auto& thread : threads)
+      thread.join();
+
+    // Drop invalid entries, keeping the file order
+    size_t numValid = 0;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (valid[i]) {
+        if (numValid != i) {
+          entries[numValid] = std::move(entries[i]);
+          usage[numValid] = usage[i];
+        }
+
+        numValid += 1;
+      }
     }
-    
-    // Rewrite entire state cache if it is outdated
-    return curHeader.version == newHeader.version;
+
+    entries.resize(numValid);
+    usage.resize(numValid);
+
+    file.version = curHeader.version;
+    file.numInvalidEntries = uint32_t(ranges.size() - numValid);
+    file.entries = std::move(entries);
+    file.usage = std::move(usage);
+    return true;
   }
 
 
   bool DxvkStateCache::readCacheHeader(
-          std::istream&             stream,
-          DxvkStateCacheHeader&     header) const {
+    const char*                     data,
+          size_t                    size,
+          DxvkStateCacheHeader&     header) {
     DxvkStateCacheHeader expected;
 
-    auto data = reinterpret_cast<char*>(&header);
-    auto size = sizeof(header);
-
-    if (!stream.read(data, size))
+    if (size < sizeof(header))
       return false;
+
+    std::memcpy(&header, data, sizeof(header));
     
     for (uint32_t i = 0; i < 4; i++) {
       if (expected.magic[i] != header.magic[i])
@@ -614,15 +872,15 @@ namespace dxvk {
 
   bool DxvkStateCache::readCacheEntryV7(
           uint32_t                  version,
-          std::istream&             stream, 
-          DxvkStateCacheEntry&      entry) const {
+    const char*                     data,
+          DxvkStateCacheEntry&      entry) {
     if (version <= 6) {
       DxvkStateCacheEntryV6 v6;
 
       if (version <= 4) {
         DxvkStateCacheEntryV4 v4;
 
-        if (!readCacheEntryTyped(stream, v4))
+        if (!readCacheEntryTyped(data, v4))
           return false;
 
         if (version == 2)
@@ -633,42 +891,59 @@ namespace dxvk {
       } else if (version <= 5) {
         DxvkStateCacheEntryV5 v5;
 
-        if (!readCacheEntryTyped(stream, v5))
+        if (!readCacheEntryTyped(data, v5))
           return false;
 
         if (!convertEntryV5(v5, v6))
           return false;
       } else {
-        if (!readCacheEntryTyped(stream, v6))
+        if (!readCacheEntryTyped(data, v6))
           return false;
       }
 
       return convertEntryV6(v6, entry);
     } else {
-      return readCacheEntryTyped(stream, entry);
+      return readCacheEntryTyped(data, entry);
     }
   }
 
 
   bool DxvkStateCache::readCacheEntry(
           uint32_t                  version,
-          std::istream&             stream, 
-          DxvkStateCacheEntry&      entry) const {
+    const char*                     bytes,
+          size_t                    size,
+          DxvkStateCacheEntry&      entry,
+          DxvkStateCacheUsage&      usage) {
     if (version < 8)
-      return readCacheEntryV7(version, stream, entry);
+      return readCacheEntryV7(version, bytes, entry);
 
-    // Read entry metadata and actual data
+    // General layout: header -> checksum -> data
     DxvkStateCacheEntryHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    const char* checksum = bytes + sizeof(header);
+    size_t checksumSize = size - sizeof(header) - header.entrySize;
+
+    const char* entryData = checksum + checksumSize;
+
+    // Validate checksum, skip entry if invalid
+    if (version < 13) {
+      Sha1Hash expected;
+      std::memcpy(&expected, checksum, sizeof(expected));
+
+      if (expected != Sha1Hash::compute(entryData, header.entrySize))
+        return false;
+    } else {
+      DxvkStateCacheChecksum expected;
+      std::memcpy(&expected, checksum, sizeof(expected));
+
+      if (!XXH128_isEqual(expected, XXH3_128bits(entryData, header.entrySize)))
+        return false;
+    }
+
     DxvkStateCacheEntryData data;
-    Sha1Hash hash;
-  
-    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))
-     || !stream.read(reinterpret_cast<char*>(&hash), sizeof(hash))
-     || !data.readFromStream(stream, header.entrySize))
-      return false;
 
-    // Validate hash, skip entry if invalid
-    if (hash != data.computeHash())
+    if (!data.readFromMemory(entryData, header.entrySize))
       return false;
 
     // Read shader hashes
@@ -770,13 +1045,21 @@ namespace dxvk {
       }
     }
 
+    // Read usage data
+    if (version >= 14) {
+      if (!data.read(usage.lastSession, version)
+       || !data.read(usage.sessionCount, version))
+        return false;
+    }
+
     return true;
   }
 
 
   void DxvkStateCache::writeCacheEntry(
           std::ostream&             stream, 
-          DxvkStateCacheEntry&      entry) const {
+          DxvkStateCacheEntry&      entry,
+    const DxvkStateCacheUsage&      usage) {
     DxvkStateCacheEntryData data;
     VkShaderStageFlags stageMask = 0;
 
@@ -847,22 +1130,26 @@ namespace dxvk {
         data.write(sc.specConstants[i]);
     }
 
-    // General layout: header -> hash -> data
+    // Write out usage data
+    data.write(usage.lastSession);
+    data.write(usage.sessionCount);
+
+    // General layout: header -> checksum -> data
     DxvkStateCacheEntryHeader header;
     header.stageMask = uint8_t(stageMask);
     header.entrySize = data.size();
 
-    Sha1Hash hash = data.computeHash();
+    DxvkStateCacheChecksum checksum = data.computeChecksum();
 
     stream.write(reinterpret_cast<char*>(&header), sizeof(header));
-    stream.write(reinterpret_cast<char*>(&hash), sizeof(hash));
+    stream.write(reinterpret_cast<char*>(&checksum), sizeof(checksum));
     stream.write(data.data(), data.size());
     stream.flush();
   }
 
 
   bool DxvkStateCache::convertEntryV2(
-          DxvkStateCacheEntryV4&    entry) const {
+          DxvkStateCacheEntryV4&    entry) {
     // Semantics changed:
     // v2: rsDepthClampEnable
     // v3: rsDepthClipEnable
@@ -877,7 +1164,7 @@ namespace dxvk {
 
   bool DxvkStateCache::convertEntryV4(
     const DxvkStateCacheEntryV4&    in,
-          DxvkStateCacheEntryV6&    out) const {
+          DxvkStateCacheEntryV6&    out) {
     out.shaders = in.shaders;
     out.format  = in.format;
     out.hash    = in.hash;
@@ -933,7 +1220,7 @@ namespace dxvk {
 
   bool DxvkStateCache::convertEntryV5(
     const DxvkStateCacheEntryV5&    in,
-          DxvkStateCacheEntryV6&    out) const {
+          DxvkStateCacheEntryV6&    out) {
     out.shaders = in.shaders;
     out.gpState = in.gpState;
     out.format  = in.format;
@@ -946,7 +1233,7 @@ namespace dxvk {
 
   bool DxvkStateCache::convertEntryV6(
     const DxvkStateCacheEntryV6&    in,
-          DxvkStateCacheEntry&      out) const {
+          DxvkStateCacheEntry&      out) {
     out.shaders = in.shaders;
     out.format  = in.format;
     out.hash    = in.hash;
@@ -1062,8 +1349,9 @@ namespace dxvk {
         if (m_workerQueue.empty())
           break;
         
-        item = m_workerQueue.front();
-        m_workerQueue.pop();
+        std::pop_heap(m_workerQueue.begin(), m_workerQueue.end());
+        item = std::move(m_workerQueue.back().item);
+        m_workerQueue.pop_back();
       }
 
       compilePipelines(item);
@@ -1112,11 +1400,75 @@ namespace dxvk {
           std::ios_base::app);
       }
 
-      writeCacheEntry(file, entry);
+      // New entries are used in the current session by definition
+      DxvkStateCacheUsage usage;
+      usage.lastSession  = m_session;
+      usage.sessionCount = 1;
+
+      writeCacheEntry(file, entry, usage);
     }
   }
 
 
+  void DxvkStateCache::rewriteCacheFile() {
+    // Entries are only ever appended to the cache file, so
+    // updated usage data requires writing a new file. Write
+    // to a temporary file first so that a failure can not
+    // corrupt the existing cache.
+    if (!m_entriesFileSize)
+      return;
+
+    std::filesystem::path fileName = getCacheFileName();
+    std::filesystem::path tempName = fileName;
+    tempName += L".tmp";
+
+    auto t0 = dxvk::high_resolution_clock::now();
+    bool success = false;
+
+    { std::ofstream file(tempName,
+        std::ios_base::binary |
+        std::ios_base::trunc);
+
+      DxvkStateCacheHeader header;
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      for (size_t i = 0; i < m_entries.size(); i++)
+        writeCacheEntry(file, m_entries[i], m_entryUsage[i]);
+
+      // Entries added in this session were appended to the old
+      // file with their usage data already, copy them verbatim
+      std::ifstream oldFile(fileName, std::ios_base::binary);
+      oldFile.seekg(std::streamoff(m_entriesFileSize));
+
+      if (oldFile && oldFile.peek() != std::ifstream::traits_type::eof())
+        file << oldFile.rdbuf();
+
+      success = bool(oldFile) && bool(file);
+    }
+
+    std::error_code ec;
+
+    if (!success) {
+      Logger::warn("DXVK: Failed to write state cache usage data");
+      std::filesystem::remove(tempName, ec);
+      return;
+    }
+
+    std::filesystem::rename(tempName, fileName, ec);
+
+    if (ec) {
+      Logger::warn(str::format("DXVK: Failed to replace state cache file: ", ec.message()));
+      std::filesystem::remove(tempName, ec);
+      return;
+    }
+
+    auto t1 = dxvk::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
+
+    Logger::info(str::format("DXVK: Updated state cache usage data in ", ms.count(), " ms"));
+  }
+
+
   std::wstring DxvkStateCache::getCacheFileName() const {
     std::string path = getCacheDir();
 
@@ -38,6 +38,41 @@ namespace dxvk {
 
   class DxvkDevice;
 
+
+  /**
+   * \brief Contents of a state cache file
+   */
+  struct DxvkStateCacheFileData {
+    uint32_t                          version           = 0;
+    uint32_t                          numInvalidEntries = 0;
+    std::vector<DxvkStateCacheEntry>  entries;
+    std::vector<DxvkStateCacheUsage>  usage;
+  };
+
+  /**
+   * \brief Compile order of a state cache worker item
+   *
+   * Remix shaders go first since nothing can be rendered
+   * without them, then pipelines the application has bound
+   * in this session, then everything else ordered by how
+   * often and how recently it was used in past sessions.
+   * Items of equal priority are compiled in queue order,
+   * the item to compile next is the largest one.
+   */
+  struct DxvkStateCacheQueueOrder {
+    constexpr static uint64_t PriorityRemix = 1ull << 63;
+    constexpr static uint64_t PriorityBound = 1ull << 62;
+
+    uint64_t priority = 0;
+    uint64_t sequence = 0;
+
+    bool operator < (const DxvkStateCacheQueueOrder& other) const {
+      if (priority != other.priority)
+        return priority < other.priority;
+      return sequence > other.sequence;
+    }
+  };
+
   /**
    * \brief State cache
    * 
@@ -98,6 +133,25 @@ namespace dxvk {
       bool                                  isRemixShader = false);
 // NV-DXVK end
 
+    /**
+     * \brief Notifies the cache of bound graphics shaders
+     *
+     * Marks all cached pipelines for the given shaders
+     * as used in the current session, and moves them
+     * ahead of other pipelines in the compile queue.
+     * \param [in] shaders Shaders bound by a context
+     */
+    void notifyGraphicsShadersBound(
+      const DxvkGraphicsPipelineShaders&    shaders);
+
+    /**
+     * \brief Notifies the cache of a bound compute shader
+     *
+     * \param [in] shaders Shaders bound by a context
+     */
+    void notifyComputeShadersBound(
+      const DxvkComputePipelineShaders&     shaders);
+
     // NV-DXVK start: compile raytracing shaders on shader compilation threads
     /**
      * \brief Registers a set of raytracing shaders
@@ -130,6 +184,68 @@ namespace dxvk {
     }
 // NV-DXVK end
 
+    /**
+     * \brief Parses a state cache file image
+     *
+     * Validates and decodes all entries of a cache file that
+     * has been loaded or mapped into memory, spread across
+     * several threads. Valid entries keep their file order.
+     * \param [in] data File contents
+     * \param [in] size File size, in bytes
+     * \param [in] numThreads Maximum number of threads to
+     *    use, or 0 to pick a number based on the entry count
+     * \param [out] file Version and entries of the file
+     * \returns \c false if the header is invalid or the
+     *    version is not supported
+     */
+    static bool parseCacheData(
+      const char*                     data,
+            size_t                    size,
+            uint32_t                  numThreads,
+            DxvkStateCacheFileData&   file);
+
+    /**
+     * \brief Writes an entry in the current format
+     *
+     * \param [in] stream Output stream
+     * \param [in] entry The entry to write
+     * \param [in] usage Usage data of the entry
+     */
+    static void writeCacheEntry(
+            std::ostream&             stream, 
+            DxvkStateCacheEntry&      entry,
+      const DxvkStateCacheUsage&      usage = DxvkStateCacheUsage());
+
+    /**
+     * \brief Computes the usage weight of an entry
+     *
+     * The number of sessions the pipeline was used in,
+     * halved for every session since it was last used.
+     * \param [in] usage Usage data of the entry
+     * \param [in] session Current session
+     * \returns Weight, higher compiles earlier
+     */
+    static uint64_t getUsageWeight(
+      const DxvkStateCacheUsage&      usage,
+            uint32_t                  session);
+
+    /**
+     * \brief Checks whether new usage data reorders entries
+     *
+     * Usage data only affects the compile order, so the
+     * cache file only needs to be rewritten if the order
+     * by usage weight differs between the two data sets.
+     * \param [in] oldUsage Usage data stored in the file
+     * \param [in] newUsage Updated usage data
+     * \param [in] session Session to compute weights for
+     * \returns \c true if any two entries change order
+     */
+    static bool isUsageOrderChanged(
+      const std::vector<DxvkStateCacheUsage>& oldUsage,
+      const std::vector<DxvkStateCacheUsage>& newUsage,
+            uint32_t                  session);
+
+
   private:
 
     using WriterItem = DxvkStateCacheEntry;
@@ -157,10 +273,27 @@ namespace dxvk {
       // NV-DXVK end
     };
 
+    struct WorkerQueueEntry {
+      DxvkStateCacheQueueOrder  order;
+      size_t                    hash;
+      WorkerItem                item;
+
+      bool operator < (const WorkerQueueEntry& other) const {
+        return order < other.order;
+      }
+    };
+
     DxvkPipelineManager*              m_pipeManager;
     DxvkRenderPassPool*               m_passManager;
 
     std::vector<DxvkStateCacheEntry>  m_entries;
+    std::vector<DxvkStateCacheUsage>  m_entryUsage;
+    // Usage data of m_entries as stored in the file, and the
+    // file size before this session appended new entries
+    std::vector<DxvkStateCacheUsage>  m_fileUsage;
+    size_t                            m_entriesFileSize = 0;
+    uint32_t                          m_session = 1;
+    bool                              m_usageChanged = false;
     std::atomic<bool>                 m_stopThreads = { false };
 
     dxvk::mutex                       m_entryLock;
@@ -179,7 +312,9 @@ namespace dxvk {
 
     dxvk::mutex                       m_workerLock;
     dxvk::condition_variable          m_workerCond;
-    std::queue<WorkerItem>            m_workerQueue;
+    std::vector<WorkerQueueEntry>     m_workerQueue;  // binary max-heap
+    uint64_t                          m_workerSequence = 0;
+    std::unordered_set<size_t>        m_workerBoundItems;
     // NV-DXVK start: do not compile same shader multiple times
     std::unordered_set<size_t>        m_workerItemsInFlight;  // stores hashes for work items in the queue
     // NV-DXVK end
@@ -212,40 +347,52 @@ namespace dxvk {
     void compilePipelines(
       const WorkerItem&               item);
 
+    void enqueueWorkerItem(
+      const WorkerItem&               item,
+      const DxvkStateCacheKey*        key);
+
+    void notifyShadersBound(
+      const DxvkStateCacheKey&        key,
+            size_t                    itemHash);
+
+    uint64_t getUsagePriority(
+      const DxvkStateCacheKey&        key) const;
+
+    void rewriteCacheFile();
+
     bool readCacheFile();
 
-    bool readCacheHeader(
-            std::istream&             stream,
-            DxvkStateCacheHeader&     header) const;
+    static bool readCacheHeader(
+      const char*                     data,
+            size_t                    size,
+            DxvkStateCacheHeader&     header);
 
-    bool readCacheEntryV7(
+    static bool readCacheEntryV7(
             uint32_t                  version,
-            std::istream&             stream, 
-            DxvkStateCacheEntry&      entry) const;
+      const char*                     data,
+            DxvkStateCacheEntry&      entry);
     
-    bool readCacheEntry(
+    static bool readCacheEntry(
             uint32_t                  version,
-            std::istream&             stream, 
-            DxvkStateCacheEntry&      entry) const;
-    
-    void writeCacheEntry(
-            std::ostream&             stream, 
-            DxvkStateCacheEntry&      entry) const;
+      const char*                     bytes,
+            size_t                    size,
+            DxvkStateCacheEntry&      entry,
+            DxvkStateCacheUsage&      usage);
     
-    bool convertEntryV2(
-            DxvkStateCacheEntryV4&    entry) const;
+    static bool convertEntryV2(
+            DxvkStateCacheEntryV4&    entry);
     
-    bool convertEntryV4(
+    static bool convertEntryV4(
       const DxvkStateCacheEntryV4&    in,
-            DxvkStateCacheEntryV6&    out) const;
+            DxvkStateCacheEntryV6&    out);
     
-    bool convertEntryV5(
+    static bool convertEntryV5(
       const DxvkStateCacheEntryV5&    in,
-            DxvkStateCacheEntryV6&    out) const;
+            DxvkStateCacheEntryV6&    out);
     
-    bool convertEntryV6(
+    static bool convertEntryV6(
       const DxvkStateCacheEntryV6&    in,
-            DxvkStateCacheEntry&      out) const;
+            DxvkStateCacheEntry&      out);
     
     void workerFunc();
 
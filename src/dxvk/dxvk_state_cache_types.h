@@ -3,6 +3,8 @@
 #include "dxvk_pipemanager.h"
 #include "dxvk_renderpass.h"
 
+#include "../util/xxHash/xxhash.h"
+
 namespace dxvk {
 
   /**
@@ -52,13 +54,54 @@ namespace dxvk {
    */
   struct DxvkStateCacheHeader {
     char     magic[4]   = { 'D', 'X', 'V', 'K' };
-    uint32_t version    = 12;
+    uint32_t version    = 14;
     uint32_t entrySize  = 0; /* no longer meaningful */
   };
 
   static_assert(sizeof(DxvkStateCacheHeader) == 12);
 
 
+  /**
+   * \brief Packed entry header
+   *
+   * Precedes the checksum and the data of
+   * every entry in v8 and newer cache files.
+   */
+  struct DxvkStateCacheEntryHeader {
+    uint32_t stageMask : 8;
+    uint32_t entrySize : 24;
+  };
+
+  static_assert(sizeof(DxvkStateCacheEntryHeader) == 4);
+
+
+  /**
+   * \brief Entry checksum
+   *
+   * Entries of v13 and newer cache files are validated
+   * with an XXH3-128 hash of the entry data, older ones
+   * with a SHA-1 hash, which is far slower to compute.
+   */
+  using DxvkStateCacheChecksum = XXH128_hash_t;
+
+  static_assert(sizeof(DxvkStateCacheChecksum) == 16);
+
+
+  /**
+   * \brief Entry usage data
+   *
+   * Tracks in which application sessions a pipeline
+   * was actually used, so that pipelines needed early
+   * can be compiled first. Stored at the end of the
+   * entry data in v14 and newer cache files, zero
+   * for entries read from older files.
+   */
+  struct DxvkStateCacheUsage {
+    uint32_t lastSession  = 0;  ///< Last session the pipeline was used in
+    uint32_t sessionCount = 0;  ///< Number of sessions the pipeline was used in
+  };
+
+
   class DxvkBindingMaskV8 : DxvkBindingSet<128> {
 
   public:
@@ -26,6 +26,15 @@ namespace dxvk {
     CsSyncCount,              ///< CS thread synchronizations
     CsSyncTicks,              ///< Time spent waiting on CS
     CsChunkCount,             ///< Submitted CS chunks
+    CsQueueDepth,             ///< Chunks waiting for the CS thread
+    CsStallCount,             ///< Dispatches that waited for a free CS queue slot
+    CsStallTicks,             ///< Time spent waiting for a free CS queue slot
+    CsCommandCount,           ///< Commands in dispatched CS chunks
+    CsChunkBytes,             ///< Bytes used in dispatched CS chunks
+    CsResourceWaitCount,      ///< Map and Lock calls that waited for a resource
+    CsResourceWaitTicks,      ///< Time spent waiting for resources on Map and Lock
+    CsFutureWaitCount,        ///< Draws where the CS thread waited on geometry workers
+    CsFutureWaitTicks,        ///< Time the CS thread spent waiting on geometry workers
 
     // NV-DXVK begin: RTX Remix counters
     CmdTraceRaysCalls,                 ///< Number of traceRays calls
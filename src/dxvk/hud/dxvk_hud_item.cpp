@@ -3,6 +3,8 @@
 #include <iomanip>
 #include <version.h>
 
+#include "../dxvk_cs.h"
+
 #include "rtx_render/rtx_options.h"
 #include "rtx_render/rtx_texture_manager.h"
 
@@ -646,12 +648,19 @@ namespace dxvk::hud {
     DxvkStatCounters counters = m_device->getStatCounters();
     uint64_t currCsSyncCount = counters.getCtr(DxvkStatCounter::CsSyncCount);
     uint64_t currCsSyncTicks = counters.getCtr(DxvkStatCounter::CsSyncTicks);
+    uint64_t currCsStallCount = counters.getCtr(DxvkStatCounter::CsStallCount);
+    uint64_t currCsStallTicks = counters.getCtr(DxvkStatCounter::CsStallTicks);
 
     m_maxCsSyncCount = std::max(m_maxCsSyncCount, currCsSyncCount - m_prevCsSyncCount);
     m_maxCsSyncTicks = std::max(m_maxCsSyncTicks, currCsSyncTicks - m_prevCsSyncTicks);
+    m_maxCsStallCount = std::max(m_maxCsStallCount, currCsStallCount - m_prevCsStallCount);
+    m_maxCsStallTicks = std::max(m_maxCsStallTicks, currCsStallTicks - m_prevCsStallTicks);
+    m_maxCsQueueDepth = std::max(m_maxCsQueueDepth, counters.getCtr(DxvkStatCounter::CsQueueDepth));
 
     m_prevCsSyncCount = currCsSyncCount;
     m_prevCsSyncTicks = currCsSyncTicks;
+    m_prevCsStallCount = currCsStallCount;
+    m_prevCsStallTicks = currCsStallTicks;
 
     m_updateCount++;
 
@@ -667,8 +676,51 @@ namespace dxvk::hud {
         ? str::format(m_maxCsSyncCount, " (", (syncTicks / 10), ".", (syncTicks % 10), " ms)")
         : str::format(m_maxCsSyncCount);
 
+      uint64_t stallTicks = m_maxCsStallTicks / 100;
+
+      m_csQueueString = str::format(m_maxCsQueueDepth);
+      m_csStallString = m_maxCsStallCount
+        ? str::format(m_maxCsStallCount, " (", (stallTicks / 10), ".", (stallTicks % 10), " ms)")
+        : str::format(m_maxCsStallCount);
+
+      // Chunk fill and waits are averaged over the interval rather
+      // than per frame, they are meant to show steady state behaviour
+      uint64_t currCsCommands = counters.getCtr(DxvkStatCounter::CsCommandCount);
+      uint64_t currCsBytes    = counters.getCtr(DxvkStatCounter::CsChunkBytes);
+      uint64_t chunkTotal     = currCsChunks - m_prevCsChunkTotal;
+
+      m_csFillString = chunkTotal
+        ? str::format((currCsBytes - m_prevCsBytes) * 100 / (chunkTotal * DxvkCsChunk::capacity()), "% (",
+            (currCsCommands - m_prevCsCommands) / chunkTotal, " cmds)")
+        : str::format("-");
+
+      m_prevCsCommands   = currCsCommands;
+      m_prevCsBytes      = currCsBytes;
+      m_prevCsChunkTotal = currCsChunks;
+
+      uint64_t currResourceWaitCount = counters.getCtr(DxvkStatCounter::CsResourceWaitCount);
+      uint64_t currResourceWaitTicks = counters.getCtr(DxvkStatCounter::CsResourceWaitTicks);
+      uint64_t currFutureWaitCount   = counters.getCtr(DxvkStatCounter::CsFutureWaitCount);
+      uint64_t currFutureWaitTicks   = counters.getCtr(DxvkStatCounter::CsFutureWaitTicks);
+
+      uint64_t resourceWaitTicks = (currResourceWaitTicks - m_prevResourceWaitTicks) / 100;
+      uint64_t futureWaitTicks   = (currFutureWaitTicks - m_prevFutureWaitTicks) / 100;
+
+      m_csResourceWaitString = str::format(currResourceWaitCount - m_prevResourceWaitCount,
+        " (", (resourceWaitTicks / 10), ".", (resourceWaitTicks % 10), " ms)");
+      m_csFutureWaitString = str::format(currFutureWaitCount - m_prevFutureWaitCount,
+        " (", (futureWaitTicks / 10), ".", (futureWaitTicks % 10), " ms)");
+
+      m_prevResourceWaitCount = currResourceWaitCount;
+      m_prevResourceWaitTicks = currResourceWaitTicks;
+      m_prevFutureWaitCount   = currFutureWaitCount;
+      m_prevFutureWaitTicks   = currFutureWaitTicks;
+
       m_maxCsSyncCount = 0;
       m_maxCsSyncTicks = 0;
+      m_maxCsStallCount = 0;
+      m_maxCsStallTicks = 0;
+      m_maxCsQueueDepth = 0;
 
       m_updateCount = 0;
       m_lastUpdate = time;
@@ -701,6 +753,61 @@ namespace dxvk::hud {
       { 1.0f, 1.0f, 1.0f, 1.0f },
       m_csSyncString);
 
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "CS queue:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csQueueString);
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "CS stalls:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csStallString);
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "CS fill:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csFillString);
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "Map waits:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csResourceWaitString);
+
+    position.y += 20.0f;
+    renderer.drawText(16.0f,
+      { position.x, position.y },
+      { 0.25f, 1.0f, 0.25f, 1.0f },
+      "Geo waits:");
+
+    renderer.drawText(16.0f,
+      { position.x + 132.0f, position.y },
+      { 1.0f, 1.0f, 1.0f, 1.0f },
+      m_csFutureWaitString);
+
     position.y += 8.0f;
     return position;
   }
@@ -412,10 +412,31 @@ namespace dxvk::hud {
     uint64_t m_maxCsSyncCount   = 0;
     uint64_t m_maxCsSyncTicks   = 0;
 
+    uint64_t m_prevCsStallCount = 0;
+    uint64_t m_prevCsStallTicks = 0;
+
+    uint64_t m_maxCsStallCount  = 0;
+    uint64_t m_maxCsStallTicks  = 0;
+    uint64_t m_maxCsQueueDepth  = 0;
+
+    uint64_t m_prevCsCommands   = 0;
+    uint64_t m_prevCsBytes      = 0;
+    uint64_t m_prevCsChunkTotal = 0;
+
+    uint64_t m_prevResourceWaitCount = 0;
+    uint64_t m_prevResourceWaitTicks = 0;
+    uint64_t m_prevFutureWaitCount   = 0;
+    uint64_t m_prevFutureWaitTicks   = 0;
+
     uint64_t m_updateCount      = 0;
 
     std::string m_csSyncString;
     std::string m_csChunkString;
+    std::string m_csQueueString;
+    std::string m_csStallString;
+    std::string m_csFillString;
+    std::string m_csResourceWaitString;
+    std::string m_csFutureWaitString;
 
     dxvk::high_resolution_clock::time_point m_lastUpdate
       = dxvk::high_resolution_clock::now();
@@ -67,7 +67,7 @@ void RtxOptionReadBool::updateRange(const Rc<DxvkContext>& context, const size_t
         
         // Get the value if it's a bool type
         if (option->type == OptionType::Bool) {
-          value = option->resolvedValue.b;
+          value = option->getPublishedValue().b;
         } else {
           ONCE(Logger::warn(str::format("RtxOptionReadBool: Option '", optionName, "' is not a bool type.")));
         }
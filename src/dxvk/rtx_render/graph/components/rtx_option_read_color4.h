@@ -66,8 +66,8 @@ void RtxOptionReadColor4::updateRange(const Rc<DxvkContext>& context, const size
         RtxOptionImpl* option = optionIt->second.get();
         
         // Get the value if it's a Vector4 type (Color4 is stored as Vector4)
-        if (option->type == OptionType::Vector4 && option->resolvedValue.v4 != nullptr) {
-          value = *option->resolvedValue.v4;
+        if (option->type == OptionType::Vector4 && option->getPublishedValue().v4 != nullptr) {
+          value = *option->getPublishedValue().v4;
         } else {
           ONCE(Logger::warn(str::format("RtxOptionReadColor4: Option '", optionName, "' is not a Vector4/Color4 type.")));
         }
@@ -67,9 +67,9 @@ void RtxOptionReadNumber::updateRange(const Rc<DxvkContext>& context, const size
         
         // Get the value based on the option type
         if (option->type == OptionType::Float) {
-          value = option->resolvedValue.f;
+          value = option->getPublishedValue().f;
         } else if (option->type == OptionType::Int) {
-          value = static_cast<float>(option->resolvedValue.i);
+          value = static_cast<float>(option->getPublishedValue().i);
         } else {
           ONCE(Logger::warn(str::format("RtxOptionReadNumber: Option '", optionName, "' is not a numeric type (float or int).")));
         }
@@ -66,8 +66,8 @@ void RtxOptionReadVector2::updateRange(const Rc<DxvkContext>& context, const siz
         RtxOptionImpl* option = optionIt->second.get();
         
         // Get the value if it's a Vector2 type
-        if (option->type == OptionType::Vector2 && option->resolvedValue.v2 != nullptr) {
-          value = *option->resolvedValue.v2;
+        if (option->type == OptionType::Vector2 && option->getPublishedValue().v2 != nullptr) {
+          value = *option->getPublishedValue().v2;
         } else {
           ONCE(Logger::warn(str::format("RtxOptionReadVector2: Option '", optionName, "' is not a Vector2 type.")));
         }
@@ -66,8 +66,8 @@ void RtxOptionReadVector3::updateRange(const Rc<DxvkContext>& context, const siz
         RtxOptionImpl* option = optionIt->second.get();
         
         // Get the value if it's a Vector3 type
-        if (option->type == OptionType::Vector3 && option->resolvedValue.v3 != nullptr) {
-          value = *option->resolvedValue.v3;
+        if (option->type == OptionType::Vector3 && option->getPublishedValue().v3 != nullptr) {
+          value = *option->getPublishedValue().v3;
         } else {
           ONCE(Logger::warn(str::format("RtxOptionReadVector3: Option '", optionName, "' is not a Vector3 type.")));
         }
@@ -40,13 +40,24 @@
 
 #include "rtx/pass/common_binding_indices.h"
 
+#include "../../util/util_threadpool.h"
+
 namespace dxvk {
 
   // Make this static and not a member of AccelManager to make it safe updating the count from ~PooledBlas()
   static int g_blasCount = 0;
 
+  // Upper bound for the planning worker threads, the planning work is memory bound and short
+  static constexpr uint32_t kMaxBlasPlanningThreads = 4;
+  // Clean data between two dirty records is uploaded along with them when it is at most this large
+  static constexpr size_t kMaxUploadGapSize = 1024;
+  // Upper bound on the number of buffer writes per dirty range upload
+  static constexpr size_t kMaxUploadRanges = 64;
+
   AccelManager::AccelManager(DxvkDevice* device)
     : CommonDeviceObject(device)
+    , m_vkInstanceMirror(sizeof(VkAccelerationStructureInstanceKHR), kMaxUploadGapSize / sizeof(VkAccelerationStructureInstanceKHR))
+    , m_surfaceMirror(kSurfaceGPUSize, kMaxUploadGapSize / kSurfaceGPUSize)
     // Note: The scratch buffer's device address must be aligned to the minimum alignment required by the Vulkan runtime, otherwise
     //    // even if scratch allocation offsets are aligned they may add to a device address which will mess up this alignment (the alignment
     //    // requirement in Vulkan applies to the scratch buffer's device address, not just an offset as the name may imply). The lack of
@@ -56,6 +67,9 @@ namespace dxvk {
     , m_scratchAlignment(device->properties().khrDeviceAccelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment) {
   }
 
+  AccelManager::~AccelManager() {
+  }
+
   void AccelManager::clear() {
     m_blasPool.clear();
   }
@@ -122,49 +136,36 @@ namespace dxvk {
     return uint32_t(std::max(g_blasCount, 0));
   }
 
-  bool AccelManager::BlasBucket::tryAddInstance(RtInstance* instance) {
-    const uint8_t geometryInstanceMask = instance->getVkInstance().mask;
-    const uint32_t geometryCustomIndexFlags = instance->getVkInstance().instanceCustomIndex & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK);
-    const bool geometryUsesUnorderedApproximations = instance->usesUnorderedApproximations();
-    const VkGeometryInstanceFlagsKHR geometryInstanceFlags = instance->getVkInstance().flags;
-    const uint32_t geometryInstanceShaderBindingTableRecordOffset = instance->getVkInstance().instanceShaderBindingTableRecordOffset;
-
-    if (!geometries.empty()) {
-      if (instanceMask != geometryInstanceMask) {
-        return false;
-      }
-      if (instanceShaderBindingTableRecordOffset != geometryInstanceShaderBindingTableRecordOffset) {
-        return false;
-      }
-      if (customIndexFlags != geometryCustomIndexFlags) {
-        return false;
-      }
-      if (instanceFlags != geometryInstanceFlags) {
-        return false;
-      }
-      if (usesUnorderedApproximations != geometryUsesUnorderedApproximations) {
-        return false;
-      }
-    }
+  // Instances can go into the same merged BLAS if all of the TLAS instance state packed here matches.
+  // SBT offset and flags are 24 and 8 bit fields, only the flag bits of the custom index are relevant.
+  static uint64_t getBlasMergeKey(const RtInstance& instance) {
+    const VkAccelerationStructureInstanceKHR& vkInstance = instance.getVkInstance();
 
-    BlasEntry* blasEntry = instance->getBlas();
+    return (uint64_t(vkInstance.instanceShaderBindingTableRecordOffset) << 20) |
+           (uint64_t(vkInstance.mask) << 12) |
+           (uint64_t(vkInstance.flags) << 4) |
+           (uint64_t(vkInstance.instanceCustomIndex >> CUSTOM_INDEX_MATERIAL_TYPE_BIT) << 1) |
+           (instance.usesUnorderedApproximations() ? 1 : 0);
+  }
 
-    geometries.insert(geometries.end(), blasEntry->buildGeometries.begin(), blasEntry->buildGeometries.end());
-    ranges.insert(ranges.end(), blasEntry->buildRanges.begin(), blasEntry->buildRanges.end());
+  // Quantized positions are built into the BLAS in their normalized encoding, so their dequantization goes into the
+  // transform the geometry or TLAS instance is placed with.
+  static VkTransformMatrixKHR getBuildTransform(const RtInstance& instance, const RaytraceGeometry& geometry, const Matrix4* instanceToObject) {
+    if (!instanceToObject && !geometry.hasQuantizedPositions()) {
+      return instance.getVkInstance().transform;
+    }
 
-    for (auto& range : blasEntry->buildRanges) {
-      originalInstances.push_back(instance);
-      primitiveCounts.push_back(range.primitiveCount);
+    Matrix4 objectToWorld = instanceToObject ? instance.surface.objectToWorld * (*instanceToObject) : instance.getTransform();
+    if (geometry.hasQuantizedPositions()) {
+      objectToWorld = objectToWorld * geometry.getPositionDequantization();
     }
-    instanceBillboardIndices.insert(instanceBillboardIndices.end(), instance->billboardIndices.begin(), instance->billboardIndices.end());
-    indexOffsets.insert(indexOffsets.end(), instance->indexOffsets.begin(), instance->indexOffsets.end());
-
-    instanceShaderBindingTableRecordOffset = geometryInstanceShaderBindingTableRecordOffset;
-    instanceMask = geometryInstanceMask;
-    customIndexFlags = geometryCustomIndexFlags;
-    instanceFlags = geometryInstanceFlags;
-    usesUnorderedApproximations = geometryUsesUnorderedApproximations;
-    return true;
+
+    // The D3D matrix on input, needs to be transposed before feeding to the VK API (left/right handed conversion)
+    // NOTE: VkTransformMatrixKHR is 4x3 matrix, and Matrix4 is 4x4
+    const Matrix4 transform = transpose(objectToWorld);
+    VkTransformMatrixKHR vkTransform;
+    memcpy(&vkTransform, &transform, sizeof(VkTransformMatrixKHR));
+    return vkTransform;
   }
 
   static void fillGeometryInfoFromBlasEntry(BlasEntry& blasEntry, RtInstance& instance, const OpacityMicromapManager* opacityMicromapManager) {
@@ -388,6 +389,179 @@ namespace dxvk {
     execBarriers.recordCommands(ctx->getCommandList());
   }
 
+  template<typename Task>
+  void AccelManager::runPlanningTasks(uint32_t taskCount, const Task& task) {
+    // Tasks are handed out through a shared counter, the calling thread takes part as well
+    std::atomic<uint32_t> nextTask = 0;
+
+    auto runTasks = [&nextTask, &task, taskCount] {
+      for (uint32_t i = nextTask++; i < taskCount; i = nextTask++) {
+        task(i);
+      }
+    };
+
+    std::array<Future<void>, kMaxBlasPlanningThreads> helpers;
+    uint32_t helperCount = 0;
+
+    if (taskCount > 1) {
+      if (m_planningThreadPool == nullptr) {
+        m_planningThreadCount = std::clamp(dxvk::thread::hardware_concurrency() / 4, 1u, kMaxBlasPlanningThreads);
+        m_planningThreadPool = std::make_unique<PlanningThreadPool>(uint8_t(m_planningThreadCount), "rtx-blas-planning");
+      }
+
+      helperCount = std::min(taskCount - 1, m_planningThreadCount);
+
+      for (uint32_t i = 0; i < helperCount; i++) {
+        helpers[i] = m_planningThreadPool->Schedule([&runTasks] { runTasks(); });
+      }
+    }
+
+    runTasks();
+
+    // A helper that could not be scheduled has nothing to wait for, its share was done above
+    for (uint32_t i = 0; i < helperCount; i++) {
+      if (helpers[i].valid()) {
+        helpers[i].get();
+      }
+    }
+  }
+
+  void AccelManager::planBlasMerging() {
+    ScopedCpuProfileZone();
+    auto& state = mergeInstancesIntoBlasFuncState;
+    BlasMergePlanner& planner = state.planner;
+
+    const uint32_t itemCount = uint32_t(state.plannedInstances.size());
+    const uint32_t batchCount = BlasMergePlanner::getBatchCount(itemCount);
+
+    const uint32_t minPrimsInDynamicBLAS = std::max(RtxOptions::minPrimsInDynamicBLAS(), 100u);
+    const uint32_t maxPrimsForMergedBLAS = RtxOptions::maxPrimsInMergedBLAS();
+    const bool minimizeBlasMerging = RtxOptions::minimizeBlasMerging();
+    const bool forceMergeAllMeshes = RtxOptions::forceMergeAllMeshes();
+
+    planner.reset(itemCount);
+
+    // Classify the instances. Only reads the instances and BLAS entries, which are not modified until planning is done.
+    runPlanningTasks(batchCount, [&] (uint32_t batch) {
+      const uint32_t end = std::min(itemCount, (batch + 1) * BlasMergePlanner::kBatchSize);
+
+      for (uint32_t i = batch * BlasMergePlanner::kBatchSize; i < end; i++) {
+        const RtInstance* instance = state.plannedInstances[i];
+        const BlasEntry* blasEntry = instance->getBlas();
+        const uint32_t geometryCount = state.plannedGeometryOffsets[i + 1] - state.plannedGeometryOffsets[i];
+        const uint32_t blasPrims = blasEntry->modifiedGeometryData.calculatePrimitiveCount();
+
+        // Figure out if this blas should be a dynamic one
+        const bool requestDynamicBlas = instance->surface.instancesToObject != nullptr ||    // Point instancer geometry is replicated many times in a scene, we want to reuse the BLAS memory for these objects
+                                        blasEntry->input.getSkinningState().numBones != 0 || // Skinned meshes are always desirable to give a dynamic BLAS, since we'll want to make use of BVH update for performance reasons
+                                        blasEntry->getLinkedInstances().size() > 1  ||       // Meshes that are used in instances multiple times should benefit from BLAS reuse
+                                        blasEntry->dynamicBlas != nullptr ||                 // If we already have a dynamic BLAS, keep using it.
+                                        blasPrims > maxPrimsForMergedBLAS ||                 // Avoid large meshes ending up in the merged BLAS which is built every frame.  # prims is proportional to build cost.
+                                        minimizeBlasMerging;                                 // Option to attempt putting as many objects into dynamic BLAS as possible.
+
+        const bool forceMergedBlas = (geometryCount > 1 ||                                            // Currently we use multiple build geometries for particle billboards, which we prefer to merge into large BLAS
+                                      (!minimizeBlasMerging && blasPrims < minPrimsInDynamicBLAS) ||  // Avoid creating lots of small dynamic BLAS
+                                      forceMergeAllMeshes) &&                                         // Setting to force all meshes into the merged BLAS
+                                        instance->surface.instancesToObject == nullptr;               // Never merge point instancer geometry
+
+        BlasMergePlanner::Item& item = planner.item(i);
+
+        if (requestDynamicBlas && !forceMergedBlas) {
+          // Instances can share BLAS, these are grouped by their BLAS entry
+          item.kind = BlasMergePlanner::Kind::Dynamic;
+          item.key = reinterpret_cast<uintptr_t>(blasEntry);
+          item.geometryCount = 0;
+        } else {
+          item.kind = BlasMergePlanner::Kind::Merged;
+          item.key = getBlasMergeKey(*instance);
+          item.geometryCount = geometryCount;
+        }
+      }
+    });
+
+    planner.plan([this] (uint32_t taskCount, const auto& task) {
+      runPlanningTasks(taskCount, task);
+    });
+
+    state.sortedInstances.resize(itemCount);
+
+    runPlanningTasks(batchCount, [&] (uint32_t batch) {
+      const uint32_t end = std::min(itemCount, (batch + 1) * BlasMergePlanner::kBatchSize);
+
+      for (uint32_t i = batch * BlasMergePlanner::kBatchSize; i < end; i++) {
+        state.sortedInstances[i] = state.plannedInstances[planner.sortedItems()[i]];
+      }
+    });
+  }
+
+  void AccelManager::fillMergedGeometries() {
+    ScopedCpuProfileZone();
+    auto& state = mergeInstancesIntoBlasFuncState;
+    const BlasMergePlanner& planner = state.planner;
+
+    const uint32_t mergedItemOffset = planner.getMergedItemOffset();
+    const uint32_t mergedItemCount = planner.getItemCount() - mergedItemOffset;
+    const uint32_t geometryCount = planner.getGeometryCount();
+
+    state.blasBuckets.resize(planner.mergedGroups().size());
+
+    for (uint32_t i = 0; i < state.blasBuckets.size(); i++) {
+      const BlasMergePlanner::Group& group = planner.mergedGroups()[i];
+      const VkAccelerationStructureInstanceKHR& vkInstance = state.sortedInstances[group.firstItem]->getVkInstance();
+
+      BlasBucket& bucket = state.blasBuckets[i];
+      bucket = BlasBucket();
+      bucket.firstGeometry = group.firstGeometry;
+      bucket.geometryCount = group.geometryCount;
+      bucket.instanceMask = vkInstance.mask;
+      bucket.instanceShaderBindingTableRecordOffset = vkInstance.instanceShaderBindingTableRecordOffset;
+      bucket.customIndexFlags = vkInstance.instanceCustomIndex & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK);
+      bucket.instanceFlags = vkInstance.flags;
+      bucket.usesUnorderedApproximations = state.sortedInstances[group.firstItem]->usesUnorderedApproximations();
+    }
+
+    state.instanceTransforms.resize(mergedItemCount);
+    state.geometries.resize(geometryCount);
+    state.ranges.resize(geometryCount);
+    state.originalInstances.resize(geometryCount);
+    state.primitiveCounts.resize(geometryCount);
+    state.instanceBillboardIndices.resize(geometryCount);
+    state.indexOffsets.resize(geometryCount);
+
+    const VkDeviceAddress transformBufferAddress = m_transformBuffer->getDeviceAddress();
+
+    // Every merged instance owns one transform slot and its own geometry range, so batches never overlap
+    runPlanningTasks(BlasMergePlanner::getBatchCount(mergedItemCount), [&] (uint32_t batch) {
+      const uint32_t end = std::min(mergedItemCount, (batch + 1) * BlasMergePlanner::kBatchSize);
+
+      for (uint32_t i = batch * BlasMergePlanner::kBatchSize; i < end; i++) {
+        const uint32_t item = planner.sortedItems()[mergedItemOffset + i];
+        RtInstance* instance = state.plannedInstances[item];
+
+        // Calculate the device address for the current instance's transform and write the transform data
+        // TODO: only do this for non-identity transforms
+        const VkDeviceAddress transformDeviceAddress = transformBufferAddress + i * sizeof(VkTransformMatrixKHR);
+        state.instanceTransforms[i] = getBuildTransform(*instance, instance->getBlas()->modifiedGeometryData, nullptr);
+
+        const uint32_t srcOffset = state.plannedGeometryOffsets[item];
+        const uint32_t dstOffset = planner.geometryOffsets()[i];
+        const uint32_t count = state.plannedGeometryOffsets[item + 1] - srcOffset;
+
+        for (uint32_t j = 0; j < count; j++) {
+          VkAccelerationStructureGeometryKHR& geometry = state.geometries[dstOffset + j];
+          geometry = state.plannedGeometries[srcOffset + j];
+          geometry.geometry.triangles.transformData.deviceAddress = transformDeviceAddress;
+
+          state.ranges[dstOffset + j] = state.plannedRanges[srcOffset + j];
+          state.originalInstances[dstOffset + j] = instance;
+          state.primitiveCounts[dstOffset + j] = state.plannedRanges[srcOffset + j].primitiveCount;
+          state.instanceBillboardIndices[dstOffset + j] = instance->billboardIndices[j];
+          state.indexOffsets[dstOffset + j] = instance->indexOffsets[j];
+        }
+      }
+    });
+  }
+
   void AccelManager::mergeInstancesIntoBlas(Rc<DxvkContext> ctx, 
                                             DxvkBarrierSet& execBarriers, 
                                             const std::vector<TextureRef>& textures,
@@ -397,6 +571,7 @@ namespace dxvk {
     ScopedGpuProfileZone(ctx, "buildBLAS");
 
     auto& instances = instanceManager.getInstanceTable();
+    auto& state = mergeInstancesIntoBlasFuncState;
 
     // Allocate the transform buffer
     DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
@@ -412,14 +587,12 @@ namespace dxvk {
       Logger::debug("DxvkRaytrace: Vulkan Transform Buffer Realloc");
     }
 
-    std::vector<VkTransformMatrixKHR> instanceTransforms;
-    instanceTransforms.reserve(instances.size());
-
-    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> blasToBuild;
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR*> blasRangesToBuild;
-
-    blasToBuild.reserve(instances.size());
-    blasRangesToBuild.reserve(instances.size());
+    state.blasToBuild.clear();
+    state.blasRangesToBuild.clear();
+    state.plannedInstances.clear();
+    state.plannedGeometryOffsets.clear();
+    state.plannedGeometries.clear();
+    state.plannedRanges.clear();
 
     m_reorderedSurfaces.clear();
     m_reorderedSurfacesFirstIndexOffset.clear();
@@ -437,14 +610,10 @@ namespace dxvk {
       opacityMicromapManager->onFrameStart(ctx);
     }
 
-    std::vector<std::unique_ptr<BlasBucket>> blasBuckets;
-    blasBuckets.reserve(instances.size());
-
     size_t totalScratchMemory = 0;
 
     // NOTE: Would like to use the BLAS Linked instances here, but that misses viewmodel and virtual instances
-    std::unordered_map<BlasEntry*, std::vector<RtInstance*>> uniqueBlas;
-
+    // This pass stays on this thread, it registers OMM requests and rewrites the BLAS entry geometries
     for (RtInstance* instance : instances) {
       if (instance->isHidden()) {
         continue;
@@ -484,76 +653,26 @@ namespace dxvk {
 
       fillGeometryInfoFromBlasEntry(*blasEntry, *instance, opacityMicromapManager);
 
-      const uint32_t minPrimsInDynamicBLAS = std::max(RtxOptions::minPrimsInDynamicBLAS(), 100u);
-      const uint32_t maxPrimsForMergedBLAS = RtxOptions::maxPrimsInMergedBLAS();
-      const uint32_t blasPrims = blasEntry->modifiedGeometryData.calculatePrimitiveCount();
-
-      // Figure out if this blas should be a dynamic one
-      const bool requestDynamicBlas = instance->surface.instancesToObject != nullptr ||    // Point instancer geometry is replicated many times in a scene, we want to reuse the BLAS memory for these objects
-                                      blasEntry->input.getSkinningState().numBones != 0 || // Skinned meshes are always desirable to give a dynamic BLAS, since we'll want to make use of BVH update for performance reasons
-                                      blasEntry->getLinkedInstances().size() > 1  ||       // Meshes that are used in instances multiple times should benefit from BLAS reuse
-                                      blasEntry->dynamicBlas != nullptr ||                 // If we already have a dynamic BLAS, keep using it.
-                                      blasPrims > maxPrimsForMergedBLAS ||                 // Avoid large meshes ending up in the merged BLAS which is built every frame.  # prims is proportional to build cost.
-                                      RtxOptions::minimizeBlasMerging();                   // Option to attempt putting as many objects into dynamic BLAS as possible.
-
-      const bool forceMergedBlas = (blasEntry->buildGeometries.size() > 1 ||                                       // Currently we use multiple build geometries for particle billboards, which we prefer to merge into large BLAS
-                                    (!RtxOptions::minimizeBlasMerging() && blasPrims < minPrimsInDynamicBLAS) ||   // Avoid creating lots of small dynamic BLAS
-                                    RtxOptions::forceMergeAllMeshes()) &&                                          // Setting to force all meshes into the merged BLAS
-                                      instance->surface.instancesToObject == nullptr;                              // Never merge point instancer geometry
-
-      if (requestDynamicBlas && !forceMergedBlas) {
-        // Since this loop is iterating over instances, and instances can share BLAS, we will build these later after identifying unique ones.
-        uniqueBlas[blasEntry].push_back(instance);
-      } else {
-        // Make sure we don't double up on blas entries, this should only happen if theres a bug
-        // TODO (REMIX-3996) will break the assumptions we make here about all instances in a BlasEntry having the same instancesToObject array
-        assert(uniqueBlas.find(blasEntry) == uniqueBlas.end());
-
-        if (blasEntry->dynamicBlas != nullptr) {
-          // Move the BLAS used by this geometry to the common pool.
-          // This also ensures the dynamic blas resource that's still being used by previous TLAS is properly tracked for the next frame
-          m_blasPool.push_back(std::move(blasEntry->dynamicBlas));
-          blasEntry->dynamicBlas = nullptr;
-        }
-
-        // Calculate the device address for the current instance's transform and write the transform data
-        // TODO: only do this for non-identity transforms
-        VkDeviceAddress transformDeviceAddress = m_transformBuffer->getDeviceAddress() + instanceTransforms.size() * sizeof(VkTransformMatrixKHR);
-        instanceTransforms.push_back(instance->getVkInstance().transform);
-
-        for (auto& geometry : blasEntry->buildGeometries) {
-          geometry.geometry.triangles.transformData.deviceAddress = transformDeviceAddress;
-        }
-
-        // Try to merge the instance into one of the blasBuckets
-        bool merged = false;
-        for (auto& bucket : blasBuckets) {
-          if (bucket->tryAddInstance(instance)) {
-            merged = true;
-            break;
-          }
-        }
+      // Instances sharing a BLAS entry can get different geometry flags or billboard splits,
+      // so keep what was filled in for this instance before the next one overwrites it
+      state.plannedInstances.push_back(instance);
+      state.plannedGeometryOffsets.push_back(uint32_t(state.plannedGeometries.size()));
+      state.plannedGeometries.insert(state.plannedGeometries.end(), blasEntry->buildGeometries.begin(), blasEntry->buildGeometries.end());
+      state.plannedRanges.insert(state.plannedRanges.end(), blasEntry->buildRanges.begin(), blasEntry->buildRanges.end());
+    }
 
-        // The instance couldn't be merged into any bucket - make a new one
-        if (!merged) {
-          auto newBucket = std::make_unique<BlasBucket>();
-          merged = newBucket->tryAddInstance(instance);
-          assert(merged);
+    state.plannedGeometryOffsets.push_back(uint32_t(state.plannedGeometries.size()));
 
-          blasBuckets.push_back(std::move(newBucket));
-        }
+    // Sort the instances into dynamic BLAS and merged BLAS buckets
+    planBlasMerging();
 
-        // Track the lifetime and states of the source geometry buffers
-        trackBlasBuildResources(ctx, execBarriers, blasEntry);
-      }
-    }
+    const BlasMergePlanner& planner = state.planner;
 
     // Build/Update the dynamic BLAS
-    for (const std::pair<BlasEntry*, std::vector<RtInstance*>> pair : uniqueBlas) {
-      BlasEntry* blasEntry = pair.first;
-      if (pair.second.size() == 0) {
-        continue;
-      }
+    for (const BlasMergePlanner::Group& group : planner.dynamicGroups()) {
+      RtInstance* const* groupInstances = &state.sortedInstances[group.firstItem];
+      BlasEntry* blasEntry = groupInstances[0]->getBlas();
+
       assert(blasEntry->buildGeometries.size() == 1); // dynamic BLAS should always have this
       assert(blasEntry->buildRanges.size() == 1); // dynamic BLAS should always have this
 
@@ -563,10 +682,10 @@ namespace dxvk {
         // Check validity of a built BLAS, only if:
         // We can only support OMM on dynamic BLAS whos surface is unique to that BLAS.  This is so we can benefit from instancing BLAS memory.  
         // In cases where there are multiple linked instances each with different surfaces OMM would break.
-        bool ommsCompatible = pair.second.size() == 1;
-        const XXH64_hash_t firstOmmHash = OpacityMicromapManager::getOpacityMicromapHash(*pair.second[0]);
-        for (uint32_t i = 1; i < pair.second.size(); i++) {
-          const XXH64_hash_t thisOmmHash = OpacityMicromapManager::getOpacityMicromapHash(*pair.second[i]);
+        bool ommsCompatible = group.itemCount == 1;
+        const XXH64_hash_t firstOmmHash = OpacityMicromapManager::getOpacityMicromapHash(*groupInstances[0]);
+        for (uint32_t i = 1; i < group.itemCount; i++) {
+          const XXH64_hash_t thisOmmHash = OpacityMicromapManager::getOpacityMicromapHash(*groupInstances[i]);
           if (thisOmmHash != firstOmmHash) {
             ommsCompatible = false;
             break;
@@ -574,7 +693,7 @@ namespace dxvk {
         }
 
         if (ommsCompatible) {
-          RtInstance* exemplarInstance = pair.second[0];
+          RtInstance* exemplarInstance = groupInstances[0];
 
           // Bind opacity micromap
           // Opacity micromaps must be bound before acceleration sizes are calculated
@@ -652,13 +771,15 @@ namespace dxvk {
         ctx->getCommandList()->trackResource<DxvkAccess::Write>(selectedBlas->accelStructure);
 
         // Put the merged BLAS into the build queue
-        blasToBuild.push_back(buildInfo);
-        blasRangesToBuild.push_back(&blasEntry->buildRanges[0]);
+        state.blasToBuild.push_back(buildInfo);
+        state.blasRangesToBuild.push_back(&blasEntry->buildRanges[0]);
 
         copyAccelerationStructureBuildGeometryInfo(buildInfo, selectedBlas->buildInfo);
       }
 
-      for (RtInstance* rtInstance : pair.second) {
+      for (uint32_t i = 0; i < group.itemCount; i++) {
+        RtInstance* rtInstance = groupInstances[i];
+
         // Append an instance of this merged BLAS to the merged instance list
         if (rtInstance->surface.instancesToObject == nullptr) {
           addBlas(rtInstance, blasEntry, nullptr);
@@ -681,9 +802,26 @@ namespace dxvk {
       trackBlasBuildResources(ctx, execBarriers, blasEntry);
     }
 
+    for (uint32_t i = planner.getMergedItemOffset(); i < state.sortedInstances.size(); i++) {
+      BlasEntry* blasEntry = state.sortedInstances[i]->getBlas();
+
+      if (blasEntry->dynamicBlas != nullptr) {
+        // Move the BLAS used by this geometry to the common pool.
+        // This also ensures the dynamic blas resource that's still being used by previous TLAS is properly tracked for the next frame
+        m_blasPool.push_back(std::move(blasEntry->dynamicBlas));
+        blasEntry->dynamicBlas = nullptr;
+      }
+
+      // Track the lifetime and states of the source geometry buffers
+      trackBlasBuildResources(ctx, execBarriers, blasEntry);
+    }
+
+    // Lay out the merged BLAS buckets and gather their geometries and transforms
+    fillMergedGeometries();
+
     // Copy the instance transform data to the device
-    if (instanceTransforms.size() > 0) {
-      ctx->writeToBuffer(m_transformBuffer, 0, instanceTransforms.size() * sizeof(VkTransformMatrixKHR), instanceTransforms.data());
+    if (state.instanceTransforms.size() > 0) {
+      ctx->writeToBuffer(m_transformBuffer, 0, state.instanceTransforms.size() * sizeof(VkTransformMatrixKHR), state.instanceTransforms.data());
     }
 
     ctx->getCommandList()->trackResource<DxvkAccess::Write>(m_transformBuffer);
@@ -699,16 +837,17 @@ namespace dxvk {
       VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
       VK_ACCESS_SHADER_READ_BIT);
 
-    // Collect all the surfaces
-    for (const auto& blasBucket : blasBuckets) {
-      // Store the offset to use it later during blas instance creation
-      blasBucket->reorderedSurfacesOffset = static_cast<uint32_t>(m_reorderedSurfaces.size());
+    // Collect all the surfaces, the merged geometries are already laid out bucket by bucket
+    const uint32_t mergedSurfacesOffset = static_cast<uint32_t>(m_reorderedSurfaces.size());
 
-      // Append the bucket's instances to the reordered surface list
-      m_reorderedSurfaces.insert(m_reorderedSurfaces.end(), blasBucket->originalInstances.begin(), blasBucket->originalInstances.end());
-      m_reorderedSurfacesFirstIndexOffset.insert(m_reorderedSurfacesFirstIndexOffset.end(), blasBucket->indexOffsets.begin(), blasBucket->indexOffsets.end());
+    for (BlasBucket& blasBucket : state.blasBuckets) {
+      // Store the offset to use it later during blas instance creation
+      blasBucket.reorderedSurfacesOffset = mergedSurfacesOffset + blasBucket.firstGeometry;
     }
 
+    m_reorderedSurfaces.insert(m_reorderedSurfaces.end(), state.originalInstances.begin(), state.originalInstances.end());
+    m_reorderedSurfacesFirstIndexOffset.insert(m_reorderedSurfacesFirstIndexOffset.end(), state.indexOffsets.begin(), state.indexOffsets.end());
+
     // Build prefix sum array
     // Collect primitive count for each surface object
     // Because we use exclusive prefix sum here, we add one more element to record the scene's total primitive count
@@ -732,8 +871,7 @@ namespace dxvk {
       totalPrimitiveIDOffset += primitiveCount;
     }
 
-    buildBlases(ctx, execBarriers, cameraManager, opacityMicromapManager, instanceManager, 
-                textures, instances, blasBuckets, blasToBuild, blasRangesToBuild, totalScratchMemory);
+    buildBlases(ctx, execBarriers, cameraManager, opacityMicromapManager, instanceManager, textures, totalScratchMemory);
   }
 
   void AccelManager::addBlas(RtInstance* instance, BlasEntry* blasEntry, const Matrix4* instanceToObject) {
@@ -744,12 +882,7 @@ namespace dxvk {
       (blasInstance.instanceCustomIndex & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK)) |
       uint32_t(m_reorderedSurfaces.size()) & uint32_t(CUSTOM_INDEX_SURFACE_MASK);
 
-    if (instanceToObject) {
-      // The D3D matrix on input, needs to be transposed before feeding to the VK API (left/right handed conversion)
-      // NOTE: VkTransformMatrixKHR is 4x3 matrix, and Matrix4 is 4x4
-      const Matrix4 transform = transpose(instance->surface.objectToWorld * (*instanceToObject));
-      memcpy(&blasInstance.transform, &transform, sizeof(VkTransformMatrixKHR));
-    }
+    blasInstance.transform = getBuildTransform(*instance, blasEntry->modifiedGeometryData, instanceToObject);
 
     // Get the instance's flags and apply the objectToWorldMirrored flag.
     if (instance->isObjectToWorldMirrored()) {
@@ -768,30 +901,29 @@ namespace dxvk {
     m_reorderedSurfacesFirstIndexOffset.push_back(0);
   }
 
-  void AccelManager::createBlasBuffersAndInstances(Rc<DxvkContext> ctx, 
-                                                   const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets,
-                                                   std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
-                                                   std::vector<VkAccelerationStructureBuildRangeInfoKHR*>& blasRangesToBuild,
-                                                   size_t& totalScratchMemory) {
+  void AccelManager::createBlasBuffersAndInstances(Rc<DxvkContext> ctx, size_t& totalScratchMemory) {
+    auto& state = mergeInstancesIntoBlasFuncState;
 
     const uint32_t currentFrame = m_device->getCurrentFrameId();
 
     // Create or find a matching BLAS for each bucket, then build it
-    for (const auto& bucket : blasBuckets) {
+    for (const BlasBucket& bucket : state.blasBuckets) {
+      const uint32_t* primitiveCounts = &state.primitiveCounts[bucket.firstGeometry];
+
       // Fill out the build info
       VkAccelerationStructureBuildGeometryInfoKHR buildInfo {};
       buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
       buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
       buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR | additionalAccelerationStructureFlags();
       buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-      buildInfo.geometryCount = bucket->geometries.size();
-      buildInfo.pGeometries = bucket->geometries.data();
+      buildInfo.geometryCount = bucket.geometryCount;
+      buildInfo.pGeometries = &state.geometries[bucket.firstGeometry];
 
       // Calculate the build sizes for this bucket
       VkAccelerationStructureBuildSizesInfoKHR sizeInfo {};
       sizeInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
       m_device->vkd()->vkGetAccelerationStructureBuildSizesKHR(m_device->handle(), VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                                                               &buildInfo, bucket->primitiveCounts.data(), &sizeInfo);
+                                                               &buildInfo, primitiveCounts, &sizeInfo);
 
       // Try to find an existing BLAS that is minimally sufficient to fit this bucket of geometries
       PooledBlas* selectedBlas = nullptr;
@@ -807,7 +939,8 @@ namespace dxvk {
 
       // Must ensure that if we are updating an existing blas, rather than rebuilding, the blas is compatible with our new build info
       // Cannot update a blas that contains OMM instances, this leads to sporadic device lost errors
-      if (!bucket->hasOmmInstances && selectedBlas && validateUpdateMode(selectedBlas->buildInfo, buildInfo) && selectedBlas->primitiveCounts == bucket->primitiveCounts) {
+      if (!bucket.hasOmmInstances && selectedBlas && validateUpdateMode(selectedBlas->buildInfo, buildInfo) &&
+          std::equal(selectedBlas->primitiveCounts.begin(), selectedBlas->primitiveCounts.end(), primitiveCounts, primitiveCounts + bucket.geometryCount)) {
         buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
       }
 
@@ -831,7 +964,7 @@ namespace dxvk {
       }
 
       copyAccelerationStructureBuildGeometryInfo(buildInfo, selectedBlas->buildInfo);
-      selectedBlas->primitiveCounts = bucket->primitiveCounts;
+      selectedBlas->primitiveCounts.assign(primitiveCounts, primitiveCounts + bucket.geometryCount);
 
       // Allocate a scratch buffer slice
       const size_t requiredScratchAllocSize = align(sizeInfo.buildScratchSize + m_scratchAlignment, m_scratchAlignment);
@@ -844,8 +977,8 @@ namespace dxvk {
       ctx->getCommandList()->trackResource<DxvkAccess::Write>(selectedBlas->accelStructure);
 
       // Put the merged BLAS into the build queue
-      blasToBuild.push_back(buildInfo);
-      blasRangesToBuild.push_back(bucket->ranges.data());
+      state.blasToBuild.push_back(buildInfo);
+      state.blasRangesToBuild.push_back(&state.ranges[bucket.firstGeometry]);
 
       static float identityTransform[3][4] = {
         { 1.f, 0.f, 0.f, 0.f },
@@ -856,15 +989,15 @@ namespace dxvk {
       // Append an instance of this merged BLAS to the merged instance list
       VkAccelerationStructureInstanceKHR instance {};
       instance.accelerationStructureReference = selectedBlas->accelerationStructureReference;
-      instance.flags = bucket->instanceFlags;
-      instance.instanceShaderBindingTableRecordOffset = bucket->instanceShaderBindingTableRecordOffset;
-      instance.mask = bucket->instanceMask;
+      instance.flags = bucket.instanceFlags;
+      instance.instanceShaderBindingTableRecordOffset = bucket.instanceShaderBindingTableRecordOffset;
+      instance.mask = bucket.instanceMask;
       instance.instanceCustomIndex =
-        (bucket->customIndexFlags & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK)) |
-        (bucket->reorderedSurfacesOffset & uint32_t(CUSTOM_INDEX_SURFACE_MASK));
+        (bucket.customIndexFlags & ~uint32_t(CUSTOM_INDEX_SURFACE_MASK)) |
+        (bucket.reorderedSurfacesOffset & uint32_t(CUSTOM_INDEX_SURFACE_MASK));
       memcpy(static_cast<void*>(&instance.transform.matrix[0][0]), &identityTransform[0][0], sizeof(VkTransformMatrixKHR));
 
-      if (bucket->usesUnorderedApproximations && RtxOptions::enableSeparateUnorderedApproximations()) {
+      if (bucket.usesUnorderedApproximations && RtxOptions::enableSeparateUnorderedApproximations()) {
         m_mergedInstances[Tlas::Unordered].push_back(instance);
       } else {
         m_mergedInstances[Tlas::Opaque].push_back(instance);
@@ -973,19 +1106,28 @@ namespace dxvk {
 
     if (m_vkInstanceBuffer == nullptr || info.size > m_vkInstanceBuffer->info().size) {
       m_vkInstanceBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXAccelerationStructure, "Instance Buffer");
+      m_vkInstanceMirror.invalidate();
       Logger::debug("DxvkRaytrace: Vulkan AS Instance Realloc");
     }
 
-    // Write instance data
+    // Write instance data, only the instances that changed since the last frame are uploaded
     size_t offset = 0;
+    size_t instancesSize = 0;
+    for (const auto& instances : m_mergedInstances) {
+      instancesSize += instances.size() * sizeof(VkAccelerationStructureInstanceKHR);
+    }
+
+    m_vkInstanceMirror.begin(instancesSize);
     for (const auto& instances : m_mergedInstances) {
       if (!instances.empty()) {
         const size_t size = instances.size() * sizeof(VkAccelerationStructureInstanceKHR);
-        ctx->writeToBuffer(m_vkInstanceBuffer, offset, size, instances.data());
+        m_vkInstanceMirror.update(offset, instances.data(), size);
         offset += size;
       }
     }
 
+    uploadDirtyRanges(ctx, m_vkInstanceBuffer, m_vkInstanceMirror);
+
     // Vk billboard buffer
     if (numActiveBillboards) {
       info.size = align(numActiveBillboards * sizeof(MemoryBillboard), kBufferAlignment);
@@ -1080,6 +1222,26 @@ namespace dxvk {
     std::swap(currIndex, prevIndex);
   }
 
+  void AccelManager::uploadDirtyRanges(Rc<DxvkContext> ctx, const Rc<DxvkBuffer>& buffer, const DirtyRangeMirror& mirror) {
+    ScopedCpuProfileZone();
+    const auto& ranges = mirror.getDirtyRanges();
+    if (ranges.empty()) {
+      return;
+    }
+
+    // Scattered changes are cheaper to upload with a single copy than with one per range
+    if (ranges.size() > kMaxUploadRanges) {
+      const size_t begin = ranges.front().offset;
+      const size_t end = ranges.back().offset + ranges.back().size;
+      ctx->writeToBuffer(buffer, begin, end - begin, mirror.data() + begin);
+      return;
+    }
+
+    for (const DirtyRangeMirror::Range& range : ranges) {
+      ctx->writeToBuffer(buffer, range.offset, range.size, mirror.data() + range.offset);
+    }
+  }
+
   void AccelManager::uploadSurfaceData(Rc<DxvkContext> ctx) {
     ScopedCpuProfileZone();
     if (m_reorderedSurfaces.empty()) {
@@ -1102,6 +1264,7 @@ namespace dxvk {
     info.size = align(surfacesGPUSize, kBufferAlignment);
     if (m_surfaceBuffer == nullptr || info.size > m_surfaceBuffer->info().size) {
       m_surfaceBuffer = m_device->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DxvkMemoryStats::Category::RTXAccelerationStructure, "Surface Buffer");
+      m_surfaceMirror.invalidate();
     }
 
     uint32_t maxPreviousSurfaceIndex = 0;
@@ -1116,7 +1279,7 @@ namespace dxvk {
 
       // Split instance geometry need to have their first index offset set in their corresponding surface instances
       currentSurface.firstIndex += m_reorderedSurfacesFirstIndexOffset[i];
-      currentSurface.writeGPUData(surfacesGPUData.data(), dataOffset, i);
+      currentSurface.writeGPUData(surfacesGPUData.data(), dataOffset, i, currentInstance.getBlas()->modifiedGeometryData.getPositionDequantization());
       currentSurface.firstIndex -= m_reorderedSurfacesFirstIndexOffset[i];
 
       // Find the size of the surface mapping buffer
@@ -1130,7 +1293,10 @@ namespace dxvk {
     assert(dataOffset == surfacesGPUSize);
     assert(surfacesGPUData.size() == surfacesGPUSize);
 
-    ctx->writeToBuffer(m_surfaceBuffer, 0, surfacesGPUData.size(), surfacesGPUData.data());
+    // Static surfaces serialize to the same bytes every frame, so only upload the surfaces that changed
+    m_surfaceMirror.begin(surfacesGPUSize);
+    m_surfaceMirror.update(0, surfacesGPUData.data(), surfacesGPUSize);
+    uploadDirtyRanges(ctx, m_surfaceBuffer, m_surfaceMirror);
 
     // Allocate and initialize the surface mapping buffer
     surfaceIndexMapping.resize(maxPreviousSurfaceIndex + 1);
@@ -1203,26 +1369,25 @@ namespace dxvk {
                                  OpacityMicromapManager* opacityMicromapManager,
                                  const InstanceManager& instanceManager,
                                  const std::vector<TextureRef>& textures,
-                                 const std::vector<RtInstance*>& instances,
-                                 const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets,
-                                 std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
-                                 std::vector<VkAccelerationStructureBuildRangeInfoKHR*>& blasRangesToBuild,
                                  size_t& totalScratchMemory) {
     ScopedGpuProfileZone(ctx, "buildBLAS");
+    auto& state = mergeInstancesIntoBlasFuncState;
+    auto& blasToBuild = state.blasToBuild;
+    auto& blasRangesToBuild = state.blasRangesToBuild;
     // Upload surfaces before opacity micromap generation which reads the surface data on the GPU
     uploadSurfaceData(ctx);
 
     // Build and bind opacity micromaps
     if (opacityMicromapManager && opacityMicromapManager->isActive()) {
-      opacityMicromapManager->buildOpacityMicromaps(ctx, textures, cameraManager.getLastCameraCutFrameId());
+      opacityMicromapManager->buildOpacityMicromaps(ctx, textures, cameraManager.getLastCameraCutFrameId(), instanceManager);
 
       // Bind opacity micromaps
-      for (auto& blasBucket : blasBuckets) {
-        for (uint32_t i = 0; i < blasBucket->geometries.size(); i++) {
-          auto ommSourceHash = opacityMicromapManager->tryBindOpacityMicromap(ctx, *blasBucket->originalInstances[i], blasBucket->instanceBillboardIndices[i],
-                                                         blasBucket->geometries[i], instanceManager);
+      for (BlasBucket& blasBucket : state.blasBuckets) {
+        for (uint32_t i = blasBucket.firstGeometry; i < blasBucket.firstGeometry + blasBucket.geometryCount; i++) {
+          auto ommSourceHash = opacityMicromapManager->tryBindOpacityMicromap(ctx, *state.originalInstances[i], state.instanceBillboardIndices[i],
+                                                         state.geometries[i], instanceManager);
           if (ommSourceHash != kEmptyHash) {
-            blasBucket->hasOmmInstances = true;
+            blasBucket.hasOmmInstances = true;
           }
         }
       }
@@ -1231,7 +1396,7 @@ namespace dxvk {
     }
 
     // Blas buffers must be created after opacity micromaps were generated to calculate correct acceleration structure sizes
-    createBlasBuffersAndInstances(ctx, blasBuckets, blasToBuild, blasRangesToBuild, totalScratchMemory);
+    createBlasBuffersAndInstances(ctx, totalScratchMemory);
 
     // Make sure we have enough scratch memory for this build job
     if (totalScratchMemory > 0) {
@@ -29,6 +29,8 @@
 #include "rtx_types.h"
 #include "rtx_common_object.h"
 #include "rtx_staging.h"
+#include "rtx_blas_merge_planner.h"
+#include "rtx_dirty_range_mirror.h"
 #include "../util/util_vector.h"
 #include "../util/util_matrix.h"
 
@@ -39,17 +41,15 @@ class DxvkDevice;
 class ResourceCache;
 class CameraManager;
 class OpacityMicromapManager;
+template<size_t NumTasksPerThread, bool WorkStealing, bool LowLatency> class WorkerThreadPool;
 
 // AccelManager is responsible for maintaining the acceleration structures (BLAS and TLAS)
 class AccelManager : public CommonDeviceObject {
-  class BlasBucket {
-  public:
-    std::vector<VkAccelerationStructureGeometryKHR> geometries {};
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges {};
-    std::vector<RtInstance*> originalInstances {};
-    std::vector<uint32_t> primitiveCounts {};
-    std::vector<uint32_t> instanceBillboardIndices {};  // Billboard index within an instance's billboard array
-    std::vector<uint32_t> indexOffsets {};              // Index offsets within geometry
+  // A merged BLAS. Its geometries are a contiguous range of the flat per-frame arrays in mergeInstancesIntoBlasFuncState,
+  // all instances in it share the same mask, SBT offset, custom index flags, instance flags and unordered approximation use.
+  struct BlasBucket {
+    uint32_t firstGeometry = 0;
+    uint32_t geometryCount = 0;
     uint8_t instanceMask = 0;
     uint32_t instanceShaderBindingTableRecordOffset = 0;
     uint32_t customIndexFlags = 0;
@@ -57,11 +57,6 @@ class AccelManager : public CommonDeviceObject {
     bool usesUnorderedApproximations = false;
     uint32_t reorderedSurfacesOffset = UINT32_MAX;
     bool hasOmmInstances = false;
-    
-    // Tries to add a geometry instance to the bucket. The addition is successful if either:
-    //   a) the bucket is empty,
-    //   b) the instance has the same mask etc. as all other instances in the bucket.
-    bool tryAddInstance(RtInstance* instance);
   };
 
 public:
@@ -69,6 +64,7 @@ public:
   AccelManager& operator=(AccelManager const&) = delete;
 
   explicit AccelManager(DxvkDevice* device);
+  ~AccelManager();
 
   // Returns a GPU buffer containing the surface data for active instances
   const Rc<DxvkBuffer> getSurfaceBuffer() const { return m_surfaceBuffer; }
@@ -124,6 +120,28 @@ private:
     uint32_t prevIndex = 1;
   } buildParticleSurfaceMappingFuncState;
 
+  // Persistent containers to reduce frame to frame reallocations in ::mergeInstancesIntoBlas()
+  struct {
+    BlasMergePlanner planner;
+    std::vector<RtInstance*> plannedInstances;    // Instances that need a BLAS, indexed by planner item
+    std::vector<uint32_t> plannedGeometryOffsets; // Range of each planned instance in plannedGeometries/plannedRanges
+    std::vector<VkAccelerationStructureGeometryKHR> plannedGeometries;
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR> plannedRanges;
+    std::vector<RtInstance*> sortedInstances;     // plannedInstances in planner order
+    std::vector<BlasBucket> blasBuckets;
+    std::vector<VkTransformMatrixKHR> instanceTransforms;
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> blasToBuild;
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR*> blasRangesToBuild;
+
+    // Geometries of all merged BLAS buckets, in bucket order
+    std::vector<VkAccelerationStructureGeometryKHR> geometries;
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges;
+    std::vector<RtInstance*> originalInstances;
+    std::vector<uint32_t> primitiveCounts;
+    std::vector<uint32_t> instanceBillboardIndices;  // Billboard index within an instance's billboard array
+    std::vector<uint32_t> indexOffsets;              // Index offsets within geometry
+  } mergeInstancesIntoBlasFuncState;
+
   // Persistent containers to reduce frame to frame reallocations in ::uploadSurfaceData()
   struct {
     std::vector<unsigned char> surfacesGPUData;
@@ -132,17 +150,13 @@ private:
 
   void buildBlases(Rc<DxvkContext> ctx, DxvkBarrierSet& execBarriers,
                    const CameraManager& cameraManager, OpacityMicromapManager* opacityMicromapManager, const InstanceManager& instanceManager,
-                   const std::vector<TextureRef>& textures, const std::vector<RtInstance*>& instances,
-                   const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets, 
-                   std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
-                   std::vector<VkAccelerationStructureBuildRangeInfoKHR*>& blasRangesToBuild,
-                   size_t& currentScratchOffset);
+                   const std::vector<TextureRef>& textures, size_t& currentScratchOffset);
   void addBlas(RtInstance* instance, BlasEntry* blasEntry, const Matrix4* instanceToObject);
-  void createBlasBuffersAndInstances(Rc<DxvkContext> ctx, 
-                                     const std::vector<std::unique_ptr<BlasBucket>>& blasBuckets,
-                                     std::vector<VkAccelerationStructureBuildGeometryInfoKHR>& blasToBuild,
-                                     std::vector<VkAccelerationStructureBuildRangeInfoKHR*>& blasRangesToBuild,
-                                     size_t& currentScratchOffset);
+  void createBlasBuffersAndInstances(Rc<DxvkContext> ctx, size_t& currentScratchOffset);
+  void planBlasMerging();
+  void fillMergedGeometries();
+  template<typename Task>
+  void runPlanningTasks(uint32_t taskCount, const Task& task);
   template<Tlas::Type type>
   void internalBuildTlas(Rc<DxvkContext> ctx, size_t& totalScratchSize);
 
@@ -164,6 +178,11 @@ private:
   Rc<DxvkBuffer> m_primitiveIDPrefixSumBuffer;
   Rc<DxvkBuffer> m_primitiveIDPrefixSumBufferLastFrame;
 
+  // Last uploaded contents of the instance and surface buffers, so only changed records get written
+  DirtyRangeMirror m_vkInstanceMirror;
+  DirtyRangeMirror m_surfaceMirror;
+  void uploadDirtyRanges(Rc<DxvkContext> ctx, const Rc<DxvkBuffer>& buffer, const DirtyRangeMirror& mirror);
+
   int getCurrentFramePrimitiveIDPrefixSumBufferID() const;
 
   Rc<PooledBlas> m_intersectionBlas;
@@ -174,6 +193,11 @@ private:
   Rc<DxvkBuffer> getScratchMemory(const size_t requiredScratchAllocSize);
   Rc<PooledBlas> createPooledBlas(size_t bufferSize, const char* name) const;
 
+  // Workers for the data parallel parts of BLAS planning, created on first use
+  using PlanningThreadPool = WorkerThreadPool<4, true, false>;
+  std::unique_ptr<PlanningThreadPool> m_planningThreadPool;
+  uint32_t m_planningThreadCount = 0;
+
   VkDeviceSize m_scratchAlignment;
   Rc<DxvkBuffer> m_scratchBuffer;
 };
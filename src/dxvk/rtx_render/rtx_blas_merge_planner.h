@@ -0,0 +1,248 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace dxvk {
+  // Plans the grouping of a frame's BLAS instances. Every item is either a dynamic item, which shares a
+  // dynamic BLAS with all other dynamic items of the same key (the BLAS entry), or a merged item, which goes
+  // into a merged BLAS bucket together with all other merged items of the same key (the TLAS instance state).
+  //
+  // Items are stably sorted by kind and key with an LSD radix sort, so groups end up contiguous, and the
+  // merged items get their offsets into flat per-frame geometry arrays. The planner only sees keys and counts,
+  // so it can be driven from worker threads and tested without a device. All containers are kept between
+  // frames to avoid reallocations.
+  class BlasMergePlanner {
+  public:
+    enum class Kind : uint8_t {
+      Dynamic = 0,
+      Merged = 1
+    };
+
+    struct Item {
+      uint64_t key = 0;
+      uint32_t geometryCount = 0; // Only used for merged items
+      Kind kind = Kind::Merged;
+    };
+
+    struct Group {
+      uint32_t firstItem = 0;     // Offset into sortedItems()
+      uint32_t itemCount = 0;
+      uint32_t firstGeometry = 0; // Offset into the flat geometry arrays, merged groups only
+      uint32_t geometryCount = 0;
+    };
+
+    // Items are processed in batches of this size, one batch per task
+    static constexpr uint32_t kBatchSize = 4096;
+
+    static uint32_t getBatchCount(uint32_t itemCount) {
+      return (itemCount + kBatchSize - 1) / kBatchSize;
+    }
+
+    // Starts a new plan, all items must be written before calling plan()
+    void reset(uint32_t itemCount) {
+      m_items.resize(itemCount);
+    }
+
+    Item& item(uint32_t index) {
+      return m_items[index];
+    }
+
+    uint32_t getItemCount() const {
+      return uint32_t(m_items.size());
+    }
+
+    // Sorts the items and lays out the groups. parallelFor(taskCount, task) must call task(i) once for
+    // every i in [0, taskCount), in any order and on any thread, and return once all calls are done.
+    template<typename ParallelFor>
+    void plan(const ParallelFor& parallelFor) {
+      const uint32_t itemCount = getItemCount();
+      const uint32_t batchCount = getBatchCount(itemCount);
+
+      m_entries[0].resize(itemCount);
+      m_entries[1].resize(itemCount);
+      m_histograms.resize(batchCount);
+
+      parallelFor(batchCount, [this, itemCount] (uint32_t batch) {
+        for (uint32_t i = batch * kBatchSize; i < std::min(itemCount, (batch + 1) * kBatchSize); i++) {
+          m_entries[0][i] = { m_items[i].key, i };
+        }
+      });
+
+      // Least significant digit first, the kind is the most significant one
+      uint32_t src = 0;
+
+      for (uint32_t pass = 0; pass <= kKeyDigits; pass++) {
+        if (sortPass(parallelFor, pass, m_entries[src], m_entries[src ^ 1])) {
+          src ^= 1;
+        }
+      }
+
+      const std::vector<SortEntry>& sorted = m_entries[src];
+
+      m_sortedItems.resize(itemCount);
+
+      parallelFor(batchCount, [this, itemCount, &sorted] (uint32_t batch) {
+        for (uint32_t i = batch * kBatchSize; i < std::min(itemCount, (batch + 1) * kBatchSize); i++) {
+          m_sortedItems[i] = sorted[i].item;
+        }
+      });
+
+      // Groups are cut wherever the kind or key changes, this is a cheap linear scan
+      m_dynamicGroups.clear();
+      m_mergedGroups.clear();
+      m_geometryOffsets.clear();
+      m_mergedItemOffset = itemCount;
+      m_geometryCount = 0;
+
+      for (uint32_t i = 0; i < itemCount; i++) {
+        const Item& item = m_items[sorted[i].item];
+        const bool merged = item.kind == Kind::Merged;
+
+        if (merged && m_mergedItemOffset == itemCount) {
+          m_mergedItemOffset = i;
+        }
+
+        std::vector<Group>& groups = merged ? m_mergedGroups : m_dynamicGroups;
+
+        if (i == 0 || sorted[i - 1].key != sorted[i].key || m_items[sorted[i - 1].item].kind != item.kind) {
+          Group& group = groups.emplace_back();
+          group.firstItem = i;
+          group.firstGeometry = m_geometryCount;
+        }
+
+        Group& group = groups.back();
+        group.itemCount++;
+
+        if (merged) {
+          m_geometryOffsets.push_back(m_geometryCount);
+          group.geometryCount += item.geometryCount;
+          m_geometryCount += item.geometryCount;
+        }
+      }
+    }
+
+    // Item indices, dynamic items first, then merged items, each ordered by key.
+    // Items with the same kind and key keep their relative order.
+    const std::vector<uint32_t>& sortedItems() const {
+      return m_sortedItems;
+    }
+
+    // Position of the first merged item in sortedItems()
+    uint32_t getMergedItemOffset() const {
+      return m_mergedItemOffset;
+    }
+
+    const std::vector<Group>& dynamicGroups() const {
+      return m_dynamicGroups;
+    }
+
+    const std::vector<Group>& mergedGroups() const {
+      return m_mergedGroups;
+    }
+
+    // Geometry offset of each merged item, indexed by its position in sortedItems() minus getMergedItemOffset()
+    const std::vector<uint32_t>& geometryOffsets() const {
+      return m_geometryOffsets;
+    }
+
+    // Total number of geometries in all merged groups
+    uint32_t getGeometryCount() const {
+      return m_geometryCount;
+    }
+
+  private:
+    static constexpr uint32_t kKeyDigits = sizeof(uint64_t);
+    static constexpr uint32_t kRadix = 256;
+
+    struct SortEntry {
+      uint64_t key;
+      uint32_t item;
+    };
+
+    using Histogram = std::array<uint32_t, kRadix>;
+
+    std::vector<Item> m_items;
+    std::vector<SortEntry> m_entries[2];
+    std::vector<Histogram> m_histograms;
+    std::vector<uint32_t> m_sortedItems;
+    std::vector<Group> m_dynamicGroups;
+    std::vector<Group> m_mergedGroups;
+    std::vector<uint32_t> m_geometryOffsets;
+    uint32_t m_mergedItemOffset = 0;
+    uint32_t m_geometryCount = 0;
+
+    uint32_t getDigit(const SortEntry& entry, uint32_t pass) const {
+      return pass < kKeyDigits ? uint32_t(entry.key >> (pass * 8)) & (kRadix - 1) : uint32_t(m_items[entry.item].kind);
+    }
+
+    // One stable counting sort pass over a single digit. Every batch scatters its own items in order,
+    // starting from the offsets of the batches before it. Returns false, without touching dst, if all
+    // items share the same digit, which is the case for most of the key bytes in practice.
+    template<typename ParallelFor>
+    bool sortPass(const ParallelFor& parallelFor, uint32_t pass, const std::vector<SortEntry>& src, std::vector<SortEntry>& dst) {
+      const uint32_t itemCount = uint32_t(src.size());
+      const uint32_t batchCount = getBatchCount(itemCount);
+
+      parallelFor(batchCount, [this, itemCount, pass, &src] (uint32_t batch) {
+        Histogram& histogram = m_histograms[batch];
+        histogram.fill(0);
+
+        for (uint32_t i = batch * kBatchSize; i < std::min(itemCount, (batch + 1) * kBatchSize); i++) {
+          histogram[getDigit(src[i], pass)]++;
+        }
+      });
+
+      uint32_t offset = 0;
+
+      for (uint32_t digit = 0; digit < kRadix; digit++) {
+        uint32_t digitCount = 0;
+
+        for (Histogram& histogram : m_histograms) {
+          const uint32_t count = histogram[digit];
+          histogram[digit] = offset + digitCount;
+          digitCount += count;
+        }
+
+        if (digitCount == itemCount) {
+          return false;
+        }
+
+        offset += digitCount;
+      }
+
+      parallelFor(batchCount, [this, itemCount, pass, &src, &dst] (uint32_t batch) {
+        Histogram& offsets = m_histograms[batch];
+
+        for (uint32_t i = batch * kBatchSize; i < std::min(itemCount, (batch + 1) * kBatchSize); i++) {
+          dst[offsets[getDigit(src[i], pass)]++] = src[i];
+        }
+      });
+
+      return true;
+    }
+  };
+}
@@ -714,8 +714,17 @@ namespace dxvk {
     getSceneManager().clearFogState();
 
     // apply changes to RtxOptions after the frame has ended
-    RtxOptionManager::applyPendingValuesOptionLayers();
-    RtxOptionManager::applyPendingValues(m_device.ptr());
+    {
+      ScopedCpuProfileZoneN("Resolve RtxOptions");
+      const auto resolveStart = std::chrono::steady_clock::now();
+
+      RtxOptionManager::applyPendingValuesOptionLayers();
+      const uint32_t numResolvedOptions = RtxOptionManager::applyPendingValues(m_device.ptr());
+
+      const std::chrono::duration<double, std::milli> resolveTime = std::chrono::steady_clock::now() - resolveStart;
+      ProfilerPlotValueF64("RtxOption resolve time (ms)", resolveTime.count());
+      ProfilerPlotValueI64("RtxOptions resolved", numResolvedOptions);
+    }
 
     // Update stats
     updateMetrics(gpuIdleTimeMilliseconds);
@@ -844,7 +853,16 @@ namespace dxvk {
         : nullptr;
 
     // Sync any pending work with geometry processing threads
-    if (drawCallState.finalizePendingFutures(lastCamera)) {
+    bool futuresFinalized;
+
+    if (drawCallState.hasUnreadyFutures()) {
+      DxvkCsStallScope stall(m_device->csStats(), DxvkCsStallReason::GeometryFuture);
+      futuresFinalized = drawCallState.finalizePendingFutures(lastCamera);
+    } else {
+      futuresFinalized = drawCallState.finalizePendingFutures(lastCamera);
+    }
+
+    if (futuresFinalized) {
       drawCallState.cameraType = cameraManager.processCameraData(drawCallState);
 
       if (drawCallState.cameraType == CameraType::Unknown) {
@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace dxvk {
+  // CPU copy of a device buffer made of fixed size records, used to upload only the records that changed since
+  // the last frame. Every frame the new contents are diffed against the mirror record by record, the mirror is
+  // updated in place, and the changed records are coalesced into a few byte ranges to be written from data().
+  //
+  // Nearby dirty runs are merged when the gap between them is at most maxGapRecords, since writing a few clean
+  // records is cheaper than recording another copy. The device buffer must not be written by anything else, and
+  // the mirror must be invalidated whenever the buffer is recreated.
+  class DirtyRangeMirror {
+  public:
+    struct Range {
+      size_t offset = 0; // In bytes
+      size_t size = 0;
+    };
+
+    DirtyRangeMirror(size_t recordSize, size_t maxGapRecords)
+      : m_recordSize(recordSize)
+      , m_maxGap(maxGapRecords * recordSize) {
+      assert(recordSize > 0);
+    }
+
+    // Forgets the buffer contents, so that the next frame is uploaded in full
+    void invalidate() {
+      m_data.clear();
+      m_dirtyRanges.clear();
+    }
+
+    // Starts a new frame with the given buffer size in bytes. Records past the previous size are dirty.
+    void begin(size_t size) {
+      assert(size % m_recordSize == 0);
+
+      m_validSize = std::min(m_data.size(), size);
+      m_data.resize(size);
+      m_dirtyRanges.clear();
+      m_nextOffset = 0;
+    }
+
+    // Diffs a span of records against the mirror. Spans must be passed in increasing offset order and together
+    // cover the size given to begin().
+    void update(size_t offset, const void* data, size_t size) {
+      assert(offset % m_recordSize == 0 && size % m_recordSize == 0);
+      assert(offset >= m_nextOffset && offset + size <= m_data.size());
+
+      const uint8_t* src = static_cast<const uint8_t*>(data);
+      uint8_t* dst = m_data.data() + offset;
+
+      // Records that were never uploaded are dirty regardless of what the mirror holds
+      const size_t compareSize = offset < m_validSize ? std::min(size, m_validSize - offset) : 0;
+
+      for (size_t i = 0; i < compareSize; i += m_recordSize) {
+        if (std::memcmp(dst + i, src + i, m_recordSize) != 0) {
+          std::memcpy(dst + i, src + i, m_recordSize);
+          markDirty(offset + i, m_recordSize);
+        }
+      }
+
+      if (compareSize < size) {
+        std::memcpy(dst + compareSize, src + compareSize, size - compareSize);
+        markDirty(offset + compareSize, size - compareSize);
+      }
+
+      m_nextOffset = offset + size;
+    }
+
+    // Coalesced byte ranges changed by this frame's update() calls, in increasing offset order
+    const std::vector<Range>& getDirtyRanges() const {
+      return m_dirtyRanges;
+    }
+
+    size_t getDirtySize() const {
+      size_t dirtySize = 0;
+
+      for (const Range& range : m_dirtyRanges) {
+        dirtySize += range.size;
+      }
+
+      return dirtySize;
+    }
+
+    // Current buffer contents, dirty ranges are uploaded from here
+    const uint8_t* data() const {
+      return m_data.data();
+    }
+
+    size_t size() const {
+      return m_data.size();
+    }
+
+  private:
+    void markDirty(size_t offset, size_t size) {
+      if (!m_dirtyRanges.empty()) {
+        Range& last = m_dirtyRanges.back();
+
+        if (offset - (last.offset + last.size) <= m_maxGap) {
+          last.size = offset + size - last.offset;
+          return;
+        }
+      }
+
+      m_dirtyRanges.push_back({ offset, size });
+    }
+
+    size_t m_recordSize;
+    size_t m_maxGap;
+    size_t m_validSize = 0;  // Bytes of m_data that match the device buffer
+    size_t m_nextOffset = 0;
+
+    std::vector<uint8_t> m_data;
+    std::vector<Range> m_dirtyRanges;
+  };
+}  // namespace dxvk
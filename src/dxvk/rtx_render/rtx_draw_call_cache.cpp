@@ -47,12 +47,16 @@ DrawCallCache::DrawCallCache(DxvkDevice* device) : CommonDeviceObject(device) {
 DrawCallCache::~DrawCallCache() {}
 
 DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, BlasEntry** out) {
+  return lookup(m_entries, drawCall, m_device->getCurrentFrameId(), out);
+}
+
+DrawCallCache::CacheState DrawCallCache::lookup(MultimapType& entries, const DrawCallState& drawCall, uint32_t currentFrameId, BlasEntry** out) {
   // First, find the right bucket:
   const XXH64_hash_t hash = drawCall.getGeometryData().getHashForRule<rules::TopologicalHash>();
-  auto range = m_entries.equal_range(hash);
-  if (range.first == m_entries.end()) {
+  auto range = entries.equal_range(hash);
+  if (range.first == entries.end()) {
     // New bucket
-    *out = allocateEntry(hash, drawCall);
+    *out = allocateEntry(entries, hash, drawCall, currentFrameId);
     return CacheState::kNew;
   }
   // Handle buckets with 1 entry:
@@ -62,7 +66,7 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
     // Only 1 element
     BlasEntry& entry = range.first->second;
 
-    const bool updatedThisFrame = entry.frameLastTouched == m_device->getCurrentFrameId();
+    const bool updatedThisFrame = entry.frameLastTouched == currentFrameId;
     const bool vertexDataMatches = entry.input.getGeometryData().getHashForRule<rules::VertexDataHash>() == drawCall.getGeometryData().getHashForRule<rules::VertexDataHash>();
     const bool boneHashesMatch = entry.input.getSkinningState().boneHash == drawCall.getSkinningState().boneHash;
     const bool materialHashesMatch = entry.input.getMaterialData().getHash() == drawCall.getMaterialData().getHash();
@@ -76,7 +80,7 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
     } else {
       // First frame of having two mismatching instances, and the first instance has already 
       // been paired with the existing BlasEntry.
-      *out = allocateEntry(hash, drawCall);
+      *out = allocateEntry(entries, hash, drawCall, currentFrameId);
       return CacheState::kNew;
     }
   }
@@ -93,7 +97,7 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
       *out = &blas;
       return CacheState::kExisted;
     }
-    if (blas.frameLastTouched == m_device->getCurrentFrameId()) {
+    if (blas.frameLastTouched == currentFrameId) {
       continue;
     }
     // TODO these heuristics could use more refinement.
@@ -120,17 +124,17 @@ DrawCallCache::CacheState DrawCallCache::get(const DrawCallState& drawCall, Blas
   }
   if (*out == nullptr) {
     // Failed to find similar blas, so allocate a new one
-    *out = allocateEntry(hash, drawCall);
+    *out = allocateEntry(entries, hash, drawCall, currentFrameId);
     return CacheState::kNew;
   }
   return CacheState::kExisted;
 
 }
 
-BlasEntry* DrawCallCache::allocateEntry(XXH64_hash_t hash, const DrawCallState& drawCall) {
-  auto iter = m_entries.emplace(hash, drawCall);
+BlasEntry* DrawCallCache::allocateEntry(MultimapType& entries, XXH64_hash_t hash, const DrawCallState& drawCall, uint32_t currentFrameId) {
+  auto iter = entries.emplace(hash, drawCall);
   BlasEntry* result = &iter->second;
-  result->frameCreated = m_device->getCurrentFrameId();
+  result->frameCreated = currentFrameId;
   return result;
 }
 
@@ -56,6 +56,10 @@ public:
 
   CacheState get(const DrawCallState& drawCall, BlasEntry** out);
 
+  // Picks the entry of `entries` a draw call belongs to, or allocates a new one. Doesn't need a device, get() forwards
+  // to it with the device's current frame.
+  static CacheState lookup(MultimapType& entries, const DrawCallState& drawCall, uint32_t currentFrameId, BlasEntry** out);
+
   MultimapType& getEntries() {return m_entries;}
 
   void clear() {
@@ -71,7 +75,7 @@ public:
 private:
   MultimapType m_entries;
 
-  BlasEntry* allocateEntry(XXH64_hash_t hash, const DrawCallState& drawCall);
+  static BlasEntry* allocateEntry(MultimapType& entries, XXH64_hash_t hash, const DrawCallState& drawCall, uint32_t currentFrameId);
 };
 
 }  // namespace nvvk
@@ -35,6 +35,7 @@
 
 #include "../../util/log/log.h"
 #include "../../util/config/config.h"
+#include "../../util/util_fastops.h"
 #include "../../util/util_filesys.h"
 #include "../../util/util_vector.h"
 #include "../../util/util_window.h"
@@ -42,6 +43,7 @@
 #include "../../lssusd/game_exporter.h"
 #include "../../lssusd/game_exporter_paths.h"
 #include "../../lssusd/game_exporter_types.h"
+#include "../../lssusd/sample_spill.h"
 #include "../../lssusd/usd_common.h"
 #include "../../lssusd/usd_include_begin.h"
 #include <pxr/base/gf/rotation.h>
@@ -62,7 +64,8 @@ namespace dxvk {
       const auto& float4x4 = reinterpret_cast<const float(&)[4][4]>(mat4);
       return pxr::GfMatrix4d{pxr::GfMatrix4f(float4x4)};
     }
-    static inline pxr::VtMatrix4dArray matrix4VecToGfMatrix4dVec(const std::vector<Matrix4>& mat4s) {
+    template<typename Allocator>
+    static inline pxr::VtMatrix4dArray matrix4VecToGfMatrix4dVec(const std::vector<Matrix4, Allocator>& mat4s) {
       pxr::VtMatrix4dArray result(mat4s.size());
       for (int i = 0; i < mat4s.size(); ++i) {
         const auto& float4x4 = reinterpret_cast<const float(&)[4][4]>(mat4s[i]);
@@ -181,6 +184,15 @@ namespace dxvk {
     if (m_pCap->bCaptureInstances) {
       prepareInstanceStage(ctx);
     }
+    if (m_options.bEnableMultiframe && m_options.streamingWindowFrames > 0) {
+      m_pCap->pSpill = std::make_shared<lss::SampleSpill>(BASE_DIR + "capture_" + m_pCap->idStr + ".spill");
+      if (!m_pCap->pSpill->isValid()) {
+        Logger::warn("[GameCapturer][" + m_pCap->idStr + "] Streaming disabled, keeping all samples in memory");
+        m_pCap->pSpill.reset();
+      }
+      m_pCap->nextXformSpillFrame = static_cast<float>(m_options.streamingWindowFrames);
+      m_pCap->camera.spill = m_pCap->pSpill;
+    }
     Logger::info("[GameCapturer][" + m_pCap->idStr + "] New capture");
     m_pCap->instanceFlags.clear();
 
@@ -219,6 +231,7 @@ namespace dxvk {
       captureLights();
     }
     captureInstances(ctx);
+    spillOldXformSamples();
     ++m_pCap->numFramesCaptured;
     Logger::debug("[GameCapturer][" + m_pCap->idStr + "] End frame capture");
   }
@@ -344,7 +357,11 @@ namespace dxvk {
       sphereLight.color[2] = colorAndIntensity.b;
       sphereLight.intensity = colorAndIntensity.w;
       sphereLight.radius = rtLight.getRadius();
-      sphereLight.xforms.reserve(m_options.numFrames - m_pCap->numFramesCaptured);
+      // A streaming capture only keeps a window of samples in memory
+      if (!m_pCap->pSpill) {
+        sphereLight.xforms.reserve(m_options.numFrames - m_pCap->numFramesCaptured);
+      }
+      sphereLight.spill = m_pCap->pSpill;
       sphereLight.firstTime = m_pCap->currentFrameNum;
       const dxvk::RtLightShaping& shaping = rtLight.getShaping();
       if (shaping.getEnabled()) {
@@ -447,6 +464,25 @@ namespace dxvk {
     }
   }
 
+  void GameCapturer::spillOldXformSamples() {
+    // Spilling in runs of a whole window keeps the number of small writes down,
+    // at most two windows of samples are held in memory
+    if (!m_pCap->pSpill || m_pCap->currentFrameNum < m_pCap->nextXformSpillFrame) {
+      return;
+    }
+    const float windowFrames = static_cast<float>(m_options.streamingWindowFrames);
+    const double spillBefore = m_pCap->currentFrameNum - windowFrames;
+    for (auto& [instanceId, instance] : m_pCap->instances) {
+      lss::spillSamplesBefore(*m_pCap->pSpill, instance.lssData.xforms, instance.lssData.spilledXforms, spillBefore);
+      lss::spillSamplesBefore(*m_pCap->pSpill, instance.lssData.boneXForms, instance.lssData.spilledBoneXForms, spillBefore);
+    }
+    for (auto& [lightHash, sphereLight] : m_pCap->sphereLights) {
+      lss::spillSamplesBefore(*m_pCap->pSpill, sphereLight.xforms, sphereLight.spilledXforms, spillBefore);
+    }
+    lss::spillSamplesBefore(*m_pCap->pSpill, m_pCap->camera.xforms, m_pCap->camera.spilledXforms, spillBefore);
+    m_pCap->nextXformSpillFrame = m_pCap->currentFrameNum + windowFrames;
+  }
+
   void GameCapturer::newInstance(const Rc<DxvkContext> ctx, const RtInstance& rtInstance) {
     const BlasEntry* pBlas = rtInstance.getBlas();
     assert(pBlas != nullptr);
@@ -470,6 +506,9 @@ namespace dxvk {
         m_pCap->meshes[meshHash] = std::make_shared<Mesh>();
         m_pCap->meshes[meshHash]->instanceCount = 0;
         m_pCap->meshes[meshHash]->matHash = matHash;
+        m_pCap->meshes[meshHash]->lssData.buffers.spill = m_pCap->pSpill;
+        m_pCap->meshes[meshHash]->spillWindowFrames = static_cast<float>(m_options.streamingWindowFrames);
+        m_pCap->meshes[meshHash]->nextSpillFrame = m_pCap->currentFrameNum + static_cast<float>(m_options.streamingWindowFrames);
       }
       instanceNum = m_pCap->meshes[meshHash]->instanceCount++;
     }
@@ -483,6 +522,7 @@ namespace dxvk {
     instance.matHash = matHash;
     instance.meshInstNum = instanceNum;
     instance.lssData.firstTime = m_pCap->currentFrameNum;
+    instance.lssData.spill = m_pCap->pSpill;
 
     Logger::debug("[GameCapturer][" + m_pCap->idStr + "][Inst:" + hashToString(instanceId) + "] New");
   }
@@ -602,6 +642,21 @@ namespace dxvk {
     }
   }
 
+  // Whole buffer comparisons for evalNewBufferAndCache
+  template <typename T>
+  static auto vectorsDifferentEnough(const float delta) {
+    return [deltaSq = delta * delta](const pxr::VtArray<T>& newBuffer, const pxr::VtArray<T>& prevBuffer) {
+      constexpr uint32_t componentCount = sizeof(T) / sizeof(float);
+      return fast::anyVectorDistanceAbove(static_cast<uint32_t>(newBuffer.size()), reinterpret_cast<const float*>(newBuffer.cdata()),
+                                          reinterpret_cast<const float*>(prevBuffer.cdata()), componentCount, deltaSq);
+    };
+  }
+
+  template <typename T>
+  static bool buffersNotIdentical(const pxr::VtArray<T>& newBuffer, const pxr::VtArray<T>& prevBuffer) {
+    return memcmp(newBuffer.cdata(), prevBuffer.cdata(), newBuffer.size() * sizeof(T)) != 0;
+  }
+
   template <typename T>
   void GameCapturer::captureMeshPositions(const Rc<DxvkContext> ctx,
                                           const size_t numVertices,
@@ -611,8 +666,6 @@ namespace dxvk {
                                             
     AssetExporter::BufferCallback captureMeshPositionsAsync = [this, ctx, numVertices, inputPositionBuffer, currentFrameNum, pMesh](Rc<DxvkBuffer> posBuf) {
       // Prep helper vars
-      constexpr size_t positionSubElementSize = sizeof(float);
-      const size_t positionStride = inputPositionBuffer.stride() / positionSubElementSize;
       const DxvkBufferSlice positionBuffer(posBuf, 0, posBuf->info().size);
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t)inputPositionBuffer.stride() + sizeof(pxr::GfVec3f)) <=
@@ -620,29 +673,20 @@ namespace dxvk {
       // Get copied-to-CPU GPU buffer
       const float* pVkPosBuf = (float*) positionBuffer.mapPtr((size_t)inputPositionBuffer.offsetFromSlice());
       assert(pVkPosBuf);
-      // Copy GPU buffer to local VtArray
+      // Copy GPU buffer to local VtArray, comparing against the previous sample in the same pass
       pxr::VtArray<pxr::GfVec3f> positions;
-      positions.reserve(numVertices);
-      OriginCalc originCalc;
-      for (size_t idx = 0; idx < numVertices; ++idx) {
-        pxr::GfVec3f pos = *reinterpret_cast<const pxr::GfVec3f*>(&pVkPosBuf[idx * positionStride]);
-        if(correctBakedTransforms()) {
+      const bool bSufficientlyDifferent = gatherBufferAndCompare(pMesh, pMesh->lssData.buffers.positionBufs, pVkPosBuf, inputPositionBuffer.stride(),
+                                                                 numVertices, RtxOptions::captureMeshPositionDelta(), positions);
+      assert(positions.size() > 0);
+      if(correctBakedTransforms()) {
+        OriginCalc originCalc;
+        for (const pxr::GfVec3f& pos : positions) {
           originCalc.compareAndSwap(pos);
         }
-        positions.push_back(pos);
-      }
-      if(correctBakedTransforms()) {
         pMesh->originCalc.compareAndSwap(originCalc);
       }
-      assert(positions.size() > 0);
-      // Create comparison function that returns float
-      static auto positionsDifferentEnough = [](const pxr::GfVec3f& a, const pxr::GfVec3f& b) {
-        const static float captureMeshPositionDelta = RtxOptions::captureMeshPositionDelta();
-        const static float captureMeshPositionDeltaSq = captureMeshPositionDelta * captureMeshPositionDelta;
-        return (a - b).GetLengthSq() > captureMeshPositionDeltaSq;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.positionBufs, positions, currentFrameNum, positionsDifferentEnough);
+      cacheNewBuffer(pMesh, pMesh->lssData.buffers.positionBufs, positions, currentFrameNum, bSufficientlyDifferent);
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, inputPositionBuffer, captureMeshPositionsAsync);
@@ -658,8 +702,6 @@ namespace dxvk {
     AssetExporter::BufferCallback captureMeshNormalsAsync = [ctx, numVertices, inputNormalBuffer, currentFrameNum, pMesh](Rc<DxvkBuffer> norBuf) {
       assert(inputNormalBuffer.vertexFormat() == VK_FORMAT_R32G32B32_SFLOAT);
       // Prep helper vars
-      constexpr size_t normalSubElementSize = sizeof(float);
-      const size_t normalStride = inputNormalBuffer.stride() / normalSubElementSize;
       const DxvkBufferSlice normalBuffer(norBuf, 0, norBuf->info().size );
       // Ensure no reads are out of bounds
       assert(((size_t) (numVertices - 1) * (size_t)inputNormalBuffer.stride() + sizeof(pxr::GfVec3f)) <=
@@ -667,21 +709,13 @@ namespace dxvk {
       // Get copied-to-CPU GPU buffer
       const float* pVkNormalBuf = (float*) normalBuffer.mapPtr((size_t)inputNormalBuffer.offsetFromSlice());
       assert(pVkNormalBuf);
-      // Copy GPU buffer to local VtArray
+      // Copy GPU buffer to local VtArray, comparing against the previous sample in the same pass
       pxr::VtArray<pxr::GfVec3f> normals;
-      normals.reserve(numVertices);
-      for (size_t idx = 0; idx < numVertices; ++idx) {
-        normals.push_back(pxr::GfVec3f(&pVkNormalBuf[idx * normalStride]));
-      }
+      const bool bSufficientlyDifferent = gatherBufferAndCompare(pMesh, pMesh->lssData.buffers.normalBufs, pVkNormalBuf, inputNormalBuffer.stride(),
+                                                                 numVertices, RtxOptions::captureMeshNormalDelta(), normals);
       assert(normals.size() > 0);
-      // Create comparison function that returns float
-      static auto normalsDifferentEnough = [](const pxr::GfVec3f& a, const pxr::GfVec3f& b) {
-        const static float captureMeshNormalDelta = RtxOptions::captureMeshNormalDelta();
-        const static float captureMeshNormalDeltaSq = captureMeshNormalDelta * captureMeshNormalDelta;
-        return (a - b).GetLengthSq() > captureMeshNormalDeltaSq;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.normalBufs, normals, currentFrameNum, normalsDifferentEnough);
+      cacheNewBuffer(pMesh, pMesh->lssData.buffers.normalBufs, normals, currentFrameNum, bSufficientlyDifferent);
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, inputNormalBuffer, captureMeshNormalsAsync);
@@ -737,12 +771,8 @@ namespace dxvk {
         }
       }
 
-      // Create comparison function that returns float
-      static auto differentIndices = [](const int a, const int b) {
-        return a != b;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.idxBufs, indices, currentFrameNum, differentIndices);
+      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.idxBufs, indices, currentFrameNum, buffersNotIdentical<int>);
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, geomData.indexBuffer, captureMeshIndicesAsync);
@@ -775,14 +805,9 @@ namespace dxvk {
                                          1.0f - pVkTexcoordsBuf[idx * texcoordStride + 1]));
       }
       assert(texcoords.size() > 0);
-      // Create comparison function that returns float
-      static auto differentIndices = [](const pxr::GfVec2f& a, const pxr::GfVec2f& b) {
-        const static float captureMeshTexcoordDelta = RtxOptions::captureMeshTexcoordDelta();
-        const static float captureMeshTexcoordDeltaSq = captureMeshTexcoordDelta * captureMeshTexcoordDelta;
-        return (a - b).GetLengthSq() > captureMeshTexcoordDeltaSq;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.texcoordBufs, texcoords, currentFrameNum, differentIndices);
+      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.texcoordBufs, texcoords, currentFrameNum,
+                            vectorsDifferentEnough<pxr::GfVec2f>(RtxOptions::captureMeshTexcoordDelta()));
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, geomData.texcoordBuffer, captureMeshTexCoordsAsync);
@@ -816,14 +841,9 @@ namespace dxvk {
                                       (float) pVkColorBuf[idx * colorStride + 3] / 255.f));
       }
       assert(colors.size() > 0);
-      // Create comparison function that returns float
-      static auto colorsDifferentEnough = [](const pxr::GfVec4f& a, const pxr::GfVec4f& b) {
-        const static float captureMeshColorDelta = RtxOptions::captureMeshColorDelta();
-        const static float captureMeshColorDeltaSq = captureMeshColorDelta * captureMeshColorDelta;
-        return (a - b).GetLengthSq() > captureMeshColorDeltaSq;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.colorBufs, colors, currentFrameNum, colorsDifferentEnough);
+      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.colorBufs, colors, currentFrameNum,
+                            vectorsDifferentEnough<pxr::GfVec4f>(RtxOptions::captureMeshColorDelta()));
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, geomData.color0Buffer, captureMeshColorAsync);
@@ -867,13 +887,9 @@ namespace dxvk {
         targetBuffer.push_back(lastWeight);
       }
       assert(targetBuffer.size() > 0);
-      // Create comparison function that returns float
-      static auto weightsDifferentEnough = [](const float& a, const float& b) {
-        const static float delta = RtxOptions::captureMeshBlendWeightDelta();
-        return std::abs(a - b) > delta;
-      };
-      // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.blendWeightBufs, targetBuffer, currentFrameNum, weightsDifferentEnough);
+      // Cache buffer iff new buffer differs from previous buffer, for single floats the squared distance is the squared difference
+      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.blendWeightBufs, targetBuffer, currentFrameNum,
+                            vectorsDifferentEnough<float>(RtxOptions::captureMeshBlendWeightDelta()));
     };
     AssetExporter::BufferCallback captureMeshBlendIndicesAsync = [ctx, geomData, currentFrameNum, pMesh](Rc<DxvkBuffer> inBuf) {
       assert(geomData.blendIndicesBuffer.vertexFormat() == VK_FORMAT_R8G8B8A8_USCALED);
@@ -897,12 +913,8 @@ namespace dxvk {
         }
       }
       assert(targetBuffer.size() > 0);
-      // Create comparison function that returns float
-      static auto weightsDifferentEnough = [](const int& a, const int& b) {
-        return a != b;
-      };
       // Cache buffer iff new buffer differs from previous buffer
-      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.blendIndicesBufs, targetBuffer, currentFrameNum, weightsDifferentEnough);
+      evalNewBufferAndCache(pMesh, pMesh->lssData.buffers.blendIndicesBufs, targetBuffer, currentFrameNum, buffersNotIdentical<int>);
     };
     pMesh->meshSync.numOutstandingInc();
     m_exporter.copyBufferFromGPU(ctx, geomData.blendWeightBuffer, captureMeshBlendWeightsAsync);
@@ -912,38 +924,86 @@ namespace dxvk {
     }
   }
 
-  template <typename T, typename CompareTReturnBool>
+  template <typename T, typename CompareBuffersReturnBool>
   static void GameCapturer::evalNewBufferAndCache(std::shared_ptr<Mesh> pMesh,
                                                   std::map<float, pxr::VtArray<T>>& bufferCache,
                                                   pxr::VtArray<T>& newBuffer,
                                                   const float currentFrameNum,
-                                                  CompareTReturnBool compareT) {
+                                                  CompareBuffersReturnBool compareBuffers) {
     std::lock_guard lock(pMesh->meshSync.mutex);
     // Discover whether the new buffer is worth cacheing
-    bool bSufficientlyDifferent = false;
+    bool bSufficientlyDifferent = true;
     if (bufferCache.size() > 0) {
       const auto& prevBuf = (--bufferCache.cend())->second;
       assert(newBuffer.size() == prevBuf.size());
-      for (size_t idx = 0; idx < newBuffer.size(); ++idx) {
-        const T& newVal = newBuffer[idx];
-        const T& prevVal = prevBuf[idx];
-        bSufficientlyDifferent = compareT(newVal, prevVal);
-        if (bSufficientlyDifferent) {
-          // Early out as soon as we've found enough of a difference
-          break;
-        }
-      }
-    } else {
-      bSufficientlyDifferent = true;
+      bSufficientlyDifferent = compareBuffers(newBuffer, prevBuf);
     }
     // Cache VtArray if there is a large enough delta
     if (bSufficientlyDifferent) {
       bufferCache[currentFrameNum] = std::move(newBuffer);
     }
+    spillOldSamples(*pMesh, currentFrameNum);
+    pMesh->meshSync.numOutstanding--;
+    pMesh->meshSync.cond.notify_all();
+  }
+
+  template <typename T>
+  bool GameCapturer::gatherBufferAndCompare(std::shared_ptr<Mesh> pMesh,
+                                            const std::map<float, pxr::VtArray<T>>& bufferCache,
+                                            const float* pSrc,
+                                            const size_t srcStride,
+                                            const size_t numElements,
+                                            const float delta,
+                                            pxr::VtArray<T>& newBuffer) {
+    // Copies of a VtArray share its storage, so the previous sample can be read outside of the lock
+    pxr::VtArray<T> prevBuf;
+    {
+      std::lock_guard lock(pMesh->meshSync.mutex);
+      if (bufferCache.size() > 0) {
+        prevBuf = (--bufferCache.cend())->second;
+      }
+    }
+    assert(prevBuf.empty() || prevBuf.size() == numElements);
+    newBuffer.resize(numElements);
+    constexpr uint32_t componentCount = sizeof(T) / sizeof(float);
+    return fast::copyStridedAndCompare(static_cast<uint32_t>(numElements), newBuffer.data()->data(), reinterpret_cast<const uint8_t*>(pSrc),
+                                       static_cast<uint32_t>(srcStride), componentCount,
+                                       prevBuf.empty() ? nullptr : prevBuf.cdata()->data(), delta * delta);
+  }
+
+  template <typename T>
+  void GameCapturer::cacheNewBuffer(std::shared_ptr<Mesh> pMesh,
+                                    std::map<float, pxr::VtArray<T>>& bufferCache,
+                                    pxr::VtArray<T>& newBuffer,
+                                    const float currentFrameNum,
+                                    const bool bSufficientlyDifferent) {
+    std::lock_guard lock(pMesh->meshSync.mutex);
+    if (bSufficientlyDifferent) {
+      bufferCache[currentFrameNum] = std::move(newBuffer);
+    }
+    spillOldSamples(*pMesh, currentFrameNum);
     pMesh->meshSync.numOutstanding--;
     pMesh->meshSync.cond.notify_all();
   }
 
+  void GameCapturer::spillOldSamples(Mesh& mesh, const float currentFrameNum) {
+    // Runs on the exporter thread after the readback of a sample, the latest sample of each buffer
+    // is always kept in memory as the reference for the next delta comparison
+    lss::MeshBuffers& buffers = mesh.lssData.buffers;
+    if (!buffers.spill || currentFrameNum < mesh.nextSpillFrame) {
+      return;
+    }
+    const float spillBefore = currentFrameNum - mesh.spillWindowFrames;
+    lss::spillSamplesBefore(*buffers.spill, buffers.idxBufs, buffers.spilledIdxBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.positionBufs, buffers.spilledPositionBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.normalBufs, buffers.spilledNormalBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.texcoordBufs, buffers.spilledTexcoordBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.colorBufs, buffers.spilledColorBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.blendWeightBufs, buffers.spilledBlendWeightBufs, spillBefore);
+    lss::spillSamplesBefore(*buffers.spill, buffers.blendIndicesBufs, buffers.spilledBlendIndicesBufs, spillBefore);
+    mesh.nextSpillFrame = currentFrameNum + mesh.spillWindowFrames;
+  }
+
   void GameCapturer::exportUsd(const Rc<DxvkContext> ctx) {
     assert(m_state.has<State::BeginExport>());
     assert(!m_state.has<State::PreppingExport>());
@@ -1034,6 +1094,9 @@ namespace dxvk {
       }
     }
     exportPrep.meta.bCorrectBakedTransforms = false;
+    exportPrep.meta.bParallelLayerExport = parallelLayerExport();
+    exportPrep.meta.layerFileFormat = binaryLayers() ? "usdc" : "";
+    exportPrep.meta.bShareMeshBuffers = shareMeshBuffers();
 
     exportPrep.debugId = cap.idStr;
     exportPrep.baseExportPath = BASE_DIR;
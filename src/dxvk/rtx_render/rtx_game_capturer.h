@@ -114,6 +114,24 @@ public:
                 "to all have identity xform matrices, enabling will attempt to correct this and\n"
                 "improve stage + mesh viewability in tools.\n"
                 "Hashes are unaffected.");
+  RTX_OPTION("rtx.capture", bool, parallelLayerExport, true,
+             "If true, the mesh, skeleton and material layers of a capture are written on multiple threads.\n"
+             "The instance stage is still composed on a single thread once all of them are written.");
+  RTX_OPTION("rtx.capture", bool, binaryLayers, false,
+             "If true, capture layers with the '.usd' extension are written in the binary crate format (usdc),\n"
+             "which is faster to write and smaller than the text format (usda).\n"
+             "If false, the USD default format for '.usd' files is used.");
+  RTX_OPTION("rtx.capture", bool, shareMeshBuffers, false,
+             "If true, mesh buffers (indices, points, normals and texcoords) with identical contents in several meshes\n"
+             "are written once to a shared buffer pool layer, which the mesh layers reference.\n"
+             "Reduces capture size and export time for scenes with a lot of repeated geometry.");
+  RTX_OPTION("rtx.capture", uint32_t, streamingWindowFrames, 0,
+             "If above 0, time samples older than this many capture frames are moved to a temporary file in the capture\n"
+             "directory while capturing, and read back one object at a time during export. This covers every mesh buffer\n"
+             "(indices, positions, normals, texcoords, colors, blend weights and indices) and the instance, bone, sphere\n"
+             "light and camera transforms. The latest sample of each is kept in memory, as are the per object properties\n"
+             "that are not time sampled. Bounds the memory used by long multiframe captures.\n"
+             "0 keeps every sample in memory until the capture is exported.");
 
   GameCapturer(DxvkDevice* const pDevice, SceneManager& sceneManager, AssetExporter& exporter);
   ~GameCapturer();
@@ -188,6 +206,9 @@ private:
     XXH64_hash_t     matHash;
     MeshSync         meshSync;
     AtomicOriginCalc originCalc;
+    // Streaming capture, guarded by meshSync.mutex
+    float            spillWindowFrames = 0.f;
+    float            nextSpillFrame = 0.f;
   };
 
   struct Instance {
@@ -247,12 +268,31 @@ private:
                            const RasterGeometry& geomData,
                            const float currentCaptureTime,
                            std::shared_ptr<Mesh> pMesh);
-  template <typename T, typename CompareTReturnBool>
+  template <typename T, typename CompareBuffersReturnBool>
   static void evalNewBufferAndCache(std::shared_ptr<Mesh> pMesh,
                                     std::map<float,pxr::VtArray<T>>& bufferCache,
                                     pxr::VtArray<T>& newBuffer,
                                     const float currentCaptureTime,
-                                    CompareTReturnBool compareT);
+                                    CompareBuffersReturnBool compareBuffers);
+  // Gathers strided float vectors into newBuffer and compares them against the latest cached sample in the same pass
+  template <typename T>
+  static bool gatherBufferAndCompare(std::shared_ptr<Mesh> pMesh,
+                                     const std::map<float,pxr::VtArray<T>>& bufferCache,
+                                     const float* pSrc,
+                                     const size_t srcStride,
+                                     const size_t numElements,
+                                     const float delta,
+                                     pxr::VtArray<T>& newBuffer);
+  template <typename T>
+  static void cacheNewBuffer(std::shared_ptr<Mesh> pMesh,
+                             std::map<float,pxr::VtArray<T>>& bufferCache,
+                             pxr::VtArray<T>& newBuffer,
+                             const float currentCaptureTime,
+                             const bool bSufficientlyDifferent);
+  // Moves mesh samples that left the streaming window to the capture's spill file, meshSync.mutex must be held
+  static void spillOldSamples(Mesh& mesh, const float currentCaptureTime);
+  // Moves instance, light and camera transforms that left the streaming window to the capture's spill file
+  void spillOldXformSamples();
   void exportUsd(const Rc<DxvkContext> ctx);
   struct Capture;
   static lss::Export prepExport(const Capture& cap,
@@ -291,6 +331,8 @@ private:
     float dTexcoord;
     float dColor;
     float dBlendweight;
+    // Streaming
+    uint32_t streamingWindowFrames;
   } m_options;
 
   static Options getOptions() {
@@ -304,7 +346,8 @@ private:
              RtxOptions::captureMeshNormalDelta(),
              RtxOptions::captureMeshTexcoordDelta(),
              RtxOptions::captureMeshColorDelta(),
-             RtxOptions::captureMeshBlendWeightDelta() };
+             RtxOptions::captureMeshBlendWeightDelta(),
+             streamingWindowFrames() };
   }
 
   // State
@@ -336,6 +379,9 @@ private:
     std::unordered_map<XXH64_hash_t, Material> materials;
     std::unordered_map<XXH64_hash_t, Instance> instances;
     std::unordered_map<XXH64_hash_t, uint8_t> instanceFlags;
+    // Streaming capture, null if disabled
+    std::shared_ptr<lss::SampleSpill> pSpill;
+    float nextXformSpillFrame = 0.f;
     HWND hwnd;
   };
   std::unique_ptr<Capture> m_pCap;
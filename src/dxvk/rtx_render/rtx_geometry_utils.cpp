@@ -479,7 +479,7 @@ namespace dxvk {
     // Fill out the arguments
     BakeOpacityMicromapArgs args {};
     size_t surfaceWriteOffset = 0;
-    instance.surface.writeGPUData(&args.surface[0], surfaceWriteOffset);
+    instance.surface.writeGPUData(&args.surface[0], surfaceWriteOffset, SIZE_MAX, geo.getPositionDequantization());
     args.numTriangles = desc.numTriangles;
     args.numMicroTrianglesPerTriangle = desc.numMicroTrianglesPerTriangle;
     args.is2StateOMMFormat = desc.ommFormat == VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT;
@@ -740,16 +740,16 @@ namespace dxvk {
   void RtxGeometryUtils::processGeometryBuffers(const InterleavedGeometryDescriptor& desc, RaytraceGeometry& output) {
     const DxvkBufferSlice targetSlice = DxvkBufferSlice(desc.buffer);
 
-    output.positionBuffer = RaytraceBuffer(targetSlice, desc.positionOffset, desc.stride, VK_FORMAT_R32G32B32_SFLOAT);
+    output.positionBuffer = RaytraceBuffer(targetSlice, desc.positionOffset, desc.stride, desc.positionFormat);
 
     if (desc.hasNormals)
-      output.normalBuffer = RaytraceBuffer(targetSlice, desc.normalOffset, desc.stride, VK_FORMAT_R32G32B32_SFLOAT);
+      output.normalBuffer = RaytraceBuffer(targetSlice, desc.normalOffset, desc.stride, desc.normalFormat);
 
     if (desc.hasTexcoord)
-      output.texcoordBuffer = RaytraceBuffer(targetSlice, desc.texcoordOffset, desc.stride, VK_FORMAT_R32G32_SFLOAT);
+      output.texcoordBuffer = RaytraceBuffer(targetSlice, desc.texcoordOffset, desc.stride, desc.texcoordFormat);
 
     if (desc.hasColor0) 
-      output.color0Buffer = RaytraceBuffer(targetSlice, desc.color0Offset, desc.stride, VK_FORMAT_B8G8R8A8_UNORM);
+      output.color0Buffer = RaytraceBuffer(targetSlice, desc.color0Offset, desc.stride, desc.color0Format);
   }
 
   void RtxGeometryUtils::processGeometryBuffers(const RasterGeometry& input, RaytraceGeometry& output) {
@@ -767,25 +767,54 @@ namespace dxvk {
       output.color0Buffer = RaytraceBuffer(slice, input.color0Buffer.offsetFromSlice(), input.color0Buffer.stride(), input.color0Buffer.vertexFormat());
   }
 
-  size_t RtxGeometryUtils::computeOptimalVertexStride(const RasterGeometry& input) {
-    // Calculate stride
-    size_t stride = sizeof(float) * 3; // position is the minimum
+  void RtxGeometryUtils::computeInterleavedLayout(const RasterGeometry& input, InterleavedGeometryDescriptor& layout) {
+    uint32_t offset = 0;
 
-    if (input.normalBuffer.defined()) {
-      stride += sizeof(float) * 3;
+    // Position is the minimum
+    layout.positionOffset = offset;
+    if (interleaver::isQuantizedPositionFormat(input.positionBuffer.vertexFormat())) {
+      layout.positionFormat = VK_FORMAT_R16G16B16A16_SNORM;
+      offset += sizeof(uint16_t) * 4;
+    } else {
+      layout.positionFormat = VK_FORMAT_R32G32B32_SFLOAT;
+      offset += sizeof(float) * 3;
+    }
+
+    layout.hasNormals = input.normalBuffer.defined();
+    if (layout.hasNormals) {
+      layout.normalOffset = offset;
+      if (interleaver::isOctahedralNormalFormat(input.normalBuffer.vertexFormat())) {
+        layout.normalFormat = VK_FORMAT_R32_UINT;
+        offset += sizeof(uint32_t);
+      } else {
+        layout.normalFormat = VK_FORMAT_R32G32B32_SFLOAT;
+        offset += sizeof(float) * 3;
+      }
     }
 
-    if (input.texcoordBuffer.defined()) {
-      stride += sizeof(float) * 2;
+    layout.hasTexcoord = input.texcoordBuffer.defined();
+    if (layout.hasTexcoord) {
+      layout.texcoordOffset = offset;
+      layout.texcoordFormat = VK_FORMAT_R32G32_SFLOAT;
+      offset += sizeof(float) * 2;
     }
 
-    if (input.color0Buffer.defined()) {
-      stride += sizeof(uint32_t);
+    layout.hasColor0 = input.color0Buffer.defined();
+    if (layout.hasColor0) {
+      layout.color0Offset = offset;
+      layout.color0Format = VK_FORMAT_B8G8R8A8_UNORM;
+      offset += sizeof(uint32_t);
     }
 
-    assert(stride <= kMaxInterleavedComponents * sizeof(float) && "Maximum number of interleaved components needs update.");
+    layout.stride = offset;
 
-    return stride;
+    assert(layout.stride <= kMaxInterleavedComponents * sizeof(float) && "Maximum number of interleaved components needs update.");
+  }
+
+  size_t RtxGeometryUtils::computeOptimalVertexStride(const RasterGeometry& input) {
+    InterleavedGeometryDescriptor layout;
+    computeInterleavedLayout(input, layout);
+    return layout.stride;
   }
 
   void RtxGeometryUtils::cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output) {
@@ -813,8 +842,8 @@ namespace dxvk {
     // Required
     assert(input.positionBuffer.defined());
 
-    // Calculate stride
-    output.stride = computeOptimalVertexStride(input);
+    // Calculate stride, offsets and formats
+    computeInterleavedLayout(input, output);
     
     assert(output.buffer->info().size == align(output.stride * input.vertexCount, CACHE_LINE_SIZE));
 
@@ -826,7 +855,7 @@ namespace dxvk {
     args.positionOffset = input.positionBuffer.offsetFromSlice() / 4;
     args.positionStride = input.positionBuffer.stride() / 4;
     args.positionFormat = input.positionBuffer.vertexFormat();
-    if (!interleaver::formatConversionFloatSupported(args.positionFormat)) {
+    if (!interleaver::formatConversionFloatSupported(args.positionFormat) && !interleaver::isQuantizedPositionFormat(args.positionFormat)) {
       ONCE(Logger::err(str::format("[rtx-interleaver] Unsupported position buffer format (", args.positionFormat, ")")));
       return;
     }
@@ -837,7 +866,7 @@ namespace dxvk {
       args.normalOffset = input.normalBuffer.offsetFromSlice() / 4;
       args.normalStride = input.normalBuffer.stride() / 4;
       args.normalFormat = input.normalBuffer.vertexFormat();
-      if (!interleaver::formatConversionFloatSupported(args.normalFormat)) {
+      if (!interleaver::formatConversionFloatSupported(args.normalFormat) && !interleaver::isOctahedralNormalFormat(args.normalFormat)) {
         ONCE(Logger::warn(str::format("[rtx-interleaver] Unsupported normal buffer format (", args.normalFormat, "), skipping normals")));
       }
     }
@@ -894,54 +923,42 @@ namespace dxvk {
     } else {
       float dst[kNumVerticesToProcessOnCPU * kMaxInterleavedComponents];
 
-      GeometryBufferData inputData(input);
+      // Note: Mapped directly rather than through GeometryBufferData, the interleaver decodes compact formats itself
+      const auto mapVertexData = [](const RasterBuffer& buffer) {
+        return buffer.defined() ? buffer.mapPtr((size_t) buffer.offsetFromSlice()) : nullptr;
+      };
 
-      // Don't need these in CPU path as GeometryBufferData handles the offset
+      // Don't need these in CPU path as the mapped pointers already include the offset
       args.positionOffset = 0;
       args.normalOffset = 0;
       args.texcoordOffset = 0;
       args.color0Offset = 0;
 
+      const float* positionData = static_cast<const float*>(mapVertexData(input.positionBuffer));
+      const float* normalData = static_cast<const float*>(mapVertexData(input.normalBuffer));
+      const float* texcoordData = static_cast<const float*>(mapVertexData(input.texcoordBuffer));
+      const uint32_t* color0Data = static_cast<const uint32_t*>(mapVertexData(input.color0Buffer));
+
       for (uint32_t i = 0; i < input.vertexCount; i++) {
-        interleaver::interleave(i, dst, inputData.positionData, inputData.normalData, inputData.texcoordData, inputData.vertexColorData, args);
+        interleaver::interleave(i, dst, positionData, normalData, texcoordData, color0Data, args);
       }
 
       ctx->writeToBuffer(output.buffer, 0, input.vertexCount * output.stride, dst);
     }
-
-    uint32_t offset = 0;
-
-    output.positionOffset = offset;
-    offset += sizeof(float) * 3;
-
-    if (input.normalBuffer.defined()) {
-      output.hasNormals = true;
-      output.normalOffset = offset;
-      offset += sizeof(float) * 3;
-    }
-
-    if (input.texcoordBuffer.defined()) {
-      output.hasTexcoord = true;
-      output.texcoordOffset = offset;
-      offset += sizeof(float) * 2;
-    }
-
-    if (input.color0Buffer.defined()) {
-      output.hasColor0 = true;
-      output.color0Offset = offset;
-      offset += sizeof(uint32_t);
-    }
   }
 
   float RtxGeometryUtils::computeMaxUVTileSize(const RasterGeometry& input, const Matrix4& objectToWorld) {
     ScopedCpuProfileZone();
 
-    const void* pVertexData = input.positionBuffer.mapPtr((size_t)input.positionBuffer.offsetFromSlice());
+    // Note: Compact replacement streams are read through their decoded float copies
+    const GeometryBufferData bufferData(input);
+
+    const void* pVertexData = bufferData.positionData;
     const uint32_t vertexCount = input.vertexCount;
-    const size_t vertexStride = input.positionBuffer.stride();
+    const size_t vertexStride = bufferData.positionStride * sizeof(float);
     
-    const void* pTexcoordData = input.texcoordBuffer.mapPtr((size_t)input.texcoordBuffer.offsetFromSlice());
-    const size_t texcoordStride = input.texcoordBuffer.stride();
+    const void* pTexcoordData = bufferData.texcoordData;
+    const size_t texcoordStride = bufferData.texcoordStride * sizeof(float);
 
     const void* pIndexData = input.indexBuffer.mapPtr((size_t)input.indexBuffer.offsetFromSlice());
     const uint32_t indexCount = input.indexCount;
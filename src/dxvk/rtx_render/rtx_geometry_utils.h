@@ -141,16 +141,22 @@ namespace dxvk {
       const TextureRef& colorOpacityTexture,
       const std::vector<TextureConversionInfo>& conversionInfos);
 
+    // Layout of the interleaved vertex data the RT pipeline consumes. Texcoords are always expanded to 32 bit
+    // floats, quantized positions and octahedral normals are kept in their encoding.
     struct InterleavedGeometryDescriptor {
       Rc<DxvkBuffer> buffer = nullptr;
       uint32_t stride = 0;
       uint32_t positionOffset = 0;
+      VkFormat positionFormat = VK_FORMAT_R32G32B32_SFLOAT;
       bool hasNormals = false;
       uint32_t normalOffset = 0;
+      VkFormat normalFormat = VK_FORMAT_R32G32B32_SFLOAT;
       bool hasTexcoord = false;
       uint32_t texcoordOffset = 0;
+      VkFormat texcoordFormat = VK_FORMAT_R32G32_SFLOAT;
       bool hasColor0 = false;
       uint32_t color0Offset = 0;
+      VkFormat color0Format = VK_FORMAT_B8G8R8A8_UNORM;
     };
 
     // Helpers for promoting Geometry Snapshots from raster pipeline to Geometry Data for RT pipeline
@@ -162,6 +168,7 @@ namespace dxvk {
     // Vertex related:
     static void processGeometryBuffers(const InterleavedGeometryDescriptor& desc, RaytraceGeometry& output);
     static void processGeometryBuffers(const RasterGeometry& input, RaytraceGeometry& output);
+    static void computeInterleavedLayout(const RasterGeometry& input, InterleavedGeometryDescriptor& layout);
     static size_t computeOptimalVertexStride(const RasterGeometry& input);
     static void cacheVertexDataOnGPU(const Rc<DxvkContext>& ctx, const RasterGeometry& input, RaytraceGeometry& output);
     
@@ -135,6 +135,7 @@ namespace dxvk {
        m_frameLastUpdated
        m_frameCreated
        m_isCreatedByRenderer
+       m_handle
        m_spatialCacheHash
        m_primInstanceOwner
        buildGeometries
@@ -150,7 +151,7 @@ namespace dxvk {
   namespace {
     template<int RtInstanceSize> struct CheckRtInstanceSize {
       // The second line of the build error should contain the new size of RtInstance in the template argument, i.e. `dxvk::CheckRtInstanceSize<newSize>`
-      static_assert(RtInstanceSize == 728, "RtInstance size has changed.  Fix the copy constructor above this message, then update the expected size.");
+      static_assert(RtInstanceSize == 736, "RtInstance size has changed.  Fix the copy constructor above this message, then update the expected size.");
     };
     CheckRtInstanceSize<sizeof(RtInstance)> _rtInstanceSizeTest;
   }
@@ -469,7 +470,7 @@ namespace dxvk {
   void InstanceManager::clear() {
     for (RtInstance* instance : m_instances) {
       removeInstance(instance);
-      delete instance;
+      m_instancePool.free(instance);
     }
 
     m_instances.clear();
@@ -477,10 +478,23 @@ namespace dxvk {
     m_playerModelInstances.clear();
   }  
 
-  void InstanceManager::garbageCollection() {
+  bool InstanceManager::shouldCollectInstance(const RtInstance& instance, uint32_t currentFrameIdx, bool forceGarbageCollection) {
     // Can be configured per game: 'rtx.numFramesToKeepInstances'
     const uint32_t numFramesToKeepInstances = RtxOptions::numFramesToKeepInstances();
-    
+
+    const bool enableGarbageCollection =
+      !RtxOptions::AntiCulling::isObjectAntiCullingEnabled() || // It's always True if anti-culling is disabled
+      (instance.m_isInsideFrustum) ||
+      (instance.getBlas()->input.getSkinningState().numBones > 0) ||
+      (instance.m_isAnimated) ||
+      (instance.m_isPlayerModel);
+
+    return ((forceGarbageCollection || enableGarbageCollection) &&
+            instance.m_frameLastUpdated + numFramesToKeepInstances <= currentFrameIdx) ||
+           instance.m_isMarkedForGC;
+  }
+
+  void InstanceManager::garbageCollection() {
     // Remove instances past their lifetime or marked for GC explicitly
     const uint32_t currentFrame = m_device->getCurrentFrameId();
 
@@ -498,16 +512,7 @@ namespace dxvk {
       RtInstance*& pInstance = m_instances[i];
       assert(pInstance != nullptr);
 
-      const bool enableGarbageCollection =
-        !RtxOptions::AntiCulling::isObjectAntiCullingEnabled() || // It's always True if anti-culling is disabled
-        (pInstance->m_isInsideFrustum) ||
-        (pInstance->getBlas()->input.getSkinningState().numBones > 0) ||
-        (pInstance->m_isAnimated) ||
-        (pInstance->m_isPlayerModel);
-
-      if (((forceGarbageCollection || enableGarbageCollection) &&
-           pInstance->m_frameLastUpdated + numFramesToKeepInstances <= currentFrame) ||
-          pInstance->m_isMarkedForGC) {
+      if (shouldCollectInstance(*pInstance, currentFrame, forceGarbageCollection)) {
         // Note: Pop and swap for performance, index not incremented to process swapped instance on next iteration
         removeInstance(pInstance);
 
@@ -516,7 +521,7 @@ namespace dxvk {
 
         m_instances[i]->m_instanceVectorId = i;
 
-        delete m_instances.back();
+        m_instancePool.free(m_instances.back());
 
         // Remove the last element
         m_instances.pop_back();
@@ -538,6 +543,7 @@ namespace dxvk {
   RtInstance* InstanceManager::processSceneObject(
     const CameraManager& cameraManager, const RayPortalManager& rayPortalManager,
     BlasEntry& blas, const DrawCallState& drawCall, MaterialData& materialData, RtInstance* existingInstance) {
+    assert((existingInstance == nullptr || isInstanceLive(existingInstance)) && "Stale RtInstance pointer passed to the InstanceManager.");
 
     // If the RtInstance represents multiple instances, use the full transform of the first copy for the spatial map.
     // this prevents a bad de-duplication when the same replacement asset is used in multiple GeomPointInstancer prims.
@@ -771,109 +777,166 @@ namespace dxvk {
   }
 
   RtInstance* InstanceManager::findSimilarInstance(BlasEntry& blas, const MaterialData& material, const Matrix4& firstInstanceObjectToWorld, CameraType::Enum cameraType, const RayPortalManager& rayPortalManager) {
+    const SimilarInstanceQuery query { material.getHash(), firstInstanceObjectToWorld, cameraType };
+    RtInstance* result = nullptr;
+    findSimilarInstances(blas, &query, 1, m_device->getCurrentFrameId(), &rayPortalManager, &result);
+    assert((result == nullptr || isInstanceLive(result)) && "Spatial map holds a stale RtInstance pointer.");
+    return result;
+  }
+
+  void InstanceManager::findSimilarInstances(const BlasEntry& blas, const SimilarInstanceQuery* queries, size_t count, uint32_t currentFrameIdx,
+                                             const RayPortalManager* rayPortalManager, RtInstance** outInstances) {
+    std::fill(outInstances, outInstances + count, nullptr);
 
     // Disable temporal correlation between instances so that duplicate instances are not created
     // should a developer option change instance enough for it not to match anymore
     if (RtxOptions::enableInstanceDebuggingTools()) {
-      return nullptr;
+      return;
     }
 
-    RtInstance* result = nullptr;
-
-    const uint32_t currentFrameIdx = m_device->getCurrentFrameId();
-    const Vector3 worldPosition = blas.input.getGeometryData().boundingBox.getTransformedCentroid(firstInstanceObjectToWorld);
-    
+    const BlasEntry::InstanceMap& spatialMap = blas.getSpatialMap();
     const float uniqueObjectDistanceSqr = RtxOptions::getUniqueObjectDistanceSqr();
 
-    RtInstance* pSimilar = nullptr;
-    float nearestDistSqr = FLT_MAX;
+    // Search for exact matches first, everything else goes into the batched nearest search
+    std::vector<uint32_t> pending;
+    std::vector<Vector3> pendingPositions;
+    for (uint32_t i = 0; i < count; ++i) {
+      outInstances[i] = const_cast<RtInstance*>(spatialMap.getDataAtTransform(queries[i].firstInstanceObjectToWorld));
+      if (outInstances[i] == nullptr) {
+        pending.push_back(i);
+        pendingPositions.push_back(blas.input.getGeometryData().boundingBox.getTransformedCentroid(queries[i].firstInstanceObjectToWorld));
+      }
+    }
+    if (pending.empty()) {
+      return;
+    }
+
+    // Filter out instances by returning false if the instance:
+    // - has already been updated this frame
+    // - doesn't use the same material
+    // - is a sub prim of a replacement instance
+    const auto isCandidate = [currentFrameIdx](const RtInstance* instance, const SimilarInstanceQuery& query) {
+      return instance->m_frameLastUpdated != currentFrameIdx && instance->m_materialHash == query.materialHash && !instance->m_primInstanceOwner.isSubPrim();
+    };
 
-    // Search the BLAS for an instance matching ours
-    {
-      // Search for an exact match
-      result = const_cast<RtInstance*>(blas.getSpatialMap().getDataAtTransform(firstInstanceObjectToWorld));
-      if (result != nullptr) {
-        return result;
+    // No exact match, so find the closest match in the region
+    // (need to check a 2x2x2 patch of cells to account for positions close to a border)
+    std::vector<const RtInstance*> nearest(pending.size());
+    std::vector<float> nearestDistSqr(pending.size());
+    spatialMap.getNearestDataBatch(pendingPositions.data(), pending.size(), uniqueObjectDistanceSqr,
+      [&](size_t p, const RtInstance* instance) { return isCandidate(instance, queries[pending[p]]); },
+      nearest.data(), nearestDistSqr.data());
+
+    // Queries are answered independently, while draw calls processed one by one would see the instance updated by
+    // an earlier match. An instance matched by several queries stays with the closest one (the earliest on a tie),
+    // the others search again without the instances already taken.
+    if (pending.size() > 1) {
+      std::unordered_map<const RtInstance*, size_t> owners;
+      for (size_t p = 0; p < pending.size(); ++p) {
+        if (nearest[p] == nullptr) {
+          continue;
+        }
+        auto [owner, inserted] = owners.emplace(nearest[p], p);
+        if (!inserted && nearestDistSqr[p] < nearestDistSqr[owner->second]) {
+          owner->second = p;
+        }
       }
-      
-      // No exact match, so find the closest match in the region
-      // (need to check a 2x2x2 patch of cells to account for positions close to a border)
-      result = const_cast<RtInstance*>(blas.getSpatialMap().getNearestData(worldPosition, uniqueObjectDistanceSqr, nearestDistSqr,
-        [&] (const RtInstance* instance) {
-          // Filter out instances by returning false if the instance:
-          // - has already been updated this frame
-          // - doesn't use the same material
-          // - is a sub prim of a replacement instance
-          return instance->m_frameLastUpdated != currentFrameIdx && instance->m_materialHash == material.getHash() && !instance->m_primInstanceOwner.isSubPrim();
+      for (size_t p = 0; p < pending.size(); ++p) {
+        if (nearest[p] == nullptr || owners[nearest[p]] == p) {
+          continue;
+        }
+        nearest[p] = spatialMap.getNearestData(pendingPositions[p], uniqueObjectDistanceSqr, nearestDistSqr[p],
+          [&](const RtInstance* instance) { return isCandidate(instance, queries[pending[p]]) && owners.find(instance) == owners.end(); });
+        if (nearest[p] != nullptr) {
+          owners.emplace(nearest[p], p);
         }
-      ));
-      if (nearestDistSqr == 0.0f && result != nullptr) {
-        // Not going to find anything closer
-        return result;
       }
     }
 
-    // For portal gun and other objects that were drawn in the ViewModel, need to check the
-    // virtual version of the instance from previous frame.
-    if (nearestDistSqr > 0.0f &&
-        cameraType == CameraType::ViewModel && 
-        RtxOptions::useRayPortalVirtualInstanceMatching() ) {
-      const Matrix4* teleportMatrix = nullptr;
-      for (const RtInstance* instance : blas.getLinkedInstances()) {
-        if (instance->m_frameLastUpdated != currentFrameIdx - 1 || 
-            instance->m_materialHash != material.getHash()) {
-          continue;
-        }
+    for (size_t p = 0; p < pending.size(); ++p) {
+      const SimilarInstanceQuery& query = queries[pending[p]];
+      const Vector3& worldPosition = pendingPositions[p];
+      RtInstance* result = const_cast<RtInstance*>(nearest[p]);
+      float nearestDist = result != nullptr ? nearestDistSqr[p] : FLT_MAX;
+
+      // For portal gun and other objects that were drawn in the ViewModel, need to check the
+      // virtual version of the instance from previous frame.
+      if (nearestDist > 0.0f &&
+          rayPortalManager != nullptr &&
+          query.cameraType == CameraType::ViewModel && 
+          RtxOptions::useRayPortalVirtualInstanceMatching() ) {
+        const Matrix4* teleportMatrix = nullptr;
+        for (const RtInstance* instance : blas.getLinkedInstances()) {
+          if (instance->m_frameLastUpdated != currentFrameIdx - 1 || 
+              instance->m_materialHash != query.materialHash) {
+            continue;
+          }
+          
+          // Compare against virtual position of a predicted instance's position in the current frame
+          const Vector3& prevPrevInstanceWorldPosition = instance->getPrevWorldPosition();
+          const Vector3& prevInstanceWorldPosition = instance->getWorldPosition();
+          const Vector3 predictedInstanceWorldPosition = prevInstanceWorldPosition +
+            (prevInstanceWorldPosition - prevPrevInstanceWorldPosition);
         
-        // Compare against virtual position of a predicted instance's position in the current frame
-        const Vector3& prevPrevInstanceWorldPosition = instance->getPrevWorldPosition();
-        const Vector3& prevInstanceWorldPosition = instance->getWorldPosition();
-        const Vector3 predictedInstanceWorldPosition = prevInstanceWorldPosition +
-          (prevInstanceWorldPosition - prevPrevInstanceWorldPosition);
-      
-        // Check all portal pairs
-        for (auto& rayPortalPair : rayPortalManager.getRayPortalPairInfos()) {
-          if (rayPortalPair.has_value()) {
-            for (uint32_t i = 0; i < 2; i++) {
-              const auto& rayPortal = rayPortalPair->pairInfos[i];
-
-              const Vector3 virtualPredictedInstanceWorldPosition =
-                rayPortalManager.getVirtualPosition(predictedInstanceWorldPosition, rayPortal.portalToOpposingPortalDirection);
-
-              // Distance of the object from the predicted virtual position of an instance
-              const float virtualDistSqr = lengthSqr(virtualPredictedInstanceWorldPosition - worldPosition);
-
-              // Is the instance is similar, and within range?  We already know the BLAS is shared, due to the for loop
-              if (virtualDistSqr <= uniqueObjectDistanceSqr && virtualDistSqr < nearestDistSqr) {
-                nearestDistSqr = virtualDistSqr;
-                result = const_cast<RtInstance*>(instance);
-                teleportMatrix = &rayPortal.portalToOpposingPortalDirection;
-                if (virtualDistSqr == 0.0f) {
-                  // Not going to find anything closer.
-                  break;
+          // Check all portal pairs
+          for (auto& rayPortalPair : rayPortalManager->getRayPortalPairInfos()) {
+            if (rayPortalPair.has_value()) {
+              for (uint32_t i = 0; i < 2; i++) {
+                const auto& rayPortal = rayPortalPair->pairInfos[i];
+
+                const Vector3 virtualPredictedInstanceWorldPosition =
+                  rayPortalManager->getVirtualPosition(predictedInstanceWorldPosition, rayPortal.portalToOpposingPortalDirection);
+
+                // Distance of the object from the predicted virtual position of an instance
+                const float virtualDistSqr = lengthSqr(virtualPredictedInstanceWorldPosition - worldPosition);
+
+                // Is the instance is similar, and within range?  We already know the BLAS is shared, due to the for loop
+                if (virtualDistSqr <= uniqueObjectDistanceSqr && virtualDistSqr < nearestDist) {
+                  nearestDist = virtualDistSqr;
+                  result = const_cast<RtInstance*>(instance);
+                  teleportMatrix = &rayPortal.portalToOpposingPortalDirection;
+                  if (virtualDistSqr == 0.0f) {
+                    // Not going to find anything closer.
+                    break;
+                  }
                 }
               }
             }
           }
         }
+        
+        // If the match was against a virtual equivalent of the instance from previous frame, 
+        // update the instance's transform to that of the virtual one
+        if (teleportMatrix) {
+          result->teleportWithHistory(*teleportMatrix);
+        }
       }
-      
-      // If the match was against a virtual equivalent of the instance from previous frame, 
-      // update the instance's transform to that of the virtual one
-      if (teleportMatrix) {
-        result->teleportWithHistory(*teleportMatrix);
-      }
+
+      outInstances[pending[p]] = result;
     }
+  }
 
+  void InstanceManager::updateInstanceMaterialHash(RtInstance& instance, XXH64_hash_t materialHash) {
+    instance.surface.hasMaterialChanged = instance.m_materialHash != kEmptyHash && instance.m_materialHash != materialHash;
+    instance.m_materialHash = materialHash;
+  }
 
-    return result; 
+  bool InstanceManager::updateInstanceTransform(RtInstance& instance, const Matrix4& objectToWorld, uint32_t currentFrameIdx, bool isFirstUpdateThisFrame) {
+    // Update the transform based on what state we're in
+    if (instance.isCreatedThisFrame(currentFrameIdx) && isFirstUpdateThisFrame) {
+      return instance.teleport(objectToWorld);
+    } else if (isFirstUpdateThisFrame) {
+      return instance.move(objectToWorld);
+    } else {
+      return instance.moveAgain(objectToWorld);
+    }
   }
 
   RtInstance* InstanceManager::addInstance(BlasEntry& blas) {
     const uint32_t currentFrameIdx = m_device->getCurrentFrameId();
 
     const uint32_t instanceIdx = m_instances.size();
-    RtInstance* newInst = new RtInstance(m_nextInstanceId++, instanceIdx);
+    RtInstance* newInst = allocateInstance(m_nextInstanceId++, instanceIdx);
     m_instances.push_back(newInst);
 
     RtInstance* currentInstance = m_instances[instanceIdx];
@@ -901,6 +964,20 @@ namespace dxvk {
     return currentInstance;
   }
 
+  RtInstance* InstanceManager::allocateInstance(const uint64_t id, uint32_t instanceVectorId) {
+    SlabHandle handle;
+    RtInstance* instance = m_instancePool.allocate(handle, id, instanceVectorId);
+    instance->m_handle = handle;
+    return instance;
+  }
+
+  RtInstance* InstanceManager::allocateInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId) {
+    SlabHandle handle;
+    RtInstance* instance = m_instancePool.allocate(handle, src, id, instanceVectorId);
+    instance->m_handle = handle;
+    return instance;
+  }
+
   // Creates a copy of an instance
   // If the copy is temporary and is not tracked via callbacks/externally, it doesn't need
   // a valid unique instance ID. In that case, set generateValidID to false to avoid overflowing the ID value
@@ -909,7 +986,7 @@ namespace dxvk {
     const uint32_t instanceIdx = m_instances.size();
 
     uint64_t id = generateValidID ? m_nextInstanceId++ : kInvalidInstanceId;
-    RtInstance* newInstance = new RtInstance(reference, id, instanceIdx);
+    RtInstance* newInstance = allocateInstance(reference, id, instanceIdx);
     newInstance->m_isCreatedByRenderer = true;
     m_instances.push_back(newInstance);
 
@@ -920,6 +997,7 @@ namespace dxvk {
     currentInstance.surface.positionBufferIndex = blas.modifiedGeometryData.positionBufferIndex;
     currentInstance.surface.positionOffset = blas.modifiedGeometryData.positionBuffer.offsetFromSlice();
     currentInstance.surface.positionStride = blas.modifiedGeometryData.positionBuffer.stride();
+    currentInstance.surface.hasQuantizedPositions = blas.modifiedGeometryData.hasQuantizedPositions();
     currentInstance.surface.normalBufferIndex = blas.modifiedGeometryData.normalBufferIndex;
     currentInstance.surface.normalOffset = blas.modifiedGeometryData.normalBuffer.offsetFromSlice();
     currentInstance.surface.normalStride = blas.modifiedGeometryData.normalBuffer.stride();
@@ -1026,10 +1104,8 @@ namespace dxvk {
 
         currentInstance.m_materialType = materialData.getType();
 
-        const XXH64_hash_t materialInstanceHash = materialData.getHash();
         currentInstance.m_materialDataHash = drawCall.getMaterialData().getHash();
-        currentInstance.surface.hasMaterialChanged = currentInstance.m_materialHash != kEmptyHash && currentInstance.m_materialHash != materialInstanceHash;
-        currentInstance.m_materialHash = materialInstanceHash;
+        updateInstanceMaterialHash(currentInstance, materialData.getHash());
 
         currentInstance.m_texcoordHash = drawCall.getGeometryData().hashes[HashComponents::VertexTexcoord];
         currentInstance.m_indexHash = drawCall.getGeometryData().hashes[HashComponents::Indices];
@@ -1121,7 +1197,6 @@ namespace dxvk {
                                    || currentInstance.testCategoryFlags(InstanceCategories::WorldUI);
 
         hasPreviousPositions = blas.modifiedGeometryData.previousPositionBuffer.defined() && !isMotionUnstable;
-        const bool isFirstUpdateAfterCreation = currentInstance.isCreatedThisFrame(m_device->getCurrentFrameId()) && isFirstUpdateThisFrame;
 
         // Note: objectToView is aliased on updates, since findSimilarInstance() doesn't discern it
         Matrix4 objectToWorld = drawCall.getTransformData().objectToWorld;
@@ -1134,14 +1209,7 @@ namespace dxvk {
           objectToWorld[3] += objectToWorld[2] * worldSpaceUiBackgroundOffset;
         }
 
-        // Update the transform based on what state we're in
-        if (isFirstUpdateAfterCreation) {
-          hasTransformChanged = currentInstance.teleport(objectToWorld);
-        } else if (isFirstUpdateThisFrame) {
-          hasTransformChanged = currentInstance.move(objectToWorld);
-        } else {
-          hasTransformChanged = currentInstance.moveAgain(objectToWorld);
-        }
+        hasTransformChanged = updateInstanceTransform(currentInstance, objectToWorld, m_device->getCurrentFrameId(), isFirstUpdateThisFrame);
 
         currentInstance.surface.textureTransform = drawCall.getTransformData().textureTransform;
 
@@ -1364,7 +1432,10 @@ namespace dxvk {
       } else {
         ONCE(Logger::info("[RTX-Compatibility-Info] Unexpected values in the perspective-corrected transform of a view model. Fallback to geometry modification"));
         // Only need to run this on BVH op (maybe this could be moved to geometry processing?)
-        if (viewModelInstance->getBlas()->frameLastUpdated == frameId) {
+        // Note: The correction writes float positions, quantized meshes are left uncorrected rather than corrupted
+        if (viewModelInstance->getBlas()->modifiedGeometryData.hasQuantizedPositions()) {
+          ONCE(Logger::warn("[RTX-Compatibility-Info] View model geometry modification is not supported for meshes with quantized positions, disable rtx.compactReplacementVertexFormat for this content"));
+        } else if (viewModelInstance->getBlas()->frameLastUpdated == frameId) {
           const auto worldToObject = inverse(reference.getTransform());
           const auto instancePositionTransform = worldToObject * perspectiveCorrection * reference.getTransform();
 
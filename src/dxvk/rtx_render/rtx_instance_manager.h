@@ -29,6 +29,7 @@
 #include "rtx_types.h"
 #include "../util/util_vector.h"
 #include "../util/util_matrix.h"
+#include "../util/util_slab_pool.h"
 #include "rtx_camera_manager.h"
 #include "dxvk_cmdlist.h"
 #include "rtx_opacity_micromap_manager.h"
@@ -51,6 +52,8 @@ public:
 
   uint64_t getId() const { return m_id; }
   uint32_t getVectorIdx() const { return m_instanceVectorId; }
+  // Generation checked handle to this instance, resolve it with InstanceManager::resolveInstance()
+  const SlabHandle& getHandle() const { return m_handle; }
   const VkAccelerationStructureInstanceKHR& getVkInstance() const { return m_vkInstance; }
   VkAccelerationStructureInstanceKHR& getVkInstance() { return m_vkInstance; }
   bool isObjectToWorldMirrored() const { return m_isObjectToWorldMirrored; }
@@ -173,6 +176,7 @@ private:
   // most notably the GameCapturer
   const uint64_t m_id;
   mutable uint32_t m_instanceVectorId; // Index within instance vector in instance manager
+  SlabHandle m_handle;                 // Handle within the instance manager's instance pool
 
   mutable bool m_isMarkedForGC = false;
   mutable bool m_isUnlinkedForGC = false;
@@ -280,6 +284,12 @@ public:
 
   // Returns the active number of instances in scene
   const uint32_t getActiveCount() const { return m_instances.size(); }
+
+  // Returns the instance referenced by the handle, or nullptr if that instance has since been destroyed
+  RtInstance* resolveInstance(const SlabHandle& handle) const { return m_instancePool.get(handle); }
+
+  // Returns true if the pointer refers to an instance which is still alive. Intended for validating cached pointers.
+  bool isInstanceLive(const RtInstance* instance) const { return m_instancePool.isLive(instance); }
   
   void onFrameEnd();
 
@@ -326,6 +336,27 @@ public:
   void resetSurfaceIndices();
 
   const std::vector<IntersectionBillboard>& getBillboards() const { return m_billboards; }
+
+  // Inputs of a single instance matching query, see findSimilarInstances()
+  struct SimilarInstanceQuery {
+    XXH64_hash_t materialHash;
+    Matrix4 firstInstanceObjectToWorld;
+    CameraType::Enum cameraType;
+  };
+
+  // Finds the "closest" matching instance of `blas` for each query and writes it (or null if not found) to `outInstances`.
+  // The nearest searches run as one batched spatial map query, and no instance is matched by more than one nearest search.
+  // Doesn't need a device. Ray portal virtual instance matching is skipped when `rayPortalManager` is null.
+  static void findSimilarInstances(const BlasEntry& blas, const SimilarInstanceQuery* queries, size_t count, uint32_t currentFrameIdx,
+                                   const RayPortalManager* rayPortalManager, RtInstance** outInstances);
+
+  // The parts of updateInstance() and garbageCollection() that instance matching depends on. Don't need a device.
+  // Sets the material hash findSimilarInstances() filters on, and flags a material change on the surface.
+  static void updateInstanceMaterialHash(RtInstance& instance, XXH64_hash_t materialHash);
+  // Moves the instance (and its spatial map entry) to a draw call's transform, returns true if the transform changed.
+  static bool updateInstanceTransform(RtInstance& instance, const Matrix4& objectToWorld, uint32_t currentFrameIdx, bool isFirstUpdateThisFrame);
+  // Returns true if the instance is past its lifetime or marked for garbage collection.
+  static bool shouldCollectInstance(const RtInstance& instance, uint32_t currentFrameIdx, bool forceGarbageCollection);
   
 private:
   ResourceCache* m_pResourceCache;
@@ -333,6 +364,9 @@ private:
   // Start at 1 to avoid using 0 - makes it easier to detect a 0 initialized RtInstance (which is invalid)
   uint64_t m_nextInstanceId = 1;
 
+  // Backing storage for all instances. Instances are allocated from fixed size slabs, so pointers remain
+  // stable, memory is recycled without going back to the heap and stale pointers/handles can be detected.
+  SlabPool<RtInstance> m_instancePool;
   std::vector<RtInstance*> m_instances; 
   std::vector<RtInstance*> m_viewModelCandidates;
   std::vector<RtInstance*> m_playerModelInstances;
@@ -364,6 +398,9 @@ private:
 
   void removeInstance(RtInstance* instance);
 
+  RtInstance* allocateInstance(const uint64_t id, uint32_t instanceVectorId);
+  RtInstance* allocateInstance(const RtInstance& src, uint64_t id, uint32_t instanceVectorId);
+
   static RtSurface::AlphaState calculateAlphaState(const DrawCallState& drawCall, const MaterialData& materialData);
 
   // Modifies an instance given active developer options. Returns true if the instance was modified
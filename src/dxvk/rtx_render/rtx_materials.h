@@ -85,7 +85,9 @@ struct RtSurface {
   RtSurface() {
   }
 
-  void writeGPUData(unsigned char* data, std::size_t& offset, size_t surfaceIndex = SIZE_MAX) const {
+  // Note: positionDequantization maps quantized positions to object space and is folded into the object to world
+  // transforms written when hasQuantizedPositions is set, see RaytraceGeometry::getPositionDequantization.
+  void writeGPUData(unsigned char* data, std::size_t& offset, size_t surfaceIndex = SIZE_MAX, const Matrix4& positionDequantization = Matrix4()) const {
     [[maybe_unused]] const std::size_t oldOffset = offset;
 
     // Note: Position buffer and surface material index are required for proper
@@ -102,6 +104,7 @@ struct RtSurface {
     uint16_t flags0 = 0;
     flags0 |= normalFormat == VK_FORMAT_R32_UINT ? 1 : 0;
     flags0 |= isVertexColorBakedLighting ? (1 << 1) : 0;
+    flags0 |= hasQuantizedPositions ? (1 << 2) : 0;
     // NOTE: Spare flags bits here
 
     writeGPUHelper(data, offset, flags0);
@@ -179,6 +182,12 @@ struct RtSurface {
       }
     }
 
+    // Note: Normals are in object space, so the normal transform does not take the dequantization
+    if (hasQuantizedPositions) {
+      instanceToWorld = instanceToWorld * positionDequantization;
+      prevInstanceToWorld = prevInstanceToWorld * positionDequantization;
+    }
+
     // Note: Last row of object to world matrix not needed as it does not encode any useful information
     writeGPUHelper(data, offset, prevInstanceToWorld.data[0].x);
     writeGPUHelper(data, offset, prevInstanceToWorld.data[0].y);
@@ -296,6 +305,7 @@ struct RtSurface {
   bool skipSurfaceInteractionSpritesheetAdjustment = false;
   bool isInsideFrustum = false;
   bool ignoreTransparencyLayer = false;
+  bool hasQuantizedPositions = false;
 
   RtTextureArgSource textureColorArg1Source = RtTextureArgSource::Texture;
   RtTextureArgSource textureColorArg2Source = RtTextureArgSource::None;
@@ -363,7 +373,8 @@ struct RtSurface {
       "  isMotionBlurMaskOut: ", isMotionBlurMaskOut, "\n",
       "  skipSurfaceInteractionSpritesheetAdjustment: ", skipSurfaceInteractionSpritesheetAdjustment, "\n",
       "  isInsideFrustum: ", isInsideFrustum, "\n",
-      "  ignoreTransparencyLayer: ", ignoreTransparencyLayer));
+      "  ignoreTransparencyLayer: ", ignoreTransparencyLayer, "\n",
+      "  hasQuantizedPositions: ", hasQuantizedPositions));
     
     // Print alpha state
     Logger::warn("=== Alpha State ===");
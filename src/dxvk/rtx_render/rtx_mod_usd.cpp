@@ -60,6 +60,7 @@
 #include <src/usd-plugins/RemixParticleSystem/ParticleSystemAPI.h>
 #include "../../lssusd/usd_include_end.h"
 #include "../util/util_watchdog.h"
+#include "../util/util_vertex_compression.h"
 
 #include "../../lssusd/game_exporter_common.h"
 #include "../../lssusd/game_exporter_paths.h"
@@ -175,6 +176,75 @@ XXH64_hash_t getStrongestOpinionatedPathHash(const pxr::UsdPrim& prim) {
   return XXH3_64bits(name.c_str(), name.size());
 }
 
+// Layout of a replacement mesh's vertices in the compact format, see RtxOptions::compactReplacementVertexFormat
+struct CompactVertexLayout {
+  uint32_t stride = 0;
+  uint32_t offsets[lss::UsdMeshImporter::Count] = {};
+  vtxcompress::PositionQuantization positionQuantization;
+};
+
+// Re-encodes the importer's interleaved float vertices: positions shrink from 12 to 8 bytes and texcoords from 8 to 4,
+// normals (octahedral) and colors are 4 bytes already and are copied as is.
+std::vector<uint8_t> encodeCompactVertices(const lss::UsdMeshImporter& mesh, CompactVertexLayout& layout) {
+  const auto& vertexDecl = mesh.GetVertexDecl();
+  const uint8_t* pSrcVertices = reinterpret_cast<const uint8_t*>(mesh.GetVertexData().data());
+  const size_t srcStride = mesh.GetVertexStride();
+  const size_t numVertices = mesh.GetNumVertices();
+
+  for (const auto& element : vertexDecl) {
+    layout.offsets[element.attribute] = layout.stride;
+    switch (element.attribute) {
+    case lss::UsdMeshImporter::VertexPositions:
+      layout.stride += sizeof(uint16_t) * 4;
+      layout.positionQuantization = vtxcompress::computePositionQuantization(pSrcVertices + element.offset, numVertices, srcStride);
+      break;
+    case lss::UsdMeshImporter::Normals:
+    case lss::UsdMeshImporter::Texcoords:
+    case lss::UsdMeshImporter::Colors:
+      layout.stride += sizeof(uint32_t);
+      break;
+    default:
+      assert(false && "Vertex attribute not supported by the compact vertex format");
+      break;
+    }
+  }
+
+  std::vector<uint8_t> compactVertices(numVertices * layout.stride);
+
+  for (size_t v = 0; v < numVertices; ++v) {
+    const uint8_t* pSrcVertex = pSrcVertices + v * srcStride;
+    uint8_t* pDstVertex = compactVertices.data() + v * layout.stride;
+
+    for (const auto& element : vertexDecl) {
+      const uint8_t* pSrc = pSrcVertex + element.offset;
+      uint8_t* pDst = pDstVertex + layout.offsets[element.attribute];
+
+      switch (element.attribute) {
+      case lss::UsdMeshImporter::VertexPositions: {
+        float position[3];
+        memcpy(position, pSrc, sizeof(position));
+        int16_t encoded[4];
+        vtxcompress::encodePosition(layout.positionQuantization, position, encoded);
+        memcpy(pDst, encoded, sizeof(encoded));
+        break;
+      }
+      case lss::UsdMeshImporter::Texcoords: {
+        float texcoord[2];
+        memcpy(texcoord, pSrc, sizeof(texcoord));
+        const uint32_t encoded = vtxcompress::encodeTexcoord(texcoord);
+        memcpy(pDst, &encoded, sizeof(encoded));
+        break;
+      }
+      default:
+        memcpy(pDst, pSrc, sizeof(uint32_t));
+        break;
+      }
+    }
+  }
+
+  return compactVertices;
+}
+
 XXH64_hash_t getNamedHash(const std::string& name, const char* prefix, const size_t len) {
   if (name.compare(0, len, prefix) == 0) {
     // is a mesh replacement.
@@ -1316,6 +1386,10 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
 
   try {
     processedMesh = std::make_unique<lss::UsdMeshImporter>(prim, RtxOptions::limitedBonesPerVertex());
+    if (RtxOptions::optimizeReplacementMeshVertexOrder()) {
+      const auto cacheDirectory = std::filesystem::path(m_openedFilePath).parent_path() / "rtx-mesh-cache";
+      processedMesh->OptimizeVertexOrder(cacheDirectory.string());
+    }
   }
   catch (DxvkError e) {
     Logger::err(e.message());
@@ -1328,15 +1402,6 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
     throw DxvkError(str::format("Warning: No vertices on this mesh after processing, id=.", prim.GetName()));
   }
 
-  const size_t vertexDataSize = processedMesh->GetNumVertices() * processedMesh->GetVertexStride();
-
-  // Allocate the instance buffer and copy its contents from host to device memory
-  DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-  info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
-  info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
-  info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
-  info.size = dxvk::align(vertexDataSize, CACHE_LINE_SIZE);
-
   // Check if the mesh has weights
   bool isDynamicMesh = false;
   for (const auto& element : processedMesh->GetVertexDecl()) {
@@ -1345,10 +1410,29 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
       break;
   }
 
+  // Note: Skinning consumes float positions directly, so only static meshes use the compact format
+  const bool useCompactVertexFormat = RtxOptions::compactReplacementVertexFormat() && !isDynamicMesh;
+  CompactVertexLayout compactLayout;
+  std::vector<uint8_t> compactVertices;
+  if (useCompactVertexFormat) {
+    compactVertices = encodeCompactVertices(*processedMesh, compactLayout);
+  }
+
+  const size_t vertexStride = useCompactVertexFormat ? compactLayout.stride : processedMesh->GetVertexStride();
+  const void* pVertexData = useCompactVertexFormat ? static_cast<const void*>(compactVertices.data()) : processedMesh->GetVertexData().data();
+  const size_t vertexDataSize = processedMesh->GetNumVertices() * vertexStride;
+
+  // Allocate the instance buffer and copy its contents from host to device memory
+  DxvkBufferCreateInfo info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+  info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+  info.stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+  info.access = VK_ACCESS_TRANSFER_WRITE_BIT;
+  info.size = dxvk::align(vertexDataSize, CACHE_LINE_SIZE);
+
   // Buffer contains:
   // |---POSITIONS---|---NORMALS---|---UVS---| ... (VERTEX DATA INTERLEAVED)
   Rc<DxvkBuffer> vertexBuffer_staging = args.context->getDevice()->createBuffer(info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, DxvkMemoryStats::Category::RTXReplacementGeometry, "Mesh Staging Buffer");
-  memcpy(vertexBuffer_staging->mapPtr(0), processedMesh->GetVertexData().data(), vertexDataSize);
+  memcpy(vertexBuffer_staging->mapPtr(0), pVertexData, vertexDataSize);
 
   // Dynamic meshes should have their vertex data in device memory, static meshes should reside in host memory and allow geometry streaming to handle host/device memory management
   Rc<DxvkBuffer> vertexBuffer;
@@ -1364,28 +1448,37 @@ bool UsdMod::Impl::processMesh(const pxr::UsdPrim& prim, Args& args) {
 
   const DxvkBufferSlice& vertexSlice = DxvkBufferSlice(vertexBuffer);
 
+  if (useCompactVertexFormat) {
+    const vtxcompress::PositionQuantization& quantization = compactLayout.positionQuantization;
+    geometryData.positionQuantizationBias = Vector3(quantization.bias[0], quantization.bias[1], quantization.bias[2]);
+    geometryData.positionQuantizationScale = Vector3(quantization.scale[0], quantization.scale[1], quantization.scale[2]);
+    geometryData.compactVertexDecodeCache = std::make_shared<CompactVertexDecodeCache>();
+  }
+
   for (const auto& element : processedMesh->GetVertexDecl()) {
+    const size_t offset = useCompactVertexFormat ? compactLayout.offsets[element.attribute] : element.offset;
+
     switch (element.attribute) {
     case lss::UsdMeshImporter::VertexPositions:
-      geometryData.positionBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32G32B32_SFLOAT);
+      geometryData.positionBuffer = RasterBuffer(vertexSlice, offset, vertexStride, useCompactVertexFormat ? VK_FORMAT_R16G16B16A16_SNORM : VK_FORMAT_R32G32B32_SFLOAT);
       break;
     case lss::UsdMeshImporter::Normals:
-      geometryData.normalBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32_UINT);
+      geometryData.normalBuffer = RasterBuffer(vertexSlice, offset, vertexStride, VK_FORMAT_R32_UINT);
       break;
     case lss::UsdMeshImporter::Texcoords:
-      geometryData.texcoordBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32G32_SFLOAT);
+      geometryData.texcoordBuffer = RasterBuffer(vertexSlice, offset, vertexStride, useCompactVertexFormat ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R32G32_SFLOAT);
       geometryData.hashes[HashComponents::VertexTexcoord] = getNextGeomHash();
       break;
     case lss::UsdMeshImporter::Colors:
-      geometryData.color0Buffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_B8G8R8A8_UNORM);
+      geometryData.color0Buffer = RasterBuffer(vertexSlice, offset, vertexStride, VK_FORMAT_B8G8R8A8_UNORM);
       break;
     case lss::UsdMeshImporter::BlendWeights:
-      geometryData.blendWeightBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R32_SFLOAT);
+      geometryData.blendWeightBuffer = RasterBuffer(vertexSlice, offset, vertexStride, VK_FORMAT_R32_SFLOAT);
       // Note: only want to set this when there are actually weights, as it triggers the replacement to be skinned.
       geometryData.numBonesPerVertex = processedMesh->GetNumBonesPerVertex(); // TODO: Implement this in UsdMesh
       break;
     case lss::UsdMeshImporter::BlendIndices:
-      geometryData.blendIndicesBuffer = RasterBuffer(vertexSlice, element.offset, processedMesh->GetVertexStride(), VK_FORMAT_R8G8B8A8_USCALED);
+      geometryData.blendIndicesBuffer = RasterBuffer(vertexSlice, offset, vertexStride, VK_FORMAT_R8G8B8A8_USCALED);
       break;
     default:
       assert(false && "Invalid vertex attribute in UsdMod::Impl::processMesh");
@@ -71,8 +71,8 @@ namespace dxvk {
                                                      const uint32_t inputSubdivisionLevel,
                                                      const bool enableVertexAndTextureOperations,
                                                      uint32_t currentFrameIndex,
-                                                     std::list<XXH64_hash_t>::iterator _leastRecentlyUsedListIter,
-                                                     std::list<XXH64_hash_t>::iterator _cacheStateListIter,
+                                                     OmmHashList::iterator _leastRecentlyUsedListIter,
+                                                     OmmHashList::iterator _cacheStateListIter,
                                                      const OmmRequest& ommRequest)
     : cacheState(_cacheState)
     , lastUseFrameIndex(currentFrameIndex)
@@ -396,9 +396,9 @@ namespace dxvk {
 
     // Delete staging numTexelsPerMicroTriangle data associated with the instance
     if (useStagingNumTexelsPerMicroTriangleObject(instance)) {
-      m_numTexelsPerMicroTriangleStaging.erase(&instance);
+      m_numTexelsPerMicroTriangleStaging.erase(instance.getHandle());
     } else {
-      omm_validation_assert(m_numTexelsPerMicroTriangleStaging.find(&instance) == m_numTexelsPerMicroTriangleStaging.end());
+      omm_validation_assert(m_numTexelsPerMicroTriangleStaging.find(instance.getHandle()) == m_numTexelsPerMicroTriangleStaging.end());
     }
   }
 
@@ -492,7 +492,7 @@ namespace dxvk {
       destroyOmmData(ommCacheIterator, destroyParentInstanceOmmRequestContainer);
     };
 
-    m_numTexelsPerMicroTriangleStaging.erase(&instance);
+    m_numTexelsPerMicroTriangleStaging.erase(instance.getHandle());
 
     // Destroy all OMM requests associated with the instance
     XXH64_hash_t ommSrcHash = getOpacityMicromapHash(instance);
@@ -951,7 +951,7 @@ namespace dxvk {
     } else {
       // Using piecewise_construct to construct in-place with an empty constructor for the object
       auto elementIter = m_numTexelsPerMicroTriangleStaging.emplace(
-        std::piecewise_construct, std::make_tuple(&instance), std::make_tuple());
+        std::piecewise_construct, std::make_tuple(instance.getHandle()), std::make_tuple());
       hasInsertedNewObject = elementIter.second;
       numTexelsPerMicroTriangle = &elementIter.first->second;
       omm_validation_assert(hasInsertedNewObject &&
@@ -1192,7 +1192,7 @@ namespace dxvk {
       }
     }
 
-    std::list<XXH64_hash_t>::iterator cacheStateListIter;
+    OmmHashList::iterator cacheStateListIter;
     if (!insertToUnprocessedList(ommRequest, cacheStateListIter))
       return false;
 
@@ -1209,7 +1209,7 @@ namespace dxvk {
     return true;
   }
   
-  bool OpacityMicromapManager::insertToUnprocessedList(const OmmRequest& ommRequest, std::list<XXH64_hash_t>::iterator& cacheStateListIter) {
+  bool OpacityMicromapManager::insertToUnprocessedList(const OmmRequest& ommRequest, OmmHashList::iterator& cacheStateListIter) {
     XXH64_hash_t ommSrcHash = ommRequest.ommSrcHash;
 
     auto sourceDataIter = registerCachedSourceData(ommRequest);
@@ -1638,7 +1638,7 @@ namespace dxvk {
 
     // Look up the object holding the data
     if (useStagingNumTexelsPerMicroTriangleObject(instance)) {
-      auto numTexelsPerMicroTriangleStagingIter = m_numTexelsPerMicroTriangleStaging.find(&instance);
+      auto numTexelsPerMicroTriangleStagingIter = m_numTexelsPerMicroTriangleStaging.find(instance.getHandle());
 
       if (numTexelsPerMicroTriangleStagingIter == m_numTexelsPerMicroTriangleStaging.end()) {
         return OmmResult::DependenciesUnavailable;
@@ -1683,7 +1683,7 @@ namespace dxvk {
       // since multiple OMM items linked to it may get purged because of it and baking iterates through a list of OMMs.
       // Instead queue up the instance destruction
       if (instance.getFrameLastUpdated() != m_device->getCurrentFrameId()) {
-        m_instancesToDestroy.push_back(&instance);
+        m_instancesToDestroy.push_back(instance.getHandle());
       }
       return texelBudgetCheckResult;
     }
@@ -2306,7 +2306,8 @@ namespace dxvk {
 
   void OpacityMicromapManager::buildOpacityMicromaps(Rc<DxvkContext> ctx,
                                                      const std::vector<TextureRef>& textures,
-                                                     uint32_t lastCameraCutFrameId) {
+                                                     uint32_t lastCameraCutFrameId,
+                                                     const InstanceManager& instanceManager) {
 
     // Get the workload scale in respect to 60 Hz for a given frame time.
     // 60 Hz is the baseline since that's what the per-second budgets have been parametrized at in RtxOptions
@@ -2356,9 +2357,11 @@ namespace dxvk {
       bakeOpacityMicromapArrays(ctx, textures, numMicroTrianglesToBakeAvailable);
       buildOpacityMicromapsInternal(ctx, numMicroTrianglesToBuildAvailable);
 
-      // Purge instances queued for deletion
-      for (const RtInstance* instance : m_instancesToDestroy) {
-        destroyInstance(*instance);
+      // Purge instances queued for deletion, skipping any that have been destroyed since
+      for (const SlabHandle& handle : m_instancesToDestroy) {
+        if (const RtInstance* instance = instanceManager.resolveInstance(handle)) {
+          destroyInstance(*instance);
+        }
       }
       m_instancesToDestroy.clear();
     }
@@ -22,6 +22,8 @@
 #pragma once
 
 #include "../util/rc/util_rc_ptr.h"
+#include "../util/util_lru.h"
+#include "../util/util_slab_pool.h"
 #include "rtx_types.h"
 #include "rtx_geometry_utils.h"
 #include "rtx_option.h"
@@ -254,6 +256,9 @@ namespace dxvk {
     }
   };
 
+  // Hash lists tracking OMM cache items, all nodes live in one pool owned by the OMM manager
+  using OmmHashList = intrusive_list<XXH64_hash_t>;
+
   class OpacityMicromapCacheItem : public DxvkResource {
   public:
     OpacityMicromapCacheState cacheState = OpacityMicromapCacheState::eUnknown;
@@ -264,12 +269,12 @@ namespace dxvk {
     uint16_t subdivisionLevel = UINT16_MAX;
     uint32_t numTriangles = UINT32_MAX;
     VkOpacityMicromapFormatEXT ommFormat = VK_OPACITY_MICROMAP_FORMAT_2_STATE_EXT;
-    std::list<XXH64_hash_t>::iterator leastRecentlyUsedListIter;
+    OmmHashList::iterator leastRecentlyUsedListIter;
 
     // Iterator to a cache state list for the current cacheState.
     // Since the iterator is moved between the lists, it is initalized only once
     // and remains valid until it's removed from a list
-    std::list<XXH64_hash_t>::iterator cacheStateListIter;
+    OmmHashList::iterator cacheStateListIter;
 
     // Whether cacheStateListIter is valid when it corresponds to m_unprocessedList.
     // This is to handle the iterator state when an OMM cache item is in unprocessed or baking state
@@ -286,7 +291,7 @@ namespace dxvk {
 
     OpacityMicromapCacheItem();
     OpacityMicromapCacheItem(DxvkDevice& device, OpacityMicromapCacheState _cacheState, const uint32_t subdivisionLevel, const bool enableVertexAndTextureOperations,     
-                             uint32_t currentFrameIndex, std::list<XXH64_hash_t>::iterator _mostRecentlyUsedListIter, std::list<XXH64_hash_t>::iterator _cacheStateListIter,
+                             uint32_t currentFrameIndex, OmmHashList::iterator _mostRecentlyUsedListIter, OmmHashList::iterator _cacheStateListIter,
                              const OmmRequest& ommRequest);
     OpacityMicromapCacheItem(const OpacityMicromapCacheItem& src) 
     : cacheState(src.cacheState)
@@ -389,7 +394,7 @@ namespace dxvk {
                                         VkAccelerationStructureGeometryKHR& targetGeometry, const InstanceManager& instanceManager);
 
     // Called once per frame to build pending Opacity Micromap items in Opacity Micromap Manager
-    void buildOpacityMicromaps(Rc<DxvkContext> ctx, const std::vector<TextureRef>& textures, uint32_t lastCameraCutFrameId);
+    void buildOpacityMicromaps(Rc<DxvkContext> ctx, const std::vector<TextureRef>& textures, uint32_t lastCameraCutFrameId, const InstanceManager& instanceManager);
 
     // Called once per frame before any calls to Opacity Micromap Manager
     void onFrameStart(Rc<DxvkContext> ctx);
@@ -463,7 +468,7 @@ namespace dxvk {
     fast_unordered_cache<CachedSourceData>::iterator registerCachedSourceData(const OmmRequest& ommRequest);
     void deleteCachedSourceData(fast_unordered_cache<CachedSourceData>::iterator sourceDataIter, OpacityMicromapCacheState ommCacheState, bool destroyParentInstanceOmmRequestContainer);
     void deleteCachedSourceData(XXH64_hash_t ommSrcHash, OpacityMicromapCacheState ommCacheState, bool destroyParentInstanceOmmRequestContainer);
-    bool insertToUnprocessedList(const OmmRequest& ommRequest, std::list<XXH64_hash_t>::iterator& cacheStateListIter);
+    bool insertToUnprocessedList(const OmmRequest& ommRequest, OmmHashList::iterator& cacheStateListIter);
     void destroyOmmData(OpacityMicromapCache::iterator ommCacheIterator, bool destroyParentInstanceOmmRequestContainer = true);
     void destroyOmmData(XXH64_hash_t ommSrcHash);
     static OpacityMicromapInstanceData& getOmmInstanceData(const RtInstance& instance);
@@ -527,10 +532,13 @@ namespace dxvk {
     fast_unordered_cache<CachedSourceData> m_cachedSourceData;
     std::vector<Rc<DxvkOpacityMicromap>> m_boundOMMs; // OMMs bound in a frame
 
+    // Shared by all hash lists below so cache items can be spliced between them without allocating
+    intrusive_list_pool<XXH64_hash_t> m_ommListPool;
+
     // Ordered lists starting with oldest and/or smallest inserted items 
-    std::list<XXH64_hash_t> m_unprocessedList;   // Contains OMM data requests that are yet to be baked
-    std::list<XXH64_hash_t> m_bakedList;         // Contains OMM items with baked OMM arrays
-    std::list<XXH64_hash_t> m_builtList;         // Contains OMM items with built OMMs but require synchronization
+    OmmHashList m_unprocessedList { m_ommListPool };   // Contains OMM data requests that are yet to be baked
+    OmmHashList m_bakedList { m_ommListPool };         // Contains OMM items with baked OMM arrays
+    OmmHashList m_builtList { m_ommListPool };         // Contains OMM items with built OMMs but require synchronization
 
     std::unordered_set<XXH64_hash_t> m_blackListedList;// Contains OMM surface hashes that failed to get baked or built (in time)
                                                  // and helps avoid wasting resources for such cases
@@ -546,7 +554,7 @@ namespace dxvk {
     uint32_t m_numMicroTrianglesBuilt = 0;    // Per frame
 
     // LRU management
-    std::list<XXH64_hash_t> m_leastRecentlyUsedList;  // Items stored in their usage order starting with least recently used item
+    OmmHashList m_leastRecentlyUsedList { m_ommListPool };  // Items stored in their usage order starting with least recently used item
 
     fast_unordered_cache<OMMBuildRequestStatistics> m_ommBuildRequestStatistics;
 
@@ -568,10 +576,11 @@ namespace dxvk {
 
     // The staging variant stores results for instances that need to have this data calculated prior to knowing the OMM hash.
     // It only applies to instances that were created in the very same frame, i.e. have a frame age of 0
-    std::unordered_map<const RtInstance*, NumTexelsPerMicroTriangleCalculationData> m_numTexelsPerMicroTriangleStaging;
+    // Keyed by instance handle, so an entry left behind by a destroyed instance can never alias a new instance reusing its memory
+    std::unordered_map<SlabHandle, NumTexelsPerMicroTriangleCalculationData, SlabHandleHash> m_numTexelsPerMicroTriangleStaging;
     // This could be stored in CachedSourceData to avoid an additional unordered_map lookup
     fast_unordered_cache<NumTexelsPerMicroTriangleCalculationData> m_numTexelsPerMicroTriangle;
-    std::vector<const RtInstance*> m_instancesToDestroy;
+    std::vector<SlabHandle> m_instancesToDestroy;
 
     // Need to give access to CachedSourceData to be able to purge m_numTexelsPerMicroTriangleStaging
     friend class CachedSourceData;
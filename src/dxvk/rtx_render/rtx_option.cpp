@@ -256,6 +256,79 @@ namespace dxvk {
     }
 
     releaseValue(resolvedValue, type);
+    delete publishedValueStorage;
+  }
+
+  namespace {
+    // Published values that have been replaced, but may still be referenced by readers
+    struct RetiredValue {
+      uint64_t frame;
+      void* value;
+      void (*destroy)(void*);
+    };
+
+    struct RetiredValueList {
+      std::mutex mutex;
+      std::vector<RetiredValue> values;
+      uint64_t frame = 0;
+
+      ~RetiredValueList() {
+        for (const RetiredValue& retired : values) {
+          retired.destroy(retired.value);
+        }
+      }
+    };
+
+    RetiredValueList& getRetiredValueList() {
+      // Options publish their initial value during static initialization, so this has to be initialized on first use
+      static RetiredValueList s_retiredValues;
+      return s_retiredValues;
+    }
+  }
+
+  void RtxOptionImpl::publishValue() {
+    GenericValueWrapper* storage = new GenericValueWrapper(type);
+    switch (type) {
+    case OptionType::Bool:
+    case OptionType::Int:
+    case OptionType::Float:
+      // Basic types may be wider than the union member copyValue() uses, so copy the whole value
+      storage->data.value = resolvedValue.value;
+      break;
+    default:
+      copyValue(resolvedValue, storage->data);
+      break;
+    }
+
+    GenericValueWrapper* retired = publishedValueStorage;
+    publishedValueStorage = storage;
+    publishedValue.store(&storage->data, std::memory_order_release);
+
+    if (retired) {
+      retireAfterFrame(retired, [](void* value) { delete static_cast<GenericValueWrapper*>(value); });
+    }
+  }
+
+  void RtxOptionImpl::retireAfterFrame(void* value, void (*destroy)(void*)) {
+    RetiredValueList& retiredValues = getRetiredValueList();
+    std::lock_guard<std::mutex> lock(retiredValues.mutex);
+    retiredValues.values.push_back({ retiredValues.frame, value, destroy });
+  }
+
+  void RtxOptionImpl::reclaimRetiredValues() {
+    // A value replaced during frame N is freed at the end of frame N + 1, so a reference obtained
+    // from get() remains valid for the rest of the frame it was read in, plus one more frame.
+    RetiredValueList& retiredValues = getRetiredValueList();
+    std::lock_guard<std::mutex> lock(retiredValues.mutex);
+
+    auto firstLive = std::partition(retiredValues.values.begin(), retiredValues.values.end(),
+      [&](const RetiredValue& retired) { return retired.frame < retiredValues.frame; });
+    for (auto it = retiredValues.values.begin(); it != firstLive; ++it) {
+      it->destroy(it->value);
+    }
+    retiredValues.values.erase(retiredValues.values.begin(), firstLive);
+
+    ++retiredValues.frame;
   }
 
   const GenericValue& RtxOptionImpl::getGenericValue(const ValueType valueType) const {
@@ -495,6 +568,7 @@ namespace dxvk {
     } else if (valueType == ValueType::Value) {
       // If reading into the value, need to immediately copy to the pending value so they stay in sync.
       copyValue(resolvedValue, getGenericValue(ValueType::PendingValue));
+      publishValue();
 
       // Also mark the option dirty so the onChange callback is invoked at the normal time.
       markDirty();
@@ -566,11 +640,13 @@ namespace dxvk {
 
   void RtxOptionImpl::insertEmptyOptionLayer(const RtxOptionLayer* layer) {
     GenericValue optionLayerValue = createGenericValue(type);
-    const PrioritizedValue newValue(optionLayerValue, layer->getBlendStrength(), layer->getBlendStrengthThreshold());
+    const PrioritizedValue newValue(optionLayerValue, layer, layer->getBlendStrength(), layer->getBlendStrengthThreshold());
     
     LayerKey key = {layer->getPriority(), layer->getName()};
     auto [it, inserted] = optionLayerValueQueue.emplace(key, newValue);
-    if (!inserted) {
+    if (inserted) {
+      layer->addOption(this);
+    } else {
       Logger::warn("[RTX Option]: Duplicate layer '" + std::string(layer->getName()) + "' with priority " + std::to_string(layer->getPriority()) + " ignored (only first kept).");
     }
   }
@@ -595,9 +671,11 @@ namespace dxvk {
     GenericValue optionLayerValue = createGenericValue(type);
     copyValue(value, optionLayerValue);
 
-    const PrioritizedValue newValue(optionLayerValue, layer->getBlendStrength(), layer->getBlendStrengthThreshold());
+    const PrioritizedValue newValue(optionLayerValue, layer, layer->getBlendStrength(), layer->getBlendStrengthThreshold());
     auto [it, inserted] = optionLayerValueQueue.emplace(key, newValue);
-    if (!inserted) {
+    if (inserted) {
+      layer->addOption(this);
+    } else {
       Logger::warn("[RTX Option]: Duplicate layer '" + std::string(layer->getName()) + "' with priority " + std::to_string(layer->getPriority()) + " ignored (only first kept).");
     }
   }
@@ -626,26 +704,35 @@ namespace dxvk {
       // When removing a layer, dirty current option
       markDirty();
       optionLayerValueQueue.erase(it);
+      layer->removeOption(this);
     }
   }
 
   void RtxOptionImpl::disableTopLayer() {
     if (!optionLayerValueQueue.empty()) {
+      const RtxOptionLayer* layer = optionLayerValueQueue.begin()->second.layer;
       optionLayerValueQueue.erase(optionLayerValueQueue.begin());
+      if (layer) {
+        layer->removeOption(this);
+      }
     }
   }
 
   void RtxOptionImpl::updateLayerBlendStrength(const RtxOptionLayer& optionLayer) {
-    const std::string fullName = getFullName();
-    // Only update the strength when the option can be found in the config of option layer
-    if (optionLayer.getConfig().findOption(fullName.c_str())) {
-      // Find the option layer value by exact layer match
-      LayerKey key = {optionLayer.getPriority(), optionLayer.getName()};
-      auto optionLayerIter = optionLayerValueQueue.find(key);
-      if (optionLayerIter != optionLayerValueQueue.end()) {
-        optionLayerIter->second.blendStrength = optionLayer.getBlendStrength();
-        optionLayerIter->second.blendThreshold = optionLayer.getBlendStrengthThreshold();
-      }
+    // Find the option layer value by exact layer match
+    LayerKey key = {optionLayer.getPriority(), optionLayer.getName()};
+    auto optionLayerIter = optionLayerValueQueue.find(key);
+    if (optionLayerIter == optionLayerValueQueue.end()) {
+      return;
+    }
+
+    PrioritizedValue& prioritizedValue = optionLayerIter->second;
+    if (prioritizedValue.blendStrength != optionLayer.getBlendStrength() ||
+        prioritizedValue.blendThreshold != optionLayer.getBlendStrengthThreshold()) {
+      prioritizedValue.blendStrength = optionLayer.getBlendStrength();
+      prioritizedValue.blendThreshold = optionLayer.getBlendStrengthThreshold();
+      // Only this option needs re-resolving, its layer values are unchanged
+      markDirty();
     }
   }
 
@@ -1167,12 +1254,8 @@ Tables below enumerate all the options and their defaults set by RTX Remix. Note
     auto it = layerMap.find(layerKey);
     
     if (it != layerMap.end()) {
-      // Remove the layer values from all RtxOptions
-      auto& globalRtxOptions = getGlobalRtxOptionMap();
-      for (auto& rtxOptionMapEntry : globalRtxOptions) {
-        RtxOptionImpl& rtxOption = *rtxOptionMapEntry.second.get();
-        rtxOption.disableLayerValue(layer);
-      }
+      // Remove the layer values from the RtxOptions holding one
+      RtxOptionManager::removeRtxOptionLayer(*layer);
       
       // Remove from the global layer map
       layerMap.erase(it);
@@ -1241,6 +1324,7 @@ Tables below enumerate all the options and their defaults set by RTX Remix. Note
     : m_configName(configName)
     , m_enabled(true)
     , m_dirty(false)
+    , m_blendStrengthDirty(false)
     , m_config(config)
     , m_priority(priority)
     , m_blendStrength(blendStrength)
@@ -1281,7 +1365,7 @@ Tables below enumerate all the options and their defaults set by RTX Remix. Note
     if (m_pendingMinBlendThreshold < kEmptyBlendThresholdRequest) {
       if (m_blendThreshold != m_pendingMinBlendThreshold) {
         m_blendThreshold = m_pendingMinBlendThreshold;
-        setDirty(true);
+        setBlendStrengthDirty(true);
       }
       m_pendingMinBlendThreshold = kEmptyBlendThresholdRequest;
     }
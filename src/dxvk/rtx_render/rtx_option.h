@@ -34,6 +34,7 @@
 #include "../util/util_math.h"
 #include "../util/util_env.h"
 #include "../util/util_keybind.h"
+#include "../util/util_flat_sorted_map.h"
 #include "rtx_utils.h"
 
 #ifndef RTX_OPTION_DEBUG_LOGGING
@@ -94,6 +95,8 @@ namespace dxvk {
 
   // Forward declaration
   class RtxOptionLayerManager;
+  struct GenericValueWrapper;
+  struct RtxOptionImpl;
 
   // Represents an RTX option layer that can override rendering settings.
   // Layers are prioritized and can be dynamically enabled/disabled at runtime.
@@ -169,8 +172,8 @@ namespace dxvk {
 
     // Mark this layer as dirty (e.g., changed values need reprocessing).
     void setDirty(bool dirty) const { m_dirty = dirty; }
+    // Blend strength or threshold changed, options only need re-resolving, not re-reading from the config
     void setBlendStrengthDirty(bool dirty) const {
-      setDirty(dirty);
       m_blendStrengthDirty = dirty;
     }
 
@@ -187,6 +190,8 @@ namespace dxvk {
     const bool isDirty() const { return m_dirty; }
     const bool isBlendStrengthDirty() const { return m_blendStrengthDirty; }
     const std::string& getName() const { return m_configName; }
+    // Options that currently hold a value from this layer
+    const std::vector<RtxOptionImpl*>& getOptions() const { return m_options; }
 
     // Get the pending enabled state for UI display (returns current state if no pending request)
     bool getPendingEnabled() const {
@@ -256,8 +261,23 @@ namespace dxvk {
       }
     }
 
+    void addOption(RtxOptionImpl* option) const {
+      m_options.push_back(option);
+    }
+
+    void removeOption(RtxOptionImpl* option) const {
+      auto it = std::find(m_options.begin(), m_options.end(), option);
+      if (it != m_options.end()) {
+        *it = m_options.back();
+        m_options.pop_back();
+      }
+    }
+
     std::string m_configName;
 
+    // Membership index, so enabling, disabling or blending a layer only touches the options it contains
+    mutable std::vector<RtxOptionImpl*> m_options;
+
     mutable bool m_enabled;
     mutable bool m_dirty;
     mutable bool m_blendStrengthDirty;
@@ -307,9 +327,10 @@ namespace dxvk {
     // The actual priority is stored in the optionLayerValueQueue key for this value.
     struct PrioritizedValue {
       PrioritizedValue() { }
-      PrioritizedValue(const GenericValue& v, const float b, const float threshold) : value(v), blendStrength(b), blendThreshold(threshold) { }
+      PrioritizedValue(const GenericValue& v, const RtxOptionLayer* l, const float b, const float threshold) : value(v), layer(l), blendStrength(b), blendThreshold(threshold) { }
 
       mutable GenericValue value; // The actual option value
+      const RtxOptionLayer* layer = nullptr; // The layer this value was read from
       mutable float blendStrength = 1.0f; // Blend weight, which allows smooth interpolation between overlapping option layers.
       mutable float blendThreshold = 0.5; // Blending strength threshold for this option layer. Only applicable to non-float variables. The option is enabled only when the blend strength exceeds this threshold.
     };
@@ -325,6 +346,11 @@ namespace dxvk {
     std::optional<GenericValue> maxValue;
     uint32_t flags = 0;
     std::function<void(DxvkDevice* device)> onChangeCallback;
+    // Incremented whenever the value may have changed. Allows caches derived from option values to detect changes without taking s_updateMutex.
+    std::atomic<uint32_t> version = 0;
+    // Immutable copy of resolvedValue that readers load without taking s_updateMutex, replaced by publishValue().
+    std::atomic<const GenericValue*> publishedValue = nullptr;
+    GenericValueWrapper* publishedValueStorage = nullptr;
 
     // --- Containers for option layers ---
     // 
@@ -350,7 +376,8 @@ namespace dxvk {
     // (default configs, app configs, user configs, runtime GUI, etc.).
     using RtxOptionLayerMap = std::map<LayerKey, std::unique_ptr<RtxOptionLayer>>;
     
-    std::map<LayerKey, PrioritizedValue> optionLayerValueQueue;
+    // Kept in a flat sorted array, as it is walked on every resolve of the option but rarely changes
+    flat_sorted_map<LayerKey, PrioritizedValue> optionLayerValueQueue;
 
     RtxOptionImpl(XXH64_hash_t hash, const char* optionName, const char* optionCategory, OptionType optionType, const char* optionDescription) :
       hash(hash),
@@ -393,8 +420,26 @@ namespace dxvk {
 
     void markDirty() {
       getDirtyRtxOptionMap()[hash] = this;
+      bumpVersion();
+    }
+
+    // Signal that the value of this option may have changed, so caches derived from it get refreshed
+    void bumpVersion() {
+      version.fetch_add(1, std::memory_order_release);
+      if (type == OptionType::HashSet) {
+        s_hashSetVersion.fetch_add(1, std::memory_order_release);
+      }
     }
 
+    // Returns the last published value. Wait-free and safe to call from any thread.
+    // The returned value stays valid until the second frame boundary after it was replaced, see reclaimRetiredValues().
+    const GenericValue& getPublishedValue() const {
+      return *publishedValue.load(std::memory_order_acquire);
+    }
+
+    // Publishes a copy of resolvedValue to readers. Must be called after every change to resolvedValue.
+    void publishValue();
+
     void invokeOnChangeCallback(DxvkDevice* device) const;
 
     // Returns true if the value was changed
@@ -411,6 +456,11 @@ namespace dxvk {
     static void readOptions(const Config& options);
     static void writeOptions(Config& options, bool changedOptionsOnly);
     static void resetOptions();
+    // Frees published values that were replaced before the previous frame boundary. Called once per frame.
+    static void reclaimRetiredValues();
+    // Frees a replaced snapshot with the same lifetime as a replaced option value, for caches derived from options
+    // that publish their own lock-free snapshots
+    static void retireAfterFrame(void* value, void (*destroy)(void*));
     static bool writeMarkdownDocumentation(const char* outputMarkdownFilePath);
 
     // Returns a global container holding all serializable options
@@ -447,6 +497,9 @@ namespace dxvk {
 
     // Mutex to prevent race conditions when clearing dirty RtxOptions
     inline static std::mutex s_updateMutex;
+
+    // Incremented whenever the value of any hash set option may have changed
+    inline static std::atomic<uint32_t> s_hashSetVersion = 0;
   };
 
   template <typename T>
@@ -509,8 +562,8 @@ namespace dxvk {
       }
     }
 
-    // Add a new RTX option layer (e.g., user config, runtime changes) to all global options.
-    // Reads the option layer into every global RtxOptionImpl instance.
+    // Add a new RTX option layer (e.g., user config, runtime changes) to the global options.
+    // Only the options named in the layer's config are visited.
     static void addRtxOptionLayer(const RtxOptionLayer& optionLayer) {
       // Do nothing for invalid(empty) layers
       if (!optionLayer.isValid()) {
@@ -518,27 +571,27 @@ namespace dxvk {
       }
 
       auto& globalRtxOptions = RtxOptionImpl::getGlobalRtxOptionMap();
-      for (auto& rtxOptionMapEntry : globalRtxOptions) {
-        RtxOptionImpl& rtxOption = *rtxOptionMapEntry.second.get();
-        rtxOption.readOptionLayer(optionLayer);
+      for (const auto& [fullName, unusedValue] : optionLayer.getConfig().getOptions()) {
+        auto pOption = globalRtxOptions.find(StringToXXH64(fullName, 0));
+        if (pOption != globalRtxOptions.end()) {
+          pOption->second->readOptionLayer(optionLayer);
+        }
       }
     }
 
-    // Remove an existing RTX option layer from all global options.
+    // Remove an existing RTX option layer from the options holding a value from it.
     static void removeRtxOptionLayer(const RtxOptionLayer& optionLayer) {
-      auto& globalRtxOptions = RtxOptionImpl::getGlobalRtxOptionMap();
-      for (auto& rtxOptionMapEntry : globalRtxOptions) {
-        RtxOptionImpl& rtxOption = *rtxOptionMapEntry.second.get();
-        rtxOption.disableLayerValue(&optionLayer);
+      // disableLayerValue() removes the option from the layer's membership index, so iterate a copy
+      const std::vector<RtxOptionImpl*> layerOptions = optionLayer.getOptions();
+      for (RtxOptionImpl* rtxOption : layerOptions) {
+        rtxOption->disableLayerValue(&optionLayer);
       }
     }
 
-    // Update an existing RTX option layer from all global options.
+    // Propagate a blend strength or threshold change to the options holding a value from the layer.
     static void updateRtxOptionLayer(const RtxOptionLayer& optionLayer) {
-      auto& globalRtxOptions = RtxOptionImpl::getGlobalRtxOptionMap();
-      for (auto& rtxOptionMapEntry : globalRtxOptions) {
-        RtxOptionImpl& rtxOption = *rtxOptionMapEntry.second.get();
-        rtxOption.updateLayerBlendStrength(optionLayer);
+      for (RtxOptionImpl* rtxOption : optionLayer.getOptions()) {
+        rtxOption->updateLayerBlendStrength(optionLayer);
       }
     }
 
@@ -592,10 +645,15 @@ namespace dxvk {
     // This should be called at the very end of the frame in the dxvk-cs thread.
     // Before the first frame is rendered, it also needs to be called at least once during initialization.
     // It's currently called twice during init, due to multiple sections that set many Options then immediately use them.
-    static void applyPendingValues(DxvkDevice* device) {
+    // Returns the number of options that were resolved.
+    static uint32_t applyPendingValues(DxvkDevice* device) {
 
       constexpr static int32_t maxResolves = 4;
       int32_t numResolves = 0;
+      uint32_t numResolvedOptions = 0;
+
+      // Readers may still hold references to values published during the last frame, so only older ones are freed
+      RtxOptionImpl::reclaimRetiredValues();
 
       // Iteratively resolve the dirty options, invoke callbacks, rinse and repeat until until no 
       // dirty options are left. 
@@ -610,12 +668,16 @@ namespace dxvk {
         {
           for (auto& rtxOption : dirtyOptions) {
             rtxOption.second->resolveValue(rtxOption.second->resolvedValue, false);
+            rtxOption.second->publishValue();
+            rtxOption.second->bumpVersion();
             dirtyOptionsVector.push_back(rtxOption.second);
           }
         }
         dirtyOptions.clear();
         lock.unlock();
 
+        numResolvedOptions += static_cast<uint32_t>(dirtyOptionsVector.size());
+
         // Invoke onChange callbacks after promoting all the values
         for (RtxOptionImpl* rtxOption : dirtyOptionsVector) {
           rtxOption->invokeOnChangeCallback(device);
@@ -643,6 +705,8 @@ namespace dxvk {
 
       // Don't let dirty options persist across frames and explode the dirty option processing in the case of circular dependencies
       RtxOptionImpl::getDirtyRtxOptionMap().clear();
+
+      return numResolvedOptions;
     }
   };
 
@@ -688,6 +752,7 @@ namespace dxvk {
       // This function sets the pending and immediate values separately, so they both need to be clamped.
       pImpl->clampValue(RtxOptionImpl::ValueType::PendingValue);
       pImpl->clampValue(RtxOptionImpl::ValueType::Value);
+      pImpl->publishValue();
       // Mark the option as dirty so that the onChange callback is invoked, even though the value already changed mid frame.
       pImpl->markDirty();
     }
@@ -708,8 +773,7 @@ namespace dxvk {
 
     template<typename = std::enable_if_t<std::is_same_v<T, fast_unordered_set>>>
     bool containsHash(const XXH64_hash_t& value) const {
-      std::lock_guard<std::mutex> lock(RtxOptionImpl::s_updateMutex);
-      return getValuePtr<fast_unordered_set>(RtxOptionImpl::ValueType::Value)->count(value) > 0;
+      return getValue().count(value) > 0;
     }
 
     // Check if a hash exists in lower priority layers (below runtime layer)
@@ -749,6 +813,11 @@ namespace dxvk {
     std::string getName() const {
       return pImpl->getFullName();
     }
+
+    // Returns a counter which changes whenever the value of this option may have changed
+    uint32_t getVersion() const {
+      return pImpl->version.load(std::memory_order_acquire);
+    }
     const char* getDescription() const {
       return pImpl->description;
     }
@@ -855,6 +924,7 @@ namespace dxvk {
         if (defaultLayer) {
           pImpl->insertOptionLayerValue(pImpl->resolvedValue, defaultLayer);
         }
+        pImpl->publishValue();
 
         initializeClamping(args);
       }
@@ -871,23 +941,32 @@ namespace dxvk {
         if (defaultLayer) {
           pImpl->insertOptionLayerValue(pImpl->resolvedValue, defaultLayer);
         }
+        pImpl->publishValue();
 
         initializeClamping(args);
       }
     }
 
+    // Lock-free, reads the value published at the last change rather than resolvedValue itself.
     const T& getValue() const {
-      std::lock_guard<std::mutex> lock(RtxOptionImpl::s_updateMutex);
       assert(RtxOptionImpl::s_isInitialized && "Trying to access an RtxOption before the config files have been loaded."); 
 #if RTX_OPTION_DEBUG_LOGGING
-      // Print out a warning whenever a dirty value is accessed.
-      if (!pImpl->isEqual(resolvedValue, getValue(RtxOptionImpl::ValueType::PendingValue)) {
-        Logger::warn(str::format("RtxOption retrieved a dirty value: ", pImpl->getFullName().c_str(),
-            " has value: ", pImpl->genericValueToString(RtxOptionImpl::ValueType::Value),
-            " and pending value: ", pImpl->genericValueToString(RtxOptionImpl::ValueType::PendingValue)));
+      {
+        std::lock_guard<std::mutex> lock(RtxOptionImpl::s_updateMutex);
+        // Print out a warning whenever a dirty value is accessed.
+        if (!pImpl->isEqual(pImpl->resolvedValue, *getGenericValuePtr(RtxOptionImpl::ValueType::PendingValue))) {
+          Logger::warn(str::format("RtxOption retrieved a dirty value: ", pImpl->getFullName().c_str(),
+              " has value: ", pImpl->genericValueToString(RtxOptionImpl::ValueType::Value),
+              " and pending value: ", pImpl->genericValueToString(RtxOptionImpl::ValueType::PendingValue)));
+        }
       }
 #endif
-      return *getValuePtr<T>(RtxOptionImpl::ValueType::Value);
+      const GenericValue& value = pImpl->getPublishedValue();
+      if constexpr (std::is_pod_v<T>) {
+        return *reinterpret_cast<const T*>(&value);
+      } else {
+        return *reinterpret_cast<const T*>(value.pointer);
+      }
     }
 
     template <typename BasicType, std::enable_if_t<std::is_pod_v<BasicType>, bool> = true>
@@ -984,6 +984,16 @@ namespace dxvk {
                "Only relevant when force high resolution replacement textures is disabled and adaptive resolution replacement textures is enabled. See asset estimated size parameter for more information.\n");
     RTX_OPTION("rtx", uint, limitedBonesPerVertex, 4,
                "Limit the number of bone influences per vertex for replacement geometry.  D3D9 games were limited to 4, which is the default.  In rare instances you may want to increase this based on your preference for replaced assets.  This config only takes affect when set on startup via the rtx.conf.");
+    RTX_OPTION("rtx", bool, optimizeReplacementMeshVertexOrder, false,
+               "Reorders the triangles of replacement meshes for GPU post-transform cache locality, and their vertices for vertex fetch and BLAS build locality, when they are loaded.\n"
+               "The new order is cached in a 'rtx-mesh-cache' directory next to the mod, so a mesh is only optimized the first time it is loaded.\n"
+               "Requires reloading replacement assets.");
+    RTX_OPTION("rtx", bool, compactReplacementVertexFormat, false,
+               "Stores the vertices of static replacement meshes in a compact encoding: positions quantized to 16 bits relative to the mesh bounds, octahedral normals and half precision texcoords.\n"
+               "This shrinks the host memory copy of the loaded vertex data, from 24 to 16 bytes per vertex with normals and texcoords.\n"
+               "Positions stay quantized (16 bit snorm) in GPU memory and are consumed directly by BLAS builds, saving 4 bytes per vertex of GPU geometry. Texcoords are still expanded to 32 bit floats on the GPU.\n"
+               "View model geometry correction is not applied to these meshes.\n"
+               "Requires reloading replacement assets.");
 
     struct TextureManager {
       RTX_OPTION("rtx.texturemanager", int, budgetPercentageOfAvailableVram, 50,
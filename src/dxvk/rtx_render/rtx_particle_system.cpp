@@ -565,8 +565,12 @@ namespace dxvk {
       gpuCtx.spawnObjectToWorld = pTargetInstance->getTransform();
       gpuCtx.spawnPrevObjectToWorld = pTargetInstance->getPrevTransform();
 
-      gpuCtx.indices32bit = pTargetInstance->getBlas()->modifiedGeometryData.indexBuffer.indexType() == VK_INDEX_TYPE_UINT32 ? 1 : 0;
-      gpuCtx.numTriangles = pTargetInstance->getBlas()->modifiedGeometryData.indexCount / 3;
+      const RaytraceGeometry& spawnGeometry = pTargetInstance->getBlas()->modifiedGeometryData;
+      gpuCtx.indices32bit = spawnGeometry.indexBuffer.indexType() == VK_INDEX_TYPE_UINT32 ? 1 : 0;
+      gpuCtx.quantizedPositions = spawnGeometry.hasQuantizedPositions() ? 1 : 0;
+      gpuCtx.numTriangles = spawnGeometry.indexCount / 3;
+      gpuCtx.spawnMeshPositionBias = spawnGeometry.positionQuantizationBias;
+      gpuCtx.spawnMeshPositionScale = spawnGeometry.positionQuantizationScale;
       gpuCtx.spawnMeshIndexIdx = pTargetInstance->surface.indexBufferIndex;
       gpuCtx.spawnMeshPositionsIdx = pTargetInstance->surface.positionBufferIndex;
       gpuCtx.spawnMeshPrevPositionsIdx = pTargetInstance->surface.previousPositionBufferIndex;
@@ -345,6 +345,9 @@ namespace dxvk {
     // Copy the hashes over
     output.hashes = input.hashes;
 
+    output.positionQuantizationBias = input.positionQuantizationBias;
+    output.positionQuantizationScale = input.positionQuantizationScale;
+
     if (!input.positionBuffer.defined()) {
       ONCE(Logger::err("processGeometryInfo: no position data on input detected"));
       return ObjectCacheState::kInvalid;
@@ -474,6 +477,8 @@ namespace dxvk {
       m_enqueueDelayedClear = false;
     }
 
+    m_sceneReplayRecorder.onFrameEnd(m_device->getCurrentFrameId(), m_cameraManager.getMainCamera());
+
     m_cameraManager.onFrameEnd();
     m_instanceManager.onFrameEnd();
     m_previousFrameSceneAvailable = RtxOptions::enablePreviousTLAS();
@@ -539,6 +544,8 @@ namespace dxvk {
       return;
     }
 
+    m_sceneReplayRecorder.recordDraw(input);
+
     if (input.getFogState().mode != D3DFOG_NONE) {
       XXH64_hash_t fogHash = input.getFogState().getHash();
       if (m_fogStates.find(fogHash) == m_fogStates.end()) {
@@ -1419,6 +1426,8 @@ namespace dxvk {
     }
 
     const RtLight rtLight = lightData->toRtLight();
+    m_sceneReplayRecorder.recordLight(rtLight);
+
     const std::vector<AssetReplacement>* pReplacements = m_pReplacer->getReplacementsForLight(rtLight.getInitialHash());
 
     if (pReplacements) {
@@ -50,6 +50,7 @@
 #include "rtx_mod_manager.h"
 #include "graph/rtx_graph_manager.h"
 #include "rtx_particle_system.h"
+#include "rtx_scene_replay.h"
 #include <d3d9types.h>
 
 namespace dxvk 
@@ -319,6 +320,8 @@ private:
 
   std::unique_ptr<TerrainBaker> m_terrainBaker;
 
+  SceneReplayRecorder m_sceneReplayRecorder;
+
   FogState m_fog;
   fast_unordered_cache<FogState> m_fogStates;
   uint32_t m_startInMediumMaterialIndex = BINDING_INDEX_INVALID;
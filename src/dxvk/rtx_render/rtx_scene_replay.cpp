@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "rtx_scene_replay.h"
+#include "rtx_types.h"
+#include "rtx_lights.h"
+#include "rtx_camera.h"
+#include "../../util/util_filesys.h"
+
+namespace dxvk {
+  static_assert(SceneReplay::kGeometryHashComponentCount == (uint32_t) HashComponents::Count, "Update the scene replay format (and its version) with the hash components.");
+
+  void SceneReplayRecorder::recordDraw(const DrawCallState& drawCall) {
+    if (!m_isRecording) {
+      return;
+    }
+
+    const RasterGeometry& geometryData = drawCall.getGeometryData();
+
+    SceneReplay::DrawRecord& record = m_frame.draws.emplace_back();
+    for (uint32_t i = 0; i < SceneReplay::kGeometryHashComponentCount; ++i) {
+      record.geometryHashes[i] = geometryData.hashes[(HashComponents) i];
+    }
+    record.materialHash = drawCall.getMaterialData().getHash();
+    record.boneHash = drawCall.getSkinningState().boneHash;
+    record.objectToWorld = drawCall.getTransformData().objectToWorld;
+    record.boundingBoxMin = geometryData.boundingBox.minPos;
+    record.boundingBoxMax = geometryData.boundingBox.maxPos;
+    record.vertexCount = geometryData.vertexCount;
+    record.indexCount = geometryData.indexCount;
+    record.numBones = drawCall.getSkinningState().numBones;
+    record.cameraType = static_cast<uint32_t>(drawCall.cameraType);
+    record.categoryFlags = drawCall.getCategoryFlags().raw();
+  }
+
+  DrawCallState SceneReplayRecorder::restoreDraw(const SceneReplay::DrawRecord& record) {
+    DrawCallState drawCall;
+
+    RasterGeometry& geometryData = drawCall.geometryData;
+    for (uint32_t i = 0; i < SceneReplay::kGeometryHashComponentCount; ++i) {
+      geometryData.hashes[(HashComponents) i] = record.geometryHashes[i];
+    }
+    geometryData.hashes.precombine();
+    geometryData.boundingBox.minPos = record.boundingBoxMin;
+    geometryData.boundingBox.maxPos = record.boundingBoxMax;
+    geometryData.vertexCount = record.vertexCount;
+    geometryData.indexCount = record.indexCount;
+
+    drawCall.materialData.setHashOverride(record.materialHash);
+    drawCall.skinningData.boneHash = record.boneHash;
+    drawCall.skinningData.numBones = record.numBones;
+    drawCall.transformData.objectToWorld = record.objectToWorld;
+    drawCall.cameraType = static_cast<CameraType::Enum>(record.cameraType);
+    drawCall.categories = CategoryFlags(record.categoryFlags);
+
+    return drawCall;
+  }
+
+  void SceneReplayRecorder::recordLight(const RtLight& light) {
+    if (!m_isRecording) {
+      return;
+    }
+
+    SceneReplay::LightRecord& record = m_frame.lights.emplace_back();
+    record.hash = light.getInitialHash();
+    record.position = light.getPosition();
+    record.type = static_cast<uint32_t>(light.getType());
+
+    switch (light.getType()) {
+    case RtLightType::Sphere:
+      record.radius = light.getSphereLight().getRadius();
+      break;
+    case RtLightType::Cylinder:
+      record.radius = light.getCylinderLight().getRadius();
+      break;
+    default:
+      record.radius = 0.f;
+      break;
+    }
+  }
+
+  void SceneReplayRecorder::onFrameEnd(uint32_t frameIndex, const RtCamera& camera) {
+    if (m_isRecording) {
+      m_frame.frameIndex = frameIndex;
+      m_frame.camera.worldToView = camera.getWorldToView(false);
+      m_frame.camera.viewToProjection = camera.getViewToProjection();
+
+      const bool written = m_writer.writeFrame(m_frame);
+      if (!written) {
+        Logger::err("[SceneReplay] Failed to write frame to the scene replay capture, stopping the recording.");
+      } else {
+        ++m_framesRecorded;
+      }
+
+      m_frame.clear();
+
+      if (!written || m_framesRecorded >= captureFrameCount()) {
+        m_writer.close();
+        m_isRecording = false;
+        captureFrameCountObject().setDeferred(0);
+        Logger::info(str::format("[SceneReplay] Recorded ", m_framesRecorded, " frames to ", capturePath()));
+      }
+      return;
+    }
+
+    if (captureFrameCount() > 0) {
+      const std::filesystem::path path(capturePath());
+      if (path.has_parent_path()) {
+        util::createDirectories(path.parent_path());
+      }
+
+      if (!m_writer.open(capturePath())) {
+        Logger::err(str::format("[SceneReplay] Failed to open ", capturePath(), " for writing."));
+        captureFrameCountObject().setDeferred(0);
+        return;
+      }
+
+      // Recording starts with the next frame so every recorded frame is complete
+      m_frame.clear();
+      m_framesRecorded = 0;
+      m_isRecording = true;
+    }
+  }
+}
@@ -0,0 +1,58 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "rtx_option.h"
+#include "rtx_scene_replay_format.h"
+
+namespace dxvk {
+  struct DrawCallState;
+  struct RtLight;
+  class RtCamera;
+
+  // Records the scene management inputs (draw calls, lights and camera) of a range of frames into a
+  // SceneReplay capture. tests/rtx/replay feeds captures through the device independent parts of the
+  // draw call cache and instance matching without a GPU, see there for what that does and does not cover.
+  class SceneReplayRecorder {
+  public:
+    RTX_OPTION("rtx.sceneReplay", uint32_t, captureFrameCount, 0,
+               "Number of frames to record into a scene replay capture, recording starts as soon as this is set to a non-zero value.\n"
+               "The option is reset to 0 once the requested number of frames has been written.");
+    RTX_OPTION("rtx.sceneReplay", std::string, capturePath, "rtx-remix/captures/scene.rxrp", "File path the scene replay capture is written to.");
+
+    bool isRecording() const { return m_isRecording; }
+
+    void recordDraw(const DrawCallState& drawCall);
+    // Rebuilds the recorded subset of a draw call, buffers, textures and the rest of the state are left empty
+    static DrawCallState restoreDraw(const SceneReplay::DrawRecord& record);
+    void recordLight(const RtLight& light);
+
+    // Writes out the frame and starts or stops recording as requested by the options
+    void onFrameEnd(uint32_t frameIndex, const RtCamera& camera);
+
+  private:
+    SceneReplay::Writer m_writer;
+    SceneReplay::Frame m_frame;
+    uint32_t m_framesRecorded = 0;
+    bool m_isRecording = false;
+  };
+}
@@ -0,0 +1,192 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../../util/util_matrix.h"
+#include "../../util/util_vector.h"
+#include "../../util/xxHash/xxhash.h"
+
+namespace dxvk {
+  // Binary capture format for replaying the CPU side scene management of a game without a GPU.
+  // A capture is a header followed by a sequence of frames, each of which holds the camera state,
+  // every draw call submitted to the SceneManager and every light submitted by the game that frame.
+  // All records are plain data written in host byte order, captures are not meant to be portable
+  // across architectures.
+  namespace SceneReplay {
+    static constexpr uint32_t kMagic = 0x50525852; // "RXRP"
+    static constexpr uint32_t kVersion = 2;
+    // Number of geometry hash components (dxvk::HashComponents::Count) stored per draw
+    static constexpr uint32_t kGeometryHashComponentCount = 9;
+
+    struct FileHeader {
+      uint32_t magic = kMagic;
+      uint32_t version = kVersion;
+    };
+
+    // The subset of a DrawCallState that the CPU side scene management (draw call cache, instance matching, GC) depends on
+    struct DrawRecord {
+      // Indexed by HashComponents, the hash rules are combined from these on replay
+      XXH64_hash_t geometryHashes[kGeometryHashComponentCount] = {};
+      XXH64_hash_t materialHash = 0;
+      XXH64_hash_t boneHash = 0;
+      Matrix4 objectToWorld;
+      Vector3 boundingBoxMin;
+      Vector3 boundingBoxMax;
+      uint32_t vertexCount = 0;
+      uint32_t indexCount = 0;
+      uint32_t numBones = 0;
+      uint32_t cameraType = 0;
+      uint32_t categoryFlags = 0;
+    };
+
+    struct LightRecord {
+      XXH64_hash_t hash = 0;
+      Vector3 position;
+      float radius = 0.f;   // Sphere and cylinder lights only
+      uint32_t type = 0;
+    };
+
+    struct CameraRecord {
+      Matrix4 worldToView;
+      Matrix4 viewToProjection;
+    };
+
+    struct FrameHeader {
+      uint32_t frameIndex = 0;
+      uint32_t drawCount = 0;
+      uint32_t lightCount = 0;
+      CameraRecord camera;
+    };
+
+    struct Frame {
+      uint32_t frameIndex = 0;
+      CameraRecord camera;
+      std::vector<DrawRecord> draws;
+      std::vector<LightRecord> lights;
+
+      void clear() {
+        draws.clear();
+        lights.clear();
+      }
+    };
+
+    class Writer {
+    public:
+      bool open(const std::string& path) {
+        m_stream.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_stream.is_open()) {
+          return false;
+        }
+
+        const FileHeader header;
+        m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return m_stream.good();
+      }
+
+      bool isOpen() const {
+        return m_stream.is_open();
+      }
+
+      void close() {
+        m_stream.close();
+      }
+
+      bool writeFrame(const Frame& frame) {
+        FrameHeader header;
+        header.frameIndex = frame.frameIndex;
+        header.drawCount = static_cast<uint32_t>(frame.draws.size());
+        header.lightCount = static_cast<uint32_t>(frame.lights.size());
+        header.camera = frame.camera;
+
+        m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_stream.write(reinterpret_cast<const char*>(frame.draws.data()), sizeof(DrawRecord) * frame.draws.size());
+        m_stream.write(reinterpret_cast<const char*>(frame.lights.data()), sizeof(LightRecord) * frame.lights.size());
+        return m_stream.good();
+      }
+
+    private:
+      std::ofstream m_stream;
+    };
+
+    class Reader {
+    public:
+      bool open(const std::string& path) {
+        m_stream.open(path, std::ios::binary);
+        if (!m_stream.is_open()) {
+          return false;
+        }
+
+        m_stream.seekg(0, std::ios::end);
+        m_remainingSize = static_cast<uint64_t>(m_stream.tellg());
+        m_stream.seekg(0, std::ios::beg);
+
+        FileHeader header;
+        if (!readBytes(&header, sizeof(header))) {
+          return false;
+        }
+
+        return header.magic == kMagic && header.version == kVersion;
+      }
+
+      // Returns false once the end of the capture has been reached, or if the next frame is truncated or corrupt
+      bool readFrame(Frame& frame) {
+        FrameHeader header;
+        if (!readBytes(&header, sizeof(header))) {
+          return false;
+        }
+
+        // Validate the counts against the rest of the file before sizing anything by them
+        const uint64_t payloadSize = sizeof(DrawRecord) * uint64_t(header.drawCount) + sizeof(LightRecord) * uint64_t(header.lightCount);
+        if (payloadSize > m_remainingSize) {
+          m_remainingSize = 0;
+          return false;
+        }
+
+        frame.frameIndex = header.frameIndex;
+        frame.camera = header.camera;
+        frame.draws.resize(header.drawCount);
+        frame.lights.resize(header.lightCount);
+        return readBytes(frame.draws.data(), sizeof(DrawRecord) * frame.draws.size())
+            && readBytes(frame.lights.data(), sizeof(LightRecord) * frame.lights.size());
+      }
+
+    private:
+      std::ifstream m_stream;
+      uint64_t m_remainingSize = 0;
+
+      bool readBytes(void* data, uint64_t size) {
+        if (size > m_remainingSize) {
+          m_remainingSize = 0;
+          return false;
+        }
+
+        m_remainingSize -= size;
+        return size == 0 || bool(m_stream.read(reinterpret_cast<char*>(data), size));
+      }
+    };
+  }
+}
@@ -21,9 +21,14 @@
 */
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <queue>
-#include <unordered_map>
+
+#include "../../util/util_bit.h"
 
 namespace dxvk 
 {
@@ -41,8 +46,9 @@ namespace dxvk
 *  { 0, 1, null, 3, 4, ..., N }
 * 
 *  All previous elements indices remain the same, the recently free'd  'null'
-*  elements (2nd) index is added to a "free list", which implies this element 
-*  should be repopulated next (FIFO) when a new tracking request comes in.
+*  elements (2nd) index is marked as free, and the lowest free index is
+*  repopulated first when a new tracking request comes in.  This keeps live
+*  objects packed towards the start of the table.
 * 
 *  This cache's storage high watermarks based on the total number of unique 
 *  objects in the scene, and so is technically unbounded.
@@ -50,12 +56,22 @@ namespace dxvk
 *  This structure is particularly useful for tracking GPU objects, where persistent
 *  indices for large, dynamic arrays are required.  e.g. bindless resources.
 * 
+*  Lookups go through a flat open addressing (linear probing) table of
+*  { hash, index } pairs, the objects themselves are only stored once in
+*  the object table.  Hashes are cached so that probing only calls KeyEqual
+*  on a hash match, and growing the table does not rehash any object.
+* 
 *  NOTE: This object does no ref counting - its expected that the user supply T 
    as a ref-counted object if that behavior is desired.
 */
 template<typename T, class HashFn, class KeyEqual = std::equal_to<T>>
 struct SparseUniqueCache
 {
+  // Default first cache callback, stores the tracked object as is
+  struct IdentityFn {
+    const T& operator()(const T& in) const { return in; }
+  };
+
 public:
   SparseUniqueCache(SparseUniqueCache const&) = delete;
   SparseUniqueCache& operator=(SparseUniqueCache const&) = delete;
@@ -64,47 +80,70 @@ public:
   ~SparseUniqueCache() {}
 
   void clear() {
-    m_freeBuffers = {};
     m_objects.clear();
-    m_bufferMap.clear();
+    m_slots.clear();
+    m_mask = 0;
+    m_freeMask.clear();
+    m_freeCount = 0;
+    m_firstFreeWord = 0;
   }
 
-  uint32_t track(const T& obj, std::function<T(const T&)> onFirstCache = [](const T& in) { return in; }) {
-    uint32_t idx;
-    if (!find(obj, idx)) {
-      const T& objectToCache = onFirstCache(obj);
-      if (!m_freeBuffers.empty()) {
-        idx = m_freeBuffers.front();
-        m_freeBuffers.pop();
-        m_objects.at(idx) = objectToCache;
-      } else {
-        idx = m_objects.size();
-        m_objects.push_back(objectToCache);
-      }
-      m_bufferMap.insert({ objectToCache, idx });
+  // onFirstCache is called once when an object is tracked for the first time,
+  // the object it returns is stored in the table in place of obj.
+  template<typename FirstCacheFn = IdentityFn>
+  uint32_t track(const T& obj, FirstCacheFn&& onFirstCache = FirstCacheFn()) {
+    const size_t hash = m_hashFn(obj);
+
+    size_t slot;
+    if (findSlot(obj, hash, slot)) {
+      return m_slots[slot].index;
+    }
+
+    const T& objectToCache = onFirstCache(obj);
+    const bool sameHash = std::is_same_v<std::decay_t<FirstCacheFn>, IdentityFn>;
+    const size_t cachedHash = sameHash ? hash : m_hashFn(objectToCache);
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    if ((getActiveCount() + 1) * 2 > m_slots.size()) {
+      rehash(m_slots.empty() ? kMinSlots : m_slots.size() * 2);
+      slot = findEmptySlot(cachedHash);
+    } else if (!sameHash) {
+      slot = findEmptySlot(cachedHash);
+    }
+
+    const uint32_t idx = allocIndex();
+    if (idx < m_objects.size()) {
+      m_objects[idx] = objectToCache;
+    } else {
+      m_objects.push_back(objectToCache);
     }
+
+    m_slots[slot] = { cachedHash, idx };
     return idx;
   }
 
   bool find(const T& buf, uint32_t& outIdx) const {
-    const auto& vtxBuffer = m_bufferMap.find(buf);
-    if (vtxBuffer != m_bufferMap.end()) {
-      outIdx = vtxBuffer->second;
+    size_t slot;
+    if (findSlot(buf, m_hashFn(buf), slot)) {
+      outIdx = m_slots[slot].index;
       return true;
     }
     return false;
   }
 
   void free(const T& buf) {
-    auto iter = m_bufferMap.find(buf);
-    if (iter != m_bufferMap.end()) {
-      m_objects.at(iter->second) = T();
-      m_freeBuffers.push(iter->second);
-      m_bufferMap.erase(iter);
+    size_t slot;
+    if (!findSlot(buf, m_hashFn(buf), slot)) {
+      return;
     }
+
+    const uint32_t idx = m_slots[slot].index;
+    m_objects.at(idx) = T();
+    releaseIndex(idx);
+    eraseSlot(slot);
   }
 
-  uint32_t getActiveCount() const { return m_objects.size() - m_freeBuffers.size(); }
+  uint32_t getActiveCount() const { return m_objects.size() - m_freeCount; }
   uint32_t getTotalCount() const { return m_objects.size(); }
 
   T& at(const uint32_t i) { return m_objects[i]; }
@@ -113,10 +152,111 @@ public:
   std::vector<T>& getObjectTable() { return m_objects; }
 
 private:
-  std::queue<uint32_t> m_freeBuffers;
+  static constexpr uint32_t kEmptyIndex = ~0u;
+  static constexpr size_t kMinSlots = 16;
+
+  struct Slot {
+    size_t hash = 0;
+    uint32_t index = kEmptyIndex;
+  };
+
   std::vector<T> m_objects;
-  std::unordered_map<T, uint32_t, HashFn, KeyEqual> m_bufferMap;
+  std::vector<Slot> m_slots;
+  size_t m_mask = 0;
+
+  // One bit per object table entry, set if the entry is free
+  std::vector<uint32_t> m_freeMask;
+  uint32_t m_freeCount = 0;
+  uint32_t m_firstFreeWord = 0;
+
+  HashFn m_hashFn;
+  KeyEqual m_keyEqual;
+
+  // Returns true and the slot of the object if it is tracked,
+  // otherwise false and the empty slot ending its probe sequence.
+  bool findSlot(const T& obj, size_t hash, size_t& outSlot) const {
+    if (m_slots.empty()) {
+      return false;
+    }
+
+    for (size_t i = hash & m_mask;; i = (i + 1) & m_mask) {
+      const Slot& slot = m_slots[i];
+      if (slot.index == kEmptyIndex) {
+        outSlot = i;
+        return false;
+      }
+      if (slot.hash == hash && m_keyEqual(m_objects[slot.index], obj)) {
+        outSlot = i;
+        return true;
+      }
+    }
+  }
+
+  size_t findEmptySlot(size_t hash) const {
+    size_t i = hash & m_mask;
+    while (m_slots[i].index != kEmptyIndex) {
+      i = (i + 1) & m_mask;
+    }
+    return i;
+  }
+
+  void eraseSlot(size_t i) {
+    // Backward shift deletion: pull following entries of the cluster into the hole
+    // if the hole lies between their home slot and their current slot.
+    for (size_t j = (i + 1) & m_mask;; j = (j + 1) & m_mask) {
+      if (m_slots[j].index == kEmptyIndex) {
+        break;
+      }
+      const size_t home = m_slots[j].hash & m_mask;
+      const bool canMove = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+      if (canMove) {
+        m_slots[i] = m_slots[j];
+        i = j;
+      }
+    }
+
+    m_slots[i] = Slot();
+  }
+
+  void rehash(size_t slotCount) {
+    std::vector<Slot> oldSlots = std::move(m_slots);
+    m_slots.assign(slotCount, Slot());
+    m_mask = slotCount - 1;
+
+    for (const Slot& slot : oldSlots) {
+      if (slot.index != kEmptyIndex) {
+        m_slots[findEmptySlot(slot.hash)] = slot;
+      }
+    }
+  }
+
+  // Returns the lowest free index, or the end of the object table if there is none
+  uint32_t allocIndex() {
+    if (m_freeCount == 0) {
+      const uint32_t idx = m_objects.size();
+      if (idx / 32 >= m_freeMask.size()) {
+        m_freeMask.push_back(0);
+      }
+      return idx;
+    }
+
+    // Words below m_firstFreeWord are known to be fully in use
+    while (m_freeMask[m_firstFreeWord] == 0) {
+      ++m_firstFreeWord;
+    }
+
+    uint32_t& word = m_freeMask[m_firstFreeWord];
+    const uint32_t idx = m_firstFreeWord * 32 + bit::bsf(word);
+    word &= word - 1;
+    --m_freeCount;
+    return idx;
+  }
+
+  void releaseIndex(uint32_t idx) {
+    m_freeMask[idx / 32] |= 1u << (idx % 32);
+    m_firstFreeWord = std::min(m_firstFreeWord, idx / 32);
+    ++m_freeCount;
+  }
 };
 
 }  // namespace dxvk
-
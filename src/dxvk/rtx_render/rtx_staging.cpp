@@ -80,4 +80,50 @@ namespace dxvk {
 
     return m_device->createBuffer(info, m_memoryFlags, DxvkMemoryStats::Category::AppBuffer, m_name);
   }
+
+  RtxFrameStagingArena::ChunkSource::ChunkSource(
+    const Rc<DxvkDevice>& device,
+    const char* name,
+    const VkMemoryPropertyFlagBits memFlags,
+    const VkBufferUsageFlags usageFlags,
+    const VkPipelineStageFlags stages,
+    const VkAccessFlags access)
+    : m_memoryFlags(memFlags)
+    , m_usage(usageFlags)
+    , m_stages(stages)
+    , m_access(access)
+    , m_device(device)
+    , m_name(name) {
+  }
+
+
+  Rc<DxvkBuffer> RtxFrameStagingArena::ChunkSource::createChunk(size_t size) {
+    DxvkBufferCreateInfo info;
+    info.size = size;
+    info.access = m_access;
+    info.stages = m_stages;
+    info.usage = m_usage;
+
+    return m_device->createBuffer(info, m_memoryFlags, DxvkMemoryStats::Category::AppBuffer, m_name);
+  }
+
+
+  RtxFrameStagingArena::RtxFrameStagingArena(
+    const Rc<DxvkDevice>& device,
+    const char* name,
+    const uint32_t framesInFlight,
+    const VkMemoryPropertyFlagBits memFlags,
+    const VkBufferUsageFlags usageFlags,
+    const VkPipelineStageFlags stages,
+    const VkAccessFlags access)
+    : m_chunks(ChunkSource(device, name, memFlags, usageFlags, stages, access), ChunkSize, framesInFlight) {
+  }
+
+
+  DxvkBufferSlice RtxFrameStagingArena::upload(const void* data, VkDeviceSize size, VkDeviceSize align) {
+    ScopedCpuProfileZone();
+
+    const auto allocation = m_chunks.upload(data, size, align);
+    return DxvkBufferSlice(allocation.chunk, allocation.offset, allocation.length);
+  }
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <deque>
 #include <queue>
+#include <vector>
 
 #include "dxvk_buffer.h"
+#include "rtx_staging_chunks.h"
 
 namespace dxvk {
   
@@ -73,4 +76,87 @@ namespace dxvk {
 
     Rc<DxvkBuffer> createBuffer(VkDeviceSize size);
   };
+
+  /**
+   * \brief Per-frame staging arena for small uploads
+   *
+   * Packs small copies (e.g. dynamic vertex streams of UI, particles and
+   * sprites) back to back into large chunks which are acquired once when
+   * first used in a frame and released together in \ref endFrame. Identical
+   * data uploaded more than once in a frame is only copied the first time.
+   * Chunks are recycled once enough frames have passed and the GPU is done.
+   */
+  class RtxFrameStagingArena {
+    constexpr static VkDeviceSize ChunkSize = 1 << 22; // 4 MiB
+
+    // Host visible buffers backing the arena's chunks
+    class ChunkSource {
+    public:
+      using Chunk = Rc<DxvkBuffer>;
+
+      ChunkSource(const Rc<DxvkDevice>& device,
+                  const char* name,
+                  const VkMemoryPropertyFlagBits memFlags,
+                  const VkBufferUsageFlags usageFlags,
+                  const VkPipelineStageFlags stages,
+                  const VkAccessFlags access);
+
+      Chunk createChunk(size_t size);
+
+      size_t chunkSize(const Chunk& chunk) const { return chunk->info().size; }
+      uint8_t* chunkData(const Chunk& chunk) const { return reinterpret_cast<uint8_t*>(chunk->mapPtr(0)); }
+      bool isInUse(const Chunk& chunk) const { return chunk->isInUse(); }
+      void acquire(const Chunk& chunk) const { chunk->acquire(DxvkAccess::Read); }
+      void release(const Chunk& chunk) const { chunk->release(DxvkAccess::Read); }
+
+    private:
+      const VkMemoryPropertyFlagBits m_memoryFlags;
+      const VkBufferUsageFlags m_usage;
+      const VkPipelineStageFlags m_stages;
+      const VkAccessFlags m_access;
+
+      Rc<DxvkDevice>  m_device;
+      const char*     m_name = nullptr;
+    };
+
+  public:
+
+    using Stats = RtxFrameStagingChunks<ChunkSource>::Stats;
+
+    RtxFrameStagingArena(const Rc<DxvkDevice>& device,
+                         const char* name,
+                         const uint32_t framesInFlight,
+                         const VkMemoryPropertyFlagBits memFlags = (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                         const VkBufferUsageFlags usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         const VkPipelineStageFlags stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         const VkAccessFlags access = VK_ACCESS_TRANSFER_READ_BIT);
+
+    /**
+     * \brief Copies data into the arena
+     *
+     * The returned slice stays valid until \ref endFrame has been
+     * called framesInFlight times. It must not be written to, since
+     * it may be shared with other uploads of identical data.
+     * \param [in] data Data to copy
+     * \param [in] size Size of the data in bytes
+     * \param [in] align Alignment of the allocation within the chunk
+     * \returns Slice containing a copy of the data
+     */
+    DxvkBufferSlice upload(const void* data, VkDeviceSize size, VkDeviceSize align);
+
+    /**
+     * \brief Ends the current frame
+     *
+     * Releases all chunks used this frame and makes
+     * chunks from old enough frames available again.
+     * \returns Statistics of the frame that ended
+     */
+    Stats endFrame() {
+      return m_chunks.endFrame();
+    }
+
+  private:
+
+    RtxFrameStagingChunks<ChunkSource> m_chunks;
+  };
 }
@@ -0,0 +1,194 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "../../util/util_flat_hash_map.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Chunk bookkeeping of the per-frame staging arena
+   *
+   * Sub-allocates uploads from chunks, deduplicates identical uploads within
+   * a frame and recycles chunks of old enough frames. How chunks are created
+   * is left to \c ChunkSource, so this works without a device:
+   *  - \c Chunk: ref counted chunk handle, default constructible and comparable to nullptr
+   *  - \c Chunk \c createChunk(size_t size)
+   *  - \c size_t \c chunkSize(const Chunk&)
+   *  - \c uint8_t* \c chunkData(const Chunk&)
+   *  - \c bool \c isInUse(const Chunk&), true while the GPU still reads it
+   *  - \c void \c acquire(const Chunk&) and \c void \c release(const Chunk&)
+   */
+  template<typename ChunkSource>
+  class RtxFrameStagingChunks {
+    constexpr static size_t MaxRetiredChunks = 16;
+  public:
+    using Chunk = typename ChunkSource::Chunk;
+
+    struct Allocation {
+      Chunk chunk;
+      size_t offset = 0;
+      size_t length = 0;
+    };
+
+    struct Stats {
+      uint32_t uploadCount = 0;
+      uint32_t dedupedCount = 0;
+      uint64_t uploadedBytes = 0;
+      uint32_t chunkCount = 0;
+    };
+
+    RtxFrameStagingChunks(ChunkSource&& source, size_t chunkSize, uint32_t framesInFlight)
+      : m_source(std::move(source))
+      , m_chunkSize(chunkSize)
+      , m_framesInFlight(framesInFlight) { }
+
+    ~RtxFrameStagingChunks() {
+      for (const Chunk& chunk : m_frameChunks)
+        m_source.release(chunk);
+    }
+
+    RtxFrameStagingChunks(const RtxFrameStagingChunks&) = delete;
+    RtxFrameStagingChunks& operator=(const RtxFrameStagingChunks&) = delete;
+
+    ChunkSource& source() { return m_source; }
+
+    Allocation upload(const void* data, size_t size, size_t align) {
+      // Seed with the size so that a prefix of another upload never matches it
+      const XXH64_hash_t hash = XXH3_64bits_withSeed(data, size, size);
+
+      auto [allocation, inserted] = m_frameUploads.emplace(hash);
+      if (!inserted) {
+        // A 64 bit hash can collide, so only reuse the allocation if it really holds the same data
+        if (allocation->length == size && memcmp(m_source.chunkData(allocation->chunk) + allocation->offset, data, size) == 0) {
+          ++m_stats.dedupedCount;
+          return *allocation;
+        }
+
+        // Keep the first upload mapped to the hash, colliding data is just not deduplicated
+        return allocate(data, size, align);
+      }
+
+      *allocation = allocate(data, size, align);
+      return *allocation;
+    }
+
+    Stats endFrame() {
+      // Readers of this frame's data hold their own references, and
+      // the GPU tracks its own use, so one release per chunk suffices.
+      for (Chunk& chunk : m_frameChunks) {
+        m_source.release(chunk);
+        m_retiredChunks.push_back({ std::move(chunk), m_frameId });
+      }
+
+      m_frameChunks.clear();
+      m_chunk = nullptr;
+      m_offset = 0;
+      m_frameUploads.clear();
+
+      while (m_retiredChunks.size() > MaxRetiredChunks)
+        m_retiredChunks.pop_front();
+
+      const Stats stats = m_stats;
+      m_stats = Stats();
+      ++m_frameId;
+      return stats;
+    }
+
+  private:
+
+    struct RetiredChunk {
+      Chunk chunk;
+      uint64_t frameId;
+    };
+
+    ChunkSource m_source;
+    const size_t m_chunkSize;
+    const uint32_t m_framesInFlight;
+
+    Chunk     m_chunk;
+    size_t    m_offset = 0;
+    uint64_t  m_frameId = 0;
+
+    // Chunks acquired by the current frame, m_chunk is the last one
+    std::vector<Chunk> m_frameChunks;
+    std::deque<RetiredChunk> m_retiredChunks;
+
+    // Content hash of the data uploaded this frame, to its allocation
+    fast_flat_map<Allocation> m_frameUploads;
+
+    Stats m_stats;
+
+    Allocation allocate(const void* data, size_t size, size_t align) {
+      size_t offset = (m_offset + align - 1) / align * align;
+
+      if (m_chunk == nullptr || offset + size > m_source.chunkSize(m_chunk)) {
+        beginChunk(size);
+        offset = 0;
+      }
+
+      memcpy(m_source.chunkData(m_chunk) + offset, data, size);
+      m_offset = offset + size;
+
+      ++m_stats.uploadCount;
+      m_stats.uploadedBytes += size;
+      return { m_chunk, offset, size };
+    }
+
+    void beginChunk(size_t size) {
+      const size_t chunkSize = std::max(m_chunkSize, size);
+
+      m_chunk = nullptr;
+
+      // Retired chunks are ordered by frame, so only the front ones can be old enough
+      while (!m_retiredChunks.empty() && m_retiredChunks.front().frameId + m_framesInFlight <= m_frameId) {
+        if (m_source.isInUse(m_retiredChunks.front().chunk))
+          break;
+
+        Chunk chunk = std::move(m_retiredChunks.front().chunk);
+        m_retiredChunks.pop_front();
+
+        // Only an oversized upload can find a chunk too small, drop it in that case
+        if (m_source.chunkSize(chunk) >= chunkSize) {
+          m_chunk = std::move(chunk);
+          break;
+        }
+      }
+
+      if (m_chunk == nullptr)
+        m_chunk = m_source.createChunk(chunkSize);
+
+      // Acquire prevents the chunk from being recycled while this frame still references it
+      m_source.acquire(m_chunk);
+      m_frameChunks.push_back(m_chunk);
+      m_offset = 0;
+      ++m_stats.chunkCount;
+    }
+  };
+
+}
@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "rtx_texture_category_cache.h"
+#include "rtx_options.h"
+
+namespace dxvk {
+
+namespace {
+  void addOptionCategories(TextureCategoryCache& cache) {
+    cache.addInstanceCategory(RtxOptions::worldSpaceUiTexturesObject(), InstanceCategories::WorldUI);
+    cache.addInstanceCategory(RtxOptions::worldSpaceUiBackgroundTexturesObject(), InstanceCategories::WorldMatte);
+    cache.addInstanceCategory(RtxOptions::ignoreTexturesObject(), InstanceCategories::Ignore);
+    cache.addInstanceCategory(RtxOptions::ignoreLightsObject(), InstanceCategories::IgnoreLights);
+    cache.addInstanceCategory(RtxOptions::antiCullingTexturesObject(), InstanceCategories::IgnoreAntiCulling);
+    cache.addInstanceCategory(RtxOptions::motionBlurMaskOutTexturesObject(), InstanceCategories::IgnoreMotionBlur);
+    cache.addInstanceCategory(RtxOptions::opacityMicromapIgnoreTexturesObject(), InstanceCategories::IgnoreOpacityMicromap);
+    cache.addInstanceCategory(RtxOptions::ignoreAlphaOnTexturesObject(), InstanceCategories::IgnoreAlphaChannel);
+    cache.addInstanceCategory(RtxOptions::ignoreBakedLightingTexturesObject(), InstanceCategories::IgnoreBakedLighting);
+    cache.addInstanceCategory(RtxOptions::hideInstanceTexturesObject(), InstanceCategories::Hidden);
+    cache.addInstanceCategory(RtxOptions::particleTexturesObject(), InstanceCategories::Particle);
+    cache.addInstanceCategory(RtxOptions::beamTexturesObject(), InstanceCategories::Beam);
+    cache.addInstanceCategory(RtxOptions::ignoreTransparencyLayerTexturesObject(), InstanceCategories::IgnoreTransparencyLayer);
+    cache.addInstanceCategory(RtxOptions::decalTexturesObject(), InstanceCategories::DecalStatic);
+    cache.addInstanceCategory(RtxOptions::dynamicDecalTexturesObject(), InstanceCategories::DecalDynamic);
+    cache.addInstanceCategory(RtxOptions::singleOffsetDecalTexturesObject(), InstanceCategories::DecalSingleOffset);
+    cache.addInstanceCategory(RtxOptions::nonOffsetDecalTexturesObject(), InstanceCategories::DecalNoOffset);
+    cache.addInstanceCategory(RtxOptions::animatedWaterTexturesObject(), InstanceCategories::AnimatedWater);
+    cache.addInstanceCategory(RtxOptions::playerModelTexturesObject(), InstanceCategories::ThirdPersonPlayerModel);
+    cache.addInstanceCategory(RtxOptions::playerModelBodyTexturesObject(), InstanceCategories::ThirdPersonPlayerBody);
+    cache.addInstanceCategory(RtxOptions::terrainTexturesObject(), InstanceCategories::Terrain);
+    cache.addInstanceCategory(RtxOptions::skyBoxTexturesObject(), InstanceCategories::Sky);
+    cache.addInstanceCategory(RtxOptions::particleEmitterTexturesObject(), InstanceCategories::ParticleEmitter);
+
+    cache.addTextureCategory(RtxOptions::lightmapTexturesObject(), TextureCategories::Lightmap);
+    cache.addTextureCategory(RtxOptions::raytracedRenderTargetTexturesObject(), TextureCategories::RaytracedRenderTarget);
+  }
+}
+
+TextureCategoryCache& TextureCategoryCache::get() {
+  static TextureCategoryCache s_instance;
+  static const bool s_hasCategories = (addOptionCategories(s_instance), true);
+  (void) s_hasCategories;
+  return s_instance;
+}
+
+TextureCategoryCache::TextureCategoryCache()
+  : m_published(new CategoryMap()) {
+  // Force the first lookup to populate the cache
+  m_hashSetVersion = RtxOptionImpl::s_hashSetVersion.load(std::memory_order_acquire) - 1;
+}
+
+TextureCategoryCache::~TextureCategoryCache() {
+  delete m_published.load(std::memory_order_relaxed);
+}
+
+void TextureCategoryCache::addInstanceCategory(RtxOption<fast_unordered_set>& option, const InstanceCategories category) {
+  // Start out of date so it gets populated on the first update
+  m_sources.push_back({ &option, category, TextureCategories::Count, option.getVersion() - 1 });
+}
+
+void TextureCategoryCache::addTextureCategory(RtxOption<fast_unordered_set>& option, const TextureCategories category) {
+  m_sources.push_back({ &option, InstanceCategories::Count, category, option.getVersion() - 1 });
+}
+
+TextureCategoryFlags TextureCategoryCache::lookup(const XXH64_hash_t textureHash) {
+  if (m_hashSetVersion.load(std::memory_order_acquire) != RtxOptionImpl::s_hashSetVersion.load(std::memory_order_acquire)) {
+    update();
+  }
+
+  const TextureCategoryFlags* flags = m_published.load(std::memory_order_acquire)->find(textureHash);
+  return flags ? *flags : TextureCategoryFlags {};
+}
+
+void TextureCategoryCache::update() {
+  std::lock_guard<std::mutex> lock(m_updateMutex);
+
+  // Sample the global version before reading the options, so a change made while updating triggers another update
+  const uint32_t hashSetVersion = RtxOptionImpl::s_hashSetVersion.load(std::memory_order_acquire);
+  if (m_hashSetVersion.load(std::memory_order_relaxed) == hashSetVersion) {
+    // Another thread already brought the cache up to date
+    return;
+  }
+
+  bool anyUpdated = false;
+  for (CategorySource& source : m_sources) {
+    const uint32_t version = source.option->getVersion();
+    if (version == source.version) {
+      continue;
+    }
+
+    updateSource(source);
+    source.version = version;
+    anyUpdated = true;
+  }
+
+  if (anyUpdated) {
+    // Drop textures which no longer belong to any category
+    m_categories.erase_if([](XXH64_hash_t, const TextureCategoryFlags& flags) { return flags.isClear(); });
+
+    // Lookups in flight may still read the previous snapshot, it is freed once they are done
+    const CategoryMap* retired = m_published.exchange(new CategoryMap(m_categories), std::memory_order_acq_rel);
+    RtxOptionImpl::retireAfterFrame(const_cast<CategoryMap*>(retired), [](void* categories) {
+      delete static_cast<CategoryMap*>(categories);
+    });
+  }
+
+  m_hashSetVersion.store(hashSetVersion, std::memory_order_release);
+}
+
+void TextureCategoryCache::updateSource(CategorySource& source) {
+  const bool isInstanceCategory = source.instanceCategory != InstanceCategories::Count;
+
+  // Remove the category from every texture, then re-add it for the textures currently in the option
+  m_categories.for_each([&](XXH64_hash_t, TextureCategoryFlags& flags) {
+    if (isInstanceCategory) {
+      flags.instanceCategories.clr(source.instanceCategory);
+    } else {
+      flags.textureCategories.clr(source.textureCategory);
+    }
+  });
+
+  for (const XXH64_hash_t textureHash : source.option->get()) {
+    TextureCategoryFlags& flags = m_categories[textureHash];
+    if (isInstanceCategory) {
+      flags.instanceCategories.set(source.instanceCategory);
+    } else {
+      flags.textureCategories.set(source.textureCategory);
+    }
+  }
+}
+
+}  // namespace dxvk
@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "rtx_types.h"
+#include "../../util/util_flat_hash_map.h"
+
+namespace dxvk {
+
+template <typename T>
+class RtxOption;
+
+// Texture level classifications which are looked up by texture hash alongside InstanceCategories,
+// but which are not instance categories themselves.
+enum class TextureCategories : uint32_t {
+  Lightmap,
+  RaytracedRenderTarget,
+
+  Count,
+};
+
+struct TextureCategoryFlags {
+  CategoryFlags instanceCategories = 0;
+  Flags<TextureCategories> textureCategories = 0;
+
+  bool isClear() const { return instanceCategories.isClear() && textureCategories.isClear(); }
+};
+
+// Resolves the set of texture hash based categories (rtx.ignoreTextures, rtx.decalTextures, ...) of a texture
+// with a single lookup, instead of probing every category's hash set individually for every draw.
+//
+// The cache maps a texture hash to the precomputed union of all categories it belongs to. It is kept in sync with
+// the category options incrementally: whenever an option layer or a runtime change modifies a hash set option, only
+// the categories whose option changed are removed and re-added.
+//
+// Lookups never lock: they read an immutable snapshot of the map that is published through an atomic pointer, the
+// same way RtxOption values are. A replaced snapshot is freed with RtxOptionImpl::retireAfterFrame().
+class TextureCategoryCache {
+public:
+  // Covers every texture category option of RtxOptions
+  static TextureCategoryCache& get();
+
+  TextureCategoryCache();
+  ~TextureCategoryCache();
+
+  TextureCategoryCache(const TextureCategoryCache&) = delete;
+  TextureCategoryCache& operator=(const TextureCategoryCache&) = delete;
+
+  // Categories must be added before the first lookup
+  void addInstanceCategory(RtxOption<fast_unordered_set>& option, const InstanceCategories category);
+  void addTextureCategory(RtxOption<fast_unordered_set>& option, const TextureCategories category);
+
+  // Returns all categories the given texture hash belongs to
+  TextureCategoryFlags lookup(const XXH64_hash_t textureHash);
+
+private:
+  using CategoryMap = fast_flat_map<TextureCategoryFlags>;
+
+  struct CategorySource {
+    RtxOption<fast_unordered_set>* option;
+    InstanceCategories instanceCategory;
+    TextureCategories textureCategory;
+    uint32_t version;
+  };
+
+  void update();
+  void updateSource(CategorySource& source);
+
+  // Serializes updates, lookups only read m_published
+  std::mutex m_updateMutex;
+  std::atomic<uint32_t> m_hashSetVersion;
+  std::vector<CategorySource> m_sources;
+  // Working copy owned by update(), copied into a new snapshot whenever it changed
+  CategoryMap m_categories;
+  std::atomic<const CategoryMap*> m_published;
+};
+
+}  // namespace dxvk
@@ -26,6 +26,7 @@
 #include "rtx_terrain_baker.h"
 #include "rtx_instance_manager.h"
 #include "rtx_light_manager.h"
+#include "rtx_texture_category_cache.h"
 #include "graph/rtx_graph_instance.h"
 #include "dxvk_scoped_annotation.h"
 
@@ -272,6 +273,16 @@ namespace dxvk {
     return false;
   }
 
+  bool DrawCallState::hasUnreadyFutures() const {
+    auto unready = [](const auto& future) {
+      return future.valid() && !future.ready();
+    };
+
+    return unready(geometryData.futureGeometryHashes)
+        || unready(geometryData.futureBoundingBox)
+        || unready(futureSkinningData);
+  }
+
   bool DrawCallState::finalizeGeometryHashes() {
     if (!geometryData.futureGeometryHashes.valid()) {
       return false;
@@ -339,41 +350,12 @@ namespace dxvk {
   }
 
   void DrawCallState::setupCategoriesForTexture() {
-    // TODO (REMIX-231): It would probably be much more efficient to use a map of texture hash to category flags, rather
-    //                   than doing N lookups per texture hash for each category.
     const XXH64_hash_t& textureHash = materialData.getColorTexture().getImageHash();
 
-    setCategory(InstanceCategories::WorldUI, lookupHash(RtxOptions::worldSpaceUiTextures(), textureHash));
-    setCategory(InstanceCategories::WorldMatte, lookupHash(RtxOptions::worldSpaceUiBackgroundTextures(), textureHash));
-
-    setCategory(InstanceCategories::Ignore, lookupHash(RtxOptions::ignoreTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreLights, lookupHash(RtxOptions::ignoreLights(), textureHash));
-    setCategory(InstanceCategories::IgnoreAntiCulling, lookupHash(RtxOptions::antiCullingTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreMotionBlur, lookupHash(RtxOptions::motionBlurMaskOutTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreOpacityMicromap, lookupHash(RtxOptions::opacityMicromapIgnoreTextures(), textureHash) || isUsingRaytracedRenderTarget);
-    setCategory(InstanceCategories::IgnoreAlphaChannel, lookupHash(RtxOptions::ignoreAlphaOnTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreBakedLighting, lookupHash(RtxOptions::ignoreBakedLightingTextures(), textureHash));
-
-    setCategory(InstanceCategories::Hidden, lookupHash(RtxOptions::hideInstanceTextures(), textureHash));
-
-    setCategory(InstanceCategories::Particle, lookupHash(RtxOptions::particleTextures(), textureHash));
-    setCategory(InstanceCategories::Beam, lookupHash(RtxOptions::beamTextures(), textureHash));
-    setCategory(InstanceCategories::IgnoreTransparencyLayer, lookupHash(RtxOptions::ignoreTransparencyLayerTextures(), textureHash));
-
-    setCategory(InstanceCategories::DecalStatic, lookupHash(RtxOptions::decalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalDynamic, lookupHash(RtxOptions::dynamicDecalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalSingleOffset, lookupHash(RtxOptions::singleOffsetDecalTextures(), textureHash));
-    setCategory(InstanceCategories::DecalNoOffset, lookupHash(RtxOptions::nonOffsetDecalTextures(), textureHash));
-
-    setCategory(InstanceCategories::AnimatedWater, lookupHash(RtxOptions::animatedWaterTextures(), textureHash));
-
-    setCategory(InstanceCategories::ThirdPersonPlayerModel, lookupHash(RtxOptions::playerModelTextures(), textureHash));
-    setCategory(InstanceCategories::ThirdPersonPlayerBody, lookupHash(RtxOptions::playerModelBodyTextures(), textureHash));
-
-    setCategory(InstanceCategories::Terrain, lookupHash(RtxOptions::terrainTextures(), textureHash));
-    setCategory(InstanceCategories::Sky, lookupHash(RtxOptions::skyBoxTextures(), textureHash));
+    // All texture hash based categories are resolved with a single lookup
+    categories.set(TextureCategoryCache::get().lookup(textureHash).instanceCategories);
 
-    setCategory(InstanceCategories::ParticleEmitter, lookupHash(RtxOptions::particleEmitterTextures(), textureHash));
+    setCategory(InstanceCategories::IgnoreOpacityMicromap, isUsingRaytracedRenderTarget);
   }
 
   void DrawCallState::setupCategoriesForGeometry() {
@@ -30,8 +30,11 @@
 #include "../../util/util_bounding_box.h"
 #include "../../util/util_threadpool.h"
 #include "../../util/util_spatial_map.h"
+#include "../../util/util_frame_arena.h"
+#include "../../util/util_vertex_compression.h"
 
 #include <inttypes.h>
+#include <cstring>
 #include <vector>
 #include <future>
 
@@ -170,7 +173,10 @@ private:
 // circular includes.  This probably requires a 
 // general cleanup.
 struct SkinningData {
-  std::vector<Matrix4> pBoneMatrices;
+  // Note: bone matrices of draw calls are allocated from a FrameArena, copies of the skinning data go to the heap.
+  using BoneMatrices = std::vector<Matrix4, FrameArenaAllocator<Matrix4>>;
+
+  BoneMatrices pBoneMatrices;
   uint32_t numBones = 0;
   uint32_t numBonesPerVertex = 0;
   XXH64_hash_t boneHash = 0;
@@ -189,6 +195,14 @@ struct SkinningData {
 };
 
 
+// Float copies of a compact mesh's positions and texcoords for CPU side consumers (see GeometryBufferData).
+// Each stream is decoded on first use and shared by every copy of the mesh's RasterGeometry.
+struct CompactVertexDecodeCache {
+  dxvk::mutex mutex;
+  std::vector<float> positions;
+  std::vector<float> texcoords;
+};
+
 // Stores the geometry data representing a raytracable object
 // Valid until the object is destroyed.
 struct RaytraceGeometry {
@@ -219,10 +233,29 @@ struct RaytraceGeometry {
   Rc<DxvkBuffer> historyBuffer[2] = {nullptr};
   Rc<DxvkBuffer> indexCacheBuffer = nullptr;
 
+  // Dequantization range of quantized positions, see RasterGeometry
+  Vector3 positionQuantizationBias { 0.f, 0.f, 0.f };
+  Vector3 positionQuantizationScale { 1.f, 1.f, 1.f };
+
   bool usesIndices() const { 
     return indexBuffer.defined();
   }
 
+  // Quantized positions are kept in their normalized encoding on the GPU, the BLAS builds and shaders read them as is
+  bool hasQuantizedPositions() const {
+    return positionBuffer.vertexFormat() == VK_FORMAT_R16G16B16A16_SNORM;
+  }
+
+  // Maps normalized positions to object space, folded into the transforms quantized positions are placed with
+  Matrix4 getPositionDequantization() const {
+    return Matrix4 {
+      Vector4(positionQuantizationScale.x, 0.f, 0.f, 0.f),
+      Vector4(0.f, positionQuantizationScale.y, 0.f, 0.f),
+      Vector4(0.f, 0.f, positionQuantizationScale.z, 0.f),
+      Vector4(positionQuantizationBias.x, positionQuantizationBias.y, positionQuantizationBias.z, 1.f)
+    };
+  }
+
   uint32_t calculatePrimitiveCount() const {
     return (usesIndices() ? indexCount : vertexCount) / 3;
   }
@@ -262,6 +295,14 @@ struct RasterGeometry {
   AxisAlignedBoundingBox boundingBox;
   Future<AxisAlignedBoundingBox> futureBoundingBox;
 
+  // Dequantization range for VK_FORMAT_R16G16B16A16_SNORM positions (compact replacement vertex format),
+  // position = positionQuantizationBias + positionQuantizationScale * snorm
+  Vector3 positionQuantizationBias { 0.f, 0.f, 0.f };
+  Vector3 positionQuantizationScale { 1.f, 1.f, 1.f };
+
+  // Set for meshes in the compact replacement vertex format
+  std::shared_ptr<CompactVertexDecodeCache> compactVertexDecodeCache;
+
   remixapi_MaterialHandle externalMaterial = nullptr;
 
   template<uint32_t rule>
@@ -308,7 +349,7 @@ struct RasterGeometry {
   bool areFormatsGpuFriendly() const {
     assert(positionBuffer.defined());
 
-    if (positionBuffer.vertexFormat() != VK_FORMAT_R32G32B32_SFLOAT && positionBuffer.vertexFormat() != VK_FORMAT_R32G32B32A32_SFLOAT)
+    if (positionBuffer.vertexFormat() != VK_FORMAT_R32G32B32_SFLOAT && positionBuffer.vertexFormat() != VK_FORMAT_R32G32B32A32_SFLOAT && positionBuffer.vertexFormat() != VK_FORMAT_R16G16B16A16_SNORM)
       return false;
 
     if (normalBuffer.defined() && (normalBuffer.vertexFormat() != VK_FORMAT_R32G32B32_SFLOAT && normalBuffer.vertexFormat() != VK_FORMAT_R32G32B32A32_SFLOAT && normalBuffer.vertexFormat() != VK_FORMAT_R32_UINT))
@@ -383,6 +424,10 @@ struct GeometryBufferData {
   uint32_t* vertexColorData;
   size_t vertexColorStride;
 
+  // Float copies of compact streams for meshes without a decode cache, the data pointers above point into them
+  std::vector<float> decodedPositions;
+  std::vector<float> decodedTexcoords;
+
   GeometryBufferData(const RasterGeometry& geometryData) {
     if (geometryData.indexBuffer.defined()) {
       constexpr size_t indexSize = sizeof(uint16_t);
@@ -393,7 +438,22 @@ struct GeometryBufferData {
       indexData = nullptr;
     }
 
-    if (geometryData.positionBuffer.defined()) {
+    // Note: Compact (quantized) positions and texcoords are decoded to 32 bit floats here, CPU side consumers
+    //       only handle floats. The decoded streams are cached per mesh as these consumers run every frame.
+    if (geometryData.positionBuffer.defined() && geometryData.positionBuffer.vertexFormat() == VK_FORMAT_R16G16B16A16_SNORM) {
+      vtxcompress::PositionQuantization quantization;
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        quantization.bias[axis] = geometryData.positionQuantizationBias[axis];
+        quantization.scale[axis] = geometryData.positionQuantizationScale[axis];
+      }
+      positionData = decodeCompactStream(geometryData, geometryData.positionBuffer, &CompactVertexDecodeCache::positions, decodedPositions, 3,
+        [&quantization](const uint8_t* pEncoded, float* pDecoded) {
+          int16_t encoded[4];
+          memcpy(encoded, pEncoded, sizeof(encoded));
+          vtxcompress::decodePosition(quantization, encoded, pDecoded);
+        });
+      positionStride = 3;
+    } else if (geometryData.positionBuffer.defined()) {
       constexpr size_t positionSubElementSize = sizeof(float);
       positionStride = geometryData.positionBuffer.stride() / positionSubElementSize;
       positionData = (float*) geometryData.positionBuffer.mapPtr((size_t) geometryData.positionBuffer.offsetFromSlice());
@@ -402,7 +462,15 @@ struct GeometryBufferData {
       positionData = nullptr;
     }
 
-    if (geometryData.texcoordBuffer.defined()) {
+    if (geometryData.texcoordBuffer.defined() && geometryData.texcoordBuffer.vertexFormat() == VK_FORMAT_R16G16_SFLOAT) {
+      texcoordData = decodeCompactStream(geometryData, geometryData.texcoordBuffer, &CompactVertexDecodeCache::texcoords, decodedTexcoords, 2,
+        [](const uint8_t* pEncoded, float* pDecoded) {
+          uint32_t encoded;
+          memcpy(&encoded, pEncoded, sizeof(encoded));
+          vtxcompress::decodeTexcoord(encoded, pDecoded);
+        });
+      texcoordStride = 2;
+    } else if (geometryData.texcoordBuffer.defined()) {
       constexpr size_t texcoordSubElementSize = sizeof(float);
       texcoordStride = geometryData.texcoordBuffer.stride() / texcoordSubElementSize;
       texcoordData = (float*) geometryData.texcoordBuffer.mapPtr((size_t) geometryData.texcoordBuffer.offsetFromSlice());
@@ -430,6 +498,36 @@ struct GeometryBufferData {
     }
   }
 
+  GeometryBufferData(const GeometryBufferData&) = delete;
+  GeometryBufferData& operator=(const GeometryBufferData&) = delete;
+
+private:
+  // Decodes a compact stream into the mesh's decode cache unless an earlier call already did, meshes without a cache
+  // decode into localStream instead. The cached streams are never modified once filled.
+  template<typename DecodeVertex>
+  static float* decodeCompactStream(const RasterGeometry& geometryData, const RasterBuffer& buffer, std::vector<float> CompactVertexDecodeCache::* cachedStream,
+                                    std::vector<float>& localStream, const size_t componentCount, const DecodeVertex& decodeVertex) {
+    CompactVertexDecodeCache* cache = geometryData.compactVertexDecodeCache.get();
+    std::vector<float>& stream = cache ? cache->*cachedStream : localStream;
+
+    std::unique_lock<dxvk::mutex> lock;
+    if (cache) {
+      lock = std::unique_lock<dxvk::mutex>(cache->mutex);
+    }
+
+    if (stream.empty()) {
+      const uint8_t* pEncoded = (const uint8_t*) buffer.mapPtr((size_t) buffer.offsetFromSlice());
+      stream.resize(geometryData.vertexCount * componentCount);
+      for (uint32_t i = 0; i < geometryData.vertexCount; ++i, pEncoded += buffer.stride()) {
+        decodeVertex(pEncoded, &stream[i * componentCount]);
+      }
+    }
+
+    return stream.data();
+  }
+
+public:
+
   uint16_t getIndex(uint32_t i) const {
     return indexData[i * indexStride];
   }
@@ -564,6 +662,9 @@ struct DrawCallState {
 
   bool finalizePendingFutures(const RtCamera* pLastCamera);
 
+  // True if finalizePendingFutures would block on the geometry worker threads
+  bool hasUnreadyFutures() const;
+
   bool hasTextureCoordinates() const {
     return getGeometryData().texcoordBuffer.defined() || getTransformData().texgenMode != TexGenMode::None;
   }
@@ -667,6 +768,7 @@ private:
   friend class TerrainBaker;
   friend struct RemixAPIPrivateAccessor;
   friend class RtxParticleSystemManager;
+  friend class SceneReplayRecorder;
 
   bool finalizeGeometryHashes();
   void finalizeGeometryBoundingBox();
@@ -25,8 +25,11 @@
 
 // This function can be executed on the CPU or GPU!!
 #ifdef __cplusplus
+#include <glm/gtc/packing.hpp>
+
 #define asfloat(x) *reinterpret_cast<const float*>(&x)
 #define asuint(x) *reinterpret_cast<const uint32_t*>(&x)
+#define f16tof32(x) glm::unpackHalf1x16(uint16_t(x))
 #define WriteBuffer(T) T*
 #define ReadBuffer(T) const T*
 #else
@@ -39,9 +42,12 @@ namespace interleaver {
   enum SupportedVkFormats : uint32_t {
     VK_FORMAT_R8G8B8A8_UNORM = 37,
     VK_FORMAT_A2B10G10R10_SNORM_PACK32 = 65,
+    VK_FORMAT_R16G16_SFLOAT = 83,
 
     // Passthrough format mapping
     VK_FORMAT_B8G8R8A8_UNORM = 44,
+    VK_FORMAT_R16G16B16A16_SNORM = 92,
+    VK_FORMAT_R32_UINT = 98,
     VK_FORMAT_R32G32_SFLOAT = 103,
     VK_FORMAT_R32G32B32_SFLOAT = 106,
     VK_FORMAT_R32G32B32A32_SFLOAT = 109,
@@ -54,12 +60,23 @@ namespace interleaver {
     case SupportedVkFormats::VK_FORMAT_R32G32B32A32_SFLOAT:
     case SupportedVkFormats::VK_FORMAT_R8G8B8A8_UNORM:
     case SupportedVkFormats::VK_FORMAT_A2B10G10R10_SNORM_PACK32:
+    case SupportedVkFormats::VK_FORMAT_R16G16_SFLOAT:
       return true;
     default:
       return false;
     }
   }
 
+  // 32 bit octahedral normals are consumed as is by the rest of the renderer, so they are copied rather than expanded
+  bool isOctahedralNormalFormat(uint32_t format) {
+    return format == SupportedVkFormats::VK_FORMAT_R32_UINT;
+  }
+
+  // Quantized positions are used in their normalized encoding by the BLAS builds and shaders, so they are copied as well
+  bool isQuantizedPositionFormat(uint32_t format) {
+    return format == SupportedVkFormats::VK_FORMAT_R16G16B16A16_SNORM;
+  }
+
   bool formatConversionUintSupported(uint32_t format) {
     switch (format) {
     case SupportedVkFormats::VK_FORMAT_B8G8R8A8_UNORM:
@@ -92,6 +109,11 @@ namespace interleaver {
       float r = unorm10ToF32(data >> 0);
       return float3(r, g, b);
     }
+    case SupportedVkFormats::VK_FORMAT_R16G16_SFLOAT:
+    {
+      uint data = asuint(input[index]);
+      return float3(f16tof32(data & 0xFFFF), f16tof32(data >> 16), 0);
+    }
     }
     return float3(1, 1, 1);
   }
@@ -110,16 +132,25 @@ namespace interleaver {
 
     uint32_t writeOffset = 0;
 
-    float3 position = convert(cb.positionFormat, srcPosition, srcVertexIndex * cb.positionStride + cb.positionOffset);
-    dst[idx * cb.outputStride + writeOffset++] = position.x;
-    dst[idx * cb.outputStride + writeOffset++] = position.y;
-    dst[idx * cb.outputStride + writeOffset++] = position.z;
+    if (isQuantizedPositionFormat(cb.positionFormat)) {
+      dst[idx * cb.outputStride + writeOffset++] = srcPosition[srcVertexIndex * cb.positionStride + cb.positionOffset + 0];
+      dst[idx * cb.outputStride + writeOffset++] = srcPosition[srcVertexIndex * cb.positionStride + cb.positionOffset + 1];
+    } else {
+      float3 position = convert(cb.positionFormat, srcPosition, srcVertexIndex * cb.positionStride + cb.positionOffset);
+      dst[idx * cb.outputStride + writeOffset++] = position.x;
+      dst[idx * cb.outputStride + writeOffset++] = position.y;
+      dst[idx * cb.outputStride + writeOffset++] = position.z;
+    }
 
     if (cb.hasNormals) {
-      float3 normals = convert(cb.normalFormat, srcNormal, srcVertexIndex * cb.normalStride + cb.normalOffset);
-      dst[idx * cb.outputStride + writeOffset++] = normals.x;
-      dst[idx * cb.outputStride + writeOffset++] = normals.y;
-      dst[idx * cb.outputStride + writeOffset++] = normals.z;
+      if (isOctahedralNormalFormat(cb.normalFormat)) {
+        dst[idx * cb.outputStride + writeOffset++] = srcNormal[srcVertexIndex * cb.normalStride + cb.normalOffset];
+      } else {
+        float3 normals = convert(cb.normalFormat, srcNormal, srcVertexIndex * cb.normalStride + cb.normalOffset);
+        dst[idx * cb.outputStride + writeOffset++] = normals.x;
+        dst[idx * cb.outputStride + writeOffset++] = normals.y;
+        dst[idx * cb.outputStride + writeOffset++] = normals.z;
+      }
     }
 
     if (cb.hasTexcoord) {
@@ -141,4 +172,5 @@ namespace interleaver {
 
 #undef asfloat
 #undef asuint
+#undef f16tof32
 #endif
\ No newline at end of file
@@ -32,8 +32,9 @@ struct GpuSpawnContext {
   uint spawnMeshPositionsOffset;
   uint spawnMeshColorsOffset;
   uint spawnMeshTexcoordsOffset;
-  uint numTriangles : 31;
+  uint numTriangles : 30;
   uint indices32bit : 1;
+  uint quantizedPositions : 1;
 
   uint16_t spawnMeshPositionsStride;
   uint16_t spawnMeshColorsStride;
@@ -44,6 +45,10 @@ struct GpuSpawnContext {
   uint16_t spawnMeshColorsIdx;
   uint16_t spawnMeshIndexIdx;
   uint16_t spawnMeshTexcoordsIdx;
+
+  // Dequantization of quantized (VK_FORMAT_R16G16B16A16_SNORM) positions: position = bias + scale * snorm
+  vec3 spawnMeshPositionBias;
+  vec3 spawnMeshPositionScale;
 };
 
 struct RtxParticleSystemDesc { 
@@ -22,6 +22,7 @@
 #include "game_exporter.h"
 #include "game_exporter_common.h"
 #include "mdl_helpers.h"
+#include "sample_spill.h"
 #include "../util/log/log.h"
 #include "../util/util_env.h"
 #include "../util/util_string.h"
@@ -63,17 +64,20 @@
 #include <pxr/base/gf/matrix4d.h>
 #include <pxr/base/gf/rotation.h>
 #include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/base/plug/registry.h>
 #include <pxr/base/plug/plugin.h>
 #include "usd_include_end.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <sstream>
 
 // Embedded MDLs
 #include <AperturePBR_Opacity.mdl.h>
@@ -172,6 +176,33 @@ namespace lss {
 bool GameExporter::s_bMultiThreadSafety = false;
 std::mutex GameExporter::s_mutex;
 
+// Stable indexable view of an IdMap, so its entries can be split across threads
+template<typename T>
+std::vector<const typename IdMap<T>::value_type*> collectEntries(const IdMap<T>& map) {
+  std::vector<const typename IdMap<T>::value_type*> entries;
+  entries.reserve(map.size());
+  for (const auto& entry : map) {
+    entries.push_back(&entry);
+  }
+  return entries;
+}
+
+// Calls fn(i) for every i in [0, count). Each call must only author its own layer.
+template<typename F>
+void forEachLayer(const Export& exportData, const size_t count, const F& fn) {
+  if (exportData.meta.bParallelLayerExport) {
+    pxr::WorkParallelForN(count, [&fn](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+    });
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+  }
+}
+
 std::string computeLocalPath(const std::string& assetPath) {  
   static pxr::ArResolver& resolver = pxr::ArGetResolver();
   const std::string identifier = resolver.CreateIdentifierForNewAsset(assetPath);
@@ -210,7 +241,7 @@ void GameExporter::exportUsdInternal(const Export& exportData) {
     setCommonStageMetaData(ctx.instanceStage, exportData);
     ctx.instanceStage->SetStartTimeCode(exportData.meta.startTimeCode);
     ctx.instanceStage->SetEndTimeCode(exportData.meta.endTimeCode);
-    ctx.instanceStage->Save();
+    saveStage(ctx.instanceStage, exportData);
   }
   dxvk::Logger::info("[GameExporter][" + exportData.debugId + "] Export end");
 }
@@ -344,7 +375,14 @@ void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx)
   const std::string fullMaterialBasePath = computeLocalPath(matDirPath);
   
   dxvk::env::createDirectory(matDirPath);
-  for(const auto& [matId, matData] : exportData.materials) {
+
+  const auto materials = collectEntries(exportData.materials);
+  std::vector<Reference> matLssReferences(materials.size());
+
+  // Every material is authored into its own layer, so the layers can be written concurrently
+  forEachLayer(exportData, materials.size(), [&](const size_t i) {
+    const Material& matData = materials[i]->second;
+
     // Build material stage
     const std::string matName = prefix::mat + matData.matName;
     const std::string matStageName = matName + ctx.extension;
@@ -410,12 +448,19 @@ void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx)
     ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeU].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeU)));
     ASSERT_OR_EXECUTE(shaderAttrs[ShaderAttr::WrapModeV].Set((uint32_t)lss::Mdl::WrapMode::vkToMdl(matData.sampler.addrModeV)));
 
-    matStage->Save();
+    saveStage(matStage, exportData);
     
     // Cache material reference
-    Reference matLssReference;
+    Reference& matLssReference = matLssReferences[i];
     matLssReference.stagePath = matStagePath;
     matLssReference.ogSdfPath = matSdfPath;
+  });
+
+  // The instance stage is shared, so it is composed on this thread once all material layers are written
+  for (size_t i = 0; i < materials.size(); ++i) {
+    const auto& [matId, matData] = *materials[i];
+    Reference& matLssReference = matLssReferences[i];
+    const std::string matName = prefix::mat + matData.matName;
 
     // Build matSchema prim on instance stage
     if(ctx.instanceStage != nullptr) {
@@ -425,7 +470,7 @@ void GameExporter::exportMaterials(const Export& exportData, ExportContext& ctx)
       
       const std::string relMeshStagePath = commonDirName::matDir + matName + ctx.extension;
       auto matInstanceUsdReferences = matInstanceSchema.GetPrim().GetReferences();
-      matInstanceUsdReferences.AddReference(relMeshStagePath, matSdfPath);
+      matInstanceUsdReferences.AddReference(relMeshStagePath, matLssReference.ogSdfPath);
       
       matLssReference.instanceSdfPath = matInstanceSdfPath;
     }
@@ -442,10 +487,19 @@ void GameExporter::exportSkeletons(const Export& exportData, ExportContext& ctx)
   const std::string dirPath = exportData.baseExportPath + "/" + relDirPath;
   const std::string fullStagePath = computeLocalPath(dirPath);
   dxvk::env::createDirectory(dirPath);
-  for (const auto& [meshId, mesh] : exportData.meshes) {
-    if (mesh.numBones == 0) {
-      continue;
+
+  std::vector<const IdMap<Mesh>::value_type*> skinnedMeshes;
+  for (const auto& entry : exportData.meshes) {
+    if (entry.second.numBones > 0) {
+      skinnedMeshes.push_back(&entry);
     }
+  }
+  std::vector<Skeleton> skeletons(skinnedMeshes.size());
+
+  // Every skeleton is authored into its own layer, so the layers can be written concurrently
+  forEachLayer(exportData, skinnedMeshes.size(), [&](const size_t i) {
+    Mesh restoredMesh;
+    const Mesh& mesh = restoreSpilledSamples(skinnedMeshes[i]->second, restoredMesh);
 
     // Build skeleton stage
     const std::string name = prefix::skeleton + mesh.meshName;
@@ -476,12 +530,12 @@ void GameExporter::exportSkeletons(const Export& exportData, ExportContext& ctx)
     // Set bindTransforms attribute
     auto bindTransformsAttr = skelSchema.CreateBindTransformsAttr();
     assert(bindTransformsAttr);
-    ctx.skeletons[meshId] = generateSkeleton(mesh.numBones,
-                                             mesh.bonesPerVertex,
-                                             mesh.buffers.positionBufs.begin()->second,
-                                             mesh.buffers.blendWeightBufs.empty() ? nullptr : &mesh.buffers.blendWeightBufs.begin()->second,
-                                             mesh.buffers.blendIndicesBufs.empty() ? nullptr : &mesh.buffers.blendIndicesBufs.begin()->second);
-    const Skeleton& skel = ctx.skeletons[meshId];
+    skeletons[i] = generateSkeleton(mesh.numBones,
+                                    mesh.bonesPerVertex,
+                                    mesh.buffers.positionBufs.begin()->second,
+                                    mesh.buffers.blendWeightBufs.empty() ? nullptr : &mesh.buffers.blendWeightBufs.begin()->second,
+                                    mesh.buffers.blendIndicesBufs.empty() ? nullptr : &mesh.buffers.blendIndicesBufs.begin()->second);
+    const Skeleton& skel = skeletons[i];
     // pxr::VtMatrix4dArray identities(mesh.numBones, pxr::GfMatrix4d(1));
     bindTransformsAttr.Set(skel.bindPose);
 
@@ -495,18 +549,27 @@ void GameExporter::exportSkeletons(const Export& exportData, ExportContext& ctx)
     assert(jointsAttr);
     jointsAttr.Set(skel.jointNames);
 
-    stage->Save();
+    saveStage(stage, exportData);
+  });
+
+  // The instance stage is shared, so it is composed on this thread once all skeleton layers are written
+  for (size_t i = 0; i < skinnedMeshes.size(); ++i) {
+    const auto& [meshId, mesh] = *skinnedMeshes[i];
 
     // Build meshSchema prim on instance stage
     if (ctx.instanceStage != nullptr) {
+      const std::string name = prefix::skeleton + mesh.meshName;
       const std::string mesh_name = prefix::mesh + mesh.meshName;
       const std::string relSkelStagePath = relDirPath + name + ctx.extension;
+      const pxr::SdfPath skeletonSdfPath = gStageRootPath.AppendElementString(name).AppendChild(gTokSkel);
       const pxr::SdfPath skelInstancePath = gRootMeshesPath.AppendElementString(mesh_name).AppendElementString(gTokSkel);
 
       auto skelSchema = pxr::UsdSkelSkeleton::Define(ctx.instanceStage, skelInstancePath);
       auto skelInstanceUsdReferences = skelSchema.GetPrim().GetReferences();
       skelInstanceUsdReferences.AddReference(relSkelStagePath, skeletonSdfPath);
     }
+
+    ctx.skeletons[meshId] = std::move(skeletons[i]);
   }
   dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportSkeletons] End");
 }
@@ -521,7 +584,39 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
   // Determine whether meshes need to be inverted
   const bool bInvX = (!exportData.camera.view.bInv) && (exportData.camera.proj.bInv || exportData.camera.isLHS());
   const bool bInvY = (!exportData.camera.view.bInv) && exportData.camera.proj.bInv;
-  for(const auto& [meshId,mesh] : exportData.meshes) {
+
+  const auto meshes = collectEntries(exportData.meshes);
+  std::vector<Reference> meshLssReferences(meshes.size());
+
+  // Hash every final buffer set up front, so each mesh layer knows which of its buffers are shared
+  const bool reduce = exportData.meta.bReduceMeshBuffers;
+  const bool bShareBuffers = exportData.meta.bShareMeshBuffers;
+  const std::string poolStageName = "buffer_pool" + ctx.extension;
+  BufferPool bufferPool;
+  std::vector<MeshBufferSets> sharedMeshBufferSets;
+  if (bShareBuffers) {
+    sharedMeshBufferSets.resize(meshes.size());
+    forEachLayer(exportData, meshes.size(), [&](const size_t i) {
+      Mesh restoredMesh;
+      const Mesh& mesh = restoreSpilledSamples(meshes[i]->second, restoredMesh);
+      MeshBufferSets bufferSets = prepareMeshBufferSets(mesh, reduce, &bufferPool);
+      // Restored samples are read back again when the mesh is written, only keep the hashes until then
+      if (&mesh == &restoredMesh) {
+        sharedMeshBufferSets[i].indicesHash = bufferSets.indicesHash;
+        sharedMeshBufferSets[i].positionsHash = bufferSets.positionsHash;
+        sharedMeshBufferSets[i].normalsHash = bufferSets.normalsHash;
+        sharedMeshBufferSets[i].texcoordsHash = bufferSets.texcoordsHash;
+      } else {
+        sharedMeshBufferSets[i] = std::move(bufferSets);
+      }
+    });
+  }
+
+  // Every mesh is authored into its own layer, so the layers can be written concurrently
+  // Samples spilled by a streaming capture are only read back for the mesh being written, and released after it
+  forEachLayer(exportData, meshes.size(), [&](const size_t i) {
+    Mesh restoredMesh;
+    const Mesh& mesh = restoreSpilledSamples(meshes[i]->second, restoredMesh);
     assert(mesh.numVertices > 0);
     assert(mesh.numIndices > 0);
 
@@ -613,22 +708,36 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
       attribute.Set(pxr::VtValue(pair.second));
     }
 
+    // Buffers found in several meshes are not authored here, the mesh prim references them from the pool instead
+    MeshBufferSets bufferSets;
+    if (!bShareBuffers) {
+      bufferSets = prepareMeshBufferSets(mesh, reduce, nullptr);
+    } else if (&mesh == &restoredMesh) {
+      bufferSets = prepareMeshBufferSets(mesh, reduce, nullptr);
+      bufferSets.indicesHash = sharedMeshBufferSets[i].indicesHash;
+      bufferSets.positionsHash = sharedMeshBufferSets[i].positionsHash;
+      bufferSets.normalsHash = sharedMeshBufferSets[i].normalsHash;
+      bufferSets.texcoordsHash = sharedMeshBufferSets[i].texcoordsHash;
+    } else {
+      bufferSets = std::move(sharedMeshBufferSets[i]);
+    }
+    if (bShareBuffers) {
+      storePooledSamples(bufferSets, bufferPool);
+    }
+    std::vector<pxr::SdfPath> pooledPrimPaths;
+    const ReducedIdxBufSet& reducedIdxBufSet = bufferSets.reducedIdxBufSet;
     // Indices
-    const bool reduce = exportData.meta.bReduceMeshBuffers;
-    ReducedIdxBufSet reducedIdxBufSet = reduce ? reduceIdxBufferSet(mesh.buffers.idxBufs) : ReducedIdxBufSet();
-    const BufSet<Index>& idxBufSet = reduce ? reducedIdxBufSet.bufSet : mesh.buffers.idxBufs;
     auto indexAttr = meshSchema.CreateFaceVertexIndicesAttr();
     assert(indexAttr);
-    exportBufferSet(idxBufSet, indexAttr);
+    exportSharedBufferSet(bufferSets.indices, bufferSets.indicesHash, indexAttr, bufferPool, pooledPrimPaths);
     // Vertices
-    const auto& posBufs = mesh.buffers.positionBufs;
     auto pointsAttr = meshSchema.CreatePointsAttr();
     assert(pointsAttr);
-    exportBufferSet(reduce ? reduceBufferSet(posBufs, reducedIdxBufSet) : posBufs, pointsAttr);
+    exportSharedBufferSet(bufferSets.positions, bufferSets.positionsHash, pointsAttr, bufferPool, pooledPrimPaths);
     // Normals
     auto normalsAttr = meshSchema.CreateNormalsAttr();
     assert(normalsAttr);
-    exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.normalBufs, reducedIdxBufSet) : mesh.buffers.normalBufs, normalsAttr);
+    exportSharedBufferSet(bufferSets.normals, bufferSets.normalsHash, normalsAttr, bufferPool, pooledPrimPaths);
     // Set subdivision scheme to None (USD defaults to catmull clark)
     auto subdivAttr = meshSchema.CreateSubdivisionSchemeAttr();
     assert(subdivAttr);
@@ -637,7 +746,12 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
     static const pxr::TfToken kTokSt("st");
     auto stAttr = primvarsAPI.CreatePrimvar(kTokSt, pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->vertex);
     assert(stAttr);
-    exportBufferSet(reduce ? reduceBufferSet(mesh.buffers.texcoordBufs, reducedIdxBufSet) : mesh.buffers.texcoordBufs, stAttr);
+    exportSharedBufferSet(bufferSets.texcoords, bufferSets.texcoordsHash, stAttr, bufferPool, pooledPrimPaths);
+    // The pool layer sits next to the mesh layers
+    auto meshUsdReferences = meshSchema.GetPrim().GetReferences();
+    for (const pxr::SdfPath& pooledPrimPath : pooledPrimPaths) {
+      meshUsdReferences.AddReference("./" + poolStageName, pooledPrimPath);
+    }
 
     // Vertex Colors
     if (mesh.buffers.colorBufs.size() > 0) {
@@ -679,8 +793,11 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
       skelRel.AddTarget(meshXformSdfPath.AppendChild(gTokSkel));
     }
 
+    // Material references are shared by all mesh layers, so only look them up here
+    static const Reference kNoReference;
     const bool bHasMat = mesh.matId != kInvalidId;
-    const Reference& matLssReference = (bHasMat) ? ctx.matReferences[mesh.matId] : Reference();
+    const auto matReferenceIt = ctx.matReferences.find(mesh.matId);
+    const Reference& matLssReference = (bHasMat && matReferenceIt != ctx.matReferences.end()) ? matReferenceIt->second : kNoReference;
     if(bHasMat) {
       const auto shaderMatSchema = pxr::UsdShadeMaterial::Define(meshStage, matLssReference.ogSdfPath);
       assert(shaderMatSchema);
@@ -691,13 +808,26 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
       pxr::UsdShadeMaterialBindingAPI(meshXformSchema.GetPrim()).Bind(shaderMatSchema);
     }
 
-    meshStage->Save();
+    saveStage(meshStage, exportData);
     
     // Cache material reference
-    Reference meshLssReference;
+    Reference& meshLssReference = meshLssReferences[i];
     meshLssReference.stagePath = meshStagePath;
     meshLssReference.ogSdfPath = meshXformSdfPath;
-    
+  });
+
+  if (bShareBuffers) {
+    exportBufferPool(exportData, meshDirPath + poolStageName, bufferPool);
+  }
+
+  // The instance stage is shared, so it is composed on this thread once all mesh layers are written
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    const auto& [meshId, mesh] = *meshes[i];
+    Reference& meshLssReference = meshLssReferences[i];
+    const std::string meshName = prefix::mesh + mesh.meshName;
+    const bool isSkeleton = mesh.numBones > 0;
+    const bool bHasMat = mesh.matId != kInvalidId;
+
     // Build meshSchema prim on instance stage
     if(ctx.instanceStage != nullptr) {
       const auto meshInstanceXformSdfPath = gRootMeshesPath.AppendElementString(meshName);
@@ -711,13 +841,14 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
 
       const std::string relMeshStagePath = relMeshDirPath + meshName + ctx.extension;
       auto meshInstanceUsdReferences = meshInstanceXformSchema.GetPrim().GetReferences();
-      meshInstanceUsdReferences.AddReference(relMeshStagePath, meshXformSdfPath);
+      meshInstanceUsdReferences.AddReference(relMeshStagePath, meshLssReference.ogSdfPath);
 
       auto meshInstanceXformVisibilityAttr = meshInstanceXformSchema.CreateVisibilityAttr();
       assert(meshInstanceXformVisibilityAttr);
       meshInstanceXformVisibilityAttr.Set(gVisibilityInvisible);
       
       if(bHasMat) {
+        const Reference& matLssReference = ctx.matReferences[mesh.matId];
         const auto shaderMatInstanceSchema = pxr::UsdShadeMaterial::Get(ctx.instanceStage, matLssReference.instanceSdfPath);
         assert(shaderMatInstanceSchema);
         pxr::UsdShadeMaterialBindingAPI(meshInstanceXformSchema.GetPrim()).Bind(shaderMatInstanceSchema);
@@ -731,6 +862,155 @@ void GameExporter::exportMeshes(const Export& exportData, ExportContext& ctx) {
   dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportMeshes] End");
 }
 
+static const pxr::SdfPath gBufferPoolPath("/BufferPool");
+
+GameExporter::MeshBufferSets GameExporter::prepareMeshBufferSets(const Mesh& mesh, const bool reduce, BufferPool* pPool) {
+  MeshBufferSets bufferSets;
+  if (reduce) {
+    bufferSets.reducedIdxBufSet = reduceIdxBufferSet(mesh.buffers.idxBufs);
+    bufferSets.indices = bufferSets.reducedIdxBufSet.bufSet;
+    bufferSets.positions = reduceBufferSet(mesh.buffers.positionBufs, bufferSets.reducedIdxBufSet);
+    bufferSets.normals = reduceBufferSet(mesh.buffers.normalBufs, bufferSets.reducedIdxBufSet);
+    bufferSets.texcoords = reduceBufferSet(mesh.buffers.texcoordBufs, bufferSets.reducedIdxBufSet);
+  } else {
+    bufferSets.indices = mesh.buffers.idxBufs;
+    bufferSets.positions = mesh.buffers.positionBufs;
+    bufferSets.normals = mesh.buffers.normalBufs;
+    bufferSets.texcoords = mesh.buffers.texcoordBufs;
+  }
+  if (pPool != nullptr) {
+    bufferSets.indicesHash = poolBufferSet(bufferSets.indices, "indices_", pxr::UsdGeomTokens->faceVertexIndices, pxr::SdfValueTypeNames->IntArray, *pPool);
+    bufferSets.positionsHash = poolBufferSet(bufferSets.positions, "points_", pxr::UsdGeomTokens->points, pxr::SdfValueTypeNames->Point3fArray, *pPool);
+    bufferSets.normalsHash = poolBufferSet(bufferSets.normals, "normals_", pxr::UsdGeomTokens->normals, pxr::SdfValueTypeNames->Normal3fArray, *pPool);
+    static const pxr::TfToken kTokPrimvarsSt("primvars:st");
+    bufferSets.texcoordsHash = poolBufferSet(bufferSets.texcoords, "st_", kTokPrimvarsSt, pxr::SdfValueTypeNames->TexCoord2fArray, *pPool);
+  }
+  return bufferSets;
+}
+
+template<typename T>
+XXH64_hash_t GameExporter::poolBufferSet(const BufSet<T>& bufSet,
+                                         const char* primPrefix,
+                                         const pxr::TfToken& attrName,
+                                         const pxr::SdfValueTypeName& typeName,
+                                         BufferPool& pool) {
+  if (bufSet.empty()) {
+    return 0;
+  }
+  // Seeding with the attribute keeps e.g. bitwise identical points and normals apart
+  XXH64_hash_t hash = XXH3_64bits(attrName.GetText(), attrName.size());
+  for (const auto& [timeCode, buf] : bufSet) {
+    hash = XXH3_64bits_withSeed(&timeCode, sizeof(timeCode), hash);
+    hash = XXH3_64bits_withSeed(buf.cdata(), buf.size() * sizeof(T), hash);
+  }
+  // 0 is reserved for unshared buffer sets
+  hash = std::max<XXH64_hash_t>(hash, 1);
+
+  std::lock_guard lock(pool.mutex);
+  PooledBuffer& pooled = pool.buffers[hash];
+  if (pooled.useCount++ == 0) {
+    std::stringstream primName;
+    primName << primPrefix << std::uppercase << std::setfill('0') << std::setw(16) << std::hex << hash;
+    pooled.primName = primName.str();
+    pooled.attrName = attrName;
+    pooled.typeName = typeName;
+  }
+  return hash;
+}
+
+void GameExporter::storePooledSamples(MeshBufferSets& bufferSets, BufferPool& pool) {
+  storePooledSamples(bufferSets.indices, bufferSets.indicesHash, pool);
+  storePooledSamples(bufferSets.positions, bufferSets.positionsHash, pool);
+  storePooledSamples(bufferSets.normals, bufferSets.normalsHash, pool);
+  storePooledSamples(bufferSets.texcoords, bufferSets.texcoordsHash, pool);
+}
+
+template<typename T>
+void GameExporter::storePooledSamples(const BufSet<T>& bufSet, XXH64_hash_t& hash, BufferPool& pool) {
+  if (hash == 0) {
+    return;
+  }
+  std::lock_guard lock(pool.mutex);
+  PooledBuffer& pooled = pool.buffers.at(hash);
+  // Unshared sets are never kept
+  if (pooled.useCount <= 1) {
+    return;
+  }
+  // The first mesh referencing a shared buffer set stores its samples
+  if (pooled.samples.empty()) {
+    for (const auto& [timeCode, buf] : bufSet) {
+      pooled.samples[timeCode] = pxr::VtValue(buf);
+    }
+    return;
+  }
+  // The hash alone does not prove the buffers are the same, a collision would point the mesh at another mesh's geometry
+  bool bMatches = pooled.samples.size() == bufSet.size();
+  for (auto pooledIt = pooled.samples.cbegin(), it = bufSet.cbegin(); bMatches && it != bufSet.cend(); ++pooledIt, ++it) {
+    const Buf<T>& pooledBuf = pooledIt->second.UncheckedGet<Buf<T>>();
+    bMatches = pooledIt->first == it->first &&
+               pooledBuf.size() == it->second.size() &&
+               memcmp(pooledBuf.cdata(), it->second.cdata(), it->second.size() * sizeof(T)) == 0;
+  }
+  if (!bMatches) {
+    dxvk::Logger::warn(dxvk::str::format("[GameExporter][exportMeshes] Hash collision on pooled buffer ",
+                                         pooled.primName, ", exporting the buffer unshared"));
+    hash = 0;
+  }
+}
+
+template<typename BufferT>
+void GameExporter::exportSharedBufferSet(const BufSet<BufferT>& bufSet,
+                                         const XXH64_hash_t hash,
+                                         pxr::UsdAttribute attr,
+                                         const BufferPool& pool,
+                                         std::vector<pxr::SdfPath>& pooledPrimPaths) {
+  // Only buffer sets used by more than one mesh are worth a reference
+  const auto pooledIt = (hash != 0) ? pool.buffers.find(hash) : pool.buffers.cend();
+  if (pooledIt != pool.buffers.cend() && pooledIt->second.useCount > 1) {
+    pooledPrimPaths.push_back(gBufferPoolPath.AppendElementString(pooledIt->second.primName));
+  } else {
+    exportBufferSet(bufSet, attr);
+  }
+}
+
+void GameExporter::exportBufferPool(const Export& exportData, const std::string& poolStagePath, const BufferPool& pool) {
+  size_t numSharedBuffers = 0;
+  size_t numReferences = 0;
+  for (const auto& [hash, pooled] : pool.buffers) {
+    if (pooled.useCount > 1) {
+      ++numSharedBuffers;
+      numReferences += pooled.useCount;
+    }
+  }
+  if (numSharedBuffers == 0) {
+    return;
+  }
+
+  pxr::UsdStageRefPtr poolStage = findOpenOrCreateStage(poolStagePath, true);
+  assert(poolStage);
+  setCommonStageMetaData(poolStage, exportData);
+  // Pooled prims are overs, so opening the pool on its own does not display anything
+  for (const auto& [hash, pooled] : pool.buffers) {
+    if (pooled.useCount <= 1) {
+      continue;
+    }
+    const pxr::UsdPrim pooledPrim = poolStage->OverridePrim(gBufferPoolPath.AppendElementString(pooled.primName));
+    assert(pooledPrim);
+    pxr::UsdAttribute attr = pooledPrim.CreateAttribute(pooled.attrName, pooled.typeName, false);
+    assert(attr);
+    if (pooled.samples.size() == 1) {
+      attr.Set(pooled.samples.cbegin()->second);
+    } else {
+      for (const auto& [timeCode, value] : pooled.samples) {
+        attr.Set(value, pxr::UsdTimeCode(timeCode));
+      }
+    }
+  }
+  saveStage(poolStage, exportData);
+  dxvk::Logger::info(dxvk::str::format("[GameExporter][", exportData.debugId, "][exportMeshes] ",
+                                       numSharedBuffers, " mesh buffers shared by ", numReferences, " meshes"));
+}
+
 GameExporter::ReducedIdxBufSet GameExporter::reduceIdxBufferSet(const BufSet<Index>& idxBufSet) {
   ReducedIdxBufSet reducedIdxBufSet;
   for(const auto& [timeCode, idxBuf] : idxBufSet) {
@@ -837,7 +1117,9 @@ void GameExporter::exportInstances(const Export& exportData, ExportContext& ctx)
     assert(transformOp);
     transformOp.Set(xform);
   }
-  for(const auto& [instId,instanceData] : exportData.instances) {
+  for(const auto& [instId,spilledInstanceData] : exportData.instances) {
+    Instance restoredInstance;
+    const Instance& instanceData = restoreSpilledSamples(spilledInstanceData, restoredInstance);
     // Build base Xform prim for instance to reside in
     auto instanceName = (instanceData.isSky ? "sky_" : "inst_") + std::string(instanceData.instanceName);
     pxr::SdfPath instancePath = gRootInstancesPath.AppendElementString(instanceName);
@@ -971,8 +1253,10 @@ void GameExporter::exportCamera(const Export& exportData, ExportContext& ctx) {
     commonXform = commonXform.GetInverse();
   }
 
+  Camera restoredCamera;
+  const Camera& camera = restoreSpilledSamples(exportData.camera, restoredCamera);
   setTimeSampledXforms(ctx.instanceStage, cameraSdfPath,
-                       exportData.camera.firstTime, exportData.camera.finalTime, exportData.camera.xforms,
+                       camera.firstTime, camera.finalTime, camera.xforms,
                        exportData.meta, false, commonXform);
 
   // Must modify here, since there may be existing data set earlier
@@ -994,7 +1278,9 @@ void GameExporter::exportSphereLights(const Export& exportData, ExportContext& c
   assert(transformOp);
   transformOp.Set(exportData.globalXform);
   dxvk::Logger::debug("[GameExporter][" + exportData.debugId + "][exportSphereLights] Begin");
-  for(const auto& [id,sphereLightData] : exportData.sphereLights) {
+  for(const auto& [id,spilledSphereLightData] : exportData.sphereLights) {
+    SphereLight restoredSphereLight;
+    const SphereLight& sphereLightData = restoreSpilledSamples(spilledSphereLightData, restoredSphereLight);
     // Build light stage
     const std::string lightName = prefix::light + sphereLightData.lightName;
     const std::string lightStagePath = lightDirPath + lightName + ctx.extension;
@@ -1051,7 +1337,7 @@ void GameExporter::exportSphereLights(const Export& exportData, ExportContext& c
     setLightIntensityOnTimeSpan(lightAPI, sphereLightData.intensity, sphereLightData.firstTime, sphereLightData.finalTime, exportData.meta.numFramesCaptured);
     lightAPI.Apply(sphereLight.GetPrim());
 
-    lightStage->Save(); 
+    saveStage(lightStage, exportData);
 
     // Cache light reference
     Reference lightLssReference;
@@ -1233,6 +1519,17 @@ void GameExporter::setLightIntensityOnTimeSpan(const pxr::UsdLuxLightAPI& luxLig
   }
 }
 
+void GameExporter::saveStage(const pxr::UsdStageRefPtr stage, const Export& exportData) {
+  const pxr::SdfLayerHandle layer = stage->GetRootLayer();
+  if (exportData.meta.layerFileFormat.empty()) {
+    layer->Save();
+    return;
+  }
+  // The format argument only applies to '.usd' layers, '.usda' and '.usdc' layers keep the format of their extension
+  const pxr::SdfLayer::FileFormatArguments args { { "format", exportData.meta.layerFileFormat } };
+  ASSERT_OR_EXECUTE(layer->Export(layer->GetRealPath(), std::string(), args));
+}
+
 pxr::UsdStageRefPtr GameExporter::findOpenOrCreateStage(const std::string path, const bool bClearIfExists) {
     const bool bLayerAlreadyExists = pxr::TfIsFile(path);
     pxr::SdfLayerRefPtr alreadyExistentLayer;
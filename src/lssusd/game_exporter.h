@@ -31,7 +31,9 @@
 #include "game_exporter_types.h"
 #include "game_exporter_paths.h"
 
+#include <map>
 #include <mutex>
+#include <unordered_map>
 
 namespace lss {
 
@@ -69,6 +71,49 @@ private:
     std::map<float,IdxMap> redToOgSet;
   };
   static ReducedIdxBufSet reduceIdxBufferSet(const BufSet<Index>& idxBufSet);
+  // Final (possibly reduced) buffers of a mesh, with a content hash per buffer set.
+  // A hash of 0 means the set is not shared through the buffer pool.
+  struct MeshBufferSets {
+    ReducedIdxBufSet reducedIdxBufSet;
+    BufSet<Index>    indices;
+    BufSet<Pos>      positions;
+    BufSet<Norm>     normals;
+    BufSet<Texcoord> texcoords;
+    XXH64_hash_t     indicesHash = 0;
+    XXH64_hash_t     positionsHash = 0;
+    XXH64_hash_t     normalsHash = 0;
+    XXH64_hash_t     texcoordsHash = 0;
+  };
+  // Buffer sets with identical contents across meshes, written once to a shared layer
+  struct PooledBuffer {
+    std::string                   primName;
+    pxr::TfToken                  attrName;
+    pxr::SdfValueTypeName         typeName;
+    std::map<float, pxr::VtValue> samples;
+    size_t                        useCount = 0;
+  };
+  struct BufferPool {
+    std::mutex mutex;
+    std::unordered_map<XXH64_hash_t, PooledBuffer> buffers;
+  };
+  static MeshBufferSets prepareMeshBufferSets(const Mesh& mesh, const bool reduce, BufferPool* pPool);
+  template<typename T>
+  static XXH64_hash_t poolBufferSet(const BufSet<T>& bufSet,
+                                    const char* primPrefix,
+                                    const pxr::TfToken& attrName,
+                                    const pxr::SdfValueTypeName& typeName,
+                                    BufferPool& pool);
+  // Clears the hash of buffer sets that only collide with a pooled set, so they are exported unshared
+  static void storePooledSamples(MeshBufferSets& bufferSets, BufferPool& pool);
+  template<typename T>
+  static void storePooledSamples(const BufSet<T>& bufSet, XXH64_hash_t& hash, BufferPool& pool);
+  template<typename BufferT>
+  static void exportSharedBufferSet(const BufSet<BufferT>& bufSet,
+                                    const XXH64_hash_t hash,
+                                    pxr::UsdAttribute attr,
+                                    const BufferPool& pool,
+                                    std::vector<pxr::SdfPath>& pooledPrimPaths);
+  static void exportBufferPool(const Export& exportData, const std::string& poolStagePath, const BufferPool& pool);
   template<typename T>
   static BufSet<T> reduceBufferSet(const BufSet<T>& bufSet,
                                    const ReducedIdxBufSet& reducedIdxBufSet,
@@ -111,6 +156,7 @@ private:
                                          const pxr::GfMatrix4d& commonXform);
   
   static pxr::UsdStageRefPtr findOpenOrCreateStage(const std::string path, const bool bClearIfExists = false);
+  static void saveStage(const pxr::UsdStageRefPtr stage, const Export& exportData);
 
   static bool s_bMultiThreadSafety;
   static std::mutex s_mutex;
@@ -34,6 +34,7 @@
 #include <stdint.h>
 #include <limits>
 #include <map>
+#include <memory>
 
 static_assert(std::numeric_limits<float>::is_iec559);
 static_assert(std::numeric_limits<double>::is_iec559);
@@ -57,6 +58,14 @@ struct SampledBoneXform {
 };
 using SampledBoneXforms = std::vector<SampledBoneXform>;
 
+class SampleSpill;
+// Location of time samples that a streaming capture moved out of memory, see sample_spill.h
+struct SpillRef {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+using SpilledBufSet = std::map<float,SpillRef>;
+
 struct Skeleton {
   pxr::VtArray<pxr::TfToken> jointNames;
   pxr::VtMatrix4dArray bindPose;
@@ -78,6 +87,9 @@ struct Camera {
   float         finalTime = NAN;
   bool          isReverseZ = false;
   SampledXforms xforms;
+  // Runs of samples spilled during a streaming capture, oldest first, restored before export
+  std::shared_ptr<SampleSpill> spill;
+  std::vector<SpillRef> spilledXforms;
   struct CamMat {
     bool     bInv = false;
     CoordSys coord = RHS;
@@ -99,6 +111,9 @@ struct SphereLight {
   float         coneSoftness = 0.f;
   float         focusExponent = 0.f;
   SampledXforms xforms;
+  // Runs of samples spilled during a streaming capture, oldest first, restored before export
+  std::shared_ptr<SampleSpill> spill;
+  std::vector<SpillRef> spilledXforms;
 };
 
 struct DistantLight {
@@ -144,6 +159,15 @@ struct MeshBuffers {
   BufSet<Color>       colorBufs;
   BufSet<BlendWeight> blendWeightBufs;
   BufSet<BlendIdx>    blendIndicesBufs;
+  // Samples spilled during a streaming capture, restored before export
+  std::shared_ptr<SampleSpill> spill;
+  SpilledBufSet       spilledIdxBufs;
+  SpilledBufSet       spilledPositionBufs;
+  SpilledBufSet       spilledNormalBufs;
+  SpilledBufSet       spilledTexcoordBufs;
+  SpilledBufSet       spilledColorBufs;
+  SpilledBufSet       spilledBlendWeightBufs;
+  SpilledBufSet       spilledBlendIndicesBufs;
 };
 
 struct RenderingMetaData {
@@ -195,6 +219,10 @@ struct Instance {
   bool              isSky;
   SampledBoneXforms boneXForms;
   RenderingMetaData metadata;
+  // Runs of samples spilled during a streaming capture, oldest first, restored before export
+  std::shared_ptr<SampleSpill> spill;
+  std::vector<SpillRef> spilledXforms;
+  std::vector<SpillRef> spilledBoneXForms;
 };
 
 template <typename T>
@@ -215,6 +243,12 @@ struct Export {
     bool isZUp;
     std::unordered_map<std::string, std::string> renderingSettingsDict;
     bool bCorrectBakedTransforms;
+    // Author independent mesh, skeleton and material layers on multiple threads
+    bool bParallelLayerExport = true;
+    // SdfFileFormat 'format' argument for '.usd' layers ("usda" or "usdc"), empty keeps the USD default
+    std::string layerFileFormat;
+    // Write mesh buffers shared by several meshes once, to a pool layer the mesh layers reference
+    bool bShareMeshBuffers = false;
   } meta;
   std::string baseExportPath;
   bool bExportInstanceStage;
@@ -0,0 +1,314 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "sample_spill.h"
+#include "../util/log/log.h"
+#include "../util/util_string.h"
+
+#include <cstring>
+#include <filesystem>
+
+namespace lss {
+
+SampleSpill::SampleSpill(std::string path)
+  : m_path(std::move(path)) {
+  m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+  m_isValid = m_file.is_open();
+  if (!m_isValid) {
+    dxvk::Logger::err(dxvk::str::format("[SampleSpill] Unable to create file: ", m_path));
+    return;
+  }
+  m_thread = std::thread([this] { writerThread(); });
+}
+
+SampleSpill::~SampleSpill() {
+  if (m_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_queueMutex);
+      m_stop = true;
+    }
+    m_queueCond.notify_all();
+    m_thread.join();
+  }
+  if (m_file.is_open()) {
+    m_file.close();
+    std::error_code ec;
+    std::filesystem::remove(m_path, ec);
+  }
+}
+
+SpillRef SampleSpill::append(std::vector<uint8_t>&& bytes) {
+  SpillRef ref;
+  {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    ref.offset = m_reservedSize;
+    ref.size = bytes.size();
+    m_reservedSize += bytes.size();
+    m_queue.push_back(std::move(bytes));
+  }
+  m_queueCond.notify_one();
+  return ref;
+}
+
+bool SampleSpill::read(const SpillRef& ref, void* pDst) {
+  {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_writtenCond.wait(lock, [&] { return m_writtenSize >= ref.offset + ref.size || !m_isValid; });
+    if (!m_isValid) {
+      return false;
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  m_file.seekg(ref.offset);
+  m_file.read(reinterpret_cast<char*>(pDst), ref.size);
+  if (!m_file) {
+    m_file.clear();
+    return false;
+  }
+  return true;
+}
+
+void SampleSpill::writerThread() {
+  std::unique_lock<std::mutex> queueLock(m_queueMutex);
+  while (true) {
+    m_queueCond.wait(queueLock, [this] { return !m_queue.empty() || m_stop; });
+    if (m_queue.empty()) {
+      return;
+    }
+    std::vector<uint8_t> bytes = std::move(m_queue.front());
+    m_queue.pop_front();
+    queueLock.unlock();
+
+    bool bWritten;
+    {
+      std::lock_guard<std::mutex> fileLock(m_fileMutex);
+      m_file.seekp(0, std::ios::end);
+      m_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+      m_file.flush();
+      bWritten = m_file.good();
+    }
+
+    queueLock.lock();
+    if (bWritten) {
+      m_writtenSize += bytes.size();
+    } else if (m_isValid) {
+      dxvk::Logger::err(dxvk::str::format("[SampleSpill] Failed writing to: ", m_path, ", spilled samples will be missing from the export"));
+      m_isValid = false;
+    }
+    m_writtenCond.notify_all();
+  }
+}
+
+namespace {
+  template<typename T>
+  void appendBytes(std::vector<uint8_t>& bytes, const T* pData, const size_t count) {
+    const size_t offset = bytes.size();
+    bytes.resize(offset + count * sizeof(T));
+    memcpy(bytes.data() + offset, pData, count * sizeof(T));
+  }
+
+  template<typename T>
+  const uint8_t* readBytes(const uint8_t* pSrc, T* pData, const size_t count) {
+    memcpy(pData, pSrc, count * sizeof(T));
+    return pSrc + count * sizeof(T);
+  }
+
+  void appendMatrix(std::vector<uint8_t>& bytes, const pxr::GfMatrix4d& matrix) {
+    appendBytes(bytes, matrix.data(), 16);
+  }
+
+  const uint8_t* readMatrix(const uint8_t* pSrc, pxr::GfMatrix4d& matrix) {
+    return readBytes(pSrc, matrix.data(), 16);
+  }
+
+  bool readRef(SampleSpill& spill, const SpillRef& ref, std::vector<uint8_t>& bytes) {
+    bytes.resize(ref.size);
+    if (!spill.read(ref, bytes.data())) {
+      dxvk::Logger::warn("[SampleSpill] Unable to restore spilled samples");
+      return false;
+    }
+    return true;
+  }
+
+  template<typename T>
+  void restoreBufSet(SampleSpill& spill, const SpilledBufSet& spilled, BufSet<T>& bufSet) {
+    for (const auto& [time, ref] : spilled) {
+      Buf<T> buf(ref.size / sizeof(T));
+      if (spill.read(ref, buf.data())) {
+        bufSet.emplace(time, std::move(buf));
+      } else {
+        dxvk::Logger::warn("[SampleSpill] Unable to restore spilled mesh buffer");
+      }
+    }
+  }
+
+  SampledXforms restoreXforms(SampleSpill& spill, const std::vector<SpillRef>& spilled, const SampledXforms& latest) {
+    SampledXforms xforms;
+    std::vector<uint8_t> bytes;
+    for (const SpillRef& ref : spilled) {
+      if (!readRef(spill, ref, bytes)) {
+        continue;
+      }
+      for (const uint8_t* pSrc = bytes.data(); pSrc < bytes.data() + bytes.size();) {
+        SampledXform& sample = xforms.emplace_back();
+        pSrc = readBytes(pSrc, &sample.time, 1);
+        pSrc = readMatrix(pSrc, sample.xform);
+      }
+    }
+    xforms.insert(xforms.end(), latest.begin(), latest.end());
+    return xforms;
+  }
+}
+
+template<typename T>
+void spillSamplesBefore(SampleSpill& spill, BufSet<T>& bufSet, SpilledBufSet& spilled, const float time) {
+  while (bufSet.size() > 1 && bufSet.begin()->first < time) {
+    const auto& [sampleTime, buf] = *bufSet.begin();
+    std::vector<uint8_t> bytes;
+    appendBytes(bytes, buf.cdata(), buf.size());
+    spilled[sampleTime] = spill.append(std::move(bytes));
+    bufSet.erase(bufSet.begin());
+  }
+}
+template void spillSamplesBefore(SampleSpill&, BufSet<Index>&, SpilledBufSet&, const float);
+template void spillSamplesBefore(SampleSpill&, BufSet<pxr::GfVec3f>&, SpilledBufSet&, const float);
+template void spillSamplesBefore(SampleSpill&, BufSet<Texcoord>&, SpilledBufSet&, const float);
+template void spillSamplesBefore(SampleSpill&, BufSet<Color>&, SpilledBufSet&, const float);
+template void spillSamplesBefore(SampleSpill&, BufSet<BlendWeight>&, SpilledBufSet&, const float);
+
+void spillSamplesBefore(SampleSpill& spill, SampledXforms& xforms, std::vector<SpillRef>& spilled, const double time) {
+  size_t numSpilled = 0;
+  while (numSpilled + 1 < xforms.size() && xforms[numSpilled].time < time) {
+    ++numSpilled;
+  }
+  if (numSpilled == 0) {
+    return;
+  }
+  std::vector<uint8_t> bytes;
+  bytes.reserve(numSpilled * (sizeof(double) * 17));
+  for (size_t i = 0; i < numSpilled; ++i) {
+    appendBytes(bytes, &xforms[i].time, 1);
+    appendMatrix(bytes, xforms[i].xform);
+  }
+  spilled.push_back(spill.append(std::move(bytes)));
+  xforms.erase(xforms.begin(), xforms.begin() + numSpilled);
+}
+
+void spillSamplesBefore(SampleSpill& spill, SampledBoneXforms& xforms, std::vector<SpillRef>& spilled, const double time) {
+  size_t numSpilled = 0;
+  while (numSpilled + 1 < xforms.size() && xforms[numSpilled].time < time) {
+    ++numSpilled;
+  }
+  if (numSpilled == 0) {
+    return;
+  }
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i < numSpilled; ++i) {
+    const uint64_t numBones = xforms[i].xforms.size();
+    appendBytes(bytes, &xforms[i].time, 1);
+    appendBytes(bytes, &numBones, 1);
+    for (const pxr::GfMatrix4d& xform : xforms[i].xforms) {
+      appendMatrix(bytes, xform);
+    }
+  }
+  spilled.push_back(spill.append(std::move(bytes)));
+  xforms.erase(xforms.begin(), xforms.begin() + numSpilled);
+}
+
+const Mesh& restoreSpilledSamples(const Mesh& mesh, Mesh& storage) {
+  const MeshBuffers& buffers = mesh.buffers;
+  if (!buffers.spill ||
+      (buffers.spilledIdxBufs.empty() && buffers.spilledPositionBufs.empty() && buffers.spilledNormalBufs.empty() &&
+       buffers.spilledTexcoordBufs.empty() && buffers.spilledColorBufs.empty() &&
+       buffers.spilledBlendWeightBufs.empty() && buffers.spilledBlendIndicesBufs.empty())) {
+    return mesh;
+  }
+  storage = mesh;
+  restoreBufSet(*buffers.spill, buffers.spilledIdxBufs, storage.buffers.idxBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledPositionBufs, storage.buffers.positionBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledNormalBufs, storage.buffers.normalBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledTexcoordBufs, storage.buffers.texcoordBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledColorBufs, storage.buffers.colorBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledBlendWeightBufs, storage.buffers.blendWeightBufs);
+  restoreBufSet(*buffers.spill, buffers.spilledBlendIndicesBufs, storage.buffers.blendIndicesBufs);
+  storage.buffers.spilledIdxBufs.clear();
+  storage.buffers.spilledPositionBufs.clear();
+  storage.buffers.spilledNormalBufs.clear();
+  storage.buffers.spilledTexcoordBufs.clear();
+  storage.buffers.spilledColorBufs.clear();
+  storage.buffers.spilledBlendWeightBufs.clear();
+  storage.buffers.spilledBlendIndicesBufs.clear();
+  return storage;
+}
+
+const Instance& restoreSpilledSamples(const Instance& instance, Instance& storage) {
+  if (!instance.spill || (instance.spilledXforms.empty() && instance.spilledBoneXForms.empty())) {
+    return instance;
+  }
+  storage = instance;
+  storage.xforms = restoreXforms(*instance.spill, instance.spilledXforms, instance.xforms);
+
+  std::vector<uint8_t> bytes;
+  SampledBoneXforms boneXForms;
+  for (const SpillRef& ref : instance.spilledBoneXForms) {
+    if (!readRef(*instance.spill, ref, bytes)) {
+      continue;
+    }
+    for (const uint8_t* pSrc = bytes.data(); pSrc < bytes.data() + bytes.size();) {
+      SampledBoneXform& sample = boneXForms.emplace_back();
+      uint64_t numBones;
+      pSrc = readBytes(pSrc, &sample.time, 1);
+      pSrc = readBytes(pSrc, &numBones, 1);
+      sample.xforms.resize(numBones);
+      for (pxr::GfMatrix4d& xform : sample.xforms) {
+        pSrc = readMatrix(pSrc, xform);
+      }
+    }
+  }
+  boneXForms.insert(boneXForms.end(), instance.boneXForms.begin(), instance.boneXForms.end());
+  storage.boneXForms = std::move(boneXForms);
+
+  storage.spilledXforms.clear();
+  storage.spilledBoneXForms.clear();
+  return storage;
+}
+
+const Camera& restoreSpilledSamples(const Camera& camera, Camera& storage) {
+  if (!camera.spill || camera.spilledXforms.empty()) {
+    return camera;
+  }
+  storage = camera;
+  storage.xforms = restoreXforms(*camera.spill, camera.spilledXforms, camera.xforms);
+  storage.spilledXforms.clear();
+  return storage;
+}
+
+const SphereLight& restoreSpilledSamples(const SphereLight& light, SphereLight& storage) {
+  if (!light.spill || light.spilledXforms.empty()) {
+    return light;
+  }
+  storage = light;
+  storage.xforms = restoreXforms(*light.spill, light.spilledXforms, light.xforms);
+  storage.spilledXforms.clear();
+  return storage;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "game_exporter_types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lss {
+
+// Append-only binary file that a streaming capture moves old time samples to, so the memory used by
+// a long capture is bounded by its streaming window rather than its length.
+// Writes happen on a dedicated thread, append() only reserves the location of the data and queues it.
+// The file is deleted when the last owner releases the spill.
+class SampleSpill {
+public:
+  explicit SampleSpill(std::string path);
+  ~SampleSpill();
+
+  SampleSpill(const SampleSpill&) = delete;
+  SampleSpill& operator=(const SampleSpill&) = delete;
+
+  bool isValid() const { return m_isValid; }
+
+  // Thread-safe
+  SpillRef append(std::vector<uint8_t>&& bytes);
+  // Thread-safe, waits for the data to be written if it is still queued. Returns false if it could not be written or read
+  bool read(const SpillRef& ref, void* pDst);
+
+private:
+  void writerThread();
+
+  const std::string m_path;
+  bool m_isValid = false;
+
+  std::mutex m_fileMutex;
+  std::fstream m_file;
+
+  std::mutex m_queueMutex;
+  std::condition_variable m_queueCond;
+  std::condition_variable m_writtenCond;
+  std::deque<std::vector<uint8_t>> m_queue;
+  uint64_t m_reservedSize = 0;
+  uint64_t m_writtenSize = 0;
+  bool m_stop = false;
+  std::thread m_thread;
+};
+
+// Moves every sample before 'time' except the latest one from bufSet to the spill
+template<typename T>
+void spillSamplesBefore(SampleSpill& spill, BufSet<T>& bufSet, SpilledBufSet& spilled, const float time);
+void spillSamplesBefore(SampleSpill& spill, SampledXforms& xforms, std::vector<SpillRef>& spilled, const double time);
+void spillSamplesBefore(SampleSpill& spill, SampledBoneXforms& xforms, std::vector<SpillRef>& spilled, const double time);
+
+// Return the object itself if it has no spilled samples, otherwise a copy in 'storage' with all samples restored
+const Mesh& restoreSpilledSamples(const Mesh& mesh, Mesh& storage);
+const Instance& restoreSpilledSamples(const Instance& instance, Instance& storage);
+const Camera& restoreSpilledSamples(const Camera& camera, Camera& storage);
+const SphereLight& restoreSpilledSamples(const SphereLight& light, SphereLight& storage);
+
+}
@@ -24,7 +24,9 @@
 #include "../util/util_vector.h"
 #include "../util/util_error.h"
 #include "../util/util_string.h"
-#include "../util/util_fast_cache.h"
+#include "../util/util_flat_hash_map.h"
+#include "../util/util_mesh_optimizer.h"
+#include "../util/util_vertex_compression.h"
 #include "../util/log/log.h"
 #include "../tracy/Tracy.hpp"
 #include "hd/usd_mesh_util.h"
@@ -45,7 +47,13 @@
 #include <pxr/usd/usdGeom/primvar.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h> 
 #include <pxr/usd/usdSkel/bindingAPI.h>
+#include <pxr/base/work/loops.h>
 #include "usd_include_end.h"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <vector>
 #include <d3d9types.h>
 
@@ -89,16 +97,20 @@ namespace lss {
   }
 
 
-  const std::vector<uint32_t> UsdMeshImporter::generateSubsetIndices(const UsdGeomSubset& subset, const std::vector<uint32_t>& indices, const UsdMeshImporter::FaceToTriangleMap& triangleMap) {
+  std::vector<uint32_t> UsdMeshImporter::generateSubsetIndices(const UsdGeomSubset& subset, const std::vector<uint32_t>& indices, const UsdMeshImporter::FaceToTriangleMap& triangleMap) {
     ZoneScoped;
-    std::vector<uint32_t> subsetIndices;
-
     VtIntArray faceIndices;
     subset.GetIndicesAttr().Get(&faceIndices);
+
+    size_t numSubsetIndices = 0;
     for (const int& faceIdx : faceIndices) {
-      for (uint32_t i = triangleMap[faceIdx].start; i < triangleMap[faceIdx].end; i++) {
-        subsetIndices.emplace_back(indices[i]);
-      }
+      numSubsetIndices += triangleMap[faceIdx].end - triangleMap[faceIdx].start;
+    }
+
+    std::vector<uint32_t> subsetIndices(numSubsetIndices);
+    uint32_t* pOut = subsetIndices.data();
+    for (const int& faceIdx : faceIndices) {
+      pOut = std::copy(indices.begin() + triangleMap[faceIdx].start, indices.begin() + triangleMap[faceIdx].end, pOut);
     }
 
     return subsetIndices;
@@ -161,8 +173,14 @@ namespace lss {
     if (geomSubsets.empty()) {
       m_meshes.emplace_back(std::move(indices), meshPrim);
     } else {
-      for (const UsdGeomSubset& subset : geomSubsets) {
-        m_meshes.emplace_back(std::move(generateSubsetIndices(subset, indices, faceToTriangles)), subset.GetPrim());
+      std::vector<std::vector<uint32_t>> subsetIndices(geomSubsets.size());
+      WorkParallelForN(geomSubsets.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          subsetIndices[i] = generateSubsetIndices(geomSubsets[i], indices, faceToTriangles);
+        }
+      });
+      for (size_t i = 0; i < geomSubsets.size(); i++) {
+        m_meshes.emplace_back(std::move(subsetIndices[i]), geomSubsets[i].GetPrim());
       }
     }
 
@@ -302,64 +320,72 @@ namespace lss {
       primvars.emplace_back(PrimvarDescriptor { jointWeightsPV, Attributes::BlendWeights, sizeof(float) * m_actualNumBonesPerVertex });
     }
 
-    uint32_t numPoints = 0;
-    for (PrimvarDescriptor const& desc : primvars) {
+    const auto createSampler = [&](const PrimvarDescriptor& desc, const VtValue& data, const uint32_t numPoints) -> GeomPrimvarSampler* {
       const UsdGeomPrimvar& pv = desc.primvar;
 
-      VtValue data;
-      pv.ComputeFlattened(&data);
-
       const size_t elementSize = sizeOfUsdType(data.GetElementTypeid()) * pv.GetElementSize();
       if (elementSize == 0) {
         Logger::warn(str::format("Skipping unknown USD type, ", desc.vertexAttribute, ", for primvar, id=", pv.GetName()));
-        continue;
+        return nullptr;
       }
 
       if (desc.expectedSize != 0 && elementSize != desc.expectedSize) {
         Logger::warn(str::format("Skipping unexpected USD type for attribute, ", desc.vertexAttribute, ", primvar, id=", pv.GetName()));
-        continue;
+        return nullptr;
       }
 
-      GeomPrimvarSampler* sampler = nullptr;
       if (desc.vertexAttribute == VertexPositions) {
-        numPoints = data.GetArraySize();
-        sampler = new TriangleVertexSampler(data, usdIndices, elementSize);
-      } else {
-        TfToken interpolation = pv.GetInterpolation();
-        if (interpolation == UsdGeomTokens->constant) {
-          sampler = new ConstantSampler(data, elementSize);
-        } else if (interpolation == UsdGeomTokens->uniform) {
-          sampler = new UniformSampler(data, trianglePrimitiveParams, elementSize);
-        } else if (interpolation == UsdGeomTokens->vertex || interpolation == UsdGeomTokens->varying) {
-          const uint32_t expectedArraySize = numPoints * pv.GetElementSize(); 
-          if (data.GetArraySize() == expectedArraySize) {
-            sampler = new TriangleVertexSampler(data, usdIndices, elementSize);
-          } else {
-            Logger::warn(str::format("Unexpected number of elements found for vertex attribute, ", desc.vertexAttribute, ", for primvar, id=", pv.GetName()));
-          }
-        } else if (interpolation == UsdGeomTokens->faceVarying) {
-          sampler = new TriangleFaceVaryingSampler(data, meshUtil, elementSize);
-        } else {
-          throw DxvkError(str::format("Unexpected interpolation mode for primvar, id=", pv.GetName()));
+        return new TriangleVertexSampler(data, usdIndices, elementSize);
+      }
+
+      TfToken interpolation = pv.GetInterpolation();
+      if (interpolation == UsdGeomTokens->constant) {
+        return new ConstantSampler(data, elementSize);
+      } else if (interpolation == UsdGeomTokens->uniform) {
+        return new UniformSampler(data, trianglePrimitiveParams, elementSize);
+      } else if (interpolation == UsdGeomTokens->vertex || interpolation == UsdGeomTokens->varying) {
+        const uint32_t expectedArraySize = numPoints * pv.GetElementSize(); 
+        if (data.GetArraySize() == expectedArraySize) {
+          return new TriangleVertexSampler(data, usdIndices, elementSize);
         }
+        Logger::warn(str::format("Unexpected number of elements found for vertex attribute, ", desc.vertexAttribute, ", for primvar, id=", pv.GetName()));
+        return nullptr;
+      } else if (interpolation == UsdGeomTokens->faceVarying) {
+        return new TriangleFaceVaryingSampler(data, meshUtil, elementSize);
       }
+      throw DxvkError(str::format("Unexpected interpolation mode for primvar, id=", pv.GetName()));
+    };
 
-      ppMeshSamplers[desc.vertexAttribute].reset(sampler);
+    // Points are always the first primvar, the other primvars are validated against their count
+    const PrimvarDescriptor& pointsDesc = primvars.front();
+    assert(pointsDesc.vertexAttribute == VertexPositions);
+    VtValue pointsData;
+    pointsDesc.primvar.ComputeFlattened(&pointsData);
+    const uint32_t numPoints = pointsData.GetArraySize();
+    ppMeshSamplers[VertexPositions].reset(createSampler(pointsDesc, pointsData, numPoints));
+
+    // Each remaining primvar fills its own sampler slot, so they are flattened and triangulated concurrently
+    std::mutex errorMutex;
+    std::exception_ptr pError;
+    WorkParallelForN(primvars.size() - 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin + 1; i < end + 1; i++) {
+        try {
+          VtValue data;
+          primvars[i].primvar.ComputeFlattened(&data);
+          ppMeshSamplers[primvars[i].vertexAttribute].reset(createSampler(primvars[i], data, numPoints));
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if (!pError) {
+            pError = std::current_exception();
+          }
+        }
+      }
+    });
+    if (pError) {
+      std::rethrow_exception(pError);
     }
   }
 
-  float signNotZero(float x) {
-    return x < 0.0f ? -1.0f : 1.0f;
-  }
-
-  std::uint32_t f32ToUnorm16(float x) {
-    assert(x >= 0.0f && x <= 1.0);
-    const float scalar = (1 << 16) - 1;
-    const float conv = x * scalar + 0.5f;
-
-    return static_cast<std::uint32_t>(conv);
-  }
-  
   // Helper function to limit bone influences with a variable number of influences per vertex
   template<uint32_t MaxBones>
   void limitBoneInfluences(const uint32_t* fullIndices,
@@ -413,6 +439,104 @@ namespace lss {
     }
   }
 
+  // Samples every attribute of a triangle corner into pVertex, laid out by the vertex declaration
+  void UsdMeshImporter::sampleCorner(const uint32_t idx,
+                                     const std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers,
+                                     float* pVertex) const {
+    for (const VertexDeclaration& decl : m_vertexDecl) {
+      switch (decl.attribute) {
+      case Attributes::BlendWeights:
+        // Do nothing, we decode the blend weights and indices together below
+        break;
+      case Attributes::BlendIndices:
+      {
+        if (ppMeshSamplers[Attributes::BlendWeights] == nullptr) {
+          assert(0);
+        }
+        // Temporary storage for the full data.
+        uint32_t blendIndicesStorage[MaxSupportedNumBones];
+        float blendWeightsStorage[MaxSupportedNumBones];
+
+        // Sample full bone indices...
+        ppMeshSamplers[Attributes::BlendIndices]->SampleBuffer(idx, &blendIndicesStorage[0]);
+        // ... and the corresponding blend weights
+        ppMeshSamplers[Attributes::BlendWeights]->SampleBuffer(idx, &blendWeightsStorage[0]);
+
+        // Helper to write the blend data to our vertex buffer
+        const auto& writeBlendData = [&](uint32_t* blendIndices, float* blendWeights) {
+          // Encode the limited bone indices into compressed byte form
+          for (int j = 0; j < m_limitedNumBonesPerVertex; j += 4) {
+            uint32_t vertIndices = 0;
+            for (int k = 0; k < 4 && (j + k) < m_limitedNumBonesPerVertex; ++k) {
+              vertIndices |= blendIndices[j + k] << (8 * k);
+            }
+            *(uint32_t*) (&pVertex[decl.offset / 4 + j / 4]) = vertIndices;
+          }
+
+          // Write the weights
+          const VertexDeclaration* blendWeightsDecl = nullptr;
+          for (const VertexDeclaration& decl : m_vertexDecl) {
+            if (decl.attribute == Attributes::BlendWeights) {
+              blendWeightsDecl = &decl;
+              break;
+            }
+          }
+          assert(blendWeightsDecl != nullptr);
+          memcpy(&pVertex[blendWeightsDecl->offset / 4], &blendWeights[0], blendWeightsDecl->size);
+        };
+
+        // Limit the influences
+        if (m_actualNumBonesPerVertex != m_limitedNumBonesPerVertex) {
+          uint32_t limitedIndices[MaxSupportedNumBones];
+          float limitedWeights[MaxSupportedNumBones];
+          limitBoneInfluences<MaxSupportedNumBones>(blendIndicesStorage, blendWeightsStorage, m_actualNumBonesPerVertex, m_limitedNumBonesPerVertex, limitedIndices, limitedWeights);
+          writeBlendData(&limitedIndices[0], &limitedWeights[0]);
+        } else {
+          writeBlendData(&blendIndicesStorage[0], &blendWeightsStorage[0]);
+        }
+        break;
+      }
+      case Attributes::Colors:
+      {
+        uint32_t& vertexColor = *(uint32_t*) &pVertex[decl.offset / 4];
+        float opacity = 1.0f;  // default to opaque
+        if (ppMeshSamplers[Attributes::Opacity]) {
+          ppMeshSamplers[Attributes::Opacity]->SampleBuffer(idx, &opacity);
+        }
+        GfVec3f color(1.0f); // default to white
+        if (ppMeshSamplers[Attributes::Colors]) {
+          ppMeshSamplers[Attributes::Colors]->SampleBuffer(idx, &color);
+        }
+        vertexColor = D3DCOLOR_ARGB(((DWORD) (opacity * 255.f)), (DWORD) ((color[0]) * 255.f), (DWORD) ((color[1]) * 255.f), (DWORD) ((color[2]) * 255.f));
+        break;
+      }
+      case Attributes::Opacity:
+      {
+        assert(false); // This attribute should never be in the VertexDeclaration.  Presence in the USD leads to Attributes::Colors existing.
+        break;
+      }
+      case Attributes::Texcoords: {
+        ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &pVertex[decl.offset / 4]);
+        // Invert texcoord.y for Remix
+        pVertex[decl.offset / 4 + 1] = 1.f - pVertex[decl.offset / 4 + 1];
+        break;
+      }
+      case Attributes::Normals: {
+        GfVec3f normal(0.0f);
+        ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &normal);
+        uint32_t& normalStorage = *reinterpret_cast<uint32_t*>(&pVertex[decl.offset / 4]);
+        normalStorage = vtxcompress::encodeOctahedralNormal(normal.data());
+
+        break;
+      }
+      default: {
+        ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &pVertex[decl.offset / 4]);
+        break;
+      }
+      }
+    }
+  }
+
   void UsdMeshImporter::triangulate(const uint32_t numTriangles, 
                                     const uint32_t elementStride,
                                     const std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers,
@@ -421,172 +545,206 @@ namespace lss {
                                     FaceToTriangleMap& triangleMapOut) {
     ZoneScoped;
     const uint32_t numIndices = numTriangles * 3;
-    const uint32_t numVertexElements = numIndices * elementStride;
     indicesOut.resize(numIndices);
-    m_vertexData.resize(numVertexElements);
-
-    fast_unordered_cache<uint32_t> uniqueVertexToIndex;
-
-    IndexRange currentFaceMapRange;
-    uint32_t uniqueVertexIndex = 0;
-    uint32_t prevFaceIdx = 0;
-    uint32_t totalOffset = 0;
-    for (uint32_t triIdx = 0; triIdx < numTriangles; triIdx++) {
-      for (uint32_t vertIdx = 0; vertIdx < 3; vertIdx++) {
-        const uint32_t idx = triIdx * 3 + vertIdx;
-
-        const uint32_t vertexOffset = totalOffset;
-
-        // Sample the vertex attributes to get all the data for this vertex.
-        for (const VertexDeclaration& decl : m_vertexDecl) {
-          switch (decl.attribute) {
-          case Attributes::BlendWeights:
-            // Do nothing, we decode the blend weights and indices together below
-            break;
-          case Attributes::BlendIndices:
-          {
-            if (ppMeshSamplers[Attributes::BlendWeights] == nullptr) {
-              assert(0);
-            }
-            // Temporary storage for the full data.
-            uint32_t blendIndicesStorage[MaxSupportedNumBones];
-            float blendWeightsStorage[MaxSupportedNumBones];
-
-            // Sample full bone indices...
-            ppMeshSamplers[Attributes::BlendIndices]->SampleBuffer(idx, &blendIndicesStorage[0]);
-            // ... and the corresponding blend weights
-            ppMeshSamplers[Attributes::BlendWeights]->SampleBuffer(idx, &blendWeightsStorage[0]);
-
-            // Helper to write the blend data to our vertex buffer
-            const auto& writeBlendData = [&](uint32_t* blendIndices, float* blendWeights) {
-              // Encode the limited bone indices into compressed byte form
-              for (int j = 0; j < m_limitedNumBonesPerVertex; j += 4) {
-                uint32_t vertIndices = 0;
-                for (int k = 0; k < 4 && (j + k) < m_limitedNumBonesPerVertex; ++k) {
-                  vertIndices |= blendIndices[j + k] << (8 * k);
-                }
-                *(uint32_t*) (&m_vertexData[vertexOffset + decl.offset / 4 + j / 4]) = vertIndices;
-              }
-
-              // Write the weights
-              const VertexDeclaration* blendWeightsDecl = nullptr;
-              for (const VertexDeclaration& decl : m_vertexDecl) {
-                if (decl.attribute == Attributes::BlendWeights) {
-                  blendWeightsDecl = &decl;
-                  break;
-                }
-              }
-              assert(blendWeightsDecl != nullptr);
-              memcpy(&m_vertexData[vertexOffset + blendWeightsDecl->offset / 4], &blendWeights[0], blendWeightsDecl->size);
-            };
-
-            // Limit the influences
-            if (m_actualNumBonesPerVertex != m_limitedNumBonesPerVertex) {
-              uint32_t limitedIndices[MaxSupportedNumBones];
-              float limitedWeights[MaxSupportedNumBones];
-              limitBoneInfluences<MaxSupportedNumBones>(blendIndicesStorage, blendWeightsStorage, m_actualNumBonesPerVertex, m_limitedNumBonesPerVertex, limitedIndices, limitedWeights);
-              writeBlendData(&limitedIndices[0], &limitedWeights[0]);
-            } else {
-              writeBlendData(&blendIndicesStorage[0], &blendWeightsStorage[0]);
-            }
-            break;
-          }
-          case Attributes::Colors:
-          {
-            uint32_t& vertexColor = *(uint32_t*) &m_vertexData[vertexOffset + decl.offset / 4];
-            float opacity = 1.0f;  // default to opaque
-            if (ppMeshSamplers[Attributes::Opacity]) {
-              ppMeshSamplers[Attributes::Opacity]->SampleBuffer(idx, &opacity);
-            }
-            GfVec3f color(1.0f); // default to white
-            if (ppMeshSamplers[Attributes::Colors]) {
-              ppMeshSamplers[Attributes::Colors]->SampleBuffer(idx, &color);
-            }
-            vertexColor = D3DCOLOR_ARGB(((DWORD) (opacity * 255.f)), (DWORD) ((color[0]) * 255.f), (DWORD) ((color[1]) * 255.f), (DWORD) ((color[2]) * 255.f));
-            break;
-          }
-          case Attributes::Opacity:
-          {
-            assert(false); // This attribute should never be in the VertexDeclaration.  Presence in the USD leads to Attributes::Colors existing.
-            break;
-          }
-          case Attributes::Texcoords: {
-            ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &m_vertexData[vertexOffset + decl.offset / 4]);
-            // Invert texcoord.y for Remix
-            m_vertexData[vertexOffset + decl.offset / 4 + 1] = 1.f - m_vertexData[vertexOffset + decl.offset / 4 + 1];
-            break;
-          }
-          case Attributes::Normals: {
-            GfVec3f normal(0.0f);
-            ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &normal);
-            uint32_t& normalStorage = *reinterpret_cast<uint32_t*>(&m_vertexData[vertexOffset + decl.offset / 4]);
-
-            const float maxMag = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
-            const float inverseMag = maxMag == 0.0f ? 0.0f : (1.0f / maxMag);
-            float x = normal[0] * inverseMag;
-            float y = normal[1] * inverseMag;
-
-            if (normal[2] < 0.0f) {
-              const auto originalXSign = signNotZero(x);
-              const auto originalYSign = signNotZero(y);
-              const auto inverseAbsX = 1.0f - std::abs(x);
-              const auto inverseAbsY = 1.0f - std::abs(y);
-
-              x = inverseAbsY * originalXSign;
-              y = inverseAbsX * originalYSign;
-            }
+    // Every corner is sampled into its own slot of the interleaved vertex buffer, which is compacted in place below
+    m_vertexData.resize(size_t(numIndices) * elementStride);
+    std::vector<XXH64_hash_t> cornerHashes(numIndices);
 
-            // Signed->Unsigned octahedral
-            x = x * 0.5f + 0.5f;
-            y = y * 0.5f + 0.5f;
+    const auto decodeFaceIdx = [&](const uint32_t triIdx) -> uint32_t {
+      return UsdMeshUtil::DecodeFaceIndexFromCoarseFaceParam(trianglePrimitiveParams[triIdx]);
+    };
 
-            normalStorage = f32ToUnorm16(x) | (f32ToUnorm16(y) << 16);
+    // Corners only depend on the samplers, so ranges of triangles are sampled and hashed concurrently.
+    // The triangles of a face are contiguous, so each range also records the face boundaries it contains.
+    const size_t numTasks = dxvk::divCeil<size_t>(numTriangles, kTrianglesPerTask);
+    WorkParallelForN(numTasks, [&](size_t beginTask, size_t endTask) {
+      const uint32_t beginTri = static_cast<uint32_t>(beginTask * kTrianglesPerTask);
+      const uint32_t endTri = static_cast<uint32_t>(std::min<size_t>(endTask * kTrianglesPerTask, numTriangles));
+      for (uint32_t triIdx = beginTri; triIdx < endTri; triIdx++) {
+        for (uint32_t idx = triIdx * 3; idx < triIdx * 3 + 3; idx++) {
+          float* pVertex = &m_vertexData[size_t(idx) * elementStride];
+          sampleCorner(idx, ppMeshSamplers, pVertex);
+          cornerHashes[idx] = XXH3_64bits(pVertex, m_vertexStride);
+        }
 
-            break;
-          }
-          default: {
-            ppMeshSamplers[decl.attribute]->SampleBuffer(idx, &m_vertexData[vertexOffset + decl.offset / 4]);
-            break;
+        // Build the face to index mapping for geom subsets
+        if (triangleMapOut.size() > 0) {
+          const uint32_t faceIdx = decodeFaceIdx(triIdx);
+          if (triIdx == 0 || decodeFaceIdx(triIdx - 1) != faceIdx) {
+            triangleMapOut[faceIdx].start = triIdx * 3;
           }
+          if (triIdx + 1 == numTriangles || decodeFaceIdx(triIdx + 1) != faceIdx) {
+            triangleMapOut[faceIdx].end = (triIdx + 1) * 3;
           }
         }
+      }
+    });
 
-        // If we've indexed this vertex before, no need to waste memory
-        const XXH64_hash_t vHash = XXH3_64bits(&m_vertexData[totalOffset], m_vertexStride);
-
-        const auto& existingVertex = uniqueVertexToIndex.find(vHash);
-        if (existingVertex == uniqueVertexToIndex.end()) {
-          std::memcpy(&m_vertexData[uniqueVertexIndex * elementStride], &m_vertexData[totalOffset], m_vertexStride);
-          uniqueVertexToIndex[vHash] = indicesOut[idx] = uniqueVertexIndex++;
-          // if this was unique, then offset the vertex data write pointer, if not, overwrite the last vertex entry
-          totalOffset += elementStride;
-        } else {
+    // Deduplicate in corner order, so the vertex order is the same as a serial triangulation.
+    // A unique vertex only ever moves to a lower slot, so no corner is overwritten before it was visited.
+    fast_flat_map<uint32_t> uniqueVertexToIndex;
+    uniqueVertexToIndex.reserve(numTriangles);
+    uint32_t uniqueVertexIndex = 0;
+    for (uint32_t idx = 0; idx < numIndices; idx++) {
+      const auto [pExistingIndex, isUnique] = uniqueVertexToIndex.emplace(cornerHashes[idx]);
+      if (isUnique) {
+        if (uniqueVertexIndex != idx) {
+          std::memcpy(&m_vertexData[size_t(uniqueVertexIndex) * elementStride], &m_vertexData[size_t(idx) * elementStride], m_vertexStride);
+        }
+        *pExistingIndex = indicesOut[idx] = uniqueVertexIndex++;
+      } else {
 #ifndef NDEBUG
-          // Check for hash collisions
-          assert(memcmp(&m_vertexData[existingVertex->second * elementStride], &m_vertexData[totalOffset], m_vertexStride) == 0);
+        // Check for hash collisions
+        assert(memcmp(&m_vertexData[size_t(*pExistingIndex) * elementStride], &m_vertexData[size_t(idx) * elementStride], m_vertexStride) == 0);
 #endif
-          indicesOut[idx] = existingVertex->second;
-        }
+        indicesOut[idx] = *pExistingIndex;
       }
+    }
 
-      // Build the face to index mapping for geom subsets
-      if (triangleMapOut.size() > 0) {
-        const uint32_t faceIdx = UsdMeshUtil::DecodeFaceIndexFromCoarseFaceParam(trianglePrimitiveParams[triIdx]);
-        if (faceIdx != prevFaceIdx) {
-          currentFaceMapRange.end = triIdx * 3;
-          triangleMapOut[prevFaceIdx] = currentFaceMapRange;
-          currentFaceMapRange.start = currentFaceMapRange.end; // restart the count
-          prevFaceIdx = faceIdx;
-        }
+    m_vertexData.resize(size_t(uniqueVertexIndex) * elementStride);
+  }
+
+  namespace {
+    // Bump when the optimizer output changes, so stale cache entries are not used
+    constexpr uint32_t kVertexOrderCacheVersion = 1;
+    constexpr uint32_t kVertexOrderCacheMagic = 0x4F565452; // "RTVO"
+
+    struct VertexOrderCacheHeader {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t numVertices;
+      uint32_t numSubMeshes;
+    };
+  }
+
+  void UsdMeshImporter::OptimizeVertexOrder(const std::string& cacheDirectory) {
+    ZoneScoped;
+    std::string cachePath;
+    if (!cacheDirectory.empty()) {
+      XXH64_hash_t key = XXH3_64bits(m_vertexData.data(), m_vertexData.size() * sizeof(float));
+      key = XXH3_64bits_withSeed(&m_vertexStride, sizeof(m_vertexStride), key);
+      for (const SubMesh& subMesh : m_meshes) {
+        key = XXH3_64bits_withSeed(subMesh.indexBuffer.data(), subMesh.indexBuffer.size() * sizeof(uint32_t), key);
+      }
+      cachePath = str::format(cacheDirectory, "/", std::hex, key, ".vtxorder");
+      if (loadVertexOrder(cachePath)) {
+        return;
       }
     }
 
-    if (triangleMapOut.size() > 0 && prevFaceIdx != 0xFFFFFFFF) {
-      // Add the last face to mapping
-      currentFaceMapRange.end = numTriangles * 3;
-      triangleMapOut[prevFaceIdx] = currentFaceMapRange;
+    WorkParallelForN(m_meshes.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        std::vector<uint32_t>& indices = m_meshes[i].indexBuffer;
+        meshopt::optimizeVertexCache(indices.data(), indices.size(), m_numVertices);
+      }
+    });
+
+    // Subsets share the vertex buffer, their vertices end up in the order the subsets first use them
+    meshopt::VertexFetchRemap fetchRemap(m_numVertices);
+    for (const SubMesh& subMesh : m_meshes) {
+      fetchRemap.addIndices(subMesh.indexBuffer.data(), subMesh.indexBuffer.size());
     }
+    const std::vector<uint32_t>& vertexRemap = fetchRemap.finish();
 
-    m_vertexData.resize(uniqueVertexIndex * elementStride);
+    for (SubMesh& subMesh : m_meshes) {
+      meshopt::remapIndexBuffer(subMesh.indexBuffer.data(), subMesh.indexBuffer.size(), vertexRemap.data());
+    }
+    std::vector<float> vertexData(m_vertexData.size());
+    meshopt::remapVertexBuffer(vertexData.data(), m_vertexData.data(), m_numVertices, m_vertexStride, vertexRemap.data());
+    m_vertexData = std::move(vertexData);
+
+    if (!cachePath.empty()) {
+      storeVertexOrder(cachePath, vertexRemap);
+    }
+  }
+
+  bool UsdMeshImporter::loadVertexOrder(const std::string& cachePath) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+
+    VertexOrderCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != kVertexOrderCacheMagic || header.version != kVertexOrderCacheVersion ||
+        header.numVertices != m_numVertices || header.numSubMeshes != m_meshes.size()) {
+      return false;
+    }
+
+    std::vector<uint32_t> vertexRemap(m_numVertices);
+    file.read(reinterpret_cast<char*>(vertexRemap.data()), vertexRemap.size() * sizeof(uint32_t));
+    std::vector<std::vector<uint32_t>> indexBuffers(m_meshes.size());
+    for (size_t i = 0; i < m_meshes.size() && file; i++) {
+      uint32_t numIndices = 0;
+      file.read(reinterpret_cast<char*>(&numIndices), sizeof(numIndices));
+      if (numIndices != m_meshes[i].GetNumIndices()) {
+        return false;
+      }
+      indexBuffers[i].resize(numIndices);
+      file.read(reinterpret_cast<char*>(indexBuffers[i].data()), numIndices * sizeof(uint32_t));
+    }
+    if (!file) {
+      Logger::warn(str::format("Ignoring truncated vertex order cache file: ", cachePath));
+      return false;
+    }
+    // The remap must be a permutation and the indices must stay in range, otherwise the remapped buffers are
+    // read out of bounds. Returning false recomputes the vertex order.
+    std::vector<bool> isRemapTarget(m_numVertices, false);
+    bool isValid = true;
+    for (uint32_t newIndex : vertexRemap) {
+      if (newIndex >= m_numVertices || isRemapTarget[newIndex]) {
+        isValid = false;
+        break;
+      }
+      isRemapTarget[newIndex] = true;
+    }
+    for (size_t i = 0; i < indexBuffers.size() && isValid; i++) {
+      isValid = std::all_of(indexBuffers[i].begin(), indexBuffers[i].end(), [this](uint32_t index) { return index < m_numVertices; });
+    }
+    if (!isValid) {
+      Logger::warn(str::format("Ignoring corrupt vertex order cache file: ", cachePath));
+      return false;
+    }
+
+    for (size_t i = 0; i < m_meshes.size(); i++) {
+      m_meshes[i].indexBuffer = std::move(indexBuffers[i]);
+    }
+    std::vector<float> vertexData(m_vertexData.size());
+    meshopt::remapVertexBuffer(vertexData.data(), m_vertexData.data(), m_numVertices, m_vertexStride, vertexRemap.data());
+    m_vertexData = std::move(vertexData);
+    return true;
+  }
+
+  void UsdMeshImporter::storeVertexOrder(const std::string& cachePath, const std::vector<uint32_t>& vertexRemap) const {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), ec);
+
+    // Written to a temporary file first, so a concurrent load never sees a partial entry
+    const std::string tempPath = cachePath + ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      if (!file) {
+        Logger::debug(str::format("Unable to write vertex order cache file: ", cachePath));
+        return;
+      }
+      const VertexOrderCacheHeader header { kVertexOrderCacheMagic, kVertexOrderCacheVersion, m_numVertices, static_cast<uint32_t>(m_meshes.size()) };
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(vertexRemap.data()), vertexRemap.size() * sizeof(uint32_t));
+      for (const SubMesh& subMesh : m_meshes) {
+        const uint32_t numIndices = static_cast<uint32_t>(subMesh.GetNumIndices());
+        file.write(reinterpret_cast<const char*>(&numIndices), sizeof(numIndices));
+        file.write(reinterpret_cast<const char*>(subMesh.indexBuffer.data()), numIndices * sizeof(uint32_t));
+      }
+      if (!file) {
+        Logger::debug(str::format("Unable to write vertex order cache file: ", cachePath));
+        file.close();
+        std::filesystem::remove(tempPath, ec);
+        return;
+      }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+      std::filesystem::remove(tempPath, ec);
+    }
   }
 }
@@ -52,7 +52,7 @@ namespace lss {
     };
 
     struct SubMesh {
-      SubMesh(const std::vector<uint32_t>&& ib, const pxr::UsdPrim& _prim)
+      SubMesh(std::vector<uint32_t>&& ib, const pxr::UsdPrim& _prim)
         : indexBuffer(std::move(ib))
         , prim(_prim) { }
 
@@ -112,8 +112,14 @@ namespace lss {
       return m_boundingBox;
     }
 
+    // Reorders triangles for post-transform cache locality and vertices for fetch locality.
+    // The new order is stored in cacheDirectory (if not empty), keyed by the mesh contents, and loaded from there next time.
+    void OptimizeVertexOrder(const std::string& cacheDirectory);
+
   private:
     inline static const uint32_t MaxSupportedNumBones = 256;
+    // Triangles sampled per task when triangulating on multiple threads
+    inline static const size_t kTrianglesPerTask = 4096;
 
     struct IndexRange {
       uint32_t start = 0, end = 0;
@@ -121,6 +127,9 @@ namespace lss {
 
     using FaceToTriangleMap = std::vector<IndexRange>;
 
+    void sampleCorner(const uint32_t idx,
+                      const std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers,
+                      float* pVertex) const;
     void triangulate(const uint32_t numTriangles, 
                      const uint32_t elementStride,
                      const std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers,
@@ -128,7 +137,10 @@ namespace lss {
                      std::vector<uint32_t>& indicesOut,
                      FaceToTriangleMap& triangleMapOut);
 
-    static const std::vector<uint32_t> generateSubsetIndices(const pxr::UsdGeomSubset& subset, const std::vector<uint32_t>& indices, const FaceToTriangleMap& triangleMap);
+    bool loadVertexOrder(const std::string& cachePath);
+    void storeVertexOrder(const std::string& cachePath, const std::vector<uint32_t>& vertexRemap) const;
+
+    static std::vector<uint32_t> generateSubsetIndices(const pxr::UsdGeomSubset& subset, const std::vector<uint32_t>& indices, const FaceToTriangleMap& triangleMap);
     void generateTriangleSamplers(UsdMeshUtil& meshUtil, const pxr::VtVec3iArray& usdIndices, const pxr::VtIntArray& trianglePrimitiveParams, std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers);
     uint32_t generateVertexDeclaration(std::unique_ptr<GeomPrimvarSampler>* ppMeshSamplers);
 
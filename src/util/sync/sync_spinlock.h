@@ -29,6 +29,28 @@ namespace dxvk::sync {
       dxvk::this_thread::yield();
     }
   }
+
+  /**
+   * \brief Bounded spin function
+   *
+   * Probes a condition a limited number of times, for
+   * waits that spin briefly before blocking on an OS
+   * primitive.
+   * \param [in] spinCount Maximum number of probes
+   * \param [in] fn Condition to test
+   * \returns \c true if the condition became \c true
+   */
+  template<typename Fn>
+  bool spinFor(uint32_t spinCount, const Fn& fn) {
+    for (uint32_t i = 0; i < spinCount; i++) {
+      if (fn())
+        return true;
+
+      _mm_pause();
+    }
+
+    return fn();
+  }
   
   /**
    * \brief Spin lock
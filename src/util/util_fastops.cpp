@@ -25,6 +25,8 @@
 #include "util_math.h"
 #include "util_fastops.h"
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <ppl.h>
 #include "util_fastops.h"
 
@@ -677,6 +679,222 @@ namespace fast {
     }
   }
 
+  void findMinMaxStrided8x4_slow(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut) {
+    uint8_t minOut8 = 0xFF;
+    uint8_t maxOut8 = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      for (uint32_t j = 0; j < componentCount; j++) {
+        minOut8 = std::min(minOut8, data[j]);
+        maxOut8 = std::max(maxOut8, data[j]);
+      }
+      data += stride;
+    }
+    minOut = (uint32_t) minOut8;
+    maxOut = (uint32_t) maxOut8;
+  }
+
+  __forceinline uint8_t extractMin8_SSE(__m128i min) {
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 8));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 4));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 2));
+    min = _mm_min_epu8(min, _mm_srli_si128(min, 1));
+    return (uint8_t) _mm_cvtsi128_si32(min);
+  }
+
+  __forceinline uint8_t extractMax8_SSE(__m128i max) {
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 8));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 4));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 2));
+    max = _mm_max_epu8(max, _mm_srli_si128(max, 1));
+    return (uint8_t) _mm_cvtsi128_si32(max);
+  }
+
+  __forceinline int loadElement32(const uint8_t* data) {
+    int value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  // Unsigned 8-bit min/max is native to SSE2, so a single implementation covers all SSE levels
+  void findMinMaxStrided8x4_SSE(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut) {
+    const uint32_t numLanes = 4;
+    const uint32_t alignedCount = dxvk::alignDown(count, numLanes);
+
+    // Bytes past componentCount are forced to 0xFF for the min and to 0 for the max, so they never win
+    const uint32_t componentMask = componentCount >= 4 ? 0xFFFFFFFFu : ((1u << (componentCount * 8)) - 1);
+    const __m128i usedMask = _mm_set1_epi32((int) componentMask);
+    const __m128i unusedMask = _mm_set1_epi32((int) ~componentMask);
+
+    __m128i min = _mm_set1_epi8((char) 0xFF);
+    __m128i max = _mm_setzero_si128();
+
+    for (uint32_t i = 0; i < alignedCount; i += numLanes) {
+      const uint8_t* element = data + i * stride;
+      __m128i values;
+      if (stride == 4) {
+        values = _mm_loadu_si128((const __m128i*) element);
+      } else {
+        values = _mm_set_epi32(loadElement32(element + 3 * stride), loadElement32(element + 2 * stride),
+                               loadElement32(element + stride), loadElement32(element));
+      }
+      min = _mm_min_epu8(min, _mm_or_si128(values, unusedMask));
+      max = _mm_max_epu8(max, _mm_and_si128(values, usedMask));
+    }
+
+    uint8_t minOut8 = extractMin8_SSE(min);
+    uint8_t maxOut8 = extractMax8_SSE(max);
+
+    // Process the remainder (if count not aligned to 4)
+    for (uint32_t i = alignedCount; i < count; ++i) {
+      const uint8_t* element = data + i * stride;
+      for (uint32_t j = 0; j < componentCount; j++) {
+        minOut8 = std::min(minOut8, element[j]);
+        maxOut8 = std::max(maxOut8, element[j]);
+      }
+    }
+
+    minOut = (uint32_t) minOut8;
+    maxOut = (uint32_t) maxOut8;
+  }
+
+  void findMinMaxStrided8x4(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut) {
+    const bool useSSE = SSE_ENABLE && count >= 32;
+
+    if (useSSE) {
+      findMinMaxStrided8x4_SSE(count, data, stride, componentCount, minOut, maxOut);
+    } else {
+      findMinMaxStrided8x4_slow(count, data, stride, componentCount, minOut, maxOut);
+    }
+  }
+
+
+  // Exact check of vectors [firstVector, endVector), matches (a - b).GetLengthSq() > deltaSq per vector
+  bool anyVectorDistanceAbove_slow(const float* a, const float* b, const uint32_t firstVector, const uint32_t endVector, const uint32_t componentCount, const float deltaSq) {
+    for (uint32_t i = firstVector; i < endVector; i++) {
+      float lengthSq = 0.f;
+      for (uint32_t c = 0; c < componentCount; c++) {
+        const float d = a[i * componentCount + c] - b[i * componentCount + c];
+        lengthSq += d * d;
+      }
+      if (lengthSq > deltaSq) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // True if any of the 8 floats at a and b differ by more than sqrt(laneThresholdSq)
+  template<SIMD simd>
+  __forceinline bool blockMayDiffer8(const float* a, const float* b, const float laneThresholdSq) {
+    if constexpr (simd == SIMD::AVX2) {
+      const __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b));
+      return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_mul_ps(d, d), _mm256_set1_ps(laneThresholdSq), _CMP_GT_OQ)) != 0;
+    } else {
+      const __m128 threshold = _mm_set1_ps(laneThresholdSq);
+      const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+      const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + 4), _mm_loadu_ps(b + 4));
+      const __m128 gt = _mm_or_ps(_mm_cmpgt_ps(_mm_mul_ps(d0, d0), threshold), _mm_cmpgt_ps(_mm_mul_ps(d1, d1), threshold));
+      return _mm_movemask_ps(gt) != 0;
+    }
+  }
+
+  // Compares the packed floats [compared, end) 8 at a time, and advances compared past every full block checked.
+  // While no float moved by more than sqrt(deltaSq / componentCount), no vector can be further than sqrt(deltaSq),
+  // so only blocks with a larger move are checked exactly. The threshold is shaved slightly to absorb rounding.
+  template<SIMD simd>
+  bool anyVectorDistanceAboveBlocks(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq) {
+    const float laneThresholdSq = deltaSq / (float) componentCount * 0.999f;
+    for (; compared + 8 <= end; compared += 8) {
+      if (blockMayDiffer8<simd>(a + compared, b + compared, laneThresholdSq)) {
+        const uint32_t firstVector = compared / componentCount;
+        const uint32_t endVector = (compared + 7) / componentCount + 1;
+        if (anyVectorDistanceAbove_slow(a, b, firstVector, endVector, componentCount, deltaSq)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool anyVectorDistanceAbove_SSE(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq) {
+    return anyVectorDistanceAboveBlocks<SIMD::SSE2>(a, b, compared, end, componentCount, deltaSq);
+  }
+
+  bool anyVectorDistanceAbove_AVX2(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq) {
+    return anyVectorDistanceAboveBlocks<SIMD::AVX2>(a, b, compared, end, componentCount, deltaSq);
+  }
+
+  __forceinline bool anyVectorDistanceAbove_SIMD(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq) {
+    switch (g_simdSupportLevel) {
+    case SIMD::AVX512:
+    case SIMD::AVX2:
+      return anyVectorDistanceAbove_AVX2(a, b, compared, end, componentCount, deltaSq);
+    case SIMD::SSE4_1:
+    case SIMD::SSE3:
+    case SIMD::SSE2:
+      return anyVectorDistanceAbove_SSE(a, b, compared, end, componentCount, deltaSq);
+    default:
+      return false;
+    }
+  }
+
+  bool anyVectorDistanceAbove(const uint32_t count, const float* a, const float* b, const uint32_t componentCount, const float deltaSq) {
+    uint32_t compared = 0;
+    if (SSE_ENABLE && count * componentCount >= 32) {
+      if (anyVectorDistanceAbove_SIMD(a, b, compared, count * componentCount, componentCount, deltaSq)) {
+        return true;
+      }
+    }
+    // Vectors of the final partial block
+    return anyVectorDistanceAbove_slow(a, b, compared / componentCount, count, componentCount, deltaSq);
+  }
+
+  template<uint32_t ComponentCount>
+  __forceinline void gatherStrided(float* dst, const uint8_t* src, const uint32_t srcStride, const uint32_t begin, const uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      memcpy(dst + i * ComponentCount, src + (size_t) i * srcStride, ComponentCount * sizeof(float));
+    }
+  }
+
+  __forceinline void gatherStrided(float* dst, const uint8_t* src, const uint32_t srcStride, const uint32_t componentCount, const uint32_t begin, const uint32_t end) {
+    switch (componentCount) {
+    case 1: gatherStrided<1>(dst, src, srcStride, begin, end); break;
+    case 2: gatherStrided<2>(dst, src, srcStride, begin, end); break;
+    case 3: gatherStrided<3>(dst, src, srcStride, begin, end); break;
+    case 4: gatherStrided<4>(dst, src, srcStride, begin, end); break;
+    default:
+      assert(false && "gatherStrided: unsupported vector size");
+      for (uint32_t i = begin; i < end; i++) {
+        memcpy(dst + (size_t) i * componentCount, src + (size_t) i * srcStride, componentCount * sizeof(float));
+      }
+      break;
+    }
+  }
+
+  bool copyStridedAndCompare(const uint32_t count, float* dst, const uint8_t* src, const uint32_t srcStride, const uint32_t componentCount, const float* prev, const float deltaSq) {
+    if (prev == nullptr) {
+      gatherStrided(dst, src, srcStride, componentCount, 0, count);
+      return true;
+    }
+
+    // Gather a batch at a time and compare it while it is still in cache. Once a difference is found the rest is only copied.
+    constexpr uint32_t kBatchSize = 256;
+    const bool useSSE = SSE_ENABLE && count * componentCount >= 32;
+    bool differs = false;
+    uint32_t compared = 0;
+    for (uint32_t begin = 0; begin < count; begin += kBatchSize) {
+      const uint32_t end = std::min(count, begin + kBatchSize);
+      gatherStrided(dst, src, srcStride, componentCount, begin, end);
+      if (!differs && useSSE) {
+        differs = anyVectorDistanceAbove_SIMD(dst, prev, compared, end * componentCount, componentCount, deltaSq);
+      }
+    }
+    if (!differs) {
+      differs = anyVectorDistanceAbove_slow(dst, prev, compared / componentCount, count, componentCount, deltaSq);
+    }
+    return differs;
+  }
+
 
   template<typename T>
   __forceinline void copySubtract_slow(T* dstData, const T* srcData, const uint32_t count, const T value, const bool ignoreSentinel, const T sentinelValue) {
@@ -54,6 +54,48 @@ namespace fast {
   template<typename T>
   void findMinMax(const uint32_t count, const T* data, uint32_t& minOut, uint32_t& maxOut, const bool sentinelIgnore = false, const T sentinelValue = 0);
 
+  /**
+    * \brief Finds minimum and maximum byte value across strided elements of up to 4 bytes
+    *
+    * count: number of elements
+    * data: pointer to the first element, 4 bytes must be readable at each element
+    * stride: distance between consecutive elements in bytes
+    * componentCount: number of leading bytes of each element to consider (1 to 4)
+    * minOut: minimum value determined by operation
+    * maxOut: maximum value determined by operation
+    *
+    * Intended for packed 8-bit vertex attributes such as UBYTE4 blend indices.
+    */
+  void findMinMaxStrided8x4(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut);
+
+  /**
+    * \brief Checks whether any vector of a packed array moved further than a threshold from its counterpart in another
+    *
+    * count: number of vectors
+    * a, b: packed arrays of count * componentCount floats
+    * componentCount: number of floats per vector (1 to 4)
+    * deltaSq: squared distance threshold
+    *
+    * Returns true on the first vector where (a[i] - b[i]).GetLengthSq() > deltaSq.
+    */
+  bool anyVectorDistanceAbove(const uint32_t count, const float* a, const float* b, const uint32_t componentCount, const float deltaSq);
+
+  /**
+    * \brief Gathers strided float vectors into a packed array, comparing them against a previous packed array in the same pass
+    *
+    * count: number of vectors
+    * dst: packed output of count * componentCount floats
+    * src: pointer to the first source vector
+    * srcStride: distance between consecutive source vectors in bytes
+    * componentCount: number of floats per vector (1 to 4)
+    * prev: packed array to compare the output with, may be null
+    * deltaSq: squared distance threshold
+    *
+    * Returns true if prev is null or anyVectorDistanceAbove(dst, prev) would. Comparison stops at the first
+    * difference, the remaining vectors are only copied.
+    */
+  bool copyStridedAndCompare(const uint32_t count, float* dst, const uint8_t* src, const uint32_t srcStride, const uint32_t componentCount, const float* prev, const float deltaSq);
+
   /**
     * \brief Performs the following operation on an array of unsigned integers, (D[i] = S[i] - V)
     *
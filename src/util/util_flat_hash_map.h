@@ -0,0 +1,245 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "xxHash/xxhash.h"
+
+namespace dxvk {
+
+  // An open addressing (linear probing) hash map for use ONLY with already hashed keys.
+  // Entries are stored inline in a single power of two sized array, so a lookup is usually a
+  // single cache line access, unlike the node based fast_unordered_cache.
+  // Key 0 is used internally to mark empty slots, an entry with key 0 is stored out of line.
+  // Erasing uses backward shift deletion, so no tombstones accumulate.
+  template<class T>
+  class fast_flat_map {
+    static constexpr XXH64_hash_t kEmptyKey = 0;
+    static constexpr size_t kMinCapacity = 16;
+
+    struct Slot {
+      XXH64_hash_t key = kEmptyKey;
+      T value {};
+    };
+
+  public:
+    fast_flat_map() = default;
+
+    T* find(XXH64_hash_t key) {
+      return const_cast<T*>(std::as_const(*this).find(key));
+    }
+
+    const T* find(XXH64_hash_t key) const {
+      if (key == kEmptyKey) {
+        return m_hasZeroKey ? &m_zeroKeySlot.value : nullptr;
+      }
+
+      if (m_slots.empty()) {
+        return nullptr;
+      }
+
+      for (size_t i = key & m_mask;; i = (i + 1) & m_mask) {
+        const Slot& slot = m_slots[i];
+        if (slot.key == key) {
+          return &slot.value;
+        }
+        if (slot.key == kEmptyKey) {
+          return nullptr;
+        }
+      }
+    }
+
+    bool contains(XXH64_hash_t key) const {
+      return find(key) != nullptr;
+    }
+
+    // Returns the value for key, default constructing it if not present.
+    // The bool is true if the value was inserted.
+    std::pair<T*, bool> emplace(XXH64_hash_t key) {
+      if (key == kEmptyKey) {
+        const bool inserted = !m_hasZeroKey;
+        if (inserted) {
+          m_zeroKeySlot.value = T {};
+          m_hasZeroKey = true;
+          ++m_size;
+        }
+        return { &m_zeroKeySlot.value, inserted };
+      }
+
+      // Keep the load factor at or below 1/2 so probe sequences stay short
+      if ((m_size + 1) * 2 > m_slots.size()) {
+        rehash(m_slots.empty() ? kMinCapacity : m_slots.size() * 2);
+      }
+
+      for (size_t i = key & m_mask;; i = (i + 1) & m_mask) {
+        Slot& slot = m_slots[i];
+        if (slot.key == key) {
+          return { &slot.value, false };
+        }
+        if (slot.key == kEmptyKey) {
+          slot.key = key;
+          slot.value = T {};
+          ++m_size;
+          return { &slot.value, true };
+        }
+      }
+    }
+
+    T& operator[](XXH64_hash_t key) {
+      return *emplace(key).first;
+    }
+
+    bool erase(XXH64_hash_t key) {
+      if (key == kEmptyKey) {
+        if (!m_hasZeroKey) {
+          return false;
+        }
+        m_hasZeroKey = false;
+        --m_size;
+        return true;
+      }
+
+      if (m_slots.empty()) {
+        return false;
+      }
+
+      size_t i = key & m_mask;
+      for (;; i = (i + 1) & m_mask) {
+        if (m_slots[i].key == key) {
+          break;
+        }
+        if (m_slots[i].key == kEmptyKey) {
+          return false;
+        }
+      }
+
+      // Backward shift deletion: pull following entries of the cluster into the hole
+      // if the hole lies between their home slot and their current slot.
+      for (size_t j = (i + 1) & m_mask;; j = (j + 1) & m_mask) {
+        if (m_slots[j].key == kEmptyKey) {
+          break;
+        }
+        const size_t home = m_slots[j].key & m_mask;
+        const bool canMove = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (canMove) {
+          m_slots[i] = std::move(m_slots[j]);
+          i = j;
+        }
+      }
+
+      m_slots[i].key = kEmptyKey;
+      m_slots[i].value = T {};
+      --m_size;
+      return true;
+    }
+
+    // Calls f(key, value) for every entry
+    template<typename F>
+    void for_each(F&& f) {
+      if (m_hasZeroKey) {
+        f(kEmptyKey, m_zeroKeySlot.value);
+      }
+      for (Slot& slot : m_slots) {
+        if (slot.key != kEmptyKey) {
+          f(slot.key, slot.value);
+        }
+      }
+    }
+
+    // Removes every entry for which p(key, value) returns true
+    template<typename P>
+    void erase_if(P&& p) {
+      if (m_hasZeroKey && p(kEmptyKey, m_zeroKeySlot.value)) {
+        m_hasZeroKey = false;
+        --m_size;
+      }
+
+      // Re-inserting survivors is simpler than shifting clusters while iterating,
+      // and is linear in the table size either way.
+      std::vector<Slot> oldSlots = std::move(m_slots);
+      m_slots.assign(oldSlots.size(), Slot {});
+      m_size = m_hasZeroKey ? 1 : 0;
+
+      for (Slot& slot : oldSlots) {
+        if (slot.key != kEmptyKey && !p(slot.key, slot.value)) {
+          insertUnique(slot.key, std::move(slot.value));
+        }
+      }
+    }
+
+    void reserve(size_t count) {
+      size_t capacity = kMinCapacity;
+      while (capacity < count * 2) {
+        capacity *= 2;
+      }
+      if (capacity > m_slots.size()) {
+        rehash(capacity);
+      }
+    }
+
+    void clear() {
+      m_slots.clear();
+      m_mask = 0;
+      m_size = 0;
+      m_hasZeroKey = false;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+  private:
+    std::vector<Slot> m_slots;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+    Slot m_zeroKeySlot;
+    bool m_hasZeroKey = false;
+
+    void insertUnique(XXH64_hash_t key, T&& value) {
+      for (size_t i = key & m_mask;; i = (i + 1) & m_mask) {
+        Slot& slot = m_slots[i];
+        if (slot.key == kEmptyKey) {
+          slot.key = key;
+          slot.value = std::move(value);
+          ++m_size;
+          return;
+        }
+      }
+    }
+
+    void rehash(size_t capacity) {
+      std::vector<Slot> oldSlots = std::move(m_slots);
+      m_slots.assign(capacity, Slot {});
+      m_mask = capacity - 1;
+      m_size = m_hasZeroKey ? 1 : 0;
+
+      for (Slot& slot : oldSlots) {
+        if (slot.key != kEmptyKey) {
+          insertUnique(slot.key, std::move(slot.value));
+        }
+      }
+    }
+  };
+
+}
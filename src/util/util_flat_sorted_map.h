@@ -0,0 +1,117 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "util_error.h"
+
+namespace dxvk {
+
+  // An ordered map stored as a sorted array of key/value pairs.
+  // Meant for small maps that are iterated much more often than they are modified, where the node allocations
+  // and pointer chasing of std::map dominate. Lookups are a binary search, inserts and erases shift the tail.
+  // Unlike std::map, inserting or erasing invalidates iterators and references to other entries.
+  template<typename Key, typename Value, typename Compare = std::less<Key>>
+  class flat_sorted_map {
+  public:
+    using value_type = std::pair<Key, Value>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+    using reverse_iterator = typename std::vector<value_type>::reverse_iterator;
+    using const_reverse_iterator = typename std::vector<value_type>::const_reverse_iterator;
+
+    iterator find(const Key& key) {
+      iterator it = lowerBound(key);
+      return (it != m_entries.end() && !m_compare(key, it->first)) ? it : m_entries.end();
+    }
+
+    const_iterator find(const Key& key) const {
+      return const_cast<flat_sorted_map*>(this)->find(key);
+    }
+
+    Value& at(const Key& key) {
+      iterator it = find(key);
+      if (it == m_entries.end()) {
+        throw DxvkError("flat_sorted_map: key not found");
+      }
+      return it->second;
+    }
+
+    const Value& at(const Key& key) const {
+      return const_cast<flat_sorted_map*>(this)->at(key);
+    }
+
+    // Inserts value if key is not present yet. The bool is true if the value was inserted.
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+      iterator it = lowerBound(key);
+      if (it != m_entries.end() && !m_compare(key, it->first)) {
+        return { it, false };
+      }
+      it = m_entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+      return { it, true };
+    }
+
+    iterator erase(const_iterator it) {
+      return m_entries.erase(it);
+    }
+
+    size_t erase(const Key& key) {
+      iterator it = find(key);
+      if (it == m_entries.end()) {
+        return 0;
+      }
+      m_entries.erase(it);
+      return 1;
+    }
+
+    void reserve(size_t count) { m_entries.reserve(count); }
+    void clear() { m_entries.clear(); }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    iterator begin() { return m_entries.begin(); }
+    iterator end() { return m_entries.end(); }
+    const_iterator begin() const { return m_entries.begin(); }
+    const_iterator end() const { return m_entries.end(); }
+    reverse_iterator rbegin() { return m_entries.rbegin(); }
+    reverse_iterator rend() { return m_entries.rend(); }
+    const_reverse_iterator rbegin() const { return m_entries.rbegin(); }
+    const_reverse_iterator rend() const { return m_entries.rend(); }
+
+  private:
+    std::vector<value_type> m_entries;
+    Compare m_compare;
+
+    iterator lowerBound(const Key& key) {
+      return std::lower_bound(m_entries.begin(), m_entries.end(), key,
+        [this](const value_type& entry, const Key& k) { return m_compare(entry.first, k); });
+    }
+  };
+
+}
@@ -0,0 +1,167 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <cassert>
+
+#include "util_frame_arena.h"
+
+namespace dxvk {
+
+  namespace {
+    // The block the calling thread is currently bumping through
+    struct ThreadBlock {
+      // Arenas are identified by a unique id rather than their address, which could be reused by a new arena
+      uint64_t arenaId = 0;
+      uint64_t frameId = 0;
+      uint8_t* memory = nullptr;
+      size_t size = 0;
+      std::atomic<uint64_t>* state = nullptr;
+    };
+
+    // Block state offset of a block that was retired, no frame id matches it
+    constexpr uint64_t kRetiredState = ~uint64_t(0);
+
+    uint64_t packBlockState(uint64_t frameId, size_t offset) {
+      return (frameId << 32) | uint64_t(offset);
+    }
+
+    thread_local ThreadBlock t_block;
+
+    std::atomic<uint64_t> s_nextArenaId = 1;
+
+    uint8_t* alignPointer(uint8_t* ptr, size_t alignment) {
+      const uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+      return reinterpret_cast<uint8_t*>((value + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    }
+  }
+
+  FrameArena::FrameArena()
+    : m_arenaId(s_nextArenaId++) {
+  }
+
+  void* FrameArena::allocate(size_t size, size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    m_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    m_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    ThreadBlock& block = t_block;
+    if (block.arenaId == m_arenaId) {
+      // The CAS fails if advanceFrame() retired the block since it was handed out, or if it was recycled for a later
+      // frame, so an allocation can never land in the memory of a frame that already ended
+      uint64_t state = block.state->load(std::memory_order_relaxed);
+      while ((state >> 32) == (block.frameId & 0xFFFFFFFF) && state != kRetiredState) {
+        const size_t offset = size_t(alignPointer(block.memory + (state & 0xFFFFFFFF), alignment) - block.memory);
+        if (offset + size > block.size) {
+          break;
+        }
+        if (block.state->compare_exchange_weak(state, packBlockState(block.frameId, offset + size), std::memory_order_acq_rel)) {
+          return block.memory + offset;
+        }
+      }
+    }
+
+    // Large allocations get a dedicated block, so they don't waste the remainder of the thread's block
+    const size_t requiredSize = size + alignment - 1;
+    if (requiredSize > kBlockSize / 4) {
+      size_t blockSize;
+      std::atomic<uint64_t>* state;
+      uint64_t frameId;
+      return alignPointer(acquireBlock(requiredSize, blockSize, state, frameId), alignment);
+    }
+
+    uint8_t* memory = acquireBlock(kBlockSize, block.size, block.state, block.frameId);
+    block.arenaId = m_arenaId;
+    block.memory = memory;
+
+    // The block is not visible to any other thread yet, so the first allocation needs no CAS
+    const size_t offset = size_t(alignPointer(memory, alignment) - memory);
+    block.state->store(packBlockState(block.frameId, offset + size), std::memory_order_relaxed);
+    return memory + offset;
+  }
+
+  FrameArena::Stats FrameArena::advanceFrame() {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    Stats stats;
+    stats.allocationCount = m_allocationCount.exchange(0, std::memory_order_relaxed);
+    stats.allocatedBytes = m_allocatedBytes.exchange(0, std::memory_order_relaxed);
+    stats.blockCount = m_blockCount;
+
+    const uint64_t frameId = m_frameId.load(std::memory_order_relaxed);
+    // Threads still bumping through these blocks fail their CAS from here on and move to a block of the next frame
+    for (Block& block : m_currentBlocks) {
+      block.state->store(kRetiredState, std::memory_order_release);
+    }
+    m_retiredFrames.push_back({ frameId, std::move(m_currentBlocks) });
+    m_currentBlocks.clear();
+
+    // Only frames the consumer is done with can be recycled
+    const uint64_t completedFrameEnd = m_completedFrameEnd.load(std::memory_order_acquire);
+    while (!m_retiredFrames.empty() && m_retiredFrames.front().frameId < completedFrameEnd) {
+      for (Block& block : m_retiredFrames.front().blocks) {
+        if (block.size == kBlockSize) {
+          m_freeBlocks.push_back(std::move(block));
+        } else {
+          --m_blockCount;
+        }
+      }
+      m_retiredFrames.pop_front();
+    }
+
+    m_frameId.store(frameId + 1, std::memory_order_release);
+    return stats;
+  }
+
+  void FrameArena::completeFrame(uint64_t frameId) {
+    uint64_t completedFrameEnd = m_completedFrameEnd.load(std::memory_order_relaxed);
+    while (completedFrameEnd <= frameId
+        && !m_completedFrameEnd.compare_exchange_weak(completedFrameEnd, frameId + 1, std::memory_order_release)) {
+    }
+  }
+
+  uint8_t* FrameArena::acquireBlock(size_t minSize, size_t& outSize, std::atomic<uint64_t>*& outState, uint64_t& outFrameId) {
+    std::lock_guard<dxvk::mutex> lock(m_mutex);
+
+    Block block;
+    if (minSize <= kBlockSize && !m_freeBlocks.empty()) {
+      block = std::move(m_freeBlocks.back());
+      m_freeBlocks.pop_back();
+    } else {
+      block.size = std::max(minSize, kBlockSize);
+      block.memory = std::make_unique<uint8_t[]>(block.size);
+      block.state = std::make_unique<std::atomic<uint64_t>>(kRetiredState);
+      ++m_blockCount;
+    }
+
+    // Read the frame under the lock so the block can't be attributed to a frame that was already retired
+    outFrameId = m_frameId.load(std::memory_order_relaxed);
+    block.state->store(packBlockState(outFrameId, 0), std::memory_order_relaxed);
+    outSize = block.size;
+    outState = block.state.get();
+
+    uint8_t* memory = block.memory.get();
+    m_currentBlocks.push_back(std::move(block));
+    return memory;
+  }
+
+}
@@ -0,0 +1,153 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "thread.h"
+
+namespace dxvk {
+
+  // Thread safe bump allocator for transient per frame data (e.g. per draw call state built on worker threads).
+  // Every thread bumps through its own block, so allocating only takes a lock once per block. Nothing is freed
+  // individually: all the memory handed out during a frame is recycled at once, after the consumer of the frame's
+  // data (e.g. the CS thread) has signalled completeFrame() for it. The producer can run frames ahead of the
+  // consumer, so recycling is never tied to a fixed frame count.
+  class FrameArena {
+  public:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    struct Stats {
+      uint64_t allocationCount = 0;
+      uint64_t allocatedBytes = 0;
+      uint64_t blockCount = 0;
+    };
+
+    FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    // Starts a new frame and recycles the memory of every frame the consumer has completed.
+    // Returns the statistics of the frame that just ended.
+    Stats advanceFrame();
+
+    // Called by the consumer once nothing allocated during frameId, or any earlier frame, is accessed anymore.
+    // Allocations from jobs that outlive advanceFrame() may land in a later frame, never in an earlier one.
+    void completeFrame(uint64_t frameId);
+
+    uint64_t getFrameId() const {
+      return m_frameId.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Block {
+      std::unique_ptr<uint8_t[]> memory;
+      size_t size = 0;
+      // Frame id in the high and bump offset in the low 32 bits, so a thread bumps with a single CAS that fails
+      // once advanceFrame() retired the block. Heap allocated so its address survives moves of the Block.
+      std::unique_ptr<std::atomic<uint64_t>> state;
+    };
+
+    struct RetiredFrame {
+      uint64_t frameId = 0;
+      std::vector<Block> blocks;
+    };
+
+    const uint64_t m_arenaId;
+    std::atomic<uint64_t> m_frameId = 0;
+    // One past the last frame completed by the consumer, so that frame 0 can be completed too
+    std::atomic<uint64_t> m_completedFrameEnd = 0;
+
+    dxvk::mutex m_mutex;
+    std::vector<Block> m_currentBlocks;
+    // Frames that ended but may still be read by the consumer, oldest first
+    std::deque<RetiredFrame> m_retiredFrames;
+    std::vector<Block> m_freeBlocks;
+
+    std::atomic<uint64_t> m_allocationCount = 0;
+    std::atomic<uint64_t> m_allocatedBytes = 0;
+    uint64_t m_blockCount = 0;
+
+    uint8_t* acquireBlock(size_t minSize, size_t& outSize, std::atomic<uint64_t>*& outState, uint64_t& outFrameId);
+  };
+
+  // Standard allocator backed by a FrameArena, or by the heap when default constructed.
+  // Moves keep the arena, so a container can be handed from the producing thread to its consumers for free.
+  // Copies are assumed to outlive the frame (e.g. state cached in a BlasEntry) and are allocated from the heap.
+  template<typename T>
+  class FrameArenaAllocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    FrameArenaAllocator() = default;
+    explicit FrameArenaAllocator(FrameArena* arena) : m_arena(arena) { }
+
+    template<typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) : m_arena(other.getArena()) { }
+
+    T* allocate(size_t count) {
+      if (m_arena != nullptr) {
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+      }
+      return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) {
+      if (m_arena == nullptr) {
+        std::allocator<T>().deallocate(ptr, count);
+      }
+    }
+
+    FrameArenaAllocator select_on_container_copy_construction() const {
+      return FrameArenaAllocator();
+    }
+
+    FrameArena* getArena() const {
+      return m_arena;
+    }
+
+    template<typename U>
+    bool operator==(const FrameArenaAllocator<U>& other) const {
+      return m_arena == other.getArena();
+    }
+
+    template<typename U>
+    bool operator!=(const FrameArenaAllocator<U>& other) const {
+      return m_arena != other.getArena();
+    }
+
+  private:
+    FrameArena* m_arena = nullptr;
+  };
+
+}
@@ -1,24 +1,288 @@
+#pragma once
+
 #include <cstdint>
-#include <list>
+#include <iterator>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace dxvk {
 
+  /**
+   * \brief Node pool for intrusive lists
+   *
+   * Stores the nodes of one or more \ref intrusive_list
+   * objects in a single flat array, linked through 32-bit
+   * indices. Released nodes are recycled through a free
+   * list, so once the pool has reached its high watermark,
+   * inserting, erasing and moving nodes between lists that
+   * share the pool does not allocate.
+   */
+  template<typename T>
+  class intrusive_list_pool {
+    template<typename> friend class intrusive_list;
+  public:
+
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    void reserve(size_t count) {
+      m_nodes.reserve(count);
+    }
+
+    size_t capacity() const {
+      return m_nodes.size();
+    }
+
+  private:
+
+    struct Node {
+      T        value;
+      uint32_t prev;
+      uint32_t next;
+    };
+
+    std::vector<Node> m_nodes;
+    uint32_t          m_freeHead = InvalidIndex;
+
+    uint32_t allocate(T&& value) {
+      if (m_freeHead == InvalidIndex) {
+        m_nodes.push_back({ std::move(value), InvalidIndex, InvalidIndex });
+        return uint32_t(m_nodes.size() - 1);
+      }
+
+      uint32_t index = m_freeHead;
+      m_freeHead = m_nodes[index].next;
+
+      m_nodes[index] = { std::move(value), InvalidIndex, InvalidIndex };
+      return index;
+    }
+
+    void release(uint32_t index) {
+      m_nodes[index].value = T();
+      m_nodes[index].next = m_freeHead;
+      m_freeHead = index;
+    }
+
+  };
+
+
+  /**
+   * \brief Intrusive doubly linked list
+   *
+   * Subset of the \c std::list interface on top of an
+   * \ref intrusive_list_pool. Iterators stay valid until
+   * the element they point to is erased, including when
+   * the element is spliced into another list of the same
+   * pool, so they can be stored alongside cached objects.
+   */
+  template<typename T>
+  class intrusive_list {
+    using Pool = intrusive_list_pool<T>;
+    static constexpr uint32_t InvalidIndex = Pool::InvalidIndex;
+  public:
+
+    template<bool Const>
+    class iterator_base {
+      friend class intrusive_list;
+      using ListPtr = std::conditional_t<Const, const intrusive_list*, intrusive_list*>;
+    public:
+
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = std::conditional_t<Const, const T*, T*>;
+      using reference         = std::conditional_t<Const, const T&, T&>;
+
+      iterator_base() { }
+
+      iterator_base(const iterator_base<false>& other)
+      : m_list(other.m_list), m_index(other.m_index) { }
+
+      reference operator * () const { return m_list->m_pool->m_nodes[m_index].value; }
+      pointer   operator -> () const { return &m_list->m_pool->m_nodes[m_index].value; }
+
+      iterator_base& operator ++ () {
+        m_index = m_list->m_pool->m_nodes[m_index].next;
+        return *this;
+      }
+
+      iterator_base operator ++ (int) {
+        iterator_base result = *this;
+        ++(*this);
+        return result;
+      }
+
+      // Decrementing the end iterator yields the last element
+      iterator_base& operator -- () {
+        m_index = m_index == InvalidIndex ? m_list->m_tail : m_list->m_pool->m_nodes[m_index].prev;
+        return *this;
+      }
+
+      iterator_base operator -- (int) {
+        iterator_base result = *this;
+        --(*this);
+        return result;
+      }
+
+      bool operator == (const iterator_base& other) const { return m_index == other.m_index; }
+      bool operator != (const iterator_base& other) const { return m_index != other.m_index; }
+
+    private:
+
+      ListPtr  m_list  = nullptr;
+      uint32_t m_index = InvalidIndex;
+
+      iterator_base(ListPtr list, uint32_t index)
+      : m_list(list), m_index(index) { }
+
+      template<bool> friend class iterator_base;
+    };
+
+    using iterator       = iterator_base<false>;
+    using const_iterator = iterator_base<true>;
+
+    explicit intrusive_list(Pool& pool)
+    : m_pool(&pool) { }
+
+    ~intrusive_list() {
+      clear();
+    }
+
+    intrusive_list             (const intrusive_list&) = delete;
+    intrusive_list& operator = (const intrusive_list&) = delete;
+
+    iterator       begin()       { return iterator(this, m_head); }
+    const_iterator begin() const { return const_iterator(this, m_head); }
+    iterator       end()         { return iterator(this, InvalidIndex); }
+    const_iterator end()   const { return const_iterator(this, InvalidIndex); }
+
+    T&       front()       { return m_pool->m_nodes[m_head].value; }
+    const T& front() const { return m_pool->m_nodes[m_head].value; }
+    T&       back()        { return m_pool->m_nodes[m_tail].value; }
+    const T& back()  const { return m_pool->m_nodes[m_tail].value; }
+
+    size_t size() const { return m_size; }
+    bool  empty() const { return m_size == 0; }
+
+    iterator insert(const_iterator pos, T value) {
+      uint32_t index = m_pool->allocate(std::move(value));
+      link(pos.m_index, index);
+      return iterator(this, index);
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+      return *insert(end(), T(std::forward<Args>(args)...));
+    }
+
+    void push_back(T value) {
+      insert(end(), std::move(value));
+    }
+
+    iterator erase(const_iterator pos) {
+      uint32_t next = m_pool->m_nodes[pos.m_index].next;
+      unlink(pos.m_index);
+      m_pool->release(pos.m_index);
+      return iterator(this, next);
+    }
+
+    /**
+     * \brief Moves an element in front of \c pos
+     *
+     * \c other may be this list, or any other
+     * list that uses the same node pool.
+     * \param [in] pos Element to insert before
+     * \param [in] other List that holds \c it
+     * \param [in] it Element to move
+     */
+    void splice(const_iterator pos, intrusive_list& other, const_iterator it) {
+      if (pos.m_index == it.m_index)
+        return;
+
+      other.unlink(it.m_index);
+      link(pos.m_index, it.m_index);
+    }
+
+    void clear() {
+      for (uint32_t index = m_head; index != InvalidIndex; ) {
+        uint32_t next = m_pool->m_nodes[index].next;
+        m_pool->release(index);
+        index = next;
+      }
+
+      m_head = InvalidIndex;
+      m_tail = InvalidIndex;
+      m_size = 0;
+    }
+
+  private:
+
+    Pool*    m_pool;
+    uint32_t m_head = InvalidIndex;
+    uint32_t m_tail = InvalidIndex;
+    size_t   m_size = 0;
+
+    void link(uint32_t pos, uint32_t index) {
+      auto& nodes = m_pool->m_nodes;
+      uint32_t prev = pos == InvalidIndex ? m_tail : nodes[pos].prev;
+
+      nodes[index].prev = prev;
+      nodes[index].next = pos;
+
+      (prev == InvalidIndex ? m_head : nodes[prev].next) = index;
+      (pos  == InvalidIndex ? m_tail : nodes[pos].prev)  = index;
+
+      m_size += 1;
+    }
+
+    void unlink(uint32_t index) {
+      auto& nodes = m_pool->m_nodes;
+      uint32_t prev = nodes[index].prev;
+      uint32_t next = nodes[index].next;
+
+      (prev == InvalidIndex ? m_head : nodes[prev].next) = next;
+      (next == InvalidIndex ? m_tail : nodes[next].prev) = prev;
+
+      m_size -= 1;
+    }
+
+  };
+
+
   template<typename T>
   class lru_list {
 
   public:
-    typedef typename std::list<T>::const_iterator const_iterator;
+    typedef typename intrusive_list<T>::const_iterator const_iterator;
+
+    lru_list() { }
+
+    lru_list(lru_list&& other)
+    : lru_list() {
+      *this = std::move(other);
+    }
+
+    // Lists point into their pool, so rebuild rather than move them
+    lru_list& operator = (lru_list&& other) {
+      m_list.clear();
+      m_cache.clear();
+
+      for (const T& value : other.m_list)
+        insert(value);
+
+      other.m_list.clear();
+      other.m_cache.clear();
+      return *this;
+    }
 
     void insert(T value) {
       auto cacheIter = m_cache.find(value);
-      if (cacheIter != m_cache.end())
-        m_list.erase(cacheIter->second);
+      if (cacheIter != m_cache.end()) {
+        m_list.splice(m_list.end(), m_list, cacheIter->second);
+        return;
+      }
 
-      m_list.push_back(value);
-      auto iter = m_list.cend();
-      iter--;
-      m_cache[value] = iter;
+      m_cache[value] = m_list.insert(m_list.end(), value);
     }
 
     void remove(const T& value) {
@@ -41,19 +305,15 @@ namespace dxvk {
       if (cacheIter == m_cache.end())
         return;
 
-      m_list.erase(cacheIter->second);
-      m_list.push_back(value);
-      auto iter = m_list.cend();
-      --iter;
-      m_cache[value] = iter;
+      m_list.splice(m_list.end(), m_list, cacheIter->second);
     }
 
     const_iterator leastRecentlyUsedIter() const {
-      return m_list.cbegin();
+      return m_list.begin();
     }
 
     const_iterator leastRecentlyUsedEndIter() const {
-      return m_list.cend();
+      return m_list.end();
     }
 
     uint32_t size() const noexcept {
@@ -61,7 +321,8 @@ namespace dxvk {
     }
 
   private:
-    std::list<T> m_list;
+    intrusive_list_pool<T> m_pool;
+    intrusive_list<T> m_list { m_pool };
     std::unordered_map<T, const_iterator> m_cache;
 
   };
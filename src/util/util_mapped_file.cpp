@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "util_mapped_file.h"
+
+#ifdef _WIN32
+#include "./com/com_include.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dxvk {
+
+  MappedFile::~MappedFile() {
+    close();
+  }
+
+#ifdef _WIN32
+
+  bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER size;
+
+    if (!::GetFileSizeEx(file, &size)) {
+      ::CloseHandle(file);
+      return false;
+    }
+
+    // Empty files cannot be mapped
+    if (size.QuadPart == 0) {
+      m_file = file;
+      return true;
+    }
+
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mapping) {
+      ::CloseHandle(file);
+      return false;
+    }
+
+    const void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!data) {
+      ::CloseHandle(mapping);
+      ::CloseHandle(file);
+      return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const char*>(data);
+    m_size    = size_t(size.QuadPart);
+    return true;
+  }
+
+
+  void MappedFile::close() {
+    if (m_data)
+      ::UnmapViewOfFile(m_data);
+
+    if (m_mapping)
+      ::CloseHandle(m_mapping);
+
+    if (m_file)
+      ::CloseHandle(m_file);
+
+    m_file    = nullptr;
+    m_mapping = nullptr;
+    m_data    = nullptr;
+    m_size    = 0;
+  }
+
+#else
+
+  bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+      return false;
+
+    struct stat info;
+
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      return false;
+    }
+
+    if (info.st_size > 0) {
+      void* data = ::mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        return false;
+      }
+
+      m_data = static_cast<const char*>(data);
+      m_size = size_t(info.st_size);
+    }
+
+    // The mapping stays valid after closing the descriptor
+    ::close(fd);
+    return true;
+  }
+
+
+  void MappedFile::close() {
+    if (m_data)
+      ::munmap(const_cast<char*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+#endif
+
+}
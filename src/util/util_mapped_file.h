@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace dxvk {
+
+  /**
+   * \brief Read-only memory mapped file
+   *
+   * Maps an entire file into the address space so that it can be
+   * parsed in place, and from several threads at once, without
+   * copying it through a stream first.
+   */
+  class MappedFile {
+
+  public:
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile             (const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    /**
+     * \brief Maps a file
+     *
+     * Unmaps any previously mapped file first. Empty files
+     * are opened successfully, but have no data pointer.
+     * \param [in] path Path of the file to map
+     * \returns \c true on success
+     */
+    bool open(const std::filesystem::path& path);
+
+    /**
+     * \brief Unmaps the file
+     */
+    void close();
+
+    const char* data() const {
+      return m_data;
+    }
+
+    size_t size() const {
+      return m_size;
+    }
+
+  private:
+
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+
+#ifdef _WIN32
+    void*       m_file    = nullptr;
+    void*       m_mapping = nullptr;
+#endif
+
+  };
+
+}
@@ -0,0 +1,254 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "util_mesh_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace dxvk::meshopt {
+
+  namespace {
+    constexpr uint32_t kInvalid = ~0u;
+
+    // Scoring constants from the paper
+    constexpr float kCacheDecayPower = 1.5f;
+    constexpr float kLastTriangleScore = 0.75f;
+    constexpr float kValenceBoostScale = 2.0f;
+    constexpr float kValenceBoostPower = 0.5f;
+    constexpr uint32_t kMaxPrecomputedValence = 64;
+
+    struct ScoreTables {
+      float cachePosition[kVertexCacheSize];
+      float valence[kMaxPrecomputedValence + 1];
+
+      ScoreTables() {
+        for (uint32_t i = 0; i < kVertexCacheSize; ++i) {
+          // The vertices of the last triangle get a fixed score, so it is not favoured over its neighbours
+          cachePosition[i] = i < 3
+            ? kLastTriangleScore
+            : std::pow(1.0f - float(i - 3) / float(kVertexCacheSize - 3), kCacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i <= kMaxPrecomputedValence; ++i) {
+          valence[i] = kValenceBoostScale * std::pow(float(i), -kValenceBoostPower);
+        }
+      }
+    };
+
+    float vertexScore(const ScoreTables& tables, const int32_t cachePosition, const uint32_t remainingTriangles) {
+      if (remainingTriangles == 0) {
+        // Not used by any triangle left to emit
+        return -1.0f;
+      }
+      // Boosting vertices with few triangles left gets rid of lone triangles early
+      float score = remainingTriangles <= kMaxPrecomputedValence
+        ? tables.valence[remainingTriangles]
+        : kValenceBoostScale * std::pow(float(remainingTriangles), -kValenceBoostPower);
+      if (cachePosition >= 0) {
+        score += tables.cachePosition[cachePosition];
+      }
+      return score;
+    }
+  }
+
+  float computeAcmr(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+      return 0.0f;
+    }
+
+    // A vertex is still in the FIFO if fewer than cacheSize misses happened since it was transformed
+    std::vector<uint32_t> transformedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+      const uint32_t vertex = pIndices[i];
+      assert(vertex < vertexCount);
+      if (time - transformedAt[vertex] > cacheSize) {
+        transformedAt[vertex] = time++;
+        ++misses;
+      }
+    }
+
+    return float(misses) / float(triangleCount);
+  }
+
+  void optimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) {
+      return;
+    }
+
+    static const ScoreTables tables;
+
+    // Triangles using each vertex. The first remainingTriangles[v] entries of a vertex are the ones not emitted yet.
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+      assert(pIndices[i] < vertexCount);
+      ++remainingTriangles[pIndices[i]];
+    }
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+      adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+      std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+      for (size_t i = 0; i < triangleCount * 3; ++i) {
+        adjacency[fill[pIndices[i]]++] = static_cast<uint32_t>(i / 3);
+      }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+      scores[v] = vertexScore(tables, -1, remainingTriangles[v]);
+    }
+
+    const auto triangleScore = [&](const uint32_t triangle) {
+      const uint32_t* pTriangle = &pIndices[triangle * 3];
+      return scores[pTriangle[0]] + scores[pTriangle[1]] + scores[pTriangle[2]];
+    };
+
+    uint32_t bestTriangle = 0;
+    float bestScore = -1.0f;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+      const float score = triangleScore(t);
+      if (score > bestScore) {
+        bestScore = score;
+        bestTriangle = t;
+      }
+    }
+
+    std::vector<uint32_t> output(triangleCount * 3);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    // Three extra entries for the vertices pushed in by the emitted triangle
+    uint32_t cache[kVertexCacheSize + 3];
+    uint32_t cacheCount = 0;
+    size_t nextUnemitted = 0;
+
+    for (size_t outTriangle = 0; outTriangle < triangleCount; ++outTriangle) {
+      if (bestTriangle == kInvalid) {
+        // Nothing in the cache has triangles left. The paper rescans every triangle here, taking the
+        // next one in input order keeps this linear and is usually a neighbour anyway.
+        while (emitted[nextUnemitted]) {
+          ++nextUnemitted;
+        }
+        bestTriangle = static_cast<uint32_t>(nextUnemitted);
+      }
+
+      const uint32_t* pTriangle = &pIndices[bestTriangle * 3];
+      memcpy(&output[outTriangle * 3], pTriangle, sizeof(uint32_t) * 3);
+      emitted[bestTriangle] = 1;
+
+      // Push the triangle's vertices to the front of the LRU cache and drop the triangle from their adjacency
+      uint32_t newCache[kVertexCacheSize + 3];
+      uint32_t newCacheCount = 0;
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t vertex = pTriangle[k];
+        uint32_t* pAdjacency = &adjacency[adjacencyOffsets[vertex]];
+        uint32_t& remaining = remainingTriangles[vertex];
+        for (uint32_t j = 0; j < remaining; ++j) {
+          if (pAdjacency[j] == bestTriangle) {
+            pAdjacency[j] = pAdjacency[remaining - 1];
+            --remaining;
+            break;
+          }
+        }
+        if (std::find(newCache, newCache + newCacheCount, vertex) == newCache + newCacheCount) {
+          newCache[newCacheCount++] = vertex;
+        }
+      }
+      const uint32_t numTriangleVertices = newCacheCount;
+      for (uint32_t i = 0; i < cacheCount; ++i) {
+        if (std::find(newCache, newCache + numTriangleVertices, cache[i]) == newCache + numTriangleVertices) {
+          newCache[newCacheCount++] = cache[i];
+        }
+      }
+
+      // Rescore everything that moved in, within or out of the cache
+      for (uint32_t i = 0; i < newCacheCount; ++i) {
+        const uint32_t vertex = newCache[i];
+        cachePosition[vertex] = i < kVertexCacheSize ? static_cast<int32_t>(i) : -1;
+        scores[vertex] = vertexScore(tables, cachePosition[vertex], remainingTriangles[vertex]);
+      }
+      cacheCount = std::min(newCacheCount, kVertexCacheSize);
+      memcpy(cache, newCache, sizeof(uint32_t) * cacheCount);
+
+      // Only triangles using a cached vertex are candidates for the next one
+      bestTriangle = kInvalid;
+      bestScore = -1.0f;
+      for (uint32_t i = 0; i < cacheCount; ++i) {
+        const uint32_t vertex = cache[i];
+        const uint32_t* pAdjacency = &adjacency[adjacencyOffsets[vertex]];
+        for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j) {
+          const float score = triangleScore(pAdjacency[j]);
+          if (score > bestScore) {
+            bestScore = score;
+            bestTriangle = pAdjacency[j];
+          }
+        }
+      }
+    }
+
+    memcpy(pIndices, output.data(), sizeof(uint32_t) * triangleCount * 3);
+  }
+
+  VertexFetchRemap::VertexFetchRemap(size_t vertexCount)
+    : m_remap(vertexCount, kInvalid) { }
+
+  void VertexFetchRemap::addIndices(const uint32_t* pIndices, size_t indexCount) {
+    for (size_t i = 0; i < indexCount; ++i) {
+      uint32_t& newIndex = m_remap[pIndices[i]];
+      if (newIndex == kInvalid) {
+        newIndex = m_nextVertex++;
+      }
+    }
+  }
+
+  const std::vector<uint32_t>& VertexFetchRemap::finish() {
+    for (uint32_t& newIndex : m_remap) {
+      if (newIndex == kInvalid) {
+        newIndex = m_nextVertex++;
+      }
+    }
+    return m_remap;
+  }
+
+  void remapIndexBuffer(uint32_t* pIndices, size_t indexCount, const uint32_t* pRemap) {
+    for (size_t i = 0; i < indexCount; ++i) {
+      pIndices[i] = pRemap[pIndices[i]];
+    }
+  }
+
+  void remapVertexBuffer(void* pDst, const void* pSrc, size_t vertexCount, size_t vertexStride, const uint32_t* pRemap) {
+    assert(pDst != pSrc);
+    uint8_t* pDstBytes = static_cast<uint8_t*>(pDst);
+    const uint8_t* pSrcBytes = static_cast<const uint8_t*>(pSrc);
+    for (size_t v = 0; v < vertexCount; ++v) {
+      memcpy(pDstBytes + size_t(pRemap[v]) * vertexStride, pSrcBytes + v * vertexStride, vertexStride);
+    }
+  }
+
+}
@@ -0,0 +1,60 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dxvk::meshopt {
+
+  // Post-transform cache size that optimizeVertexCache tunes the triangle order for
+  static constexpr uint32_t kVertexCacheSize = 32;
+
+  // Average cache miss ratio (vertex transforms per triangle) of a triangle list when drawn through a FIFO
+  // post-transform cache with cacheSize entries. 0.5 is the lower bound for large regular meshes, 3 the worst case.
+  float computeAcmr(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize);
+
+  // Reorders the triangles of a triangle list in place so consecutive triangles reuse recently transformed vertices.
+  // Greedy scoring of T. Forsyth's "Linear-Speed Vertex Cache Optimisation", runs in O(indexCount).
+  void optimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount);
+
+  // Builds a vertex remap (old index -> new index) that orders vertices by first use across one or more index
+  // lists, so vertex fetches walk the vertex buffer mostly sequentially. Vertices that no list references are
+  // kept, after all referenced ones.
+  class VertexFetchRemap {
+  public:
+    explicit VertexFetchRemap(size_t vertexCount);
+
+    void addIndices(const uint32_t* pIndices, size_t indexCount);
+    const std::vector<uint32_t>& finish();
+
+  private:
+    std::vector<uint32_t> m_remap;
+    uint32_t m_nextVertex = 0;
+  };
+
+  void remapIndexBuffer(uint32_t* pIndices, size_t indexCount, const uint32_t* pRemap);
+  // pDst must not alias pSrc
+  void remapVertexBuffer(void* pDst, const void* pSrc, size_t vertexCount, size_t vertexStride, const uint32_t* pRemap);
+
+}
@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dxvk {
+
+  // Handle to an object owned by a SlabPool. The index holds the slab in its high bits and the
+  // slot within the slab in its low bits, so resolving a handle is a shift and a mask. The
+  // generation is bumped every time a slot is released, so a handle kept past the lifetime of
+  // its object resolves to nullptr instead of aliasing whatever object reuses the slot.
+  struct SlabHandle {
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != kInvalidIndex; }
+
+    bool operator==(const SlabHandle& other) const {
+      return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlabHandle& other) const { return !(*this == other); }
+  };
+
+  struct SlabHandleHash {
+    size_t operator()(const SlabHandle& handle) const {
+      return std::hash<uint64_t>()((uint64_t(handle.generation) << 32) | handle.index);
+    }
+  };
+
+  // Fixed size slab allocator for objects that are created and destroyed at a high rate.
+  // Objects are placed in fixed size slabs which are never moved or returned to the heap
+  // while the pool is alive, so:
+  //  - pointers to live objects stay stable,
+  //  - released slots are recycled LIFO (the most recently freed, still cache-warm, slot is reused first),
+  //  - a dangling pointer to a released object still points into pool memory, which lets
+  //    isLive() detect stale pointers in O(1) rather than reading freed heap memory.
+  // Not thread safe, external synchronization is required.
+  template<typename T, uint32_t SlabSize = 256>
+  class SlabPool {
+    static_assert(SlabSize > 0 && (SlabSize & (SlabSize - 1)) == 0, "Slab size must be a power of two.");
+
+    static constexpr uint32_t getSlabShift() {
+      uint32_t shift = 0;
+      while ((1u << shift) < SlabSize) {
+        ++shift;
+      }
+      return shift;
+    }
+
+    static constexpr uint32_t kSlabShift = getSlabShift();
+    static constexpr uint32_t kSlotMask = SlabSize - 1;
+
+    struct Slot {
+      // Note: storage must remain the first member, object pointers are converted back to slots.
+      alignas(T) uint8_t storage[sizeof(T)];
+      uint32_t index = SlabHandle::kInvalidIndex;
+      uint32_t generation = 0;
+      uint32_t nextFree = SlabHandle::kInvalidIndex;
+      bool live = false;
+
+      T* object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+  public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+      clear();
+    }
+
+    // Constructs a new object in the pool, the handle to it is returned in outHandle
+    template<typename... Args>
+    T* allocate(SlabHandle& outHandle, Args&&... args) {
+      Slot& slot = acquireSlot();
+
+      T* object = new (slot.storage) T(std::forward<Args>(args)...);
+      slot.live = true;
+      ++m_liveCount;
+
+      outHandle.index = slot.index;
+      outHandle.generation = slot.generation;
+      return object;
+    }
+
+    // Destroys an object previously returned by allocate()
+    void free(const T* object) {
+      assert(object != nullptr);
+      Slot& slot = slotFromObject(object);
+      assert(slot.live && "Double free of a SlabPool object.");
+
+      slot.object()->~T();
+      releaseSlot(slot);
+    }
+
+    // Returns the object referenced by the handle, or nullptr if the handle is stale
+    T* get(const SlabHandle& handle) const {
+      if (handle.index >= m_capacity) {
+        return nullptr;
+      }
+
+      Slot& slot = getSlot(handle.index);
+      if (!slot.live || slot.generation != handle.generation) {
+        return nullptr;
+      }
+
+      return slot.object();
+    }
+
+    // Returns true if the handle refers to a live object
+    bool isLive(const SlabHandle& handle) const {
+      return get(handle) != nullptr;
+    }
+
+    // Returns true if the object pointer refers to a live object owned by this pool. Intended for validating
+    // cached raw pointers, which must have been returned by allocate() on a pool of this type at some point.
+    // The slot header outlives the object, so this is safe for stale pointers as slabs are never freed.
+    bool isLive(const T* object) const {
+      if (object == nullptr) {
+        return false;
+      }
+
+      const Slot& slot = slotFromObject(object);
+      return slot.index < m_capacity && &getSlot(slot.index) == &slot && slot.live;
+    }
+
+    // Destroys all live objects. Slabs are retained so subsequent allocations don't hit the heap.
+    void clear() {
+      for (uint32_t i = 0; i < m_capacity; ++i) {
+        Slot& slot = getSlot(i);
+        if (slot.live) {
+          slot.object()->~T();
+          releaseSlot(slot);
+        }
+      }
+      assert(m_liveCount == 0);
+    }
+
+    uint32_t size() const { return m_liveCount; }
+    uint32_t capacity() const { return m_capacity; }
+
+  private:
+    std::vector<std::unique_ptr<Slot[]>> m_slabs;
+    uint32_t m_capacity = 0;
+    uint32_t m_liveCount = 0;
+    uint32_t m_freeHead = SlabHandle::kInvalidIndex;
+
+    Slot& getSlot(uint32_t index) const {
+      return m_slabs[index >> kSlabShift][index & kSlotMask];
+    }
+
+    static Slot& slotFromObject(const T* object) {
+      return *reinterpret_cast<Slot*>(const_cast<T*>(object));
+    }
+
+    Slot& acquireSlot() {
+      if (m_freeHead == SlabHandle::kInvalidIndex) {
+        std::unique_ptr<Slot[]> slab = std::make_unique<Slot[]>(SlabSize);
+
+        // Chain the new slots in ascending order so allocation order follows memory order
+        for (uint32_t i = 0; i < SlabSize; ++i) {
+          slab[i].index = m_capacity + i;
+          slab[i].nextFree = (i + 1 < SlabSize) ? m_capacity + i + 1 : SlabHandle::kInvalidIndex;
+        }
+
+        m_freeHead = m_capacity;
+        m_capacity += SlabSize;
+        m_slabs.push_back(std::move(slab));
+      }
+
+      Slot& slot = getSlot(m_freeHead);
+      m_freeHead = slot.nextFree;
+      slot.nextFree = SlabHandle::kInvalidIndex;
+      return slot;
+    }
+
+    void releaseSlot(Slot& slot) {
+      slot.live = false;
+      ++slot.generation;
+      slot.nextFree = m_freeHead;
+      m_freeHead = slot.index;
+      --m_liveCount;
+    }
+  };
+
+}
@@ -21,15 +21,25 @@
 */
 
 #pragma once
+#include <algorithm>
+#include <array>
+#include <type_traits>
 #include <unordered_map>
 
 #include "util_matrix.h"
 #include "util_vector.h"
 #include "util_fast_cache.h"
+#include "util_flat_hash_map.h"
 #include "./log/log.h"
 
 namespace dxvk {
   // A structure to allow for quickly returning data close to a specific position.
+  //
+  // Entries live in one of two layouts:
+  //  - dynamic: one vector per cell, cheap to insert, erase and move individual entries.
+  //  - packed: all entries in a single array sorted by the Morton code of their cell, plus a flat cell offset table
+  //    keyed by that code. Neighbouring cells are close in memory, so queries touch far fewer cache lines.
+  // build(), rebuild() and pack() produce the packed layout, the next insert/erase/move converts back to the dynamic one.
   template<class T>
   class SpatialMap {
   private:
@@ -40,19 +50,36 @@ namespace dxvk {
       Entry() : data(nullptr), centroid(0.f), transformHash(0) { }
       Entry(const T* data, const Vector3& centroid, XXH64_hash_t transformHash) : data(data), centroid(centroid), transformHash(transformHash) { }
       Entry(const Entry& other) : data(other.data), centroid(other.centroid), transformHash(other.transformHash) { }
+      Entry& operator=(const Entry& other) = default;
     };
+
+    struct CellRange {
+      uint32_t begin = 0;
+      uint32_t count = 0;
+    };
+
   public:
-    SpatialMap(float cellSize) : m_cellSize(cellSize) {
-      if (m_cellSize <= 0) {
-        ONCE(Logger::err("Invalid cell size in SpatialMap. cellSize must be greater than 0."));
-        m_cellSize = 1.f;
-      }
-    }
+    struct BuildEntry {
+      Vector3 centroid;
+      Matrix4 transform;
+      const T* data;
+    };
+
+    // Result of a k nearest query, sorted by ascending distance
+    struct Neighbor {
+      float distSqr;
+      const T* data;
+    };
+
+    SpatialMap(float cellSize) : m_cellSize(validateCellSize(cellSize)) { }
 
     SpatialMap& operator=(SpatialMap&& other) {
       m_cellSize = other.m_cellSize;
       m_cells = std::move(other.m_cells);
       m_cache = std::move(other.m_cache);
+      m_packedEntries = std::move(other.m_packedEntries);
+      m_packedCells = std::move(other.m_packedCells);
+      m_isPacked = other.m_isPacked;
       return *this;
     }
 
@@ -68,7 +95,9 @@ namespace dxvk {
 
     // returns the entry cosest to `centroid` that passes the `filter` and is less than `sqrt(maxDistSqr)` units from `centroid`.
     // `filter` should return true if the entry is a valid result.
-    const T* getNearestData(const Vector3& centroid, float maxDistSqr, float& nearestDistSqr, std::function<bool(const T*)> filter) const {
+    // Note: only the 2x2x2 cells around `centroid` are searched, so `maxDistSqr` should not exceed (cellSize / 2)^2.
+    template<typename Filter>
+    const T* getNearestData(const Vector3& centroid, float maxDistSqr, float& nearestDistSqr, Filter&& filter) const {
       static const std::array kOffsets{
         Vector3i{0, 0, 0},
         Vector3i{0, 0, 1},
@@ -85,46 +114,89 @@ namespace dxvk {
       const T* nearestData = nullptr;
       nearestDistSqr = FLT_MAX;
       for (const Vector3i& offset : kOffsets) {
-        auto cell = m_cells.find(floorPos + offset);
-        if (cell == m_cells.end()) {
-          continue;
-        }
-        for (const Entry& entry : cell->second) {
+        const bool foundExact = !forEachEntryInCell(floorPos + offset, [&](const Entry& entry) {
           if (!filter(entry.data)) {
-            continue;
+            return true;
           }
           const float distSqr = lengthSqr(entry.centroid - centroid);
           if (distSqr <= maxDistSqr && distSqr < nearestDistSqr) {
-              nearestDistSqr = distSqr;
-            if (nearestDistSqr == 0.0f) {
-              // Not going to find anything closer, so stop the iteration
-              return entry.data;
-            }
+            nearestDistSqr = distSqr;
             nearestData = entry.data;
+            // Not going to find anything closer, so stop the iteration
+            return nearestDistSqr != 0.0f;
           }
+          return true;
+        });
+        if (foundExact) {
+          break;
         }
       }
       return nearestData;
     }
-    
-    XXH64_hash_t insert(const Vector3& centroid, const Matrix4& transform, const T* data) {
-      XXH64_hash_t transformHash = XXH64(&transform, sizeof(transform), 0);
-      while(m_cache.find(transformHash) != m_cache.end()) {
-        // Note: This can happen if an instance is moved to the same position as another existing instance.
-        // It can cause a single frame of NaN, but shouldn't cause any crashes.
-        // TODO(REMIX-4134): Once spatial map is used on draw calls and not rtInstances, it should be safe to restore the assert() below.
-        ONCE(Logger::warn("Specified hash was already present in SpatialMap::insert(). May indicate a duplicated overlapping object."));
-        // assert(false);
-        transformHash++;
+
+    // Batched getNearestData(). Queries are processed in Morton order of their cells so consecutive queries
+    // hit the same or neighbouring cells, results are written in the order of `centroids`.
+    // `filter(queryIndex, data)` should return true if the entry is a valid result for the query.
+    template<typename Filter>
+    void getNearestDataBatch(const Vector3* centroids, size_t count, float maxDistSqr, Filter&& filter,
+                             const T** outData, float* outNearestDistSqr) const {
+      std::vector<std::pair<uint64_t, uint32_t>> order(count);
+      for (size_t i = 0; i < count; ++i) {
+        order[i] = { encodeMorton(getCellPos(centroids[i])), static_cast<uint32_t>(i) };
       }
-      auto [iter, success] = m_cache.emplace(std::piecewise_construct,
-          std::forward_as_tuple(transformHash),
-          std::forward_as_tuple(data, centroid, transformHash));
-      if (!success) {
-        ONCE(Logger::err("Failed to add entry in SpatialMap::insert()."));
-        assert(false);
-        return transformHash;
+      std::sort(order.begin(), order.end());
+
+      for (const auto& [code, queryIndex] : order) {
+        outData[queryIndex] = getNearestData(centroids[queryIndex], maxDistSqr, outNearestDistSqr[queryIndex],
+          [&](const T* data) { return filter(queryIndex, data); });
+      }
+    }
+
+    // Appends all entries within `radius` of `centroid` that pass the `filter` to `out`, returns the number appended.
+    template<typename Filter>
+    size_t getDataInRadius(const Vector3& centroid, float radius, Filter&& filter, std::vector<const T*>& out) const {
+      const size_t initialSize = out.size();
+      const float radiusSqr = radius * radius;
+      forEachEntryInBox(centroid - Vector3(radius), centroid + Vector3(radius), [&](const Entry& entry) {
+        if (lengthSqr(entry.centroid - centroid) <= radiusSqr && filter(entry.data)) {
+          out.push_back(entry.data);
+        }
+      });
+      return out.size() - initialSize;
+    }
+
+    // Writes up to `k` entries closest to `centroid` that pass the `filter` and are less than `sqrt(maxDistSqr)` units
+    // from `centroid` to `out`, sorted by ascending distance. Returns the number of results.
+    template<typename Filter>
+    size_t getKNearestData(const Vector3& centroid, size_t k, float maxDistSqr, Filter&& filter, std::vector<Neighbor>& out) const {
+      out.clear();
+      if (k == 0) {
+        return 0;
       }
+
+      // Max-heap on distance holding the k best candidates so far
+      const auto farther = [](const Neighbor& a, const Neighbor& b) { return a.distSqr < b.distSqr; };
+      const float radius = std::sqrt(maxDistSqr);
+      forEachEntryInBox(centroid - Vector3(radius), centroid + Vector3(radius), [&](const Entry& entry) {
+        const float distSqr = lengthSqr(entry.centroid - centroid);
+        if (distSqr > maxDistSqr || (out.size() == k && distSqr >= out.front().distSqr) || !filter(entry.data)) {
+          return;
+        }
+        if (out.size() == k) {
+          std::pop_heap(out.begin(), out.end(), farther);
+          out.pop_back();
+        }
+        out.push_back({ distSqr, entry.data });
+        std::push_heap(out.begin(), out.end(), farther);
+      });
+
+      std::sort_heap(out.begin(), out.end(), farther);
+      return out.size();
+    }
+    
+    XXH64_hash_t insert(const Vector3& centroid, const Matrix4& transform, const T* data) {
+      unpack();
+      XXH64_hash_t transformHash = insertIntoCache(centroid, transform, data);
       m_cells[getCellPos(centroid)].emplace_back(data, centroid, transformHash);
       return transformHash;
     }
@@ -132,6 +204,7 @@ namespace dxvk {
     void erase(const XXH64_hash_t& transformHash) {
       auto pair = m_cache.find(transformHash);
       if (pair != m_cache.end()) {
+        unpack();
         eraseFromCell(pair->second.centroid, transformHash);
         m_cache.erase(pair);
       } else {
@@ -152,24 +225,242 @@ namespace dxvk {
       return transformHash;
     }
 
+    // Replaces the contents of the map with `count` entries in a single pass and packs them.
+    // If `outTransformHashes` is not null it receives the hash insert() would have returned for each entry.
+    void build(const BuildEntry* entries, size_t count, XXH64_hash_t* outTransformHashes = nullptr) {
+      clear();
+      m_cache.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        const XXH64_hash_t transformHash = insertIntoCache(entries[i].centroid, entries[i].transform, entries[i].data);
+        if (outTransformHashes) {
+          outTransformHashes[i] = transformHash;
+        }
+      }
+      packFromCache();
+    }
+
+    // Re-buckets all entries using a new cell size, the result is packed.
     void rebuild(float cellSize) {
-      m_cells.clear();
-      for (auto pair : m_cache) {
-        m_cells[getCellPos(pair.second.centroid)].emplace_back(pair.second);
+      m_cellSize = validateCellSize(cellSize);
+      packFromCache();
+    }
+
+    // Converts the current contents to the packed layout, e.g. ahead of a large number of queries.
+    void pack() {
+      if (!m_isPacked) {
+        packFromCache();
       }
     }
 
+    void clear() {
+      m_cells.clear();
+      m_cache.clear();
+      m_packedEntries.clear();
+      m_packedCells.clear();
+      m_isPacked = false;
+    }
+
     size_t size() const {
       return m_cache.size();
     }
 
+    bool isPacked() const {
+      return m_isPacked;
+    }
+
+    float getCellSize() const {
+      return m_cellSize;
+    }
+
   private:
 
+    static float validateCellSize(float cellSize) {
+      if (cellSize <= 0) {
+        ONCE(Logger::err("Invalid cell size in SpatialMap. cellSize must be greater than 0."));
+        return 1.f;
+      }
+      return cellSize;
+    }
+
     Vector3i getCellPos(const Vector3& position) const {
       const Vector3 scaledPos = position / m_cellSize;
       return Vector3i(int(std::floor(scaledPos.x)), int(std::floor(scaledPos.y)), int(std::floor(scaledPos.z))); 
     }
 
+    static constexpr int kMaxPackedCellCoord = (1 << 20) - 1;
+
+    static bool isPackable(const Vector3i& cellPos) {
+      return std::abs(cellPos.x) <= kMaxPackedCellCoord && std::abs(cellPos.y) <= kMaxPackedCellCoord && std::abs(cellPos.z) <= kMaxPackedCellCoord;
+    }
+
+    // Interleaves the low 21 bits of each (biased) cell coordinate. Unique for packable cells, cells further than
+    // 2^20 cells from the origin alias. Queries that far out may visit an aliased cell, but its entries are
+    // millions of cells away and get rejected by the distance checks.
+    static uint64_t encodeMorton(const Vector3i& cellPos) {
+      const auto spreadBits = [](int32_t value) {
+        uint64_t x = static_cast<uint32_t>(value + (1 << 20)) & 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffull;
+        x = (x | x << 16) & 0x1f0000ff0000ffull;
+        x = (x | x << 8) & 0x100f00f00f00f00full;
+        x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+        x = (x | x << 2) & 0x1249249249249249ull;
+        return x;
+      };
+      return spreadBits(cellPos.x) | (spreadBits(cellPos.y) << 1) | (spreadBits(cellPos.z) << 2);
+    }
+
+    // Calls f(entry) for every entry in the cell, f may return false to stop the iteration.
+    // Returns false if the iteration was stopped.
+    template<typename F>
+    bool forEachEntryInCell(const Vector3i& cellPos, F&& f) const {
+      const auto visit = [&](const Entry& entry) {
+        if constexpr (std::is_same_v<decltype(f(entry)), bool>) {
+          return f(entry);
+        } else {
+          f(entry);
+          return true;
+        }
+      };
+
+      if (m_isPacked) {
+        const CellRange* range = m_packedCells.find(encodeMorton(cellPos));
+        if (range == nullptr) {
+          return true;
+        }
+        const Entry* begin = m_packedEntries.data() + range->begin;
+        for (const Entry* entry = begin; entry != begin + range->count; ++entry) {
+          if (!visit(*entry)) {
+            return false;
+          }
+        }
+      } else {
+        auto cell = m_cells.find(cellPos);
+        if (cell == m_cells.end()) {
+          return true;
+        }
+        for (const Entry& entry : cell->second) {
+          if (!visit(entry)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    // Calls f(entry) for every entry in the cells overlapping the box [minPos, maxPos]
+    template<typename F>
+    void forEachEntryInBox(const Vector3& minPos, const Vector3& maxPos, F&& f) const {
+      const Vector3i minCell = getCellPos(minPos);
+      const Vector3i maxCell = getCellPos(maxPos);
+      const uint64_t boxCellCount = uint64_t(maxCell.x - minCell.x + 1) * uint64_t(maxCell.y - minCell.y + 1) * uint64_t(maxCell.z - minCell.z + 1);
+
+      // Large boxes cover more cells than there are entries, a linear scan is cheaper then
+      if (boxCellCount > m_cache.size()) {
+        for (const auto& [hash, entry] : m_cache) {
+          const Vector3i cellPos = getCellPos(entry.centroid);
+          if (cellPos.x >= minCell.x && cellPos.y >= minCell.y && cellPos.z >= minCell.z &&
+              cellPos.x <= maxCell.x && cellPos.y <= maxCell.y && cellPos.z <= maxCell.z) {
+            f(entry);
+          }
+        }
+        return;
+      }
+
+      for (int z = minCell.z; z <= maxCell.z; ++z) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+          for (int x = minCell.x; x <= maxCell.x; ++x) {
+            forEachEntryInCell(Vector3i(x, y, z), f);
+          }
+        }
+      }
+    }
+
+    XXH64_hash_t insertIntoCache(const Vector3& centroid, const Matrix4& transform, const T* data) {
+      XXH64_hash_t transformHash = XXH64(&transform, sizeof(transform), 0);
+      while(m_cache.find(transformHash) != m_cache.end()) {
+        // Note: This can happen if an instance is moved to the same position as another existing instance.
+        // It can cause a single frame of NaN, but shouldn't cause any crashes.
+        // TODO(REMIX-4134): Once spatial map is used on draw calls and not rtInstances, it should be safe to restore the assert() below.
+        ONCE(Logger::warn("Specified hash was already present in SpatialMap::insert(). May indicate a duplicated overlapping object."));
+        // assert(false);
+        transformHash++;
+      }
+      auto [iter, success] = m_cache.emplace(std::piecewise_construct,
+          std::forward_as_tuple(transformHash),
+          std::forward_as_tuple(data, centroid, transformHash));
+      if (!success) {
+        ONCE(Logger::err("Failed to add entry in SpatialMap::insert()."));
+        assert(false);
+      }
+      return transformHash;
+    }
+
+    void packFromCache() {
+      struct SortKey {
+        uint64_t morton;
+        const Entry* entry;
+      };
+
+      std::vector<SortKey> keys;
+      keys.reserve(m_cache.size());
+      for (const auto& [hash, entry] : m_cache) {
+        const Vector3i cellPos = getCellPos(entry.centroid);
+        if (!isPackable(cellPos)) {
+          // The Morton code would alias, keep the dynamic layout
+          ONCE(Logger::warn("SpatialMap entry too far from the origin to be packed, falling back to per cell storage."));
+          m_packedCells.clear();
+          m_packedEntries.clear();
+          m_isPacked = false;
+          rebuildCells();
+          return;
+        }
+        keys.push_back({ encodeMorton(cellPos), &entry });
+      }
+
+      std::sort(keys.begin(), keys.end(), [](const SortKey& a, const SortKey& b) {
+        return a.morton < b.morton;
+      });
+
+      m_cells.clear();
+      m_packedCells.clear();
+      m_packedCells.reserve(keys.size());
+      m_packedEntries.clear();
+      m_packedEntries.reserve(keys.size());
+      for (const SortKey& key : keys) {
+        CellRange& range = m_packedCells[key.morton];
+        if (range.count == 0) {
+          range.begin = static_cast<uint32_t>(m_packedEntries.size());
+        }
+        ++range.count;
+        m_packedEntries.push_back(*key.entry);
+      }
+      m_isPacked = true;
+    }
+
+    void rebuildCells() {
+      m_cells.clear();
+      for (const auto& [hash, entry] : m_cache) {
+        m_cells[getCellPos(entry.centroid)].emplace_back(entry);
+      }
+    }
+
+    void unpack() {
+      if (!m_isPacked) {
+        return;
+      }
+
+      // Runs of entries sharing a cell are contiguous in the packed array
+      for (size_t begin = 0; begin < m_packedEntries.size();) {
+        const Vector3i cellPos = getCellPos(m_packedEntries[begin].centroid);
+        const CellRange* range = m_packedCells.find(encodeMorton(cellPos));
+        m_cells[cellPos].assign(m_packedEntries.begin() + range->begin, m_packedEntries.begin() + range->begin + range->count);
+        begin = range->begin + range->count;
+      }
+      m_packedCells.clear();
+      m_packedEntries.clear();
+      m_isPacked = false;
+    }
+
     void eraseFromCell(const Vector3& pos, XXH64_hash_t hash) {
       auto cellIter = m_cells.find(getCellPos(pos));
       if (cellIter == m_cells.end()) {
@@ -198,5 +489,9 @@ namespace dxvk {
     float m_cellSize;
     fast_spatial_cache<std::vector<Entry>> m_cells;
     fast_unordered_cache<Entry> m_cache;
+
+    std::vector<Entry> m_packedEntries;
+    fast_flat_map<CellRange> m_packedCells;
+    bool m_isPacked = false;
   };
 }
@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "util_math.h"
+
+namespace dxvk {
+
+  /**
+   * \brief Bounded lock-free single producer, single consumer ring
+   *
+   * Exactly one thread may push and exactly one other thread may pop.
+   * Pushes from several threads must be serialized by the caller,
+   * debug builds assert that no two pushes overlap.
+   * Head and tail live on separate cache lines and each side caches the
+   * other side's index, so the shared lines are only touched when the
+   * ring looks full (producer) or empty (consumer).
+   * \tparam T Element type, must be default constructible and movable
+   * \tparam Capacity Number of elements, must be a power of two
+   */
+  template<typename T, uint32_t Capacity>
+  class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+    constexpr static uint64_t Mask = Capacity - 1;
+  public:
+
+    /**
+     * \brief Pushes an element, producer thread only
+     *
+     * \param [in] item Element, only moved from on success
+     * \returns \c false if the ring is full
+     */
+    bool tryPush(T&& item) {
+      ProducerCheck check(*this);
+      const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+      if (tail - m_cachedHead == Capacity) {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+
+        if (tail - m_cachedHead == Capacity)
+          return false;
+      }
+
+      m_slots[tail & Mask] = std::move(item);
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * \brief Pops an element, consumer thread only
+     *
+     * \param [out] item Receives the element on success
+     * \returns \c false if the ring is empty
+     */
+    bool tryPop(T& item) {
+      const uint64_t head = m_head.load(std::memory_order_relaxed);
+
+      if (head == m_cachedTail) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+        if (head == m_cachedTail)
+          return false;
+      }
+
+      item = std::move(m_slots[head & Mask]);
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * \brief Number of queued elements
+     *
+     * Exact on the producer and consumer threads when the
+     * other side is idle, a snapshot otherwise.
+     */
+    uint32_t size() const {
+      // Load head first, the tail can only have moved further since
+      const uint64_t head = m_head.load(std::memory_order_acquire);
+      const uint64_t tail = m_tail.load(std::memory_order_acquire);
+      return uint32_t(tail - head);
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    static constexpr uint32_t capacity() {
+      return Capacity;
+    }
+
+  private:
+
+#ifndef NDEBUG
+    struct ProducerCheck {
+      explicit ProducerCheck(SpscRing& ring) : m_ring(ring) {
+        const std::thread::id producer = m_ring.m_producer.exchange(std::this_thread::get_id(), std::memory_order_acquire);
+        assert(producer == std::thread::id() && "SpscRing: concurrent producers");
+      }
+
+      ~ProducerCheck() {
+        m_ring.m_producer.store(std::thread::id(), std::memory_order_release);
+      }
+
+      SpscRing& m_ring;
+    };
+
+    std::atomic<std::thread::id> m_producer;
+#else
+    struct ProducerCheck {
+      explicit ProducerCheck(SpscRing&) { }
+    };
+#endif
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_head = { 0ull };
+    uint64_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_tail = { 0ull };
+    uint64_t m_cachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_slots;
+
+  };
+
+}
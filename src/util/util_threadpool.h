@@ -113,6 +113,10 @@ namespace dxvk {
       return isDisposed;
     }
 
+    bool ready() const {
+      return hasResult;
+    }
+
   private:
     std::array<uint8_t, Capacity> storage;
     std::atomic_bool hasResult = false;
@@ -182,6 +186,10 @@ namespace dxvk {
       return !result.disposed();
     }
 
+    bool ready() const {
+      return result.ready();
+    }
+
   private:
     template<typename InvocableType>
     static inline void Thunk(void* thunkLambda) {
@@ -227,6 +235,11 @@ namespace dxvk {
       return task != nullptr && task->valid();
     }
 
+    // True if get() will return without waiting
+    bool ready() const {
+      return task != nullptr && task->ready();
+    }
+
     void cancel() const {
       task->cancel();
       task = nullptr;
@@ -251,6 +264,11 @@ namespace dxvk {
       return task != nullptr && task->valid();
     }
 
+    // True if get() will return without waiting
+    bool ready() const {
+      return task != nullptr && task->ready();
+    }
+
     void cancel() const {
       task->cancel();
       task = nullptr;
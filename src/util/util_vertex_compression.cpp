@@ -0,0 +1,130 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "util_vertex_compression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace dxvk::vtxcompress {
+
+  namespace {
+    constexpr float kUnorm16Max = 65535.f;
+    constexpr float kSnorm16Max = 32767.f;
+
+    uint16_t floatToUnorm16(const float value) {
+      return uint16_t(std::floor(std::clamp(value, 0.f, 1.f) * kUnorm16Max + 0.5f));
+    }
+
+    float signNotZero(const float value) {
+      return value >= 0.f ? 1.f : -1.f;
+    }
+  }
+
+  PositionQuantization computePositionQuantization(const void* pPositions, size_t count, size_t stride) {
+    float minPos[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float maxPos[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    const uint8_t* pVertex = static_cast<const uint8_t*>(pPositions);
+    for (size_t i = 0; i < count; ++i, pVertex += stride) {
+      float position[3];
+      std::memcpy(position, pVertex, sizeof(position));
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        minPos[axis] = std::min(minPos[axis], position[axis]);
+        maxPos[axis] = std::max(maxPos[axis], position[axis]);
+      }
+    }
+
+    PositionQuantization quantization;
+    if (count == 0) {
+      return quantization;
+    }
+
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      quantization.bias[axis] = 0.5f * (minPos[axis] + maxPos[axis]);
+      // A flat axis still needs a non zero scale so the dequantization transform stays invertible
+      const float halfExtent = 0.5f * (maxPos[axis] - minPos[axis]);
+      quantization.scale[axis] = halfExtent > 0.f ? halfExtent : 1.f;
+    }
+    return quantization;
+  }
+
+  void encodePosition(const PositionQuantization& quantization, const float* pPosition, int16_t* pEncoded) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      const float normalized = std::clamp((pPosition[axis] - quantization.bias[axis]) / quantization.scale[axis], -1.f, 1.f);
+      pEncoded[axis] = int16_t(std::lround(normalized * kSnorm16Max));
+    }
+    pEncoded[3] = 0;
+  }
+
+  void decodePosition(const PositionQuantization& quantization, const int16_t* pEncoded, float* pPosition) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      // Matches the Vulkan snorm conversion, -32768 decodes to -1 as well
+      const float normalized = std::max(float(pEncoded[axis]) / kSnorm16Max, -1.f);
+      pPosition[axis] = quantization.bias[axis] + quantization.scale[axis] * normalized;
+    }
+  }
+
+  uint32_t encodeOctahedralNormal(const float* pNormal) {
+    const float maxMag = std::abs(pNormal[0]) + std::abs(pNormal[1]) + std::abs(pNormal[2]);
+    const float inverseMag = maxMag == 0.0f ? 0.0f : (1.0f / maxMag);
+    float x = pNormal[0] * inverseMag;
+    float y = pNormal[1] * inverseMag;
+
+    // Fold the lower hemisphere over the diagonals
+    if (pNormal[2] < 0.0f) {
+      const float originalXSign = signNotZero(x);
+      const float originalYSign = signNotZero(y);
+      const float inverseAbsX = 1.0f - std::abs(x);
+      const float inverseAbsY = 1.0f - std::abs(y);
+
+      x = inverseAbsY * originalXSign;
+      y = inverseAbsX * originalYSign;
+    }
+
+    // Signed->Unsigned octahedral
+    x = x * 0.5f + 0.5f;
+    y = y * 0.5f + 0.5f;
+
+    return uint32_t(floatToUnorm16(x)) | (uint32_t(floatToUnorm16(y)) << 16);
+  }
+
+  void decodeOctahedralNormal(uint32_t encoded, float* pNormal) {
+    float x = float(encoded & 0xFFFF) / kUnorm16Max * 2.0f - 1.0f;
+    float y = float(encoded >> 16) / kUnorm16Max * 2.0f - 1.0f;
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+
+    if (z < 0.0f) {
+      const float unfoldedX = (1.0f - std::abs(y)) * signNotZero(x);
+      const float unfoldedY = (1.0f - std::abs(x)) * signNotZero(y);
+      x = unfoldedX;
+      y = unfoldedY;
+    }
+
+    const float length = std::sqrt(x * x + y * y + z * z);
+    pNormal[0] = x / length;
+    pNormal[1] = y / length;
+    pNormal[2] = z / length;
+  }
+
+}
@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/gtc/packing.hpp>
+
+namespace dxvk::vtxcompress {
+
+  // Maps positions inside an axis aligned box to 16 bit snorms: position = bias + scale * snorm, i.e. bias is the box
+  // center and scale its half extent. This is the mapping the renderer folds into an instance's object to world transform.
+  struct PositionQuantization {
+    float bias[3] = { 0.f, 0.f, 0.f };
+    float scale[3] = { 1.f, 1.f, 1.f };
+  };
+
+  // Computes the quantization covering count float3 positions spaced stride bytes apart
+  PositionQuantization computePositionQuantization(const void* pPositions, size_t count, size_t stride);
+
+  // Encodes a position as VK_FORMAT_R16G16B16A16_SNORM with w = 0, positions outside the range are clamped.
+  // The round trip error per axis is at most half a quantization step, i.e. 0.5 * scale / 32767.
+  void encodePosition(const PositionQuantization& quantization, const float* pPosition, int16_t* pEncoded);
+  void decodePosition(const PositionQuantization& quantization, const int16_t* pEncoded, float* pPosition);
+
+  // Unsigned octahedral encoding with 16 bits per component (x in the low half), the layout used for
+  // VK_FORMAT_R32_UINT normals throughout the renderer.
+  uint32_t encodeOctahedralNormal(const float* pNormal);
+  void decodeOctahedralNormal(uint32_t encoded, float* pNormal);
+
+  // Encodes a texcoord as VK_FORMAT_R16G16_SFLOAT, out of range values become infinity
+  inline uint32_t encodeTexcoord(const float* pTexcoord) {
+    return uint32_t(glm::packHalf1x16(pTexcoord[0])) | (uint32_t(glm::packHalf1x16(pTexcoord[1])) << 16);
+  }
+
+  inline void decodeTexcoord(uint32_t encoded, float* pTexcoord) {
+    pTexcoord[0] = glm::unpackHalf1x16(uint16_t(encoded & 0xFFFF));
+    pTexcoord[1] = glm::unpackHalf1x16(uint16_t(encoded >> 16));
+  }
+
+}
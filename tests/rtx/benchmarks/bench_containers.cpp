@@ -0,0 +1,149 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <random>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/util/util_lru.h"
+#include "../../../src/dxvk/rtx_render/rtx_sparse_unique_cache.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_containers.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  // Stand in for the material/buffer objects tracked by the scene manager
+  struct TrackedObject {
+    uint64_t hash = 0;
+    uint64_t payload[7] = {};
+
+    bool operator==(const TrackedObject& other) const {
+      return hash == other.hash;
+    }
+  };
+
+  struct TrackedObjectHashFn {
+    size_t operator()(const TrackedObject& object) const {
+      return object.hash;
+    }
+  };
+
+  std::vector<uint64_t> generateKeys(uint32_t count, uint32_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<uint64_t> keys(count);
+    for (uint64_t& key : keys) {
+      key = random();
+    }
+    return keys;
+  }
+
+  void benchSparseUniqueCache(BenchmarkRunner& runner, uint32_t count) {
+    std::vector<TrackedObject> objects(count);
+    const std::vector<uint64_t> keys = generateKeys(count, count);
+    for (uint32_t i = 0; i < count; ++i) {
+      objects[i].hash = keys[i];
+    }
+
+    const std::string suffix = str::format("/", count);
+    SparseUniqueCache<TrackedObject, TrackedObjectHashFn> cache;
+
+    runner.run("SparseUniqueCache::track (miss)" + suffix,
+      [&] { cache.clear(); },
+      [&] {
+        for (const TrackedObject& object : objects) {
+          doNotOptimize(cache.track(object));
+        }
+      }, count, "objects");
+
+    // Steady state of a frame: every object already tracked
+    runner.run("SparseUniqueCache::track (hit)" + suffix, [&] {
+      for (const TrackedObject& object : objects) {
+        doNotOptimize(cache.track(object));
+      }
+    }, count, "objects");
+
+    // A quarter of the objects is replaced every frame
+    uint32_t churnOffset = 0;
+    runner.run("SparseUniqueCache::free+track (churn)" + suffix, [&] {
+      const uint32_t churnCount = count / 4;
+      for (uint32_t i = 0; i < churnCount; ++i) {
+        TrackedObject& object = objects[(churnOffset + i) % count];
+        cache.free(object);
+        object.hash = ~object.hash;
+        doNotOptimize(cache.track(object));
+      }
+      churnOffset += churnCount;
+    }, count / 4, "objects");
+  }
+
+  void benchLruList(BenchmarkRunner& runner, uint32_t count) {
+    const std::vector<uint64_t> keys = generateKeys(count, count + 1);
+    const std::string suffix = str::format("/", count);
+
+    lru_list<uint64_t> lru;
+
+    runner.run("lru_list::insert" + suffix,
+      [&] { lru = lru_list<uint64_t>(); },
+      [&] {
+        for (uint64_t key : keys) {
+          lru.insert(key);
+        }
+      }, count, "keys");
+
+    runner.run("lru_list::touch" + suffix, [&] {
+      for (uint64_t key : keys) {
+        lru.touch(key);
+      }
+    }, count, "keys");
+
+    // Evict from the cold end and re-insert, as a budgeted cache does
+    runner.run("lru_list::evict+insert" + suffix, [&] {
+      for (uint32_t i = 0; i < count / 4; ++i) {
+        const uint64_t key = *lru.leastRecentlyUsedIter();
+        lru.remove(lru.leastRecentlyUsedIter());
+        lru.insert(key);
+      }
+    }, count / 4, "keys");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("containers", argc, argv);
+
+    benchSparseUniqueCache(runner, 1024);
+    benchSparseUniqueCache(runner, 32768);
+
+    benchLruList(runner, 1024);
+    benchLruList(runner, 32768);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
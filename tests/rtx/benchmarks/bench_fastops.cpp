@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <random>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/util/util_fastops.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_fastops.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  template<typename T>
+  void benchFindMinMax(BenchmarkRunner& runner, uint32_t count) {
+    std::mt19937 random(count);
+    std::uniform_int_distribution<uint32_t> value(0, std::numeric_limits<T>::max());
+
+    std::vector<T> indices(count);
+    for (T& index : indices) {
+      index = static_cast<T>(value(random));
+    }
+
+    const std::string name = str::format("fast::findMinMax<", sizeof(T) * 8, ">/", count);
+    runner.run(name, [&] {
+      uint32_t minValue, maxValue;
+      fast::findMinMax<T>(count, indices.data(), minValue, maxValue);
+      doNotOptimize(minValue);
+      doNotOptimize(maxValue);
+    }, count, "indices");
+
+    // Primitive restart indices are skipped with a sentinel
+    runner.run(name + " (sentinel)", [&] {
+      uint32_t minValue, maxValue;
+      fast::findMinMax<T>(count, indices.data(), minValue, maxValue, true, std::numeric_limits<T>::max());
+      doNotOptimize(minValue);
+      doNotOptimize(maxValue);
+    }, count, "indices");
+  }
+
+  // Blend indices interleaved in a skinned vertex (position, weights, indices, normal, texcoord)
+  void benchFindMinMaxStrided(BenchmarkRunner& runner, uint32_t vertexCount, uint32_t stride) {
+    std::mt19937 random(vertexCount);
+    std::vector<uint8_t> vertices(vertexCount * stride);
+    for (uint8_t& b : vertices) {
+      b = static_cast<uint8_t>(random());
+    }
+
+    runner.run(str::format("fast::findMinMaxStrided8x4/", vertexCount, "/stride", stride), [&] {
+      uint32_t minValue, maxValue;
+      fast::findMinMaxStrided8x4(vertexCount, vertices.data(), stride, 4, minValue, maxValue);
+      doNotOptimize(minValue);
+      doNotOptimize(maxValue);
+    }, vertexCount, "vertices");
+  }
+
+  // Capture time sample check: gather interleaved positions and compare them against the previous sample,
+  // which is identical, so the whole buffer has to be compared
+  void benchCopyStridedAndCompare(BenchmarkRunner& runner, uint32_t vertexCount, uint32_t stride) {
+    std::mt19937 random(vertexCount);
+    std::uniform_real_distribution<float> value(-100.f, 100.f);
+    std::vector<float> vertices(vertexCount * stride / sizeof(float));
+    for (float& f : vertices) {
+      f = value(random);
+    }
+    std::vector<float> prev(vertexCount * 3);
+    std::vector<float> positions(vertexCount * 3);
+    fast::copyStridedAndCompare(vertexCount, prev.data(), reinterpret_cast<const uint8_t*>(vertices.data()), stride, 3, nullptr, 0.f);
+
+    const float deltaSq = 0.3f * 0.3f;
+    runner.run(str::format("fast::copyStridedAndCompare/", vertexCount, "/stride", stride), [&] {
+      const bool differs = fast::copyStridedAndCompare(vertexCount, positions.data(), reinterpret_cast<const uint8_t*>(vertices.data()), stride, 3, prev.data(), deltaSq);
+      doNotOptimize(differs);
+      doNotOptimize(positions.data());
+    }, vertexCount, "vertices");
+
+    runner.run(str::format("fast::anyVectorDistanceAbove/", vertexCount), [&] {
+      const bool differs = fast::anyVectorDistanceAbove(vertexCount, positions.data(), prev.data(), 3, deltaSq);
+      doNotOptimize(differs);
+    }, vertexCount, "vertices");
+  }
+
+  void benchMemcpy(BenchmarkRunner& runner, size_t byteCount) {
+    std::vector<uint8_t> src(byteCount);
+    std::vector<uint8_t> dst(byteCount);
+    std::mt19937 random(static_cast<uint32_t>(byteCount));
+    for (uint8_t& b : src) {
+      b = static_cast<uint8_t>(random());
+    }
+
+    const std::string suffix = str::format("/", byteCount / 1024, "KB");
+
+    runner.run("memcpy" + suffix, [&] {
+      memcpy(dst.data(), src.data(), byteCount);
+      doNotOptimize(dst.data());
+    }, byteCount, "bytes");
+
+    runner.run("fast::parallel_memcpy" + suffix, [&] {
+      fast::parallel_memcpy(dst.data(), src.data(), byteCount);
+      doNotOptimize(dst.data());
+    }, byteCount, "bytes");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("fastops", argc, argv);
+
+    benchFindMinMax<uint16_t>(runner, 3 * 1024);
+    benchFindMinMax<uint16_t>(runner, 3 * 65536);
+    benchFindMinMax<uint32_t>(runner, 3 * 1024);
+    benchFindMinMax<uint32_t>(runner, 3 * 1024 * 1024);
+
+    benchFindMinMaxStrided(runner, 4 * 1024, 4);
+    benchFindMinMaxStrided(runner, 64 * 1024, 44);
+
+    benchCopyStridedAndCompare(runner, 64 * 1024, 32);
+
+    benchMemcpy(runner, 64 * 1024);
+    benchMemcpy(runner, 16 * 1024 * 1024);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
@@ -0,0 +1,117 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <random>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/dxvk/rtx_render/rtx_hashing.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_hashing.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  struct Vertex {
+    float position[3];
+    float normal[3];
+    float texcoord[2];
+  };
+
+  HashQuery makeQuery(std::vector<Vertex>& vertices) {
+    HashQuery query;
+    query.pBase = reinterpret_cast<uint8_t*>(vertices.data());
+    query.size = vertices.size() * sizeof(Vertex);
+    query.stride = sizeof(Vertex);
+    query.elementSize = sizeof(Vertex::position);
+    query.ref = nullptr;
+    return query;
+  }
+
+  void benchVertexHashing(BenchmarkRunner& runner, uint32_t vertexCount) {
+    std::mt19937 random(vertexCount);
+    std::uniform_real_distribution<float> position(-100.f, 100.f);
+
+    std::vector<Vertex> vertices(vertexCount);
+    for (Vertex& vertex : vertices) {
+      for (float& p : vertex.position) {
+        p = position(random);
+      }
+    }
+    const HashQuery query = makeQuery(vertices);
+
+    // Unique indices as produced by a typical triangle list, every vertex referenced once in a shuffled order
+    std::vector<uint16_t> indices16;
+    std::vector<uint32_t> indices32(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+      indices32[i] = i;
+    }
+    std::shuffle(indices32.begin(), indices32.end(), random);
+    if (vertexCount <= 0xFFFF) {
+      indices16.assign(indices32.begin(), indices32.end());
+    }
+
+    const std::string suffix = str::format("/", vertexCount);
+    const uint64_t bytes = static_cast<uint64_t>(vertexCount) * sizeof(Vertex::position);
+
+    runner.run("hashVertexRegionIndexed<none>" + suffix, [&] {
+      doNotOptimize(hashVertexRegionIndexed(query, std::vector<int>()));
+    }, bytes, "bytes");
+
+    if (!indices16.empty()) {
+      runner.run("hashVertexRegionIndexed<uint16_t>" + suffix, [&] {
+        doNotOptimize(hashVertexRegionIndexed(query, indices16));
+      }, bytes, "bytes");
+    }
+
+    runner.run("hashVertexRegionIndexed<uint32_t>" + suffix, [&] {
+      doNotOptimize(hashVertexRegionIndexed(query, indices32));
+    }, bytes, "bytes");
+
+    runner.run("hashRegionLegacy" + suffix, [&] {
+      XXH64_hash_t h0 = 0, h1 = 0;
+      hashRegionLegacy(query, h0, h1);
+      doNotOptimize(h0);
+      doNotOptimize(h1);
+    }, bytes, "bytes");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("hashing", argc, argv);
+
+    // Small props, typical characters and dense world geometry
+    benchVertexHashing(runner, 256);
+    benchVertexHashing(runner, 8192);
+    benchVertexHashing(runner, 262144);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
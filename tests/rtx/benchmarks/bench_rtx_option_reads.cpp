@@ -0,0 +1,130 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <thread>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/dxvk/rtx_render/rtx_option.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_rtx_option_reads.log");
+
+  class BenchOptions {
+    RTX_OPTION("rtx.bench", float, floatOption, 1.f, "Float option read by the benchmark.");
+    RTX_OPTION("rtx.bench", int, intOption, 1, "Int option read by the benchmark.");
+    RTX_OPTION("rtx.bench", fast_unordered_set, hashSetOption, {}, "Hash set option read by the benchmark.");
+  };
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  constexpr uint32_t kReadsPerThread = 1 << 18;
+
+  // Reads a float, an int and a hash set option, as a typical per draw call option check does
+  template<bool Locked>
+  uint64_t readOptions(uint32_t reads) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < reads; ++i) {
+      if constexpr (Locked) {
+        // Models the previous getValue(), which took s_updateMutex on every read
+        std::lock_guard<std::mutex> lock(RtxOptionImpl::s_updateMutex);
+        sum += static_cast<uint64_t>(BenchOptions::floatOption());
+        sum += BenchOptions::intOption();
+        sum += BenchOptions::hashSetOption().count(i);
+      } else {
+        sum += static_cast<uint64_t>(BenchOptions::floatOption());
+        sum += BenchOptions::intOption();
+        sum += BenchOptions::hashSetOption().count(i);
+      }
+    }
+    return sum;
+  }
+
+  template<bool Locked>
+  void benchReads(BenchmarkRunner& runner, uint32_t numThreads, bool withFrameUpdates) {
+    const std::string name = str::format(Locked ? "RtxOption::get<mutex>/" : "RtxOption::get<snapshot>/",
+                                         numThreads, withFrameUpdates ? "/frameUpdates" : "");
+
+    runner.run(name, [&] {
+      std::atomic<bool> done = false;
+      std::thread updater;
+      if (withFrameUpdates) {
+        // Stands in for the CS thread changing an option and publishing it at the end of every frame
+        updater = std::thread([&] {
+          float value = 1.f;
+          while (!done.load(std::memory_order_relaxed)) {
+            BenchOptions::floatOptionObject().setDeferred(value);
+            RtxOptionManager::applyPendingValues(nullptr);
+            value = value == 1.f ? 2.f : 1.f;
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+          }
+        });
+      }
+
+      std::vector<std::thread> readers;
+      readers.reserve(numThreads);
+      for (uint32_t i = 0; i < numThreads; ++i) {
+        readers.emplace_back([] {
+          doNotOptimize(readOptions<Locked>(kReadsPerThread));
+        });
+      }
+      for (std::thread& reader : readers) {
+        reader.join();
+      }
+
+      done = true;
+      if (updater.joinable()) {
+        updater.join();
+      }
+    }, static_cast<uint64_t>(kReadsPerThread) * numThreads * 3, "reads");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("rtx_option_reads", argc, argv);
+
+    // No config files are loaded, the options keep their defaults
+    RtxOptionImpl::s_isInitialized = true;
+    RtxOptionManager::applyPendingValues(nullptr);
+
+    std::vector<uint32_t> threadCounts = { 1, 4 };
+    if (std::thread::hardware_concurrency() > 4) {
+      threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+    for (const uint32_t numThreads : threadCounts) {
+      benchReads<true>(runner, numThreads, false);
+      benchReads<false>(runner, numThreads, false);
+    }
+    benchReads<true>(runner, threadCounts.back(), true);
+    benchReads<false>(runner, threadCounts.back(), true);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
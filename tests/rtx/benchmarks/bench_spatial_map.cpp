@@ -0,0 +1,172 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <cfloat>
+#include <random>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/util/util_spatial_map.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_spatial_map.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  // Matches the default rtx.uniqueObjectDistance, the instance manager uses a cell size of twice that distance
+  constexpr float kUniqueObjectDistance = 300.f;
+  constexpr float kCellSize = kUniqueObjectDistance * 2.f;
+
+  struct Entry {
+    Vector3 position;
+    Matrix4 transform;
+    XXH64_hash_t hash = 0;
+    int data = 0;
+  };
+
+  std::vector<Entry> generateEntries(uint32_t count, float extent, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-extent, extent);
+
+    std::vector<Entry> entries(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      entries[i].position = Vector3(position(random), position(random), position(random));
+      entries[i].transform = translationMatrix(entries[i].position);
+      entries[i].data = static_cast<int>(i);
+    }
+    return entries;
+  }
+
+  void benchSpatialMap(BenchmarkRunner& runner, uint32_t count) {
+    // Scale the extent with the count to keep the density (and so the entries per cell) constant
+    const float extent = 500.f * std::cbrt(static_cast<float>(count));
+    std::vector<Entry> entries = generateEntries(count, extent, count);
+    std::vector<Entry> queries = generateEntries(count, extent, count + 1);
+    const std::string suffix = str::format("/", count);
+
+    SpatialMap<int> map(kCellSize);
+    SpatialMap<int> packedMap(kCellSize);
+    std::vector<SpatialMap<int>::BuildEntry> buildEntries;
+
+    runner.run("SpatialMap::insert" + suffix,
+      [&] { map = SpatialMap<int>(kCellSize); },
+      [&] {
+        for (Entry& entry : entries) {
+          entry.hash = map.insert(entry.position, entry.transform, &entry.data);
+        }
+      }, count, "inserts");
+
+    runner.run("SpatialMap::getDataAtTransform" + suffix, [&] {
+      for (const Entry& entry : entries) {
+        doNotOptimize(map.getDataAtTransform(entry.transform));
+      }
+    }, count, "queries");
+
+    runner.run("SpatialMap::getNearestData" + suffix, [&] {
+      for (const Entry& query : queries) {
+        float nearestDistSqr = FLT_MAX;
+        doNotOptimize(map.getNearestData(query.position, kUniqueObjectDistance * kUniqueObjectDistance, nearestDistSqr,
+                                         [](const int*) { return true; }));
+      }
+    }, count, "queries");
+
+    runner.run("SpatialMap::build" + suffix,
+      [&] {
+        buildEntries.clear();
+        for (const Entry& entry : entries) {
+          buildEntries.push_back({ entry.position, entry.transform, &entry.data });
+        }
+      },
+      [&] { packedMap.build(buildEntries.data(), buildEntries.size()); }, count, "inserts");
+
+    runner.run("SpatialMap::getNearestData (packed)" + suffix, [&] {
+      for (const Entry& query : queries) {
+        float nearestDistSqr = FLT_MAX;
+        doNotOptimize(packedMap.getNearestData(query.position, kUniqueObjectDistance * kUniqueObjectDistance, nearestDistSqr,
+                                               [](const int*) { return true; }));
+      }
+    }, count, "queries");
+
+    std::vector<Vector3> queryPositions;
+    for (const Entry& query : queries) {
+      queryPositions.push_back(query.position);
+    }
+    std::vector<const int*> batchResults(count);
+    std::vector<float> batchDistances(count);
+    runner.run("SpatialMap::getNearestDataBatch (packed)" + suffix, [&] {
+      packedMap.getNearestDataBatch(queryPositions.data(), count, kUniqueObjectDistance * kUniqueObjectDistance,
+                                    [](size_t, const int*) { return true; }, batchResults.data(), batchDistances.data());
+      doNotOptimize(batchResults.data());
+    }, count, "queries");
+
+    std::vector<SpatialMap<int>::Neighbor> neighbors;
+    runner.run("SpatialMap::getKNearestData k=8 (packed)" + suffix, [&] {
+      for (const Entry& query : queries) {
+        doNotOptimize(packedMap.getKNearestData(query.position, 8, kCellSize * kCellSize, [](const int*) { return true; }, neighbors));
+      }
+    }, count, "queries");
+
+    std::vector<const int*> inRadius;
+    runner.run("SpatialMap::getDataInRadius (packed)" + suffix, [&] {
+      for (const Entry& query : queries) {
+        inRadius.clear();
+        doNotOptimize(packedMap.getDataInRadius(query.position, kCellSize, [](const int*) { return true; }, inRadius));
+      }
+    }, count, "queries");
+
+    // Small per frame motion, most entries stay within their cell
+    std::vector<Vector3> offsets(count);
+    std::vector<Matrix4> transforms(count);
+    runner.run("SpatialMap::move" + suffix,
+      [&] {
+        for (uint32_t i = 0; i < count; ++i) {
+          offsets[i] = entries[i].position + Vector3(1.f, 0.f, 0.5f);
+          transforms[i] = translationMatrix(offsets[i]);
+        }
+      },
+      [&] {
+        for (uint32_t i = 0; i < count; ++i) {
+          entries[i].hash = map.move(entries[i].hash, offsets[i], transforms[i], &entries[i].data);
+          entries[i].position = offsets[i];
+          entries[i].transform = transforms[i];
+        }
+      }, count, "moves");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("spatial_map", argc, argv);
+
+    benchSpatialMap(runner, 1000);
+    benchSpatialMap(runner, 20000);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <filesystem>
+#include <sstream>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/dxvk/dxvk_state_cache.h"
+#include "../../../src/util/util_mapped_file.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_state_cache_load.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  // In the range of a state cache after a few hours of play
+  constexpr uint32_t kEntryCount = 50000;
+
+  DxvkStateCacheEntry makeEntry(uint32_t index) {
+    DxvkStateCacheEntry entry;
+
+    auto shaderKey = [index] (VkShaderStageFlagBits stage) {
+      const uint32_t seed[2] = { index, uint32_t(stage) };
+      return DxvkShaderKey(stage, Sha1Hash::compute(seed, sizeof(seed)));
+    };
+
+    entry.shaders.vs = shaderKey(VK_SHADER_STAGE_VERTEX_BIT);
+    entry.shaders.fs = shaderKey(VK_SHADER_STAGE_FRAGMENT_BIT);
+
+    entry.format.color[0] = { VK_FORMAT_B8G8R8A8_UNORM, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    entry.format.depth = { VK_FORMAT_D24_UNORM_S8_UINT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+    // Up to four float4 attributes from a single vertex buffer
+    const uint32_t attributeCount = 1 + index % 4;
+
+    entry.gpState.ia = DxvkIaInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE, 0);
+    entry.gpState.il = DxvkIlInfo(attributeCount, 1);
+
+    for (uint32_t i = 0; i < attributeCount; i++)
+      entry.gpState.ilAttributes[i] = DxvkIlAttribute(i, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 16 * i);
+
+    entry.gpState.ilBindings[0] = DxvkIlBinding(0, 16 * attributeCount, VK_VERTEX_INPUT_RATE_VERTEX, 0);
+    entry.gpState.sc.specConstants[0] = index % 7;
+    return entry;
+  }
+
+  std::string makeCacheFile() {
+    std::ostringstream stream;
+
+    DxvkStateCacheHeader header;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (uint32_t i = 0; i < kEntryCount; i++) {
+      DxvkStateCacheEntry entry = makeEntry(i);
+      DxvkStateCache::writeCacheEntry(stream, entry);
+    }
+
+    return stream.str();
+  }
+
+  // Replaces the XXH3 checksums of a current cache file with the SHA-1 hashes used up to v12
+  std::string convertToV12(const std::string& file) {
+    DxvkStateCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    header.version = 12;
+
+    std::string result(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (size_t offset = sizeof(header); offset < file.size(); ) {
+      DxvkStateCacheEntryHeader entryHeader;
+      std::memcpy(&entryHeader, file.data() + offset, sizeof(entryHeader));
+
+      const char* data = file.data() + offset + sizeof(entryHeader) + sizeof(DxvkStateCacheChecksum);
+      Sha1Hash hash = Sha1Hash::compute(data, entryHeader.entrySize);
+
+      result.append(reinterpret_cast<const char*>(&entryHeader), sizeof(entryHeader));
+      result.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+      result.append(data, entryHeader.entrySize);
+
+      offset += sizeof(entryHeader) + sizeof(DxvkStateCacheChecksum) + entryHeader.entrySize;
+    }
+
+    return result;
+  }
+
+  void parse(const char* data, size_t size, uint32_t numThreads) {
+    DxvkStateCacheFileData file;
+
+    if (!DxvkStateCache::parseCacheData(data, size, numThreads, file) || file.entries.size() != kEntryCount)
+      throw DxvkError("Failed to parse synthetic state cache");
+
+    doNotOptimize(file.entries.data());
+  }
+
+  void benchParse(BenchmarkRunner& runner, const char* format, const std::string& file) {
+    runner.run(str::format("StateCache/parse/", format, "/serial"), [&] {
+      parse(file.data(), file.size(), 1);
+    }, kEntryCount, "entries");
+
+    runner.run(str::format("StateCache/parse/", format, "/parallel"), [&] {
+      parse(file.data(), file.size(), 0);
+    }, kEntryCount, "entries");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("state_cache_load", argc, argv);
+
+    const std::string v14 = makeCacheFile();
+    const std::string v12 = convertToV12(v14);
+
+    benchParse(runner, "v12-sha1", v12);
+    benchParse(runner, "v14-xxh3", v14);
+
+    // Full load path, mapping the file from disk and parsing it in place
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "bench_state_cache_load.dxvk-cache";
+
+    { std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+      out.write(v14.data(), v14.size());
+    }
+
+    runner.run("StateCache/load/mapped/v14-xxh3", [&] {
+      MappedFile file;
+
+      if (!file.open(path))
+        throw DxvkError("Failed to map synthetic state cache");
+
+      parse(file.data(), file.size(), 0);
+    }, kEntryCount, "entries");
+
+    std::filesystem::remove(path);
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
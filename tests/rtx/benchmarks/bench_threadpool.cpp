@@ -0,0 +1,77 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/util/util_threadpool.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_threadpool.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  constexpr uint32_t kBatchSize = 1024;
+
+  template<bool LowLatency>
+  void benchThreadPool(BenchmarkRunner& runner, uint8_t numThreads) {
+    WorkerThreadPool<kBatchSize, true, LowLatency> threadPool(numThreads, "bench worker");
+    const std::string suffix = str::format(LowLatency ? "<lowLatency>/" : "<waiting>/", uint32_t(numThreads));
+
+    // Round trip of a single empty task, measures the wake up + hand off latency
+    runner.run("WorkerThreadPool::Schedule roundtrip" + suffix, [&] {
+      Future<uint32_t> future = threadPool.Schedule([]() -> uint32_t { return 1; });
+      doNotOptimize(future.get());
+    });
+
+    // Cost on the scheduling thread of submitting a batch of tasks, and the time to drain it
+    std::vector<Future<uint32_t>> futures(kBatchSize);
+    runner.run("WorkerThreadPool::Schedule batch" + suffix, [&] {
+      for (uint32_t i = 0; i < kBatchSize; ++i) {
+        futures[i] = threadPool.Schedule([i]() -> uint32_t { return i; });
+      }
+      for (Future<uint32_t>& future : futures) {
+        if (future.valid()) {
+          doNotOptimize(future.get());
+        }
+      }
+    }, kBatchSize, "tasks");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("threadpool", argc, argv);
+
+    benchThreadPool<true>(runner, 1);
+    benchThreadPool<true>(runner, 4);
+    benchThreadPool<false>(runner, 4);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
@@ -0,0 +1,172 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <filesystem>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/lssusd/game_exporter.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_usd_export.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  constexpr uint32_t kMeshCount = 10000;
+  constexpr uint32_t kMaterialCount = 1000;
+  // Vertices per side of the grid each synthetic mesh is made of
+  constexpr uint32_t kGridSize = 8;
+
+  lss::Mesh makeGridMesh(const uint32_t meshIndex) {
+    lss::Mesh mesh;
+    mesh.meshName = str::format(std::hex, 0x1000000000000000ull + meshIndex);
+    mesh.matId = meshIndex % kMaterialCount;
+    mesh.numVertices = kGridSize * kGridSize;
+    mesh.numIndices = (kGridSize - 1) * (kGridSize - 1) * 6;
+
+    lss::Buf<lss::Pos> positions(mesh.numVertices);
+    lss::Buf<lss::Norm> normals(mesh.numVertices);
+    lss::Buf<lss::Texcoord> texcoords(mesh.numVertices);
+    for (uint32_t y = 0; y < kGridSize; ++y) {
+      for (uint32_t x = 0; x < kGridSize; ++x) {
+        const uint32_t v = y * kGridSize + x;
+        positions[v] = lss::Pos(static_cast<float>(x), static_cast<float>(y), static_cast<float>(meshIndex % 7));
+        normals[v] = lss::Norm(0.f, 0.f, 1.f);
+        texcoords[v] = lss::Texcoord(x / float(kGridSize - 1), y / float(kGridSize - 1));
+      }
+    }
+
+    lss::Buf<lss::Index> indices;
+    indices.reserve(mesh.numIndices);
+    for (uint32_t y = 0; y + 1 < kGridSize; ++y) {
+      for (uint32_t x = 0; x + 1 < kGridSize; ++x) {
+        const int v = static_cast<int>(y * kGridSize + x);
+        const int quad[] = { v, v + 1, v + int(kGridSize), v + 1, v + int(kGridSize) + 1, v + int(kGridSize) };
+        for (const int index : quad) {
+          indices.push_back(index);
+        }
+      }
+    }
+
+    mesh.buffers.idxBufs[0.f] = indices;
+    mesh.buffers.positionBufs[0.f] = positions;
+    mesh.buffers.normalBufs[0.f] = normals;
+    mesh.buffers.texcoordBufs[0.f] = texcoords;
+    return mesh;
+  }
+
+  lss::Export makeExport(const std::string& basePath) {
+    lss::Export exportData;
+    exportData.debugId = "bench";
+    exportData.meta.windowTitle = "bench_usd_export";
+    exportData.meta.exeName = "bench_usd_export.exe";
+    exportData.meta.iconPath = basePath + "bench_usd_export_icon.bmp";
+    exportData.meta.geometryHashRule = "positions,indices";
+    exportData.meta.metersPerUnit = 1.0;
+    exportData.meta.timeCodesPerSecond = 24.0;
+    exportData.meta.startTimeCode = 0.0;
+    exportData.meta.endTimeCode = 0.0;
+    exportData.meta.numFramesCaptured = 1;
+    exportData.meta.bReduceMeshBuffers = true;
+    exportData.meta.isZUp = false;
+    exportData.meta.bCorrectBakedTransforms = false;
+    exportData.baseExportPath = basePath;
+    exportData.bExportInstanceStage = true;
+    exportData.instanceStagePath = basePath + "capture.usd";
+
+    exportData.camera.fov = 1.f;
+    exportData.camera.aspectRatio = 16.f / 9.f;
+    exportData.camera.nearPlane = 0.1f;
+    exportData.camera.farPlane = 1000.f;
+    exportData.camera.firstTime = 0.f;
+    exportData.camera.finalTime = 0.f;
+    exportData.camera.xforms.push_back({ 0.0, pxr::GfMatrix4d(1.0) });
+
+    for (uint32_t i = 0; i < kMaterialCount; ++i) {
+      lss::Material& material = exportData.materials[i];
+      material.matName = str::format(std::hex, 0x2000000000000000ull + i);
+      material.albedoTexPath = basePath + lss::commonDirName::texDir + material.matName + lss::ext::dds;
+      material.sampler.addrModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+      material.sampler.addrModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+      material.sampler.filter = VK_FILTER_LINEAR;
+      material.sampler.borderColor = {};
+      material.textureAlphaArg2Source = 0;
+      material.textureAlphaOperation = 0;
+      material.tFactor = 0xffffffff;
+      material.isTextureFactorBlend = false;
+      material.isVertexColorBakedLighting = false;
+    }
+
+    for (uint32_t i = 0; i < kMeshCount; ++i) {
+      exportData.meshes[i] = makeGridMesh(i);
+
+      lss::Instance& instance = exportData.instances[i];
+      instance.instanceName = str::format(std::hex, 0x3000000000000000ull + i);
+      instance.firstTime = 0.f;
+      instance.finalTime = 0.f;
+      instance.matId = exportData.meshes[i].matId;
+      instance.meshId = i;
+      instance.isSky = false;
+      instance.metadata = {};
+      instance.xforms.push_back({ 0.0, pxr::GfMatrix4d(1.0).SetTranslate(pxr::GfVec3d(i % 100, i / 100, 0.0)) });
+    }
+
+    return exportData;
+  }
+
+  void benchExport(BenchmarkRunner& runner, lss::Export& exportData, const char* name, const bool parallel, const std::string& layerFileFormat, const bool shareBuffers = false) {
+    runner.run(name, [&] {
+      exportData.meta.bParallelLayerExport = parallel;
+      exportData.meta.layerFileFormat = layerFileFormat;
+      exportData.meta.bShareMeshBuffers = shareBuffers;
+    }, [&] {
+      lss::GameExporter::exportUsd(exportData);
+    }, kMeshCount, "meshes");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("usd_export", argc, argv);
+
+    const std::filesystem::path basePath = std::filesystem::temp_directory_path() / "remix_bench_usd_export";
+    std::filesystem::create_directories(basePath);
+    lss::Export exportData = makeExport(basePath.generic_string() + "/");
+
+    benchExport(runner, exportData, "GameExporter::exportUsd/serial/usda", false, "usda");
+    benchExport(runner, exportData, "GameExporter::exportUsd/parallel/usda", true, "usda");
+    benchExport(runner, exportData, "GameExporter::exportUsd/parallel/usdc", true, "usdc");
+    // Every synthetic mesh has the same indices, normals and texcoords, and one of 7 position sets
+    benchExport(runner, exportData, "GameExporter::exportUsd/parallel/usdc/shared", true, "usdc", true);
+
+    std::filesystem::remove_all(basePath);
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
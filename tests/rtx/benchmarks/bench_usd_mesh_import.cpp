@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <cmath>
+
+#include "../../test_utils.h"
+#include "benchmark_harness.h"
+#include "../../../src/lssusd/usd_mesh_importer.h"
+
+#include "../../../src/lssusd/usd_include_begin.h"
+#include <pxr/base/work/threadLimits.h>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/primvarsAPI.h>
+#include <pxr/usd/usdGeom/subset.h>
+#include "../../../src/lssusd/usd_include_end.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this benchmark.
+  Logger Logger::s_instance("bench_usd_mesh_import.log");
+}
+
+using namespace dxvk;
+using namespace dxvk::bench;
+
+namespace {
+  // Quads per side of the synthetic grid, 2 * 707 * 707 is just under a million triangles
+  constexpr uint32_t kGridQuads = 707;
+  constexpr uint32_t kGridVertices = kGridQuads + 1;
+  constexpr uint32_t kNumTriangles = kGridQuads * kGridQuads * 2;
+  constexpr uint32_t kNumSubsets = 4;
+
+  // Quad grid with vertex normals, face varying texcoords, a constant color and geom subsets,
+  // so every kind of sampler and the face to triangle map are exercised
+  pxr::UsdPrim makeGridMesh(const pxr::UsdStageRefPtr& stage, const bool withSubsets) {
+    pxr::UsdGeomMesh mesh = pxr::UsdGeomMesh::Define(stage, pxr::SdfPath(withSubsets ? "/GridWithSubsets" : "/Grid"));
+
+    pxr::VtVec3fArray points(kGridVertices * kGridVertices);
+    pxr::VtVec3fArray normals(points.size());
+    for (uint32_t y = 0; y < kGridVertices; ++y) {
+      for (uint32_t x = 0; x < kGridVertices; ++x) {
+        const uint32_t v = y * kGridVertices + x;
+        const float height = 0.25f * std::sin(x * 0.05f) * std::cos(y * 0.05f);
+        points[v] = pxr::GfVec3f(static_cast<float>(x), static_cast<float>(y), height);
+        normals[v] = pxr::GfVec3f(-height, height, 1.f).GetNormalized();
+      }
+    }
+
+    const uint32_t numQuads = kGridQuads * kGridQuads;
+    pxr::VtIntArray faceVertexCounts(numQuads, 4);
+    pxr::VtIntArray faceVertexIndices(numQuads * 4);
+    pxr::VtVec2fArray texcoords(numQuads * 4);
+    for (uint32_t y = 0; y < kGridQuads; ++y) {
+      for (uint32_t x = 0; x < kGridQuads; ++x) {
+        const uint32_t quad = y * kGridQuads + x;
+        const int v = static_cast<int>(y * kGridVertices + x);
+        const int corners[] = { v, v + 1, v + int(kGridVertices) + 1, v + int(kGridVertices) };
+        const pxr::GfVec2f uvs[] = { { 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f } };
+        for (uint32_t c = 0; c < 4; ++c) {
+          faceVertexIndices[quad * 4 + c] = corners[c];
+          texcoords[quad * 4 + c] = uvs[c];
+        }
+      }
+    }
+
+    mesh.CreatePointsAttr().Set(points);
+    mesh.CreateNormalsAttr().Set(normals);
+    mesh.SetNormalsInterpolation(pxr::UsdGeomTokens->vertex);
+    mesh.CreateFaceVertexCountsAttr().Set(faceVertexCounts);
+    mesh.CreateFaceVertexIndicesAttr().Set(faceVertexIndices);
+    mesh.CreateDisplayColorPrimvar(pxr::UsdGeomTokens->constant).Set(pxr::VtVec3fArray { pxr::GfVec3f(0.5f) });
+    pxr::UsdGeomPrimvarsAPI(mesh.GetPrim())
+      .CreatePrimvar(pxr::TfToken("st"), pxr::SdfValueTypeNames->TexCoord2fArray, pxr::UsdGeomTokens->faceVarying)
+      .Set(texcoords);
+
+    if (withSubsets) {
+      // Horizontal bands of the grid
+      for (uint32_t s = 0; s < kNumSubsets; ++s) {
+        pxr::VtIntArray subsetFaces;
+        for (uint32_t quad = s * numQuads / kNumSubsets; quad < (s + 1) * numQuads / kNumSubsets; ++quad) {
+          subsetFaces.push_back(static_cast<int>(quad));
+        }
+        pxr::UsdGeomSubset::CreateGeomSubset(mesh, pxr::TfToken(str::format("band", s)), pxr::UsdGeomTokens->face, subsetFaces);
+      }
+    }
+
+    return mesh.GetPrim();
+  }
+
+  void benchImport(BenchmarkRunner& runner, const pxr::UsdPrim& prim, const char* name, const bool serial) {
+    runner.run(name, [&] {
+      if (serial) {
+        pxr::WorkSetConcurrencyLimit(1);
+      } else {
+        pxr::WorkSetMaximumConcurrencyLimit();
+      }
+    }, [&] {
+      lss::UsdMeshImporter importer(prim, 4);
+      doNotOptimize(importer.GetVertexData().data());
+    }, kNumTriangles, "triangles");
+  }
+}
+
+int main(int argc, char** argv) {
+  try {
+    BenchmarkRunner runner("usd_mesh_import", argc, argv);
+
+    pxr::UsdStageRefPtr stage = pxr::UsdStage::CreateInMemory();
+    const pxr::UsdPrim grid = makeGridMesh(stage, false);
+    const pxr::UsdPrim gridWithSubsets = makeGridMesh(stage, true);
+
+    benchImport(runner, grid, "UsdMeshImporter/1M triangles/serial", true);
+    benchImport(runner, grid, "UsdMeshImporter/1M triangles/parallel", false);
+    benchImport(runner, gridWithSubsets, "UsdMeshImporter/1M triangles/subsets/serial", true);
+    benchImport(runner, gridWithSubsets, "UsdMeshImporter/1M triangles/subsets/parallel", false);
+    pxr::WorkSetMaximumConcurrencyLimit();
+
+    return runner.finish();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+}
@@ -0,0 +1,241 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Minimal microbenchmark harness shared by the tests/rtx benchmarks.
+//
+// Every benchmark is run for a number of untimed warmup iterations followed by timed iterations, and reports
+// mean/min/max and percentiles of the per iteration time. Results can be written as JSON so runs can be compared
+// against each other to catch performance regressions.
+//
+// Command line (parsed by BenchmarkRunner):
+//   --iterations N   timed iterations per benchmark (default 50)
+//   --warmup N       untimed warmup iterations per benchmark (default 5)
+//   --filter STR     only run benchmarks whose name contains STR
+//   --json PATH      write the results as JSON to PATH
+//
+// Inputs are generated from fixed seeds so runs are reproducible.
+namespace dxvk::bench {
+
+  // Prevents the compiler from optimizing away a value computed by a benchmark
+  template<typename T>
+  inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+  }
+
+  struct Statistics {
+    size_t samples = 0;
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+      if (sorted.empty()) {
+        return 0.0;
+      }
+      // Nearest rank
+      const size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()));
+      return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    static Statistics compute(std::vector<double> values) {
+      Statistics stats;
+      if (values.empty()) {
+        return stats;
+      }
+
+      std::sort(values.begin(), values.end());
+
+      double sum = 0.0;
+      for (double v : values) {
+        sum += v;
+      }
+
+      stats.samples = values.size();
+      stats.mean = sum / static_cast<double>(values.size());
+      stats.min = values.front();
+      stats.max = values.back();
+      stats.p50 = percentile(values, 50.0);
+      stats.p90 = percentile(values, 90.0);
+      stats.p95 = percentile(values, 95.0);
+      stats.p99 = percentile(values, 99.0);
+      return stats;
+    }
+  };
+
+  struct BenchmarkResult {
+    std::string name;
+    Statistics timeUs;
+    // Number of items (bytes, elements, tasks...) processed per iteration, used for the throughput column
+    uint64_t itemsPerIteration = 0;
+    const char* itemUnit = "items";
+
+    double itemsPerSecond() const {
+      return timeUs.p50 > 0.0 ? static_cast<double>(itemsPerIteration) / (timeUs.p50 * 1e-6) : 0.0;
+    }
+  };
+
+  class BenchmarkRunner {
+  public:
+    BenchmarkRunner(const char* suiteName, int argc, char** argv)
+      : m_suiteName(suiteName) {
+      for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--iterations") == 0 && hasValue) {
+          m_iterations = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+        } else if (strcmp(argv[i], "--warmup") == 0 && hasValue) {
+          m_warmupIterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+          m_filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+          m_jsonPath = argv[++i];
+        } else {
+          std::cerr << "Unknown argument: " << argv[i] << std::endl;
+        }
+      }
+
+      std::cout << "Benchmark suite: " << m_suiteName << " (" << m_warmupIterations << " warmup, " << m_iterations << " timed iterations)" << std::endl;
+    }
+
+    // Times fn() per iteration
+    template<typename F>
+    void run(const std::string& name, F&& fn, uint64_t itemsPerIteration = 0, const char* itemUnit = "items") {
+      run(name, [] { }, std::forward<F>(fn), itemsPerIteration, itemUnit);
+    }
+
+    // Calls setup() untimed before each timed call of fn(), for benchmarks that consume their input
+    template<typename S, typename F>
+    void run(const std::string& name, S&& setup, F&& fn, uint64_t itemsPerIteration = 0, const char* itemUnit = "items") {
+      if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+        return;
+      }
+
+      for (uint32_t i = 0; i < m_warmupIterations; ++i) {
+        setup();
+        fn();
+      }
+
+      std::vector<double> samples;
+      samples.reserve(m_iterations);
+      for (uint32_t i = 0; i < m_iterations; ++i) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+      }
+
+      BenchmarkResult& result = m_results.emplace_back();
+      result.name = name;
+      result.timeUs = Statistics::compute(std::move(samples));
+      result.itemsPerIteration = itemsPerIteration;
+      result.itemUnit = itemUnit;
+
+      print(result);
+    }
+
+    // Writes the JSON results if requested, returns the process exit code
+    int finish() const {
+      if (m_jsonPath.empty()) {
+        return 0;
+      }
+
+      std::ofstream json(m_jsonPath);
+      if (!json.is_open()) {
+        std::cerr << "Failed to open " << m_jsonPath << " for writing" << std::endl;
+        return 1;
+      }
+
+      json << "{\n"
+           << "  \"suite\": \"" << m_suiteName << "\",\n"
+           << "  \"warmupIterations\": " << m_warmupIterations << ",\n"
+           << "  \"iterations\": " << m_iterations << ",\n"
+           << "  \"results\": [\n";
+
+      for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& r = m_results[i];
+        json << "    { \"name\": \"" << r.name << "\""
+             << ", \"meanUs\": " << r.timeUs.mean
+             << ", \"minUs\": " << r.timeUs.min
+             << ", \"maxUs\": " << r.timeUs.max
+             << ", \"p50Us\": " << r.timeUs.p50
+             << ", \"p90Us\": " << r.timeUs.p90
+             << ", \"p95Us\": " << r.timeUs.p95
+             << ", \"p99Us\": " << r.timeUs.p99;
+        if (r.itemsPerIteration > 0) {
+          json << ", \"itemsPerIteration\": " << r.itemsPerIteration
+               << ", \"itemUnit\": \"" << r.itemUnit << "\""
+               << ", \"itemsPerSecond\": " << r.itemsPerSecond();
+        }
+        json << " }" << (i + 1 < m_results.size() ? ",\n" : "\n");
+      }
+
+      json << "  ]\n}\n";
+      std::cout << "Results written to " << m_jsonPath << std::endl;
+      return 0;
+    }
+
+  private:
+    std::string m_suiteName;
+    std::string m_filter;
+    std::string m_jsonPath;
+    uint32_t m_iterations = 50;
+    uint32_t m_warmupIterations = 5;
+    std::vector<BenchmarkResult> m_results;
+
+    static void print(const BenchmarkResult& r) {
+      char line[512];
+      snprintf(line, sizeof(line), "  %-48s p50 %10.2f us  p95 %10.2f us  p99 %10.2f us  mean %10.2f us",
+               r.name.c_str(), r.timeUs.p50, r.timeUs.p95, r.timeUs.p99, r.timeUs.mean);
+      std::cout << line;
+      if (r.itemsPerIteration > 0) {
+        snprintf(line, sizeof(line), "  (%.3g %s/s)", r.itemsPerSecond(), r.itemUnit);
+        std::cout << line;
+      }
+      std::cout << std::endl;
+    }
+  };
+
+}
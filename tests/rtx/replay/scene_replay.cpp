@@ -0,0 +1,474 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+// Render-free replay of the scene management.
+//
+// Feeds a SceneReplay capture (recorded with rtx.sceneReplay.captureFrameCount) or a synthetic scene through the device
+// independent parts of the scene management: DrawCallCache::lookup() picks the BLAS entry of every draw call,
+// InstanceManager::findSimilarInstances() matches it to an instance, and BLAS entries and instances are garbage collected
+// by the rules of SceneManager and InstanceManager. Reports per stage timings, and checks the outcomes every frame: each
+// live instance must be linked to a live BLAS entry, and in the synthetic scene every object that did not respawn must
+// keep its BLAS entry and instance from the previous frame.
+//
+// Note: geometry processing, BLAS builds, materials, anti-culling, ray portals and the light manager need a device and
+// are not run. Instances are matched on the draw call's material hash, where a replacement material would be used in
+// game, and lights are only tracked for their lifetime.
+//
+// Usage: scene_replay [capture.rxrp] [--frames N] [--json results.json]
+//        Without a capture a synthetic scene is generated.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#include "../../test_utils.h"
+#include "../benchmarks/benchmark_harness.h"
+#include "../../../src/util/util_slab_pool.h"
+#include "../../../src/dxvk/rtx_render/rtx_option.h"
+#include "../../../src/dxvk/rtx_render/rtx_options.h"
+#include "../../../src/dxvk/rtx_render/rtx_draw_call_cache.h"
+#include "../../../src/dxvk/rtx_render/rtx_instance_manager.h"
+#include "../../../src/dxvk/rtx_render/rtx_scene_replay.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this tool.
+  Logger Logger::s_instance("scene_replay.log");
+}
+
+using namespace dxvk;
+
+namespace {
+  struct LightModel {
+    uint32_t frameLastUpdated = 0;
+  };
+
+  enum Stage : uint32_t {
+    DrawCallCacheStage,
+    InstanceMatchingStage,
+    LightProcessingStage,
+    GarbageCollectionStage,
+    FrameTotal,
+    StageCount
+  };
+
+  const char* kStageNames[StageCount] = {
+    "drawCallCache",
+    "instanceMatching",
+    "lightProcessing",
+    "garbageCollection",
+    "frameTotal",
+  };
+
+  // What the scene management did with a draw call
+  struct DrawOutcome {
+    const BlasEntry* blas = nullptr;
+    uint64_t instanceId = 0;
+    bool isNewBlas = false;
+    bool isNewInstance = false;
+  };
+
+  class SceneReplayer {
+  public:
+    ~SceneReplayer() {
+      for (RtInstance* instance : m_instances) {
+        m_instancePool.free(instance);
+      }
+      m_instances.clear();
+      m_blasEntries.clear();
+    }
+
+    void replayFrame(const SceneReplay::Frame& frame, std::vector<DrawOutcome>& outcomes) {
+      using Clock = std::chrono::steady_clock;
+
+      ++m_frameId;
+      double stageTime[StageCount] = {};
+      outcomes.clear();
+
+      const auto frameStart = Clock::now();
+      for (const SceneReplay::DrawRecord& draw : frame.draws) {
+        const DrawCallState drawCall = SceneReplayRecorder::restoreDraw(draw);
+        DrawOutcome& outcome = outcomes.emplace_back();
+
+        const auto t0 = Clock::now();
+        BlasEntry* blas = processBlas(drawCall, outcome);
+        const auto t1 = Clock::now();
+        processSceneObject(*blas, drawCall, outcome);
+        const auto t2 = Clock::now();
+
+        stageTime[DrawCallCacheStage] += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        stageTime[InstanceMatchingStage] += std::chrono::duration<double, std::micro>(t2 - t1).count();
+      }
+
+      {
+        const auto t0 = Clock::now();
+        for (const SceneReplay::LightRecord& light : frame.lights) {
+          m_lights[light.hash].frameLastUpdated = m_frameId;
+        }
+        const auto t1 = Clock::now();
+        stageTime[LightProcessingStage] = std::chrono::duration<double, std::micro>(t1 - t0).count();
+      }
+
+      {
+        const auto t0 = Clock::now();
+        garbageCollection();
+        const auto t1 = Clock::now();
+        stageTime[GarbageCollectionStage] = std::chrono::duration<double, std::micro>(t1 - t0).count();
+      }
+
+      stageTime[FrameTotal] = std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count();
+
+      for (uint32_t i = 0; i < StageCount; ++i) {
+        m_samples[i].push_back(stageTime[i]);
+      }
+      m_drawCount += frame.draws.size();
+
+      checkLinks();
+    }
+
+    size_t getLiveInstanceCount() const { return m_instances.size(); }
+    size_t getBlasCreatedCount() const { return m_blasCreated; }
+
+    void report(const std::string& jsonPath) {
+      std::cout << "Replayed " << m_samples[FrameTotal].size() << " frames, " << m_drawCount << " draws, "
+                << m_instancesCreated << " instances created, " << m_blasCreated << " BLAS entries created" << std::endl;
+      std::cout << str::format("  ", "stage", std::string(14, ' '), "mean(us)    p50(us)     p95(us)     max(us)") << std::endl;
+
+      std::ofstream json;
+      if (!jsonPath.empty()) {
+        json.open(jsonPath);
+        json << "{\n  \"frames\": " << m_samples[FrameTotal].size() << ",\n  \"draws\": " << m_drawCount << ",\n  \"stages\": {\n";
+      }
+
+      for (uint32_t i = 0; i < StageCount; ++i) {
+        if (m_samples[i].empty()) {
+          continue;
+        }
+        const bench::Statistics stats = bench::Statistics::compute(m_samples[i]);
+
+        char line[256];
+        snprintf(line, sizeof(line), "  %-19s%-12.1f%-12.1f%-12.1f%-12.1f", kStageNames[i], stats.mean, stats.p50, stats.p95, stats.max);
+        std::cout << line << std::endl;
+
+        if (json.is_open()) {
+          json << "    \"" << kStageNames[i] << "\": { \"meanUs\": " << stats.mean << ", \"p50Us\": " << stats.p50
+               << ", \"p95Us\": " << stats.p95 << ", \"maxUs\": " << stats.max << " }" << (i + 1 < StageCount ? ",\n" : "\n");
+        }
+      }
+
+      if (json.is_open()) {
+        json << "  }\n}\n";
+      }
+    }
+
+  private:
+    DrawCallCache::MultimapType m_blasEntries;
+    SlabPool<RtInstance> m_instancePool;
+    std::vector<RtInstance*> m_instances;
+    fast_unordered_cache<LightModel> m_lights;
+    uint64_t m_nextInstanceId = 1;
+    uint32_t m_frameId = 0;
+
+    std::vector<double> m_samples[StageCount];
+    size_t m_drawCount = 0;
+    size_t m_instancesCreated = 0;
+    size_t m_blasCreated = 0;
+
+    // SceneManager::processDrawCallState up to instance processing, without the geometry processing
+    BlasEntry* processBlas(const DrawCallState& drawCall, DrawOutcome& outcome) {
+      BlasEntry* blas = nullptr;
+      outcome.isNewBlas = DrawCallCache::lookup(m_blasEntries, drawCall, m_frameId, &blas) == DrawCallCache::CacheState::kNew;
+      outcome.blas = blas;
+
+      if (outcome.isNewBlas) {
+        // SceneManager::onSceneObjectAdded
+        blas->modifiedGeometryData.hashes = drawCall.getGeometryData().hashes;
+        blas->frameLastUpdated = m_frameId;
+        ++m_blasCreated;
+      } else if (blas->frameLastTouched == m_frameId) {
+        // SceneManager::onSceneObjectUpdated for a BLAS entry already used this frame
+        blas->cacheMaterial(drawCall.getMaterialData());
+      } else {
+        // SceneManager::onSceneObjectUpdated, processGeometryInfo copies the hashes the draw call cache scores candidates with
+        blas->modifiedGeometryData.hashes = drawCall.getGeometryData().hashes;
+        blas->clearMaterialCache();
+        blas->input = drawCall;
+      }
+
+      blas->frameLastTouched = m_frameId;
+      return blas;
+    }
+
+    // InstanceManager::processSceneObject, restricted to the state instance matching depends on
+    void processSceneObject(BlasEntry& blas, const DrawCallState& drawCall, DrawOutcome& outcome) {
+      const Matrix4& objectToWorld = drawCall.getTransformData().objectToWorld;
+      const InstanceManager::SimilarInstanceQuery query { drawCall.getMaterialData().getHash(), objectToWorld, drawCall.cameraType };
+
+      RtInstance* instance = nullptr;
+      InstanceManager::findSimilarInstances(blas, &query, 1, m_frameId, nullptr, &instance);
+
+      outcome.isNewInstance = instance == nullptr;
+      if (outcome.isNewInstance) {
+        instance = addInstance(blas);
+      }
+      outcome.instanceId = instance->getId();
+
+      // InstanceManager::updateInstance
+      const bool isFirstUpdateThisFrame = instance->setFrameLastUpdated(m_frameId);
+      const bool isNewCameraSet = instance->registerCamera(drawCall.cameraType, m_frameId);
+      const bool overridePreviousCameraUpdate = isNewCameraSet &&
+        (drawCall.cameraType == CameraType::Main || !instance->isCameraRegistered(CameraType::Main));
+
+      if (isFirstUpdateThisFrame || overridePreviousCameraUpdate) {
+        if (isFirstUpdateThisFrame) {
+          InstanceManager::updateInstanceMaterialHash(*instance, query.materialHash);
+        }
+        InstanceManager::updateInstanceTransform(*instance, objectToWorld, m_frameId, isFirstUpdateThisFrame);
+      }
+    }
+
+    // InstanceManager::addInstance and SceneManager::onInstanceAdded
+    RtInstance* addInstance(BlasEntry& blas) {
+      SlabHandle handle;
+      RtInstance* instance = m_instancePool.allocate(handle, m_nextInstanceId++, static_cast<uint32_t>(m_instances.size()));
+      instance->setFrameCreated(m_frameId);
+      instance->setBlas(blas);
+      blas.linkInstance(instance);
+      m_instances.push_back(instance);
+      ++m_instancesCreated;
+      return instance;
+    }
+
+    // SceneManager::garbageCollection (without anti-culling) followed by InstanceManager::garbageCollection
+    void garbageCollection() {
+      if (m_frameId > RtxOptions::numFramesToKeepGeometryData()) {
+        const uint32_t oldestFrame = m_frameId - RtxOptions::numFramesToKeepGeometryData();
+        for (auto iter = m_blasEntries.begin(); iter != m_blasEntries.end();) {
+          if (iter->second.frameLastTouched < oldestFrame) {
+            // SceneManager::onSceneObjectDestroyed
+            for (RtInstance* instance : iter->second.getLinkedInstances()) {
+              instance->markForGarbageCollection();
+              instance->markAsUnlinkedFromBlasEntryForGarbageCollection();
+            }
+            iter = m_blasEntries.erase(iter);
+          } else {
+            ++iter;
+          }
+        }
+      }
+
+      const bool forceGarbageCollection = m_instances.size() >= RtxOptions::AntiCulling::Object::numObjectsToKeep();
+      for (uint32_t i = 0; i < m_instances.size();) {
+        RtInstance*& instance = m_instances[i];
+        if (InstanceManager::shouldCollectInstance(*instance, m_frameId, forceGarbageCollection)) {
+          // InstanceManager::removeInstance and SceneManager::onInstanceDestroyed
+          instance->removeFromSpatialCache();
+          if (!instance->isUnlinkedForGC()) {
+            instance->getBlas()->unlinkInstance(instance);
+          }
+          std::swap(instance, m_instances.back());
+          m_instancePool.free(m_instances.back());
+          m_instances.pop_back();
+          continue;
+        }
+        ++i;
+      }
+
+      const uint32_t numFramesToKeepLights = RtxOptions::numFramesToKeepLights();
+      m_lights.erase_if([this, numFramesToKeepLights](const auto& light) {
+        return light->second.frameLastUpdated + numFramesToKeepLights <= m_frameId;
+      });
+    }
+
+    // Every live instance must be linked to exactly one live BLAS entry, and nothing else may be linked
+    void checkLinks() const {
+      std::unordered_set<const RtInstance*> linked;
+      for (const auto& [hash, blas] : m_blasEntries) {
+        for (const RtInstance* instance : blas.getLinkedInstances()) {
+          check(instance->getBlas() == &blas, "a linked instance must point back at its BLAS entry");
+          check(linked.insert(instance).second, "an instance must be linked to a single BLAS entry");
+        }
+      }
+      check(linked.size() == m_instances.size(), "every live instance must be linked to a live BLAS entry");
+      for (const RtInstance* instance : m_instances) {
+        check(linked.count(instance) == 1, "a live instance is not linked to any BLAS entry");
+      }
+    }
+  };
+
+  // Generates a scene with a mix of static, moving and respawning objects, drawn with a set of shared meshes.
+  // Objects live on a lattice spaced far wider than rtx.uniqueObjectDistance, so which instance each draw call
+  // should be matched to is known: its own unless it respawned.
+  class SyntheticScene {
+  public:
+    SyntheticScene(uint32_t objectCount, uint32_t meshCount) : m_objectCount(objectCount), m_meshCount(meshCount) {
+      m_isInRespawnRegion.resize(objectCount, false);
+    }
+
+    uint32_t getMeshCount() const { return m_meshCount; }
+
+    // Draw i of every frame is object i, isRespawned() is true if it jumped to its other position this frame
+    bool isRespawned(uint32_t frameIndex, uint32_t objectIndex) const {
+      return frameIndex > 0 && objectIndex % 97 == frameIndex % 97;
+    }
+
+    void generateFrame(uint32_t frameIndex, SceneReplay::Frame& frame) {
+      frame.clear();
+      frame.frameIndex = frameIndex;
+
+      for (uint32_t i = 0; i < m_objectCount; ++i) {
+        // Roughly 1% of the objects respawn every frame to exercise instance turnover
+        if (isRespawned(frameIndex, i)) {
+          m_isInRespawnRegion[i] = !m_isInRespawnRegion[i];
+        }
+
+        Vector3 position = getLatticePosition(i);
+        if (m_isInRespawnRegion[i]) {
+          position.z += kRespawnRegionOffset;
+        }
+        // Every 10th object circles around its lattice point, moving a few units per frame
+        if (i % 10 == 0) {
+          const float angle = 0.1f * float(frameIndex);
+          position = position + Vector3(100.f * std::sin(angle), 0.f, 100.f * std::cos(angle));
+        }
+
+        SceneReplay::DrawRecord& draw = frame.draws.emplace_back();
+        const uint32_t mesh = i % m_meshCount;
+        const XXH64_hash_t meshHash = XXH3_64bits(&mesh, sizeof(mesh));
+        for (uint32_t c = 0; c < SceneReplay::kGeometryHashComponentCount; ++c) {
+          draw.geometryHashes[c] = meshHash ^ (c + 1);
+        }
+        draw.materialHash = meshHash ^ 0x100;
+        draw.objectToWorld = translationMatrix(position);
+        draw.boundingBoxMin = Vector3(-1.f);
+        draw.boundingBoxMax = Vector3(1.f);
+        draw.vertexCount = 1024;
+        draw.indexCount = 3072;
+        draw.cameraType = static_cast<uint32_t>(CameraType::Main);
+      }
+
+      for (uint32_t i = 0; i < 64; ++i) {
+        SceneReplay::LightRecord& light = frame.lights.emplace_back();
+        light.hash = XXH3_64bits(&i, sizeof(i)) ^ (frameIndex / 200);
+        light.position = Vector3(float(i) * 10.f, 0.f, 0.f);
+        light.radius = 1.f;
+      }
+    }
+
+  private:
+    static constexpr uint32_t kLatticeSize = 32;
+    static constexpr float kLatticeSpacing = 2000.f;
+    // Beyond the extent of the lattice, so respawned objects never come close to other objects
+    static constexpr float kRespawnRegionOffset = 100000.f;
+
+    static Vector3 getLatticePosition(uint32_t objectIndex) {
+      const float x = float(objectIndex % kLatticeSize);
+      const float y = float((objectIndex / kLatticeSize) % kLatticeSize);
+      const float z = float(objectIndex / (kLatticeSize * kLatticeSize));
+      return Vector3(x, y, z) * kLatticeSpacing;
+    }
+
+    uint32_t m_objectCount;
+    uint32_t m_meshCount;
+    std::vector<bool> m_isInRespawnRegion;
+  };
+
+  // Objects keep their BLAS entry (one per mesh) and instance unless they respawned
+  void checkSyntheticOutcomes(const SyntheticScene& scene, uint32_t frameIndex, const std::vector<DrawOutcome>& previous, const std::vector<DrawOutcome>& current) {
+    for (uint32_t i = 0; i < current.size(); ++i) {
+      const DrawOutcome& outcome = current[i];
+      if (frameIndex == 0) {
+        check(outcome.isNewInstance, "every object must get its own instance on the first frame");
+        check(outcome.isNewBlas == (i < scene.getMeshCount()), "only the first draw of each mesh may create a BLAS entry");
+        continue;
+      }
+
+      check(!outcome.isNewBlas, "a mesh drawn every frame must keep its BLAS entry");
+      check(outcome.blas == previous[i].blas, "a draw call must be matched to the BLAS entry of its mesh");
+      if (!scene.isRespawned(frameIndex, i)) {
+        check(!outcome.isNewInstance && outcome.instanceId == previous[i].instanceId, "a static or moving object must keep its instance");
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string capturePath;
+  std::string jsonPath;
+  uint32_t maxFrames = UINT32_MAX;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      maxFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else {
+      capturePath = argv[i];
+    }
+  }
+
+  try {
+    // No config files are loaded, the options keep their defaults
+    RtxOptionImpl::s_isInitialized = true;
+    RtxOptionManager::applyPendingValues(nullptr);
+
+    SceneReplayer replayer;
+    SceneReplay::Frame frame;
+    std::vector<DrawOutcome> outcomes;
+
+    if (!capturePath.empty()) {
+      SceneReplay::Reader reader;
+      if (!reader.open(capturePath)) {
+        std::cerr << "Failed to open scene replay capture " << capturePath << std::endl;
+        return 1;
+      }
+
+      for (uint32_t i = 0; i < maxFrames && reader.readFrame(frame); ++i) {
+        replayer.replayFrame(frame, outcomes);
+      }
+    } else {
+      constexpr uint32_t kSyntheticObjects = 20000;
+      constexpr uint32_t kSyntheticMeshes = 500;
+      SyntheticScene scene(kSyntheticObjects, kSyntheticMeshes);
+      std::vector<DrawOutcome> previousOutcomes;
+
+      const uint32_t frameCount = std::min(maxFrames, 300u);
+      for (uint32_t i = 0; i < frameCount; ++i) {
+        scene.generateFrame(i, frame);
+        replayer.replayFrame(frame, outcomes);
+
+        checkSyntheticOutcomes(scene, i, previousOutcomes, outcomes);
+        check(replayer.getLiveInstanceCount() == kSyntheticObjects, "instances of respawned objects must be collected");
+        std::swap(previousOutcomes, outcomes);
+      }
+      check(replayer.getBlasCreatedCount() == kSyntheticMeshes, "each mesh must have a single BLAS entry");
+    }
+
+    replayer.report(jsonPath);
+  }
+  catch (const DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/rtx_render/rtx_blas_merge_planner.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_blas_merge_planner.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static void serialFor(uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+      for (uint32_t i = 0; i < taskCount; i++) {
+        task(i);
+      }
+    }
+
+    // Hands tasks out to a few threads in a nondeterministic order
+    static void threadedFor(uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+      std::atomic<uint32_t> nextTask = 0;
+      std::vector<std::thread> threads;
+
+      for (uint32_t t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+          for (uint32_t i = nextTask++; i < taskCount; i = nextTask++) {
+            task(i);
+          }
+        });
+      }
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+
+    // Synthetic scene: a few instance states shared by many merged instances, and BLAS
+    // entries referenced by one or more dynamic instances, with pointer-like keys
+    static void fillItems(BlasMergePlanner& planner, uint32_t itemCount, uint32_t seed) {
+      std::mt19937 random(seed);
+      planner.reset(itemCount);
+
+      for (uint32_t i = 0; i < itemCount; i++) {
+        BlasMergePlanner::Item& item = planner.item(i);
+
+        if (random() % 3 == 0) {
+          item.kind = BlasMergePlanner::Kind::Dynamic;
+          item.key = 0x00007ff000000000ull + (random() % (itemCount / 2 + 1)) * 0x140;
+          item.geometryCount = 1;
+        } else {
+          item.kind = BlasMergePlanner::Kind::Merged;
+          item.key = (uint64_t(random() % 4) << 20) | (uint64_t(0xff) << 12) | (random() % 2);
+          item.geometryCount = random() % 8 == 0 ? random() % 16 : 1;
+        }
+      }
+    }
+
+    static void checkPlan(BlasMergePlanner& planner) {
+      const uint32_t itemCount = planner.getItemCount();
+
+      // Reference: stable sort by kind, then key
+      std::vector<uint32_t> reference(itemCount);
+      for (uint32_t i = 0; i < itemCount; i++) {
+        reference[i] = i;
+      }
+
+      std::stable_sort(reference.begin(), reference.end(), [&planner] (uint32_t a, uint32_t b) {
+        const BlasMergePlanner::Item& itemA = planner.item(a);
+        const BlasMergePlanner::Item& itemB = planner.item(b);
+        return itemA.kind != itemB.kind ? itemA.kind < itemB.kind : itemA.key < itemB.key;
+      });
+
+      check(planner.sortedItems() == reference, "items must be stably sorted by kind and key");
+
+      uint32_t mergedItemOffset = 0;
+      while (mergedItemOffset < itemCount && planner.item(reference[mergedItemOffset]).kind == BlasMergePlanner::Kind::Dynamic) {
+        mergedItemOffset++;
+      }
+      check(planner.getMergedItemOffset() == mergedItemOffset, "merged items must follow the dynamic items");
+
+      // Groups must tile the sorted items, each holding exactly one key
+      uint32_t nextItem = 0;
+      uint32_t nextGeometry = 0;
+
+      for (const auto* groups : { &planner.dynamicGroups(), &planner.mergedGroups() }) {
+        for (const BlasMergePlanner::Group& group : *groups) {
+          check(group.firstItem == nextItem && group.itemCount > 0, "groups must be contiguous and non-empty");
+
+          const BlasMergePlanner::Item& first = planner.item(reference[group.firstItem]);
+          const bool merged = first.kind == BlasMergePlanner::Kind::Merged;
+          uint32_t geometryCount = 0;
+
+          if (merged) {
+            check(group.firstGeometry == nextGeometry, "merged group geometries must be contiguous");
+          }
+
+          for (uint32_t i = group.firstItem; i < group.firstItem + group.itemCount; i++) {
+            const BlasMergePlanner::Item& item = planner.item(reference[i]);
+            check(item.kind == first.kind && item.key == first.key, "a group must hold a single kind and key");
+
+            if (merged) {
+              check(planner.geometryOffsets()[i - mergedItemOffset] == nextGeometry, "merged items must have packed geometry offsets");
+              nextGeometry += item.geometryCount;
+              geometryCount += item.geometryCount;
+            }
+          }
+
+          if (merged) {
+            check(group.geometryCount == geometryCount, "merged group geometry counts must match their items");
+          }
+
+          if (group.firstItem + group.itemCount < itemCount) {
+            const BlasMergePlanner::Item& next = planner.item(reference[group.firstItem + group.itemCount]);
+            check(next.kind != first.kind || next.key != first.key, "equal keys must not be split over groups");
+          }
+
+          nextItem += group.itemCount;
+        }
+      }
+
+      check(nextItem == itemCount, "groups must cover all items");
+      check(planner.getGeometryCount() == nextGeometry, "total geometry count must match");
+    }
+
+    void testSmallPlans() {
+      BlasMergePlanner planner;
+
+      for (uint32_t itemCount : { 0u, 1u, 2u, 17u, 1000u }) {
+        fillItems(planner, itemCount, itemCount);
+        planner.plan(serialFor);
+        checkPlan(planner);
+      }
+    }
+
+    // Many batches, run on threads, and reusing the planner between frames of different sizes
+    void testLargePlans() {
+      BlasMergePlanner planner;
+
+      for (uint32_t itemCount : { 60000u, 4096u * 3u, 50001u }) {
+        fillItems(planner, itemCount, itemCount * 7);
+        planner.plan(threadedFor);
+        checkPlan(planner);
+      }
+    }
+
+    void run() {
+      testSmallPlans();
+      testLargePlans();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
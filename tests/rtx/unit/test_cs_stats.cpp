@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include "../../test_utils.h"
+#include "../../../src/dxvk/dxvk_cs_stats.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_cs_stats.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    void testCountBuckets() {
+      check(DxvkCsStats::countBucket(0) == 0, "zero must land in bucket 0");
+      check(DxvkCsStats::countBucket(1) == 1, "1 must land in bucket 1");
+
+      // Bucket n holds [2^(n-1), 2^n)
+      for (uint32_t bucket = 2; bucket < DxvkCsFrameStats::CountBuckets - 1; bucket++) {
+        const size_t low = size_t(1) << (bucket - 1);
+        check(DxvkCsStats::countBucket(low) == bucket, "lower bound of a bucket misplaced");
+        check(DxvkCsStats::countBucket(2 * low - 1) == bucket, "upper bound of a bucket misplaced");
+      }
+
+      // The last bucket also holds everything larger
+      const uint32_t lastBucket = DxvkCsFrameStats::CountBuckets - 1;
+      check(DxvkCsStats::countBucket(size_t(1) << (lastBucket - 1)) == lastBucket, "lower bound of the last bucket misplaced");
+      check(DxvkCsStats::countBucket(~size_t(0)) == lastBucket, "large values must clamp to the last bucket");
+    }
+
+    void testFillBuckets() {
+      constexpr size_t capacity = 16384;
+      constexpr size_t bucketSize = capacity / DxvkCsFrameStats::FillBuckets;
+
+      check(DxvkCsStats::fillBucket(0, capacity) == 0, "an empty chunk must land in bucket 0");
+      for (uint32_t bucket = 0; bucket < DxvkCsFrameStats::FillBuckets; bucket++) {
+        check(DxvkCsStats::fillBucket(bucket * bucketSize, capacity) == bucket, "lower bound of a fill bucket misplaced");
+        check(DxvkCsStats::fillBucket((bucket + 1) * bucketSize - 1, capacity) == bucket, "upper bound of a fill bucket misplaced");
+      }
+      check(DxvkCsStats::fillBucket(capacity, capacity) == DxvkCsFrameStats::FillBuckets - 1, "a full chunk must land in the last bucket");
+    }
+
+    void testFrames() {
+      DxvkCsStats stats;
+      stats.recordChunk(0, 0, 0, 1024);
+      stats.recordChunk(5, 2, 1024, 1024);
+      stats.recordChunk(100, 0, 500, 1024);
+      stats.recordQueueDepth(3);
+      stats.recordQueueDepth(1);
+      stats.recordStall(DxvkCsStallReason::QueueFull, 2000);
+      stats.endFrame(1);
+
+      DxvkCsFrameStats frame = stats.lastFrame();
+      check(frame.frameId == 1, "frame id mismatch");
+      check(frame.chunkCount == 3 && frame.commandCount == 105 && frame.dataCommandCount == 2, "chunk counters mismatch");
+      check(frame.chunkBytes == 1524 && frame.maxQueueDepth == 3, "chunk bytes or queue depth mismatch");
+      check(frame.chunkFill[0] == 1 && frame.chunkFill[3] == 1 && frame.chunkFill[DxvkCsFrameStats::FillBuckets - 1] == 1, "fill histogram mismatch");
+      check(frame.commandsPerChunk[0] == 1 && frame.commandsPerChunk[3] == 1 && frame.commandsPerChunk[7] == 1, "commands per chunk histogram mismatch");
+      check(frame.queueDepth[1] == 1 && frame.queueDepth[2] == 1, "queue depth histogram mismatch");
+      check(frame.stallCount[uint32_t(DxvkCsStallReason::QueueFull)] == 1 && frame.stallNs[uint32_t(DxvkCsStallReason::QueueFull)] == 2000, "stall mismatch");
+
+      // Histograms start over with every frame
+      stats.recordChunk(1, 0, 10, 1024);
+      stats.endFrame(2);
+      frame = stats.lastFrame();
+      check(frame.chunkCount == 1 && frame.maxQueueDepth == 0, "counters must be reset by endFrame");
+      check(frame.chunkFill[0] == 1 && frame.commandsPerChunk[1] == 1 && frame.queueDepth[1] == 0, "histograms must be reset by endFrame");
+    }
+
+    void run() {
+      testCountBuckets();
+      testFillBuckets();
+      testFrames();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
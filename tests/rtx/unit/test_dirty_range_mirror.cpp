@@ -0,0 +1,185 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <random>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/rtx_render/rtx_dirty_range_mirror.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_dirty_range_mirror.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static constexpr size_t kRecordSize = 64;
+
+    // Diffs a frame against the mirror and applies the dirty ranges to a simulated device buffer
+    static void uploadFrame(DirtyRangeMirror& mirror, std::vector<uint8_t>& device, const std::vector<uint8_t>& frame) {
+      mirror.begin(frame.size());
+      mirror.update(0, frame.data(), frame.size());
+
+      if (device.size() < frame.size()) {
+        device.resize(frame.size(), 0xcd);
+      }
+
+      size_t previousEnd = 0;
+      for (const DirtyRangeMirror::Range& range : mirror.getDirtyRanges()) {
+        check(range.size > 0 && range.offset % kRecordSize == 0 && range.size % kRecordSize == 0, "ranges must cover whole records");
+        check(range.offset >= previousEnd && range.offset + range.size <= frame.size(), "ranges must be ordered and in bounds");
+        std::copy(mirror.data() + range.offset, mirror.data() + range.offset + range.size, device.begin() + range.offset);
+        previousEnd = range.offset + range.size;
+      }
+
+      check(std::equal(frame.begin(), frame.end(), device.begin()), "device buffer must match the frame");
+    }
+
+    static void setRecord(std::vector<uint8_t>& frame, size_t record, uint8_t value) {
+      std::fill(frame.begin() + record * kRecordSize, frame.begin() + (record + 1) * kRecordSize, value);
+    }
+
+    void testStaticFrames() {
+      DirtyRangeMirror mirror(kRecordSize, 2);
+      std::vector<uint8_t> device;
+      std::vector<uint8_t> frame(100 * kRecordSize);
+
+      for (size_t i = 0; i < 100; i++) {
+        setRecord(frame, i, uint8_t(i));
+      }
+
+      uploadFrame(mirror, device, frame);
+      check(mirror.getDirtySize() == frame.size(), "first frame must be uploaded in full");
+
+      uploadFrame(mirror, device, frame);
+      check(mirror.getDirtyRanges().empty(), "unchanged frame must not upload anything");
+    }
+
+    void testCoalescing() {
+      DirtyRangeMirror mirror(kRecordSize, 2);
+      std::vector<uint8_t> device;
+      std::vector<uint8_t> frame(100 * kRecordSize);
+      uploadFrame(mirror, device, frame);
+
+      // 10 and 13 are two clean records apart and merge, 20 is too far away
+      setRecord(frame, 10, 1);
+      setRecord(frame, 13, 1);
+      setRecord(frame, 20, 1);
+      uploadFrame(mirror, device, frame);
+
+      const auto& ranges = mirror.getDirtyRanges();
+      check(ranges.size() == 2, "nearby dirty records must be coalesced");
+      check(ranges[0].offset == 10 * kRecordSize && ranges[0].size == 4 * kRecordSize, "coalesced range must span both records");
+      check(ranges[1].offset == 20 * kRecordSize && ranges[1].size == kRecordSize, "distant record must get its own range");
+    }
+
+    void testResizeAndInvalidate() {
+      DirtyRangeMirror mirror(kRecordSize, 0);
+      std::vector<uint8_t> device;
+      std::vector<uint8_t> frame(10 * kRecordSize, 7);
+      uploadFrame(mirror, device, frame);
+
+      // Shrinking uploads nothing, growing back uploads the tail even though the bytes match the old contents
+      frame.resize(4 * kRecordSize);
+      uploadFrame(mirror, device, frame);
+      check(mirror.getDirtyRanges().empty(), "shrinking must not upload anything");
+
+      frame.resize(10 * kRecordSize, 7);
+      uploadFrame(mirror, device, frame);
+      check(mirror.getDirtySize() == 6 * kRecordSize, "grown records must be uploaded");
+
+      // A new device buffer has unknown contents
+      mirror.invalidate();
+      device.assign(device.size(), 0xcd);
+      uploadFrame(mirror, device, frame);
+      check(mirror.getDirtySize() == frame.size(), "invalidated mirror must upload everything");
+    }
+
+    // Spans of several arrays packed back to back, as done for the TLAS instance lists
+    void testMultipleSpans() {
+      DirtyRangeMirror mirror(kRecordSize, 0);
+      std::vector<uint8_t> first(3 * kRecordSize, 1);
+      std::vector<uint8_t> second(5 * kRecordSize, 2);
+
+      for (uint32_t frameIndex = 0; frameIndex < 2; frameIndex++) {
+        mirror.begin(first.size() + second.size());
+        mirror.update(0, first.data(), first.size());
+        mirror.update(first.size(), second.data(), second.size());
+      }
+
+      check(mirror.getDirtyRanges().empty(), "unchanged spans must not upload anything");
+
+      second[kRecordSize] = 3;
+      mirror.begin(first.size() + second.size());
+      mirror.update(0, first.data(), first.size());
+      mirror.update(first.size(), second.data(), second.size());
+
+      const auto& ranges = mirror.getDirtyRanges();
+      check(ranges.size() == 1 && ranges[0].offset == 4 * kRecordSize && ranges[0].size == kRecordSize, "only the changed record must be dirty");
+      check(mirror.data()[4 * kRecordSize] == 3, "mirror must hold the new contents");
+    }
+
+    // Random edits over many frames, the device buffer must always end up matching
+    void testRandomFrames() {
+      std::mt19937 random(1234);
+      DirtyRangeMirror mirror(kRecordSize, 3);
+      std::vector<uint8_t> device;
+      std::vector<uint8_t> frame;
+
+      for (uint32_t frameIndex = 0; frameIndex < 200; frameIndex++) {
+        frame.resize((random() % 300) * kRecordSize, 0);
+
+        for (uint32_t edit = random() % 20; edit > 0 && !frame.empty(); edit--) {
+          frame[random() % frame.size()] = uint8_t(random());
+        }
+
+        if (random() % 50 == 0) {
+          mirror.invalidate();
+          device.assign(device.size(), 0xcd);
+        }
+
+        uploadFrame(mirror, device, frame);
+      }
+    }
+
+    void run() {
+      testStaticFrames();
+      testCoalescing();
+      testResizeAndInvalidate();
+      testMultipleSpans();
+      testRandomFrames();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
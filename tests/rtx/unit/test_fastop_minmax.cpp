@@ -21,6 +21,7 @@
 */
 #include <cstring>
 #include <random>
+#include <vector>
 #include "../../test_utils.h"
 #include "../../../src/util/util_fastops.h"
 #include "../../../src/util/util_timer.h"
@@ -88,6 +89,9 @@ namespace fast {
   extern void findMinMaxWithsentinelValue32_SSE(const uint32_t count, const uint32_t* data, uint32_t& minOut, uint32_t& maxOut, const uint32_t sentinelValue);
   extern void findMinMaxWithsentinelValue32_AVX2(const uint32_t count, const uint32_t* data, uint32_t& minOut, uint32_t& maxOut, const uint32_t sentinelValue);
 
+  extern void findMinMaxStrided8x4_slow(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut);
+  extern void findMinMaxStrided8x4_SSE(const uint32_t count, const uint8_t* data, const uint32_t stride, const uint32_t componentCount, uint32_t& minOut, uint32_t& maxOut);
+
 class MinMaxTestApp {
 public:
   static void run() { 
@@ -98,9 +102,55 @@ public:
     std::cout << std::endl << "Begin test (32-bit)" << std::endl;
     test_smoke<uint32_t>();
     test_correctness<uint32_t>();
+
+    std::cout << std::endl << "Begin test (strided 8-bit)" << std::endl;
+    test_strided8x4();
   }
   
 private:
+  static void test_strided8x4() {
+    std::random_device rd;
+    std::mt19937 rng(rd());
+    std::uniform_int_distribution<uint32_t> uni(16, 200);
+
+    // Vertex layouts: tightly packed indices and indices interleaved with other attributes
+    const uint32_t strides[] = { 4, 20, 36 };
+    const uint32_t count = 64 * 1024 + 3;
+
+    for (const uint32_t stride : strides) {
+      std::vector<uint8_t> data(count * stride);
+      for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < stride; j++) {
+          data[i * stride + j] = (uint8_t) uni(rng);
+        }
+        // Padding past the used components must be ignored
+        data[i * stride + 3] = (i % 2) ? 0 : 255;
+      }
+
+      for (uint32_t componentCount = 1; componentCount <= 4; componentCount++) {
+        std::cout << "Running: findMinMaxStrided8x4, stride " << stride << ", components " << componentCount << std::endl;
+        uint32_t min, max;
+        uint32_t min2, max2;
+        fast::findMinMaxStrided8x4_slow(count, data.data(), stride, componentCount, min, max);
+        fast::findMinMaxStrided8x4_SSE(count, data.data(), stride, componentCount, min2, max2);
+        if (min2 != min || max2 != max)
+          throw dxvk::DxvkError("Min/Max not matching findMinMaxStrided8x4_SSE");
+
+        if (componentCount == 4 ? (min != 0 || max != 255) : (min < 16 || max > 200))
+          throw dxvk::DxvkError("Min/Max not matching findMinMaxStrided8x4 padding check");
+      }
+    }
+
+    const uint8_t data1[] = { 7, 3, 9, 0, 12, 5, 4, 0, 8, 2, 11, 0 };
+    uint32_t min, max;
+    fast::findMinMaxStrided8x4(3, data1, 4, 3, min, max);
+
+    if (2 != min || 12 != max)
+      throw dxvk::DxvkError("Min/Max not matching strided correctness check");
+
+    std::cout << "Strided Min/Max fast ops successfully tested" << std::endl;
+  }
+
   template<typename T>
   static void test_smoke() {
     std::random_device rd;
@@ -0,0 +1,198 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../../test_utils.h"
+#include "../../../src/util/util_fastops.h"
+#include "../../../src/util/util_timer.h"
+
+using namespace dxvk;
+
+namespace fast {
+  extern bool anyVectorDistanceAbove_slow(const float* a, const float* b, const uint32_t firstVector, const uint32_t endVector, const uint32_t componentCount, const float deltaSq);
+  extern bool anyVectorDistanceAbove_SSE(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq);
+  extern bool anyVectorDistanceAbove_AVX2(const float* a, const float* b, uint32_t& compared, const uint32_t end, const uint32_t componentCount, const float deltaSq);
+
+class VectorDeltaTestApp {
+public:
+  static void run() {
+    std::cout << "Begin test (anyVectorDistanceAbove)" << std::endl;
+    test_smoke();
+    test_correctness();
+    std::cout << "Begin test (copyStridedAndCompare)" << std::endl;
+    test_copyStridedAndCompare();
+  }
+
+private:
+  static constexpr float kDelta = 0.01f;
+  static constexpr float kDeltaSq = kDelta * kDelta;
+
+  // Reference implementation of the per-vector comparison done by the capturer
+  static bool reference(const std::vector<float>& a, const std::vector<float>& b, const uint32_t count, const uint32_t componentCount, const float deltaSq) {
+    return anyVectorDistanceAbove_slow(a.data(), b.data(), 0, count, componentCount, deltaSq);
+  }
+
+  // Runs every SIMD implementation over whole blocks, then the scalar tail, like the dispatcher does
+  static void checkAllISAs(const std::vector<float>& a, const std::vector<float>& b, const uint32_t count, const uint32_t componentCount, const float deltaSq) {
+    const bool expected = reference(a, b, count, componentCount, deltaSq);
+
+    const auto finish = [&](bool differs, uint32_t compared) {
+      return differs || anyVectorDistanceAbove_slow(a.data(), b.data(), compared / componentCount, count, componentCount, deltaSq);
+    };
+
+    uint32_t compared = 0;
+    if (finish(anyVectorDistanceAbove_SSE(a.data(), b.data(), compared, count * componentCount, componentCount, deltaSq), compared) != expected) {
+      throw dxvk::DxvkError("Output not matching anyVectorDistanceAbove_SSE");
+    }
+    if (fast::getSimdSupportLevel() >= SIMD::AVX2) {
+      compared = 0;
+      if (finish(anyVectorDistanceAbove_AVX2(a.data(), b.data(), compared, count * componentCount, componentCount, deltaSq), compared) != expected) {
+        throw dxvk::DxvkError("Output not matching anyVectorDistanceAbove_AVX2");
+      }
+    }
+    if (fast::anyVectorDistanceAbove(count, a.data(), b.data(), componentCount, deltaSq) != expected) {
+      throw dxvk::DxvkError("Output not matching anyVectorDistanceAbove");
+    }
+  }
+
+  static void test_smoke() {
+    std::random_device rd;
+    std::mt19937 rng(rd());
+    std::uniform_real_distribution<float> uni(-100.f, 100.f);
+
+    const uint32_t count = 64 * 1024 + 3;
+    for (uint32_t componentCount = 1; componentCount <= 4; componentCount++) {
+      std::vector<float> a(count * componentCount);
+      for (float& value : a) {
+        value = uni(rng);
+      }
+      std::vector<float> b = a;
+
+      std::cout << "Running smoke check, components: " << componentCount << " --> ";
+      {
+        Timer time;
+        if (fast::anyVectorDistanceAbove(count, a.data(), b.data(), componentCount, kDeltaSq)) {
+          throw dxvk::DxvkError("Identical buffers reported as different");
+        }
+      }
+
+      // A single moved vector at the very end must still be found
+      b[(count - 1) * componentCount] += 1.f;
+      checkAllISAs(a, b, count, componentCount, kDeltaSq);
+      if (!fast::anyVectorDistanceAbove(count, a.data(), b.data(), componentCount, kDeltaSq)) {
+        throw dxvk::DxvkError("Moved vector not found");
+      }
+    }
+
+    std::cout << "Vector delta fast ops successfully smoke tested" << std::endl;
+  }
+
+  static void test_correctness() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> uni(-1.f, 1.f);
+
+    // Moves spread over all components just below and above the threshold, where the per-float
+    // prefilter cannot decide alone and vectors straddle 8 float blocks
+    for (uint32_t componentCount = 1; componentCount <= 4; componentCount++) {
+      for (const uint32_t count : { 7u, 33u, 100u, 1031u }) {
+        for (const float scale : { 0.f, 0.5f, 0.99f, 1.01f, 2.f }) {
+          for (uint32_t trial = 0; trial < 16; trial++) {
+            std::vector<float> a(count * componentCount);
+            for (float& value : a) {
+              value = uni(rng);
+            }
+            std::vector<float> b = a;
+            const uint32_t moved = rng() % count;
+            const float perComponent = kDelta * scale / std::sqrt((float) componentCount);
+            for (uint32_t c = 0; c < componentCount; c++) {
+              b[moved * componentCount + c] += perComponent;
+            }
+            checkAllISAs(a, b, count, componentCount, kDeltaSq);
+            checkAllISAs(a, b, count, componentCount, 0.f);
+          }
+        }
+      }
+    }
+
+    std::cout << "Vector delta fast ops successfully tested for correctness" << std::endl;
+  }
+
+  static void test_copyStridedAndCompare() {
+    std::mt19937 rng(5678);
+    std::uniform_real_distribution<float> uni(-10.f, 10.f);
+
+    // Positions in an interleaved vertex (position, normal, texcoord) and tightly packed
+    const uint32_t count = 16 * 1024 + 5;
+    for (uint32_t componentCount = 1; componentCount <= 4; componentCount++) {
+      for (const uint32_t strideFloats : { componentCount, 8u }) {
+        const uint32_t stride = strideFloats * sizeof(float);
+        std::vector<float> src(count * strideFloats);
+        for (float& value : src) {
+          value = uni(rng);
+        }
+
+        std::vector<float> packed(count * componentCount);
+        if (!fast::copyStridedAndCompare(count, packed.data(), (const uint8_t*) src.data(), stride, componentCount, nullptr, kDeltaSq)) {
+          throw dxvk::DxvkError("No previous buffer must always differ");
+        }
+        for (uint32_t i = 0; i < count; i++) {
+          if (memcmp(&packed[i * componentCount], &src[i * strideFloats], componentCount * sizeof(float)) != 0) {
+            throw dxvk::DxvkError("Output not matching gathered source");
+          }
+        }
+
+        std::vector<float> next(count * componentCount);
+        if (fast::copyStridedAndCompare(count, next.data(), (const uint8_t*) src.data(), stride, componentCount, packed.data(), kDeltaSq)) {
+          throw dxvk::DxvkError("Identical buffers reported as different");
+        }
+
+        // A difference in the middle must be found, and everything after it must still be copied
+        src[(count / 2) * strideFloats] += 1.f;
+        src[(count - 1) * strideFloats] += 2.f;
+        if (!fast::copyStridedAndCompare(count, next.data(), (const uint8_t*) src.data(), stride, componentCount, packed.data(), kDeltaSq)) {
+          throw dxvk::DxvkError("Moved vector not found");
+        }
+        if (next[(count - 1) * componentCount] != src[(count - 1) * strideFloats]) {
+          throw dxvk::DxvkError("Output not copied past the first difference");
+        }
+      }
+    }
+
+    std::cout << "copyStridedAndCompare fast op successfully tested" << std::endl;
+  }
+};
+}
+
+int main() {
+  try {
+    fast::VectorDeltaTestApp::run();
+  }
+  catch (const dxvk::DxvkError& e) {
+    std::cerr << e.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <random>
+#include <unordered_map>
+#include "../../test_utils.h"
+#include "../../../src/util/util_flat_hash_map.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_flat_hash_map.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static void checkMatches(const fast_flat_map<uint64_t>& map, const std::unordered_map<XXH64_hash_t, uint64_t>& reference) {
+      check(map.size() == reference.size(), "sizes must match");
+      for (const auto& [key, value] : reference) {
+        const uint64_t* found = map.find(key);
+        check(found != nullptr && *found == value, "every reference entry must be found");
+      }
+    }
+
+    void testInsertAndFind() {
+      fast_flat_map<uint64_t> map;
+      check(map.empty() && map.find(42) == nullptr, "a new map must be empty");
+
+      auto [value, inserted] = map.emplace(42);
+      check(inserted && *value == 0, "emplace must default construct new values");
+      *value = 7;
+      auto [existing, insertedAgain] = map.emplace(42);
+      check(!insertedAgain && existing == value && *existing == 7, "emplace must return existing values");
+
+      map[43] = 8;
+      check(map.size() == 2 && map.contains(43) && *map.find(43) == 8, "operator[] must insert");
+
+      // Key 0 marks empty slots internally and is stored out of line
+      check(!map.contains(0), "key 0 must not be found before it is inserted");
+      map[0] = 9;
+      check(map.size() == 3 && *map.find(0) == 9, "key 0 must be stored");
+      check(map.erase(0) && !map.contains(0) && map.size() == 2, "key 0 must be erasable");
+    }
+
+    void testRehash() {
+      fast_flat_map<uint64_t> map;
+      std::unordered_map<XXH64_hash_t, uint64_t> reference;
+
+      // Growing through several rehashes must keep every entry
+      for (uint64_t i = 1; i <= 5000; ++i) {
+        const XXH64_hash_t key = i * 0x9E3779B97F4A7C15ull;
+        map[key] = i;
+        reference[key] = i;
+      }
+      checkMatches(map, reference);
+
+      fast_flat_map<uint64_t> reserved;
+      reserved.reserve(1000);
+      for (const auto& [key, value] : reference) {
+        reserved[key] = value;
+      }
+      checkMatches(reserved, reference);
+    }
+
+    void testCollisions() {
+      fast_flat_map<uint64_t> map;
+      std::unordered_map<XXH64_hash_t, uint64_t> reference;
+
+      // Keys sharing their low bits all land in the same home slot, building a single long cluster.
+      // The cluster starts at the last slot of the 16 slot table, so probing wraps around.
+      for (uint64_t i = 0; i < 7; ++i) {
+        const XXH64_hash_t key = (i << 32) | 15;
+        map[key] = i;
+        reference[key] = i;
+      }
+      checkMatches(map, reference);
+
+      // Erasing from the middle of the wrapped cluster must shift the rest back, so nothing is lost
+      for (uint64_t i : { 1ull, 4ull, 0ull }) {
+        const XXH64_hash_t key = (i << 32) | 15;
+        check(map.erase(key), "colliding keys must be erasable");
+        check(!map.erase(key), "an erased key must not be found again");
+        reference.erase(key);
+        checkMatches(map, reference);
+      }
+    }
+
+    void testEraseMatchesReference() {
+      fast_flat_map<uint64_t> map;
+      std::unordered_map<XXH64_hash_t, uint64_t> reference;
+      std::mt19937_64 random(7);
+
+      // Few distinct low bits force many collisions and backward shifts
+      for (uint32_t i = 0; i < 50000; ++i) {
+        const XXH64_hash_t key = (random() % 512) * 0x100000001ull;
+        if (random() % 3 == 0) {
+          check(map.erase(key) == (reference.erase(key) != 0), "erase must report whether the key was present");
+        } else {
+          map[key] = i;
+          reference[key] = i;
+        }
+      }
+      checkMatches(map, reference);
+
+      map.erase_if([](XXH64_hash_t, const uint64_t& value) { return (value & 1) != 0; });
+      for (auto it = reference.begin(); it != reference.end();) {
+        it = (it->second & 1) != 0 ? reference.erase(it) : std::next(it);
+      }
+      checkMatches(map, reference);
+
+      size_t visited = 0;
+      map.for_each([&](XXH64_hash_t key, uint64_t& value) {
+        check(reference.at(key) == value, "for_each must visit the stored entries");
+        ++visited;
+      });
+      check(visited == reference.size(), "for_each must visit every entry once");
+
+      map.clear();
+      check(map.empty() && map.find(reference.begin()->first) == nullptr, "clear must remove every entry");
+    }
+
+    void run() {
+      testInsertAndFind();
+      testRehash();
+      testCollisions();
+      testEraseMatchesReference();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <map>
+#include <memory>
+#include <random>
+#include "../../test_utils.h"
+#include "../../../src/util/util_flat_sorted_map.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_flat_sorted_map.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    // Random inserts and erases must leave the same ordered contents as std::map
+    void testMatchesStdMap() {
+      // Descending order, as used for option layer priorities
+      flat_sorted_map<uint32_t, uint32_t, std::greater<uint32_t>> map;
+      std::map<uint32_t, uint32_t, std::greater<uint32_t>> reference;
+      std::mt19937 random(42);
+
+      for (uint32_t i = 0; i < 10000; ++i) {
+        const uint32_t key = random() % 64;
+        if (random() % 3 == 0) {
+          check(map.erase(key) == reference.erase(key), "erase must report the same count");
+        } else {
+          auto [it, inserted] = map.emplace(key, i);
+          auto [referenceIt, referenceInserted] = reference.emplace(key, i);
+          check(inserted == referenceInserted, "emplace must only insert missing keys");
+          check(it->first == key && it->second == referenceIt->second, "emplace must return the entry for the key");
+        }
+
+        check(map.size() == reference.size(), "sizes must match");
+        auto referenceIt = reference.begin();
+        for (const auto& [entryKey, entryValue] : map) {
+          check(entryKey == referenceIt->first && entryValue == referenceIt->second, "entries must match in order");
+          ++referenceIt;
+        }
+      }
+
+      for (uint32_t key = 0; key < 64; ++key) {
+        const bool present = reference.count(key) > 0;
+        check((map.find(key) != map.end()) == present, "find must locate exactly the present keys");
+        if (present) {
+          check(map.at(key) == reference.at(key), "at must return the stored value");
+        }
+      }
+
+      if (!reference.empty()) {
+        check(map.begin()->first == reference.begin()->first, "begin must be the first key in order");
+        check(map.rbegin()->first == reference.rbegin()->first, "rbegin must be the last key in order");
+      }
+
+      bool threw = false;
+      try {
+        map.clear();
+        map.at(1);
+      } catch (const DxvkError&) {
+        threw = true;
+      }
+      check(threw && map.empty(), "at must throw for missing keys");
+    }
+
+    void testMoveOnlyValues() {
+      flat_sorted_map<uint32_t, std::unique_ptr<uint32_t>> map;
+      for (uint32_t key : { 5u, 1u, 3u }) {
+        map.emplace(key, std::make_unique<uint32_t>(key * 10));
+      }
+      uint32_t* three = map.at(3).get();
+
+      // Inserting in front moves the entries, but the owned objects stay put
+      map.emplace(0, std::make_unique<uint32_t>(0));
+      check(map.at(3).get() == three && *three == 30, "owned values must survive entries moving");
+
+      map.erase(map.find(1));
+      uint32_t expected[] = { 0, 3, 5 };
+      uint32_t i = 0;
+      for (const auto& [key, value] : map) {
+        check(key == expected[i] && *value == expected[i] * 10, "entries must stay sorted after erase");
+        ++i;
+      }
+    }
+
+    void run() {
+      testMatchesStdMap();
+      testMoveOnlyValues();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/util/util_frame_arena.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_frame_arena.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    using ArenaVector = std::vector<uint64_t, FrameArenaAllocator<uint64_t>>;
+
+    static bool isAligned(const void* ptr, size_t alignment) {
+      return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+    }
+
+    void testAllocation() {
+      FrameArena arena;
+
+      uint8_t* a = static_cast<uint8_t*>(arena.allocate(3, 1));
+      uint8_t* b = static_cast<uint8_t*>(arena.allocate(16, 16));
+      uint8_t* c = static_cast<uint8_t*>(arena.allocate(FrameArena::kBlockSize * 2, 64));
+      check(isAligned(b, 16) && isAligned(c, 64), "allocations must be aligned");
+      check(b >= a + 3, "allocations must not overlap");
+      memset(c, 0xff, FrameArena::kBlockSize * 2);
+
+      const FrameArena::Stats stats = arena.advanceFrame();
+      check(stats.allocationCount == 3, "allocation count mismatch");
+      check(stats.allocatedBytes == 3 + 16 + FrameArena::kBlockSize * 2, "allocated bytes mismatch");
+      check(stats.blockCount == 2, "expected one shared and one dedicated block");
+
+      // Frame 0 was not completed by the consumer yet, so its memory must not be recycled
+      uint8_t* d = static_cast<uint8_t*>(arena.allocate(3, 1));
+      check(d != a, "memory must not be recycled before the frame was completed");
+      check(arena.advanceFrame().blockCount == 3, "frame 1 must not reuse the blocks of frame 0");
+
+      uint8_t* e = static_cast<uint8_t*>(arena.allocate(3, 1));
+      check(e != a && e != d, "memory must not be recycled before the frame was completed");
+
+      // Completing frame 1 implies frame 0 was completed too, their blocks are recycled by the next advance
+      arena.completeFrame(1);
+      arena.completeFrame(0);
+      check(arena.advanceFrame().blockCount == 4, "blocks are only recycled when the frame advances");
+      uint8_t* f = static_cast<uint8_t*>(arena.allocate(3, 1));
+      check(f == a || f == d, "the blocks of completed frames should be recycled");
+
+      // The dedicated block is released rather than recycled
+      check(arena.advanceFrame().blockCount == 3, "dedicated blocks must be released");
+    }
+
+    void testLaggingConsumer() {
+      FrameArena arena;
+      std::vector<uint32_t*> allocations;
+
+      // The producer runs several frames ahead of the consumer, nothing may be overwritten until it caught up
+      for (uint32_t frame = 0; frame < 8; ++frame) {
+        for (uint32_t i = 0; i < 1000; ++i) {
+          uint32_t* ptr = static_cast<uint32_t*>(arena.allocate(sizeof(uint32_t), alignof(uint32_t)));
+          *ptr = frame * 1000 + i;
+          allocations.push_back(ptr);
+        }
+        arena.advanceFrame();
+
+        if (frame >= 4) {
+          arena.completeFrame(frame - 4);
+        }
+
+        for (uint32_t i = (frame >= 4 ? frame - 3 : 0) * 1000; i < allocations.size(); ++i) {
+          check(*allocations[i] == i, "memory of a frame the consumer did not complete was recycled");
+        }
+      }
+    }
+
+    void testRetiredBlock() {
+      FrameArena arena;
+      std::atomic<uint32_t> step = 0;
+      uint8_t* workerPtrs[2] = {};
+
+      // The worker keeps bumping through a block that the main thread retires and recycles in the meantime
+      std::thread worker([&]() {
+        workerPtrs[0] = static_cast<uint8_t*>(arena.allocate(64, 16));
+        step = 1;
+        while (step != 2) {
+          std::this_thread::yield();
+        }
+        workerPtrs[1] = static_cast<uint8_t*>(arena.allocate(64, 16));
+      });
+
+      while (step != 1) {
+        std::this_thread::yield();
+      }
+      arena.advanceFrame();
+      arena.completeFrame(0);
+      arena.advanceFrame();
+
+      // The recycled block of the worker is handed to this thread for the current frame
+      uint8_t* recycled = static_cast<uint8_t*>(arena.allocate(64, 16));
+      check(recycled <= workerPtrs[0] && workerPtrs[0] < recycled + FrameArena::kBlockSize, "the retired block must be recycled");
+      std::memset(recycled, 0xAB, FrameArena::kBlockSize / 8);
+
+      step = 2;
+      worker.join();
+      check(workerPtrs[1] < recycled || workerPtrs[1] >= recycled + FrameArena::kBlockSize,
+            "an allocation must never land in a block retired since the thread acquired it");
+    }
+
+    void testAllocator() {
+      FrameArena arena;
+
+      ArenaVector transient { FrameArenaAllocator<uint64_t>(&arena) };
+      for (uint64_t i = 0; i < 100; ++i) {
+        transient.push_back(i);
+      }
+      check(transient.get_allocator().getArena() == &arena, "vector must allocate from the arena");
+
+      // Moving keeps the arena memory
+      const uint64_t* data = transient.data();
+      ArenaVector moved = std::move(transient);
+      check(moved.data() == data && moved.get_allocator().getArena() == &arena, "moves must keep the arena memory");
+
+      // Copies outlive the frame and must use the heap
+      ArenaVector copy = moved;
+      check(copy.get_allocator().getArena() == nullptr, "copies must allocate from the heap");
+
+      ArenaVector persistent;
+      persistent = moved;
+      check(persistent.get_allocator().getArena() == nullptr, "copy assignment must keep the heap allocator");
+      check(persistent == moved && copy == moved, "copied contents mismatch");
+    }
+
+    void testThreads() {
+      FrameArena arena;
+      constexpr uint32_t kThreads = 8;
+      constexpr uint32_t kAllocations = 20000;
+
+      for (uint32_t frame = 0; frame < 4; ++frame) {
+        std::vector<std::vector<uint32_t*>> allocations(kThreads);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < kThreads; ++t) {
+          threads.emplace_back([&, t] {
+            for (uint32_t i = 0; i < kAllocations; ++i) {
+              uint32_t* ptr = static_cast<uint32_t*>(arena.allocate(sizeof(uint32_t) * (1 + i % 7), alignof(uint32_t)));
+              *ptr = t * kAllocations + i;
+              allocations[t].push_back(ptr);
+            }
+          });
+        }
+        for (std::thread& thread : threads) {
+          thread.join();
+        }
+
+        // Every thread must have written to its own memory
+        for (uint32_t t = 0; t < kThreads; ++t) {
+          for (uint32_t i = 0; i < kAllocations; ++i) {
+            check(*allocations[t][i] == t * kAllocations + i, "allocations from different threads overlap");
+          }
+        }
+
+        const FrameArena::Stats stats = arena.advanceFrame();
+        check(stats.allocationCount == kThreads * kAllocations, "threaded allocation count mismatch");
+        arena.completeFrame(frame);
+      }
+    }
+
+    void run() {
+      testAllocation();
+      testLaggingConsumer();
+      testRetiredBlock();
+      testAllocator();
+      testThreads();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
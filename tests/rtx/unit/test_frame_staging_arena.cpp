@@ -0,0 +1,198 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/rtx_render/rtx_staging_chunks.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_frame_staging_arena.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    // Host memory stand-in for the arena's buffers, tracks what the arena does with them
+    struct HostChunk {
+      std::vector<uint8_t> memory;
+      int acquireCount = 0;
+      bool inUse = false;
+    };
+
+    class HostChunkSource {
+    public:
+      using Chunk = std::shared_ptr<HostChunk>;
+
+      Chunk createChunk(size_t size) {
+        Chunk chunk = std::make_shared<HostChunk>();
+        chunk->memory.resize(size);
+        created.push_back(chunk);
+        return chunk;
+      }
+
+      size_t chunkSize(const Chunk& chunk) const { return chunk->memory.size(); }
+      uint8_t* chunkData(const Chunk& chunk) const { return chunk->memory.data(); }
+      bool isInUse(const Chunk& chunk) const { return chunk->inUse; }
+      void acquire(const Chunk& chunk) const { ++chunk->acquireCount; }
+      void release(const Chunk& chunk) const { --chunk->acquireCount; }
+
+      std::vector<Chunk> created;
+    };
+
+    using Arena = RtxFrameStagingChunks<HostChunkSource>;
+
+    static constexpr size_t kChunkSize = 256;
+    static constexpr uint32_t kFramesInFlight = 2;
+
+    static bool holds(const Arena::Allocation& allocation, const void* data, size_t size) {
+      return allocation.length == size && allocation.offset + size <= allocation.chunk->memory.size() &&
+             memcmp(allocation.chunk->memory.data() + allocation.offset, data, size) == 0;
+    }
+
+    void testSubAllocation() {
+      Arena arena(HostChunkSource(), kChunkSize, kFramesInFlight);
+
+      const uint8_t a[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+      const uint8_t b[7] = { 11, 12, 13, 14, 15, 16, 17 };
+      const uint8_t c[5] = { 21, 22, 23, 24, 25 };
+
+      const Arena::Allocation allocA = arena.upload(a, sizeof(a), 16);
+      const Arena::Allocation allocB = arena.upload(b, sizeof(b), 16);
+      const Arena::Allocation allocC = arena.upload(c, sizeof(c), 4);
+      check(allocA.offset == 0 && allocB.offset == 16 && allocC.offset == 24, "uploads must be packed at their alignment");
+      check(allocA.chunk == allocB.chunk && allocB.chunk == allocC.chunk, "small uploads must share a chunk");
+      check(holds(allocA, a, sizeof(a)) && holds(allocB, b, sizeof(b)) && holds(allocC, c, sizeof(c)), "uploads must hold a copy of their data");
+
+      // Doesn't fit in what is left of the first chunk
+      std::vector<uint8_t> d(kChunkSize - 16, 0x5a);
+      const Arena::Allocation allocD = arena.upload(d.data(), d.size(), 16);
+      check(allocD.chunk != allocA.chunk && allocD.offset == 0, "an upload that doesn't fit must start a new chunk");
+      check(holds(allocA, a, sizeof(a)), "starting a chunk must not touch the previous one");
+
+      // Larger than a chunk
+      std::vector<uint8_t> e(kChunkSize * 3, 0xa5);
+      const Arena::Allocation allocE = arena.upload(e.data(), e.size(), 16);
+      check(allocE.offset == 0 && allocE.chunk->memory.size() == e.size() && holds(allocE, e.data(), e.size()), "oversized uploads get their own chunk");
+
+      for (const HostChunkSource::Chunk& chunk : arena.source().created) {
+        check(chunk->acquireCount == 1, "chunks must be acquired while the frame uses them");
+      }
+
+      const Arena::Stats stats = arena.endFrame();
+      check(stats.uploadCount == 5 && stats.dedupedCount == 0, "upload count mismatch");
+      check(stats.uploadedBytes == sizeof(a) + sizeof(b) + sizeof(c) + d.size() + e.size(), "uploaded bytes mismatch");
+      check(stats.chunkCount == 3 && arena.source().created.size() == 3, "chunk count mismatch");
+
+      for (const HostChunkSource::Chunk& chunk : arena.source().created) {
+        check(chunk->acquireCount == 0, "chunks must be released at the end of the frame");
+      }
+    }
+
+    void testDeduplication() {
+      Arena arena(HostChunkSource(), kChunkSize, kFramesInFlight);
+
+      const uint8_t data[12] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+      const Arena::Allocation first = arena.upload(data, sizeof(data), 4);
+      const Arena::Allocation second = arena.upload(data, sizeof(data), 4);
+      check(second.chunk == first.chunk && second.offset == first.offset, "identical uploads must share their copy");
+
+      // A prefix of earlier data is a different upload
+      const Arena::Allocation prefix = arena.upload(data, 8, 4);
+      check(prefix.offset != first.offset && holds(prefix, data, 8), "a prefix must not be deduplicated");
+
+      // Make the stored copy differ from data hashing to it, as a hash collision would. The byte compare must
+      // reject the match and upload a fresh copy.
+      first.chunk->memory[first.offset] ^= 0xff;
+      const Arena::Allocation third = arena.upload(data, sizeof(data), 4);
+      check(third.offset != first.offset && holds(third, data, sizeof(data)), "uploads must only be shared if the bytes match");
+
+      Arena::Stats stats = arena.endFrame();
+      check(stats.uploadCount == 3 && stats.dedupedCount == 1, "deduplication count mismatch");
+
+      // Deduplication is per frame
+      const Arena::Allocation nextFrame = arena.upload(data, sizeof(data), 4);
+      check(holds(nextFrame, data, sizeof(data)), "upload after the frame ended must hold its data");
+      stats = arena.endFrame();
+      check(stats.uploadCount == 1 && stats.dedupedCount == 0, "uploads must not be shared across frames");
+    }
+
+    void testRecycling() {
+      Arena arena(HostChunkSource(), kChunkSize, kFramesInFlight);
+      const uint32_t value = 0x12345678;
+
+      const HostChunkSource::Chunk frame0 = arena.upload(&value, sizeof(value), 4).chunk;
+      arena.endFrame();
+
+      // Frame 0 may still be read by the GPU for kFramesInFlight frames
+      const HostChunkSource::Chunk frame1 = arena.upload(&value, sizeof(value), 4).chunk;
+      check(frame1 != frame0, "chunks must not be recycled while their frame is in flight");
+      arena.endFrame();
+
+      const HostChunkSource::Chunk frame2 = arena.upload(&value, sizeof(value), 4).chunk;
+      check(frame2 == frame0, "chunks must be recycled once their frame is old enough");
+      arena.endFrame();
+
+      // The chunk of frame 1 is old enough now, but still in use
+      frame1->inUse = true;
+      const HostChunkSource::Chunk frame3 = arena.upload(&value, sizeof(value), 4).chunk;
+      check(frame3 != frame1 && frame3 != frame2, "chunks still in use must not be recycled");
+      arena.endFrame();
+
+      frame1->inUse = false;
+      const HostChunkSource::Chunk frame4 = arena.upload(&value, sizeof(value), 4).chunk;
+      check(frame4 == frame1, "chunks must be recycled once they are no longer in use");
+      arena.endFrame();
+
+      // Oversized uploads can't reuse a regular chunk, which is dropped instead
+      const size_t createdBefore = arena.source().created.size();
+      std::vector<uint8_t> large(kChunkSize * 2, 0x33);
+      const Arena::Allocation allocLarge = arena.upload(large.data(), large.size(), 4);
+      check(allocLarge.chunk->memory.size() == large.size() && arena.source().created.size() == createdBefore + 1,
+            "an oversized upload must get a new chunk");
+      arena.endFrame();
+
+      check(arena.source().created.size() == 4, "unexpected number of chunks created");
+    }
+
+    void run() {
+      testSubAllocation();
+      testDeduplication();
+      testRecycling();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
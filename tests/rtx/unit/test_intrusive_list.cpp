@@ -0,0 +1,162 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <list>
+#include <random>
+#include "../../test_utils.h"
+#include "../../../src/util/util_lru.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_intrusive_list.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    template<typename A, typename B>
+    static bool sameContents(const A& a, const B& b) {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    // Random operations on two lists sharing a pool must match two std::lists,
+    // including iterators held across splices between the lists
+    void testMatchesStdList() {
+      intrusive_list_pool<uint32_t> pool;
+      intrusive_list<uint32_t> a(pool);
+      intrusive_list<uint32_t> b(pool);
+      std::list<uint32_t> referenceA;
+      std::list<uint32_t> referenceB;
+
+      // Iterators into either list, by value, as the OMM cache items store them
+      std::vector<std::pair<intrusive_list<uint32_t>::iterator, std::list<uint32_t>::iterator>> iterators;
+      std::vector<bool> inA;
+      std::mt19937 random(42);
+
+      for (uint32_t i = 0; i < 20000; ++i) {
+        const uint32_t op = random() % 6;
+
+        if (op <= 1 || iterators.empty()) {
+          // Insert into A, at a random position or at the end
+          if (op == 0 && !iterators.empty() && inA[random() % inA.size()]) {
+            const size_t n = random() % iterators.size();
+            if (inA[n]) {
+              iterators.emplace_back(a.insert(iterators[n].first, i), referenceA.insert(iterators[n].second, i));
+              inA.push_back(true);
+              continue;
+            }
+          }
+          a.emplace_back(i);
+          referenceA.emplace_back(i);
+          iterators.emplace_back(std::prev(a.end()), std::prev(referenceA.end()));
+          inA.push_back(true);
+        } else if (op == 2) {
+          // Move between the lists
+          const size_t n = random() % iterators.size();
+          if (inA[n]) {
+            b.splice(b.end(), a, iterators[n].first);
+            referenceB.splice(referenceB.end(), referenceA, iterators[n].second);
+          } else {
+            a.splice(a.end(), b, iterators[n].first);
+            referenceA.splice(referenceA.end(), referenceB, iterators[n].second);
+          }
+          inA[n] = !inA[n];
+        } else if (op == 3) {
+          // Touch, moving an element to the end of its own list
+          const size_t n = random() % iterators.size();
+          auto& list = inA[n] ? a : b;
+          auto& reference = inA[n] ? referenceA : referenceB;
+          list.splice(list.end(), list, iterators[n].first);
+          reference.splice(reference.end(), reference, iterators[n].second);
+        } else {
+          const size_t n = random() % iterators.size();
+          if (inA[n]) {
+            a.erase(iterators[n].first);
+            referenceA.erase(iterators[n].second);
+          } else {
+            b.erase(iterators[n].first);
+            referenceB.erase(iterators[n].second);
+          }
+          iterators[n] = iterators.back();
+          inA[n] = inA.back();
+          iterators.pop_back();
+          inA.pop_back();
+        }
+
+        check(sameContents(a, referenceA), "first list must match");
+        check(sameContents(b, referenceB), "second list must match");
+      }
+
+      // Nodes are recycled, the pool never holds more than the peak element count
+      check(pool.capacity() <= 20000, "pool must recycle nodes");
+
+      a.clear();
+      b.clear();
+      check(a.empty() && b.empty() && a.begin() == a.end(), "clear must empty the lists");
+    }
+
+    // Touching must not grow the pool, and eviction order must follow use order
+    void testLruList() {
+      lru_list<uint64_t> lru;
+
+      for (uint64_t key = 0; key < 8; ++key) {
+        lru.insert(key);
+      }
+
+      lru.touch(0);
+      lru.touch(3);
+      lru.insert(5);
+      lru.remove(6);
+
+      const uint64_t expected[] = { 1, 2, 4, 7, 0, 3, 5 };
+      uint32_t i = 0;
+      for (auto iter = lru.leastRecentlyUsedIter(); iter != lru.leastRecentlyUsedEndIter(); ++iter) {
+        check(*iter == expected[i++], "entries must be ordered by use");
+      }
+      check(i == 7 && lru.size() == 7, "size must match");
+
+      lru.remove(lru.leastRecentlyUsedIter());
+      check(*lru.leastRecentlyUsedIter() == 2, "removing the LRU entry must expose the next one");
+
+      lru = lru_list<uint64_t>();
+      check(lru.size() == 0, "assigning an empty list must clear it");
+    }
+
+    void run() {
+      testMatchesStdList();
+      testLruList();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
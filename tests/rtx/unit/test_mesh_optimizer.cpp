@@ -0,0 +1,177 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/util/util_mesh_optimizer.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_mesh_optimizer.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    // Triangle list of a size x size quad grid, with its triangles shuffled to simulate a poor export order
+    static std::vector<uint32_t> makeShuffledGrid(const uint32_t size, const uint32_t seed) {
+      const uint32_t rowVertices = size + 1;
+      std::vector<std::array<uint32_t, 3>> triangles;
+      for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+          const uint32_t v = y * rowVertices + x;
+          triangles.push_back({ v, v + 1, v + rowVertices });
+          triangles.push_back({ v + 1, v + rowVertices + 1, v + rowVertices });
+        }
+      }
+      std::mt19937 rng(seed);
+      std::shuffle(triangles.begin(), triangles.end(), rng);
+
+      std::vector<uint32_t> indices;
+      for (const auto& triangle : triangles) {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+      }
+      return indices;
+    }
+
+    // Triangles as rotation independent keys, so winding is checked along with the triangle set
+    static std::vector<std::array<uint32_t, 3>> canonicalTriangles(const std::vector<uint32_t>& indices) {
+      std::vector<std::array<uint32_t, 3>> triangles;
+      for (size_t i = 0; i < indices.size(); i += 3) {
+        std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+      }
+      std::sort(triangles.begin(), triangles.end());
+      return triangles;
+    }
+
+    void testAcmr() {
+      // A single triangle always misses 3 times, repeating it hits every time
+      const std::vector<uint32_t> indices = { 0, 1, 2, 0, 1, 2 };
+      check(meshopt::computeAcmr(indices.data(), indices.size(), 3, 16) == 1.5f, "repeated triangle ACMR");
+
+      // Strip order on a 1 quad wide strip reuses 2 vertices per triangle
+      std::vector<uint32_t> strip;
+      for (uint32_t i = 0; i < 100; ++i) {
+        strip.insert(strip.end(), { i, i + 1, i + 2 });
+      }
+      const float stripAcmr = meshopt::computeAcmr(strip.data(), strip.size(), 102, 16);
+      check(stripAcmr > 1.0f && stripAcmr < 1.03f, "strip ACMR");
+
+      // A cache of 1 misses on every index that differs from the previous one
+      check(meshopt::computeAcmr(strip.data(), strip.size(), 102, 1) == 3.0f, "tiny cache ACMR");
+    }
+
+    void testVertexCache() {
+      constexpr uint32_t kGridSize = 64;
+      const uint32_t vertexCount = (kGridSize + 1) * (kGridSize + 1);
+      std::vector<uint32_t> indices = makeShuffledGrid(kGridSize, 7);
+      const auto triangles = canonicalTriangles(indices);
+
+      const float acmrBefore = meshopt::computeAcmr(indices.data(), indices.size(), vertexCount, meshopt::kVertexCacheSize);
+      meshopt::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+      const float acmrAfter = meshopt::computeAcmr(indices.data(), indices.size(), vertexCount, meshopt::kVertexCacheSize);
+
+      std::cout << "ACMR (cache " << meshopt::kVertexCacheSize << ") shuffled grid: " << acmrBefore << " -> " << acmrAfter << std::endl;
+      check(canonicalTriangles(indices) == triangles, "optimization must keep every triangle and its winding");
+      // A shuffled grid misses on almost every vertex, a cache friendly order gets close to the 0.5 bound
+      check(acmrBefore > 2.0f, "shuffled grid should be cache unfriendly");
+      check(acmrAfter < 0.8f, "optimized ACMR too high");
+      // Smaller hardware caches must benefit too
+      check(meshopt::computeAcmr(indices.data(), indices.size(), vertexCount, 16) < 0.9f, "optimized ACMR too high for a 16 entry cache");
+
+      // Degenerate and tiny inputs
+      std::vector<uint32_t> degenerate = { 0, 0, 1, 1, 2, 2, 0, 1, 2 };
+      meshopt::optimizeVertexCache(degenerate.data(), degenerate.size(), 3);
+      check(canonicalTriangles(degenerate) == canonicalTriangles({ 0, 0, 1, 1, 2, 2, 0, 1, 2 }), "degenerate triangles must be kept");
+      std::vector<uint32_t> single = { 2, 1, 0 };
+      meshopt::optimizeVertexCache(single.data(), single.size(), 3);
+      check(single == std::vector<uint32_t>({ 2, 1, 0 }), "single triangle must be untouched");
+    }
+
+    void testVertexFetch() {
+      constexpr uint32_t kGridSize = 16;
+      const uint32_t vertexCount = (kGridSize + 1) * (kGridSize + 1) + 1; // Plus one vertex no triangle uses
+      std::vector<uint32_t> indices = makeShuffledGrid(kGridSize, 11);
+      // Second index list only using part of the vertices, like a geom subset
+      std::vector<uint32_t> subsetIndices(indices.begin(), indices.begin() + 30);
+
+      struct Vertex {
+        float position[3];
+        uint32_t id;
+      };
+      std::vector<Vertex> vertices(vertexCount);
+      for (uint32_t v = 0; v < vertexCount; ++v) {
+        vertices[v] = { { float(v), float(v) * 2.0f, 0.0f }, v };
+      }
+
+      meshopt::VertexFetchRemap fetchRemap(vertexCount);
+      fetchRemap.addIndices(indices.data(), indices.size());
+      fetchRemap.addIndices(subsetIndices.data(), subsetIndices.size());
+      const std::vector<uint32_t>& remap = fetchRemap.finish();
+
+      std::vector<uint32_t> sortedRemap = remap;
+      std::sort(sortedRemap.begin(), sortedRemap.end());
+      for (uint32_t v = 0; v < vertexCount; ++v) {
+        check(sortedRemap[v] == v, "remap must be a permutation");
+      }
+      check(remap[vertexCount - 1] == vertexCount - 1, "unreferenced vertices must go last");
+
+      std::vector<Vertex> remappedVertices(vertexCount);
+      meshopt::remapVertexBuffer(remappedVertices.data(), vertices.data(), vertexCount, sizeof(Vertex), remap.data());
+      std::vector<uint32_t> remappedIndices = indices;
+      meshopt::remapIndexBuffer(remappedIndices.data(), remappedIndices.size(), remap.data());
+
+      // Every index must still fetch the same vertex, and vertices must be first referenced in order
+      uint32_t nextNewVertex = 0;
+      for (size_t i = 0; i < indices.size(); ++i) {
+        check(remappedVertices[remappedIndices[i]].id == indices[i], "remapped index fetches a different vertex");
+        check(remappedIndices[i] <= nextNewVertex, "vertices must be ordered by first use");
+        nextNewVertex = std::max(nextNewVertex, remappedIndices[i] + 1);
+      }
+    }
+
+    void run() {
+      testAcmr();
+      testVertexCache();
+      testVertexFetch();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
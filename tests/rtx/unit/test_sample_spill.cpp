@@ -0,0 +1,205 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <filesystem>
+#include <memory>
+#include "../../test_utils.h"
+#include "../../../src/lssusd/sample_spill.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_sample_spill.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static constexpr uint32_t kNumFrames = 10;
+
+    static std::string getSpillPath() {
+      return (std::filesystem::temp_directory_path() / "test_sample_spill.spill").string();
+    }
+
+    static pxr::GfMatrix4d makeXform(double seed) {
+      pxr::GfMatrix4d xform(1.0);
+      xform.SetTranslateOnly(pxr::GfVec3d(seed, seed * 2.0, seed * 3.0));
+      return xform;
+    }
+
+    void testMeshRoundTrip() {
+      const std::string path = getSpillPath();
+      lss::Mesh mesh;
+      mesh.buffers.spill = std::make_shared<lss::SampleSpill>(path);
+      check(mesh.buffers.spill->isValid(), "failed to create the spill file");
+
+      for (uint32_t frame = 0; frame < kNumFrames; frame++) {
+        lss::Buf<lss::Index> indices;
+        lss::Buf<lss::Pos> positions;
+        lss::Buf<lss::Norm> normals;
+        lss::Buf<lss::Texcoord> texcoords;
+        lss::Buf<lss::Color> colors;
+        lss::Buf<lss::BlendWeight> blendWeights;
+        lss::Buf<lss::BlendIdx> blendIndices;
+        // Buffers of different sizes make a mix up of spilled blocks visible
+        for (uint32_t i = 0; i < 3 * (frame + 1); i++) {
+          indices.push_back(int(frame * 100 + i));
+          positions.push_back(lss::Pos(float(frame), float(i), 1.f));
+          normals.push_back(lss::Norm(0.f, float(frame), float(i)));
+          texcoords.push_back(lss::Texcoord(float(i), float(frame)));
+          colors.push_back(lss::Color(float(frame), 0.5f, float(i), 1.f));
+          blendWeights.push_back(float(frame) + float(i) * 0.25f);
+          blendIndices.push_back(int(frame + i));
+        }
+        mesh.buffers.idxBufs[float(frame)] = indices;
+        mesh.buffers.positionBufs[float(frame)] = positions;
+        mesh.buffers.normalBufs[float(frame)] = normals;
+        mesh.buffers.texcoordBufs[float(frame)] = texcoords;
+        mesh.buffers.colorBufs[float(frame)] = colors;
+        mesh.buffers.blendWeightBufs[float(frame)] = blendWeights;
+        mesh.buffers.blendIndicesBufs[float(frame)] = blendIndices;
+      }
+
+      const lss::MeshBuffers original = mesh.buffers;
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.idxBufs, mesh.buffers.spilledIdxBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.positionBufs, mesh.buffers.spilledPositionBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.normalBufs, mesh.buffers.spilledNormalBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.texcoordBufs, mesh.buffers.spilledTexcoordBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.colorBufs, mesh.buffers.spilledColorBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.blendWeightBufs, mesh.buffers.spilledBlendWeightBufs, 6.f);
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.blendIndicesBufs, mesh.buffers.spilledBlendIndicesBufs, 6.f);
+      check(mesh.buffers.idxBufs.size() == 4 && mesh.buffers.spilledIdxBufs.size() == 6, "samples before the spill time must leave memory");
+
+      // Everything but the latest sample may be spilled
+      lss::spillSamplesBefore(*mesh.buffers.spill, mesh.buffers.positionBufs, mesh.buffers.spilledPositionBufs, 100.f);
+      check(mesh.buffers.positionBufs.size() == 1, "the latest sample must stay in memory");
+
+      lss::Mesh storage;
+      const lss::Mesh& restored = lss::restoreSpilledSamples(mesh, storage);
+      check(&restored == &storage, "a mesh with spilled samples must be restored into the storage");
+      check(restored.buffers.idxBufs == original.idxBufs, "restored indices mismatch");
+      check(restored.buffers.positionBufs == original.positionBufs, "restored positions mismatch");
+      check(restored.buffers.normalBufs == original.normalBufs, "restored normals mismatch");
+      check(restored.buffers.texcoordBufs == original.texcoordBufs, "restored texcoords mismatch");
+      check(restored.buffers.colorBufs == original.colorBufs, "restored colors mismatch");
+      check(restored.buffers.blendWeightBufs == original.blendWeightBufs, "restored blend weights mismatch");
+      check(restored.buffers.blendIndicesBufs == original.blendIndicesBufs, "restored blend indices mismatch");
+      check(restored.buffers.spilledIdxBufs.empty() && restored.buffers.spilledPositionBufs.empty(), "restored meshes must not reference the spill");
+
+      // A mesh without spilled samples is used as is
+      lss::Mesh unspilled;
+      check(&lss::restoreSpilledSamples(unspilled, storage) == &unspilled, "a mesh without spilled samples must not be copied");
+
+      // The file only lives as long as the spill
+      storage = lss::Mesh();
+      mesh = lss::Mesh();
+      check(!std::filesystem::exists(path), "the spill file must be deleted with the last owner");
+    }
+
+    void testInstanceRoundTrip() {
+      lss::Instance instance;
+      instance.spill = std::make_shared<lss::SampleSpill>(getSpillPath());
+      check(instance.spill->isValid(), "failed to create the spill file");
+
+      for (uint32_t frame = 0; frame < kNumFrames; frame++) {
+        instance.xforms.push_back({ double(frame), makeXform(frame) });
+
+        lss::SampledBoneXform bones;
+        bones.time = double(frame);
+        for (uint32_t bone = 0; bone <= frame % 4; bone++) {
+          bones.xforms.push_back(makeXform(frame * 10.0 + bone));
+        }
+        instance.boneXForms.push_back(bones);
+      }
+
+      const lss::SampledXforms originalXforms = instance.xforms;
+      const lss::SampledBoneXforms originalBoneXforms = instance.boneXForms;
+
+      // Spilled in two runs, as a capture does once per window
+      for (const double time : { 4.0, 8.0 }) {
+        lss::spillSamplesBefore(*instance.spill, instance.xforms, instance.spilledXforms, time);
+        lss::spillSamplesBefore(*instance.spill, instance.boneXForms, instance.spilledBoneXForms, time);
+      }
+      check(instance.spilledXforms.size() == 2 && instance.xforms.size() == 2, "transforms must be spilled in runs");
+      check(instance.spilledBoneXForms.size() == 2 && instance.boneXForms.size() == 2, "bone transforms must be spilled in runs");
+
+      lss::Instance storage;
+      const lss::Instance& restored = lss::restoreSpilledSamples(instance, storage);
+      check(restored.xforms.size() == originalXforms.size(), "restored transform count mismatch");
+      for (size_t i = 0; i < originalXforms.size(); i++) {
+        check(restored.xforms[i].time == originalXforms[i].time && restored.xforms[i].xform == originalXforms[i].xform, "restored transform mismatch");
+      }
+      check(restored.boneXForms.size() == originalBoneXforms.size(), "restored bone transform count mismatch");
+      for (size_t i = 0; i < originalBoneXforms.size(); i++) {
+        check(restored.boneXForms[i].time == originalBoneXforms[i].time && restored.boneXForms[i].xforms == originalBoneXforms[i].xforms, "restored bone transforms mismatch");
+      }
+    }
+
+    void testLightAndCameraRoundTrip() {
+      auto spill = std::make_shared<lss::SampleSpill>(getSpillPath());
+      check(spill->isValid(), "failed to create the spill file");
+
+      lss::SphereLight light;
+      light.spill = spill;
+      lss::Camera camera;
+      camera.spill = spill;
+      for (uint32_t frame = 0; frame < kNumFrames; frame++) {
+        light.xforms.push_back({ double(frame), makeXform(frame) });
+        camera.xforms.push_back({ double(frame), makeXform(frame * 0.5) });
+      }
+      const lss::SampledXforms originalLightXforms = light.xforms;
+      const lss::SampledXforms originalCameraXforms = camera.xforms;
+
+      lss::spillSamplesBefore(*spill, light.xforms, light.spilledXforms, 5.0);
+      lss::spillSamplesBefore(*spill, camera.xforms, camera.spilledXforms, 5.0);
+      check(light.xforms.size() == 5 && camera.xforms.size() == 5, "light and camera transforms must be spilled");
+
+      lss::SphereLight restoredLight;
+      lss::Camera restoredCamera;
+      const lss::SphereLight& lightData = lss::restoreSpilledSamples(light, restoredLight);
+      const lss::Camera& cameraData = lss::restoreSpilledSamples(camera, restoredCamera);
+      check(lightData.xforms.size() == kNumFrames && cameraData.xforms.size() == kNumFrames, "restored transform count mismatch");
+      for (uint32_t i = 0; i < kNumFrames; i++) {
+        check(lightData.xforms[i].time == originalLightXforms[i].time && lightData.xforms[i].xform == originalLightXforms[i].xform, "restored light transform mismatch");
+        check(cameraData.xforms[i].time == originalCameraXforms[i].time && cameraData.xforms[i].xform == originalCameraXforms[i].xform, "restored camera transform mismatch");
+      }
+    }
+
+    void run() {
+      testMeshRoundTrip();
+      testInstanceRoundTrip();
+      testLightAndCameraRoundTrip();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
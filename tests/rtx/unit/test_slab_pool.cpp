@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/util/util_slab_pool.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_slab_pool.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    struct TestObject {
+      static inline int s_liveObjects = 0;
+
+      uint64_t id;
+      std::vector<uint32_t> payload;
+
+      TestObject(uint64_t id) : id(id), payload(4, uint32_t(id)) { ++s_liveObjects; }
+      ~TestObject() { --s_liveObjects; }
+    };
+
+    void testHandles() {
+      SlabPool<TestObject, 4> pool;
+
+      SlabHandle handleA, handleB;
+      TestObject* a = pool.allocate(handleA, 1);
+      TestObject* b = pool.allocate(handleB, 2);
+
+      check(pool.get(handleA) == a && pool.get(handleB) == b, "handles must resolve to their objects");
+      check(pool.isLive(a) && pool.isLive(b), "allocated objects must be live");
+
+      pool.free(a);
+      check(pool.get(handleA) == nullptr, "handle to a freed object must not resolve");
+      check(!pool.isLive(a), "freed object must not be live");
+
+      // The freed slot is recycled first, but the old handle must remain stale
+      SlabHandle handleC;
+      TestObject* c = pool.allocate(handleC, 3);
+      check(c == a, "freed slot should be reused first");
+      check(handleC.index == handleA.index && handleC.generation != handleA.generation, "recycled slot must bump its generation");
+      check(pool.get(handleA) == nullptr && pool.get(handleC) == c, "stale handle must not alias the new object");
+
+      check(pool.isLive(handleC) && !pool.isLive(handleA), "handle liveness must follow the generation");
+
+      SlabPool<TestObject, 4> otherPool;
+      SlabHandle otherHandle;
+      TestObject* other = otherPool.allocate(otherHandle, 4);
+      check(!pool.isLive(other) && otherPool.isLive(other), "objects of another pool must not be live");
+    }
+
+    void testGrowthAndStability() {
+      SlabPool<TestObject, 4> pool;
+
+      std::vector<std::pair<SlabHandle, TestObject*>> objects;
+      for (uint64_t i = 0; i < 37; ++i) {
+        SlabHandle handle;
+        objects.emplace_back(handle, pool.allocate(handle, i));
+        objects.back().first = handle;
+      }
+
+      check(pool.size() == 37 && pool.capacity() == 40, "unexpected pool size after growth");
+
+      // Growing the pool must never move existing objects
+      for (uint64_t i = 0; i < objects.size(); ++i) {
+        check(pool.get(objects[i].first) == objects[i].second, "object moved after pool growth");
+        check(objects[i].second->id == i && objects[i].second->payload[3] == i, "object contents corrupted");
+      }
+
+      // Free every other object and make sure the capacity is reused
+      for (uint64_t i = 0; i < objects.size(); i += 2) {
+        pool.free(objects[i].second);
+      }
+      for (uint64_t i = 0; i < objects.size(); i += 2) {
+        SlabHandle handle;
+        pool.allocate(handle, i);
+      }
+      check(pool.capacity() == 40, "freed slots must be reused before growing");
+
+      pool.clear();
+      check(pool.size() == 0 && TestObject::s_liveObjects == 0, "clear must destroy all objects");
+      for (auto& object : objects) {
+        check(pool.get(object.first) == nullptr, "handles must be stale after clear");
+      }
+    }
+
+    void run() {
+      testHandles();
+      testGrowthAndStability();
+      check(TestObject::s_liveObjects == 0, "pool destructor must destroy all objects");
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <random>
+#include <unordered_map>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/rtx_render/rtx_sparse_unique_cache.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_sparse_unique_cache.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    struct Object {
+      uint64_t key = 0;
+
+      bool operator==(const Object& other) const {
+        return key == other.key;
+      }
+    };
+
+    // Deliberately weak so that many keys share probe sequences and full hashes
+    struct CollidingHashFn {
+      size_t operator()(const Object& object) const {
+        return object.key % 7;
+      }
+    };
+
+    // Random track and free calls must keep every live object at a stable index
+    void testMatchesReference() {
+      SparseUniqueCache<Object, CollidingHashFn> cache;
+      std::unordered_map<uint64_t, uint32_t> reference;
+      std::mt19937 random(42);
+
+      for (uint32_t i = 0; i < 20000; ++i) {
+        const Object object { random() % 256 + 1 };
+        const auto referenceIt = reference.find(object.key);
+
+        if (random() % 3 == 0) {
+          cache.free(object);
+          if (referenceIt != reference.end()) {
+            reference.erase(referenceIt);
+          }
+        } else {
+          const uint32_t idx = cache.track(object);
+          if (referenceIt != reference.end()) {
+            check(idx == referenceIt->second, "tracked objects must keep their index");
+          } else {
+            reference.emplace(object.key, idx);
+          }
+          check(cache.at(idx) == object, "the index must refer to the tracked object");
+        }
+
+        check(cache.getActiveCount() == reference.size(), "active count must match");
+      }
+
+      for (uint64_t key = 1; key <= 256; ++key) {
+        uint32_t idx = 0;
+        const auto referenceIt = reference.find(key);
+        const bool found = cache.find(Object { key }, idx);
+        check(found == (referenceIt != reference.end()), "find must locate exactly the live objects");
+        if (found) {
+          check(idx == referenceIt->second, "find must return the tracked index");
+        }
+      }
+    }
+
+    // Freed indices must be reused lowest first, so the table stays dense
+    void testLowestFreeIndex() {
+      SparseUniqueCache<Object, CollidingHashFn> cache;
+
+      for (uint64_t key = 1; key <= 100; ++key) {
+        check(cache.track(Object { key }) == key - 1, "new objects must be appended");
+      }
+
+      cache.free(Object { 71 });
+      cache.free(Object { 5 });
+      cache.free(Object { 40 });
+      check(cache.getActiveCount() == 97 && cache.getTotalCount() == 100, "free must not shrink the table");
+      check(cache.getObjectTable()[4] == Object(), "freed entries must be reset");
+
+      check(cache.track(Object { 1000 }) == 4, "the lowest free index must be reused first");
+      check(cache.track(Object { 1001 }) == 39, "the lowest free index must be reused first");
+      check(cache.track(Object { 1002 }) == 70, "the lowest free index must be reused first");
+      check(cache.track(Object { 1003 }) == 100, "objects must be appended once no index is free");
+
+      cache.clear();
+      check(cache.getTotalCount() == 0 && cache.track(Object { 5 }) == 0, "clear must reset the table");
+    }
+
+    // The object returned by the callback is stored, and the callback only runs on first track
+    void testFirstCacheCallback() {
+      SparseUniqueCache<Object, CollidingHashFn> cache;
+      uint32_t calls = 0;
+      const auto onFirstCache = [&calls](const Object& in) {
+        ++calls;
+        return in;
+      };
+
+      const uint32_t idx = cache.track(Object { 3 }, onFirstCache);
+      check(cache.track(Object { 3 }, onFirstCache) == idx, "tracking again must return the same index");
+      check(calls == 1, "the callback must only run for new objects");
+    }
+
+    void run() {
+      testMatchesReference();
+      testLowestFreeIndex();
+      testFirstCacheCallback();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
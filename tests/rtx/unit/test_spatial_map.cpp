@@ -19,6 +19,8 @@
 * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 * DEALINGS IN THE SOFTWARE.
 */
+#include <algorithm>
+#include <random>
 #include <set>
 #include "../../test_utils.h"
 #include "../../../src/util/util_spatial_map.h"
@@ -82,8 +84,198 @@ namespace dxvk {
       testPoint(map, Vector3(2.5f, 2.5f, 2.51f), 3);
       // far section of next cell
       testPoint(map, Vector3(3.5f, 3.5f, 3.5f), 3);
+
+      // Same queries against the packed layout
+      map.pack();
+      testPoint(map, Vector3(0.f, 0.f, 0.f), 0);
+      testPoint(map, Vector3(1.5f, 1.5f, 1.51f), 2);
+      testPoint(map, Vector3(3.5f, 3.5f, 3.5f), 3);
+
+      // Mutating a packed map goes back to the dynamic layout
+      TestData moved(Vector3(10.f, 10.f, 10.f), 4);
+      map.insert(moved.pos, moved.transform, &moved.data);
+      testPoint(map, Vector3(10.f, 10.f, 10.f), 4);
+      testPoint(map, Vector3(1.5f, 1.5f, 1.51f), 2);
+
+      testRebuild();
+      testRandomized();
+      testBatchFilter();
       std::cout << "All passed\n";
     }
+
+  private:
+    void testRebuild() {
+      // With a cell size of 2 the 2x2x2 neighbourhood of the query doesn't reach the entry, with 8 it does
+      SpatialMap<int> map(2.0f);
+      TestData data(Vector3(3.f, 0.f, 0.f), 7);
+      map.insert(data.pos, data.transform, &data.data);
+
+      float nearestDistSqr;
+      if (map.getNearestData(Vector3(-0.9f, 0.f, 0.f), 16.f, nearestDistSqr, [](const int*) { return true; }) != nullptr) {
+        throw DxvkError("unexpected result before rebuild");
+      }
+
+      map.rebuild(8.0f);
+      if (map.getCellSize() != 8.0f || !map.isPacked()) {
+        throw DxvkError("rebuild didn't apply the new cell size");
+      }
+      const int* result = map.getNearestData(Vector3(-0.9f, 0.f, 0.f), 16.f, nearestDistSqr, [](const int*) { return true; });
+      if (result == nullptr || *result != 7) {
+        throw DxvkError("rebuild didn't re-bucket the entries");
+      }
+    }
+
+    // Compares the packed and dynamic layouts and the radius/k nearest queries against brute force
+    void testRandomized() {
+      constexpr float kCellSize = 4.f;
+      constexpr int kCount = 2000;
+      std::mt19937 random(42);
+      std::uniform_real_distribution<float> position(-50.f, 50.f);
+
+      std::vector<TestData> data;
+      data.reserve(kCount);
+      std::vector<SpatialMap<int>::BuildEntry> buildEntries;
+      for (int i = 0; i < kCount; ++i) {
+        data.emplace_back(Vector3(position(random), position(random), position(random)), i);
+      }
+      for (const TestData& d : data) {
+        buildEntries.push_back({ d.pos, d.transform, &d.data });
+      }
+
+      SpatialMap<int> dynamicMap(kCellSize);
+      std::vector<XXH64_hash_t> dynamicHashes;
+      for (const TestData& d : data) {
+        dynamicHashes.push_back(dynamicMap.insert(d.pos, d.transform, &d.data));
+      }
+
+      SpatialMap<int> packedMap(kCellSize);
+      std::vector<XXH64_hash_t> packedHashes(kCount);
+      packedMap.build(buildEntries.data(), buildEntries.size(), packedHashes.data());
+      if (packedHashes != dynamicHashes || packedMap.size() != kCount) {
+        throw DxvkError("build() doesn't match insert()");
+      }
+
+      const auto oddOnly = [](const int* d) { return (*d & 1) != 0; };
+      const float maxDistSqr = (kCellSize / 2.f) * (kCellSize / 2.f);
+
+      std::vector<Vector3> queries;
+      for (int i = 0; i < 500; ++i) {
+        queries.push_back(Vector3(position(random), position(random), position(random)));
+      }
+
+      std::vector<const int*> batchResults(queries.size());
+      std::vector<float> batchDistances(queries.size());
+      packedMap.getNearestDataBatch(queries.data(), queries.size(), maxDistSqr,
+        [&](size_t, const int* d) { return oddOnly(d); }, batchResults.data(), batchDistances.data());
+
+      std::vector<const int*> radiusResults;
+      std::vector<SpatialMap<int>::Neighbor> knnResults;
+      for (size_t q = 0; q < queries.size(); ++q) {
+        const Vector3& query = queries[q];
+
+        float dynamicDist, packedDist;
+        const int* dynamicResult = dynamicMap.getNearestData(query, maxDistSqr, dynamicDist, oddOnly);
+        const int* packedResult = packedMap.getNearestData(query, maxDistSqr, packedDist, oddOnly);
+        if (dynamicResult != packedResult || batchResults[q] != packedResult) {
+          throw DxvkError(str::format("packed/batched nearest query mismatch at ", ToString(query)));
+        }
+
+        // Brute force reference
+        const float radius = 7.f;
+        std::vector<std::pair<float, int>> expected;
+        for (const TestData& d : data) {
+          const float distSqr = lengthSqr(d.pos - query);
+          if (distSqr <= radius * radius && oddOnly(&d.data)) {
+            expected.emplace_back(distSqr, d.data);
+          }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        for (SpatialMap<int>* map : { &dynamicMap, &packedMap }) {
+          radiusResults.clear();
+          map->getDataInRadius(query, radius, oddOnly, radiusResults);
+          std::set<int> radiusSet;
+          for (const int* d : radiusResults) {
+            radiusSet.insert(*d);
+          }
+          std::set<int> expectedSet;
+          for (const auto& e : expected) {
+            expectedSet.insert(e.second);
+          }
+          if (radiusSet != expectedSet) {
+            throw DxvkError(str::format("radius query mismatch at ", ToString(query), ": expected [", ToString(expectedSet), "] got [", ToString(radiusSet), "]"));
+          }
+
+          const size_t k = 5;
+          map->getKNearestData(query, k, radius * radius, oddOnly, knnResults);
+          if (knnResults.size() != std::min(k, expected.size())) {
+            throw DxvkError(str::format("k nearest query returned ", knnResults.size(), " results at ", ToString(query)));
+          }
+          for (size_t i = 0; i < knnResults.size(); ++i) {
+            if (knnResults[i].distSqr != expected[i].first) {
+              throw DxvkError(str::format("k nearest query order mismatch at ", ToString(query)));
+            }
+          }
+        }
+      }
+
+      // Erasing from a packed map
+      for (int i = 0; i < kCount; i += 2) {
+        packedMap.erase(packedHashes[i]);
+      }
+      if (packedMap.isPacked() || packedMap.size() != kCount / 2 || packedMap.getDataAtTransform(data[1].transform) != &data[1].data) {
+        throw DxvkError("erase from a packed map failed");
+      }
+
+      // Nearest queries after the erase, against brute force
+      for (const Vector3& query : queries) {
+        float nearestDistSqr;
+        const int* result = packedMap.getNearestData(query, maxDistSqr, nearestDistSqr, oddOnly);
+
+        float expectedDistSqr = FLT_MAX;
+        for (const TestData& d : data) {
+          const float distSqr = lengthSqr(d.pos - query);
+          if ((d.data & 1) != 0 && distSqr <= maxDistSqr && distSqr < expectedDistSqr) {
+            expectedDistSqr = distSqr;
+          }
+        }
+
+        const bool found = result != nullptr;
+        if (found != (expectedDistSqr != FLT_MAX) || (found && nearestDistSqr != expectedDistSqr)) {
+          throw DxvkError(str::format("nearest query mismatch after erase at ", ToString(query)));
+        }
+      }
+    }
+
+    // The batch filter gets the index of the query it is evaluated for
+    void testBatchFilter() {
+      SpatialMap<int> map(4.f);
+      TestData data[3] = {
+        TestData(Vector3(0.f, 0.f, 0.f), 0),
+        TestData(Vector3(0.5f, 0.f, 0.f), 1),
+        TestData(Vector3(20.f, 0.f, 0.f), 2)
+      };
+      std::vector<SpatialMap<int>::BuildEntry> buildEntries;
+      for (const TestData& d : data) {
+        buildEntries.push_back({ d.pos, d.transform, &d.data });
+      }
+      map.build(buildEntries.data(), buildEntries.size());
+
+      // Query i only accepts entry i, the far query has nothing within range
+      const Vector3 queries[4] = { Vector3(0.1f, 0.f, 0.f), Vector3(0.1f, 0.f, 0.f), Vector3(20.f, 0.f, 0.f), Vector3(-30.f, 0.f, 0.f) };
+      const int* results[4];
+      float distances[4];
+      map.getNearestDataBatch(queries, 4, 4.f, [](size_t queryIndex, const int* d) { return *d == int(queryIndex) || queryIndex == 3; },
+                              results, distances);
+      for (int i = 0; i < 3; ++i) {
+        if (results[i] != &data[i].data || distances[i] != lengthSqr(data[i].pos - queries[i])) {
+          throw DxvkError(str::format("batched query ", i, " returned the wrong entry"));
+        }
+      }
+      if (results[3] != nullptr) {
+        throw DxvkError("batched query found an entry out of range");
+      }
+    }
   };
 }
 
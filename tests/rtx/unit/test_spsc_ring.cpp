@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <memory>
+#include <thread>
+#include "../../test_utils.h"
+#include "../../../src/util/util_spsc_ring.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_spsc_ring.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    void testSingleThreaded() {
+      SpscRing<std::unique_ptr<uint32_t>, 8> ring;
+      uint32_t value = 0;
+      check(!ring.tryPop(*std::make_unique<std::unique_ptr<uint32_t>>()), "a new ring must be empty");
+
+      // Wrap around a few times
+      for (uint32_t round = 0; round < 3; ++round) {
+        for (uint32_t i = 0; i < ring.capacity(); ++i) {
+          std::unique_ptr<uint32_t> item = std::make_unique<uint32_t>(value + i);
+          check(ring.tryPush(std::move(item)), "pushing into a ring with free slots must succeed");
+          check(item == nullptr, "a pushed item must be moved from");
+        }
+
+        std::unique_ptr<uint32_t> overflow = std::make_unique<uint32_t>(~0u);
+        check(!ring.tryPush(std::move(overflow)), "pushing into a full ring must fail");
+        check(overflow != nullptr, "a rejected item must not be moved from");
+        check(ring.size() == ring.capacity(), "a full ring must report its capacity");
+
+        for (uint32_t i = 0; i < ring.capacity(); ++i) {
+          std::unique_ptr<uint32_t> item;
+          check(ring.tryPop(item) && item && *item == value + i, "items must pop in push order");
+        }
+        check(ring.empty(), "a drained ring must be empty");
+        value += ring.capacity();
+      }
+    }
+
+    void testProducerConsumer() {
+      constexpr uint64_t kItemCount = 1 << 20;
+      SpscRing<uint64_t, 64> ring;
+
+      std::thread consumer([&] {
+        uint64_t expected = 1;
+        while (expected <= kItemCount) {
+          uint64_t item = 0;
+          if (ring.tryPop(item)) {
+            check(item == expected, "items must arrive once and in order");
+            ++expected;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+
+      for (uint64_t i = 1; i <= kItemCount; ++i) {
+        uint64_t item = i;
+        while (!ring.tryPush(std::move(item))) {
+          std::this_thread::yield();
+        }
+      }
+
+      consumer.join();
+      check(ring.empty(), "all items must be consumed");
+    }
+
+    void run() {
+      testSingleThreaded();
+      testProducerConsumer();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/dxvk_state_cache.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_state_cache.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static DxvkStateCacheEntry makeEntry(uint32_t index) {
+      DxvkStateCacheEntry entry;
+
+      auto shaderKey = [index] (VkShaderStageFlagBits stage) {
+        const uint32_t seed[2] = { index, uint32_t(stage) };
+        return DxvkShaderKey(stage, Sha1Hash::compute(seed, sizeof(seed)));
+      };
+
+      entry.shaders.vs = shaderKey(VK_SHADER_STAGE_VERTEX_BIT);
+      entry.shaders.fs = shaderKey(VK_SHADER_STAGE_FRAGMENT_BIT);
+
+      entry.format.color[0] = { VK_FORMAT_B8G8R8A8_UNORM, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+      entry.gpState.ia = DxvkIaInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE, 0);
+      entry.gpState.il = DxvkIlInfo(1, 1);
+      entry.gpState.ilAttributes[0] = DxvkIlAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 0);
+      entry.gpState.ilBindings[0] = DxvkIlBinding(0, 16, VK_VERTEX_INPUT_RATE_VERTEX, 0);
+      entry.gpState.sc.specConstants[0] = index;
+      return entry;
+    }
+
+    static std::string makeCacheFile(uint32_t version, std::vector<DxvkStateCacheEntry>& entries, const std::vector<DxvkStateCacheUsage>& usage) {
+      std::ostringstream stream;
+
+      DxvkStateCacheHeader header;
+      header.version = version;
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      for (size_t i = 0; i < entries.size(); i++)
+        DxvkStateCache::writeCacheEntry(stream, entries[i], usage[i]);
+
+      return stream.str();
+    }
+
+    void testRoundTrip() {
+      std::vector<DxvkStateCacheEntry> entries;
+      std::vector<DxvkStateCacheUsage> usage;
+
+      for (uint32_t i = 0; i < 100; i++) {
+        entries.push_back(makeEntry(i));
+        usage.push_back({ i % 7, i % 5 });
+      }
+
+      const std::string file = makeCacheFile(DxvkStateCacheHeader().version, entries, usage);
+      DxvkStateCacheFileData data;
+      check(DxvkStateCache::parseCacheData(file.data(), file.size(), 0, data), "failed to parse the cache file");
+      check(data.version == DxvkStateCacheHeader().version && data.numInvalidEntries == 0, "unexpected version or invalid entries");
+      check(data.entries.size() == entries.size() && data.usage.size() == entries.size(), "entry count mismatch");
+
+      for (size_t i = 0; i < entries.size(); i++) {
+        check(data.entries[i].shaders.eq(entries[i].shaders), "shader keys must survive a round trip");
+        check(data.entries[i].gpState.sc.specConstants[0] == i, "entries must keep their file order");
+        check(data.usage[i].lastSession == usage[i].lastSession && data.usage[i].sessionCount == usage[i].sessionCount, "usage data must survive a round trip");
+      }
+
+      // v13 entries carry no usage data, they are read with zeroed usage
+      const std::string v13 = makeCacheFile(13, entries, std::vector<DxvkStateCacheUsage>(entries.size()));
+      check(DxvkStateCache::parseCacheData(v13.data(), v13.size(), 0, data), "failed to parse a v13 cache file");
+      check(data.version == 13 && data.entries.size() == entries.size(), "v13 entries must be read");
+      check(std::all_of(data.usage.begin(), data.usage.end(), [] (const DxvkStateCacheUsage& u) { return u.sessionCount == 0 && u.lastSession == 0; }), "v13 usage must be zero");
+
+      // A corrupted entry is skipped
+      std::string corrupt = file;
+      corrupt[corrupt.size() - 1] ^= 0xff;
+      check(DxvkStateCache::parseCacheData(corrupt.data(), corrupt.size(), 0, data), "failed to parse a corrupted cache file");
+      check(data.numInvalidEntries == 1 && data.entries.size() == entries.size() - 1, "the corrupted entry must be skipped");
+    }
+
+    void testQueueOrder() {
+      // Remix shaders, then bound pipelines, then usage weight, then queue order
+      std::vector<DxvkStateCacheQueueOrder> heap;
+      std::vector<uint64_t> priorities = {
+        0, 100, DxvkStateCacheQueueOrder::PriorityBound, 0, 100,
+        DxvkStateCacheQueueOrder::PriorityRemix, 50, DxvkStateCacheQueueOrder::PriorityBound | 10, 0 };
+
+      uint64_t sequence = 0;
+
+      for (uint64_t priority : priorities) {
+        heap.push_back({ priority, sequence++ });
+        std::push_heap(heap.begin(), heap.end());
+      }
+
+      // Raise the priority of the last item with priority 0 in place, as a bind does
+      for (size_t i = 0; i < heap.size(); i++) {
+        if (heap[i].sequence == 8) {
+          heap[i].priority |= DxvkStateCacheQueueOrder::PriorityBound;
+          std::push_heap(heap.begin(), heap.begin() + i + 1);
+          break;
+        }
+      }
+
+      const std::vector<uint64_t> expectedOrder = { 5, 7, 2, 8, 1, 4, 6, 0, 3 };
+      std::vector<uint64_t> order;
+
+      while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        order.push_back(heap.back().sequence);
+        heap.pop_back();
+      }
+
+      check(order == expectedOrder, "worker items popped in the wrong order");
+    }
+
+    void testUsageWeights() {
+      check(DxvkStateCache::getUsageWeight({ 10, 0 }, 10) == 0, "unused entries must have no weight");
+      check(DxvkStateCache::getUsageWeight({ 10, 2 }, 10) == 2 * DxvkStateCache::getUsageWeight({ 9, 2 }, 10), "weights must halve per session");
+      check(DxvkStateCache::getUsageWeight({ 10, 3 }, 10) > DxvkStateCache::getUsageWeight({ 10, 2 }, 10), "more sessions must weigh more");
+
+      std::vector<DxvkStateCacheUsage> oldUsage = { { 4, 3 }, { 4, 3 }, { 2, 1 }, { 0, 0 } };
+
+      // Every entry used in every session keeps the order
+      std::vector<DxvkStateCacheUsage> newUsage = oldUsage;
+      check(!DxvkStateCache::isUsageOrderChanged(oldUsage, newUsage, 6), "unchanged usage must keep the order");
+      newUsage[0] = { 5, 4 };
+      newUsage[1] = { 5, 4 };
+      check(!DxvkStateCache::isUsageOrderChanged(oldUsage, newUsage, 6), "uniformly updated usage must keep the order");
+
+      // Breaking a tie or overtaking another entry reorders
+      newUsage[1] = oldUsage[1];
+      check(DxvkStateCache::isUsageOrderChanged(oldUsage, newUsage, 6), "breaking a tie must change the order");
+      newUsage = oldUsage;
+      newUsage[3] = { 5, 1 };
+      check(DxvkStateCache::isUsageOrderChanged(oldUsage, newUsage, 6), "a newly used entry must change the order");
+    }
+
+    void run() {
+      testRoundTrip();
+      testQueueOrder();
+      testUsageWeights();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/dxvk/rtx_render/rtx_option.h"
+#include "../../../src/dxvk/rtx_render/rtx_texture_category_cache.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_texture_category_cache.log");
+
+  class TestOptions {
+    RTX_OPTION("rtx.test", fast_unordered_set, ignoreTextures, {}, "Ignore category of the test cache.");
+    RTX_OPTION("rtx.test", fast_unordered_set, skyTextures, {}, "Sky category of the test cache.");
+    RTX_OPTION("rtx.test", fast_unordered_set, lightmapTextures, {}, "Lightmap category of the test cache.");
+  };
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static void applyOptions() {
+      RtxOptionManager::applyPendingValues(nullptr);
+    }
+
+    void testCategories() {
+      TextureCategoryCache cache;
+      cache.addInstanceCategory(TestOptions::ignoreTexturesObject(), InstanceCategories::Ignore);
+      cache.addInstanceCategory(TestOptions::skyTexturesObject(), InstanceCategories::Sky);
+      cache.addTextureCategory(TestOptions::lightmapTexturesObject(), TextureCategories::Lightmap);
+
+      check(cache.lookup(1).isClear(), "textures must start out without categories");
+
+      TestOptions::ignoreTexturesObject().addHash(1);
+      TestOptions::skyTexturesObject().addHash(1);
+      TestOptions::lightmapTexturesObject().addHash(2);
+      // The cache only picks up option changes once they are applied at the end of the frame
+      check(cache.lookup(1).isClear(), "pending option values must not be visible yet");
+      applyOptions();
+
+      const TextureCategoryFlags both = cache.lookup(1);
+      check(both.instanceCategories.test(InstanceCategories::Ignore) && both.instanceCategories.test(InstanceCategories::Sky),
+            "a texture must get the union of its categories");
+      check(both.textureCategories.isClear(), "instance categories must not set texture categories");
+      const TextureCategoryFlags lightmap = cache.lookup(2);
+      check(lightmap.textureCategories.test(TextureCategories::Lightmap) && lightmap.instanceCategories.isClear(),
+            "texture categories must be kept apart from instance categories");
+
+      // Changing one option's version rebuilds only that category
+      TestOptions::skyTexturesObject().removeHash(1);
+      TestOptions::skyTexturesObject().addHash(3);
+      applyOptions();
+      const TextureCategoryFlags ignoreOnly = cache.lookup(1);
+      check(ignoreOnly.instanceCategories.test(InstanceCategories::Ignore) && !ignoreOnly.instanceCategories.test(InstanceCategories::Sky),
+            "a removed hash must lose its category");
+      check(cache.lookup(3).instanceCategories.test(InstanceCategories::Sky), "an added hash must gain its category");
+      check(cache.lookup(2).textureCategories.test(TextureCategories::Lightmap), "unchanged categories must be kept");
+
+      TestOptions::ignoreTexturesObject().removeHash(1);
+      applyOptions();
+      check(cache.lookup(1).isClear(), "a texture without categories must be dropped");
+
+      TestOptions::skyTexturesObject().removeHash(3);
+      TestOptions::lightmapTexturesObject().removeHash(2);
+      applyOptions();
+    }
+
+    void testConcurrentLookups() {
+      TextureCategoryCache cache;
+      cache.addInstanceCategory(TestOptions::ignoreTexturesObject(), InstanceCategories::Ignore);
+
+      // Readers must always see a complete snapshot while the options change every frame
+      std::atomic<bool> done = false;
+      std::vector<std::thread> readers;
+      for (uint32_t i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+          while (!done.load(std::memory_order_relaxed)) {
+            const TextureCategoryFlags flags = cache.lookup(100);
+            check(flags.instanceCategories.isClear() || flags.instanceCategories.test(InstanceCategories::Ignore),
+                  "lookups must only see categories of the cache");
+          }
+        });
+      }
+
+      for (uint32_t frame = 0; frame < 200; ++frame) {
+        if (frame % 2 == 0) {
+          TestOptions::ignoreTexturesObject().addHash(100);
+        } else {
+          TestOptions::ignoreTexturesObject().removeHash(100);
+        }
+        applyOptions();
+      }
+      done = true;
+      for (std::thread& reader : readers) {
+        reader.join();
+      }
+      check(cache.lookup(100).isClear(), "the last published snapshot must win");
+    }
+
+    void run() {
+      // No config files are loaded, the options keep their defaults
+      RtxOptionImpl::s_isInitialized = true;
+      applyOptions();
+
+      testCategories();
+      testConcurrentLookups();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
@@ -0,0 +1,264 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION. All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../../test_utils.h"
+#include "../../../src/util/util_vertex_compression.h"
+
+namespace dxvk {
+  // Note: Logger needed by some shared code used in this Unit Test.
+  Logger Logger::s_instance("test_vertex_compression.log");
+}
+
+namespace dxvk {
+  class TestApp {
+  public:
+    static uint16_t encodeHalf(const float value) {
+      const float texcoord[2] = { value, 0.0f };
+      return uint16_t(vtxcompress::encodeTexcoord(texcoord) & 0xFFFF);
+    }
+
+    static float decodeHalf(const uint16_t half) {
+      float texcoord[2];
+      vtxcompress::decodeTexcoord(half, texcoord);
+      return texcoord[0];
+    }
+
+    void testHalfRoundTrip() {
+      // Every finite half must survive a round trip through float exactly
+      for (uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        const uint16_t half = uint16_t(bits);
+        if ((half & 0x7C00) == 0x7C00) {
+          continue;
+        }
+        check(encodeHalf(decodeHalf(half)) == half, "finite half round trip");
+      }
+
+      check(encodeHalf(1.0f) == 0x3C00, "1.0 encoding");
+      check(encodeHalf(-2.0f) == 0xC000, "-2.0 encoding");
+      check(encodeHalf(65504.0f) == 0x7BFF, "largest half");
+      check(encodeHalf(1.0e6f) == 0x7C00, "overflow to infinity");
+      check(encodeHalf(1.0e-9f) == 0x0000, "underflow to zero");
+      check(decodeHalf(0x0001) == std::ldexp(1.0f, -24), "smallest subnormal");
+      check(std::isnan(decodeHalf(encodeHalf(NAN))), "NaN stays NaN");
+
+      // Both halves of the texcoord are kept apart
+      const float texcoord[2] = { 1.0f, -2.0f };
+      check(vtxcompress::encodeTexcoord(texcoord) == 0xC0003C00, "texcoord layout");
+    }
+
+    void testTexcoordError() {
+      std::mt19937 rng(7);
+      std::uniform_real_distribution<float> dist(-8.0f, 8.0f);
+
+      for (uint32_t i = 0; i < 100000; ++i) {
+        const float texcoord[2] = { dist(rng), dist(rng) };
+        float decoded[2];
+        vtxcompress::decodeTexcoord(vtxcompress::encodeTexcoord(texcoord), decoded);
+
+        for (uint32_t c = 0; c < 2; ++c) {
+          // Half precision has an 11 bit significand, rounding is within half an ulp. Values below the
+          // smallest normal half are bounded by half the subnormal spacing instead.
+          const float bound = std::max(std::abs(texcoord[c]) * std::ldexp(1.0f, -11), std::ldexp(1.0f, -25));
+          check(std::abs(decoded[c] - texcoord[c]) <= bound, "texcoord error above half an ulp");
+        }
+      }
+    }
+
+    void testPositionError() {
+      std::mt19937 rng(11);
+      std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+      const float minPos[3] = { -150.0f, 2.0f, -0.25f };
+      const float maxPos[3] = { 350.0f, 2.0f, 0.25f };
+
+      std::vector<float> positions;
+      for (uint32_t i = 0; i < 50000; ++i) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          positions.push_back(minPos[axis] + (maxPos[axis] - minPos[axis]) * dist(rng));
+        }
+      }
+      // Make sure the box corners are part of the data
+      positions.insert(positions.end(), minPos, minPos + 3);
+      positions.insert(positions.end(), maxPos, maxPos + 3);
+
+      const size_t count = positions.size() / 3;
+      const vtxcompress::PositionQuantization quantization =
+        vtxcompress::computePositionQuantization(positions.data(), count, sizeof(float) * 3);
+
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        check(quantization.bias[axis] == 0.5f * (minPos[axis] + maxPos[axis]), "quantization bias is the box center");
+        check(quantization.scale[axis] > 0.0f, "quantization scale must be positive, even for flat axes");
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        const float* position = &positions[i * 3];
+        int16_t encoded[4];
+        vtxcompress::encodePosition(quantization, position, encoded);
+        check(encoded[3] == 0, "w must be zero");
+
+        float decoded[3];
+        vtxcompress::decodePosition(quantization, encoded, decoded);
+
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          // Half a quantization step, plus float rounding of the largest magnitude involved
+          const float step = quantization.scale[axis] / 32767.0f;
+          const float magnitude = std::abs(quantization.bias[axis]) + quantization.scale[axis];
+          const float bound = 0.5f * step + 4.0f * magnitude * std::numeric_limits<float>::epsilon();
+          check(std::abs(decoded[axis] - position[axis]) <= bound, "position error above half a quantization step");
+        }
+      }
+
+      // The box corners map to the ends of the snorm range, the center to zero
+      int16_t encoded[4];
+      vtxcompress::encodePosition(quantization, minPos, encoded);
+      check(encoded[0] == -32767 && encoded[2] == -32767, "box minimum must encode to -1");
+      vtxcompress::encodePosition(quantization, maxPos, encoded);
+      check(encoded[0] == 32767 && encoded[2] == 32767, "box maximum must encode to 1");
+      vtxcompress::encodePosition(quantization, quantization.bias, encoded);
+      check(encoded[0] == 0 && encoded[1] == 0 && encoded[2] == 0, "box center must encode to 0");
+
+      // -32768 is a valid encoding and decodes like -32767
+      const int16_t lowest[4] = { -32768, -32767, 0, 0 };
+      float decoded[3];
+      vtxcompress::decodePosition(quantization, lowest, decoded);
+      check(decoded[0] == quantization.bias[0] - quantization.scale[0], "-32768 must decode to -1");
+      check(decoded[1] == quantization.bias[1] - quantization.scale[1], "-32767 must decode to -1");
+    }
+
+    void testPositionErrorBound() {
+      // The documented bound of half a quantization step must hold for tiny and huge meshes alike,
+      // and for meshes far away from the origin
+      const float extents[] = { 1.0e-3f, 1.0f, 37.5f, 1.0e4f };
+      const float origins[] = { 0.0f, -512.0f, 3.0e4f };
+
+      std::mt19937 rng(17);
+      std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+      for (const float extent : extents) {
+        for (const float origin : origins) {
+          std::vector<float> positions;
+          for (uint32_t i = 0; i < 4096; ++i) {
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+              positions.push_back(origin + extent * dist(rng));
+            }
+          }
+
+          const size_t count = positions.size() / 3;
+          const vtxcompress::PositionQuantization quantization =
+            vtxcompress::computePositionQuantization(positions.data(), count, sizeof(float) * 3);
+
+          for (size_t i = 0; i < count; ++i) {
+            const float* position = &positions[i * 3];
+            int16_t encoded[4];
+            vtxcompress::encodePosition(quantization, position, encoded);
+
+            float decoded[3];
+            vtxcompress::decodePosition(quantization, encoded, decoded);
+
+            // Decoding lands on a quantization step, so encoding it again must be stable as long as the steps are
+            // coarser than the float spacing around the mesh
+            const bool stepsRepresentable = extent / 65534.0f > 4.0f * (std::abs(origin) + extent) * std::numeric_limits<float>::epsilon();
+            if (stepsRepresentable) {
+              int16_t reencoded[4];
+              vtxcompress::encodePosition(quantization, decoded, reencoded);
+              check(std::memcmp(encoded, reencoded, sizeof(encoded)) == 0, "re-encoding a decoded position must be stable");
+            }
+
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+              const float step = quantization.scale[axis] / 32767.0f;
+              const float magnitude = std::abs(origin) + extent;
+              const float bound = 0.5f * step + 4.0f * magnitude * std::numeric_limits<float>::epsilon();
+              check(std::abs(decoded[axis] - position[axis]) <= bound, "position error above the documented bound");
+            }
+          }
+        }
+      }
+    }
+
+    void testNormalError() {
+      // The existing 32 bit octahedral layout: +Z sits at the center of the unsigned square
+      const float up[3] = { 0.0f, 0.0f, 1.0f };
+      check(vtxcompress::encodeOctahedralNormal(up) == 0x80008000, "+Z encoding must match the renderer layout");
+
+      std::mt19937 rng(13);
+      std::normal_distribution<float> dist(0.0f, 1.0f);
+
+      float maxAngle = 0.0f;
+      for (uint32_t i = 0; i < 100000; ++i) {
+        float normal[3] = { dist(rng), dist(rng), dist(rng) };
+        const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length == 0.0f) {
+          continue;
+        }
+        for (float& c : normal) {
+          c /= length;
+        }
+
+        float decoded[3];
+        vtxcompress::decodeOctahedralNormal(vtxcompress::encodeOctahedralNormal(normal), decoded);
+
+        const float decodedLength = std::sqrt(decoded[0] * decoded[0] + decoded[1] * decoded[1] + decoded[2] * decoded[2]);
+        check(std::abs(decodedLength - 1.0f) < 1.0e-5f, "decoded normal must be unit length");
+
+        // atan2 of the cross and dot products stays accurate for tiny angles, unlike acos
+        const double cross[3] = {
+          double(normal[1]) * decoded[2] - double(normal[2]) * decoded[1],
+          double(normal[2]) * decoded[0] - double(normal[0]) * decoded[2],
+          double(normal[0]) * decoded[1] - double(normal[1]) * decoded[0]
+        };
+        const double sinAngle = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+        const double cosAngle = double(normal[0]) * decoded[0] + double(normal[1]) * decoded[1] + double(normal[2]) * decoded[2];
+        maxAngle = std::max(maxAngle, float(std::atan2(sinAngle, cosAngle)));
+      }
+
+      // 16 bits per axis bound the angular error well below a hundredth of a degree
+      check(maxAngle < 1.0e-4f, "normal angular error above bound");
+    }
+
+    void run() {
+      testHalfRoundTrip();
+      testTexcoordError();
+      testPositionError();
+      testPositionErrorBound();
+      testNormalError();
+      std::cout << "All passed\n";
+    }
+  };
+}
+
+int main() {
+  try {
+    dxvk::TestApp testApp;
+    testApp.run();
+  }
+  catch (const dxvk::DxvkError& error) {
+    std::cerr << error.message() << std::endl;
+    throw;
+  }
+
+  return 0;
+}
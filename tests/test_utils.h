@@ -15,3 +15,14 @@
 #include "../src/util/util_enum.h"
 #include "../src/util/util_error.h"
 #include "../src/util/util_string.h"
+
+namespace dxvk {
+
+  // Assertion for unit tests, failures surface as a DxvkError like the rest of the test suite
+  inline void check(bool condition, const char* message) {
+    if (!condition) {
+      throw DxvkError(str::format("Test failed: ", message));
+    }
+  }
+
+}